@@ -41,6 +41,37 @@ struct DSideAccessInfo {
   bool m_mode_access;
 };
 
+// Most mhpmcounters a `RetireRecord` can carry (mhpmcounter3 to
+// mhpmcounter31) and the CSR numbers of the first of them (mhpmcounter3 and
+// mhpmcounter3h)
+static const int kRetireRecordMhpmCounters = 29;
+static const int kRetireRecordMhpmCounterCsr = 0xb03;
+static const int kRetireRecordMhpmCounterhCsr = 0xb83;
+
+// Everything observed about a single retired instruction: the arguments to
+// `step` along with the side-band state that is set before it. See
+// `step_batch`.
+struct RetireRecord {
+  uint32_t write_reg;
+  uint32_t write_reg_data;
+  uint32_t pc;
+  bool sync_trap;
+  bool suppress_reg_write;
+
+  bool nmi;
+  bool nmi_int;
+  uint32_t pre_mip;
+  uint32_t post_mip;
+  bool debug_req;
+  uint64_t mcycle;
+  // Number of valid entries in `mhpmcounters` and `mhpmcountersh`, the
+  // MHPMCounterNum the DUT was built with
+  uint32_t num_mhpmcounters;
+  uint32_t mhpmcounters[kRetireRecordMhpmCounters];
+  uint32_t mhpmcountersh[kRetireRecordMhpmCounters];
+  bool ic_scr_key_valid;
+};
+
 class Cosim {
  public:
   virtual ~Cosim() {}
@@ -78,6 +109,39 @@ class Cosim {
   virtual bool step(uint32_t write_reg, uint32_t write_reg_data, uint32_t pc,
                     bool sync_trap, bool suppress_reg_write) = 0;
 
+  // Step the co-simulator over `n` retired instructions in order. For each
+  // record this is equivalent to calling `set_nmi`, `set_nmi_int`, `set_mip`,
+  // `set_debug_req`, `set_mcycle`, `set_csr` for each valid mhpmcounter,
+  // `set_ic_scr_key_valid` and then `step` with the record's values.
+  //
+  // Stops at the first step that fails. Returns the number of records that
+  // stepped without error, so a return less than `n` means
+  // `records[return value]` failed and the records after it weren't applied;
+  // use `get_errors` to obtain details.
+  virtual size_t step_batch(const RetireRecord *records, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      const RetireRecord &r = records[i];
+
+      set_nmi(r.nmi);
+      set_nmi_int(r.nmi_int);
+      set_mip(r.pre_mip, r.post_mip);
+      set_debug_req(r.debug_req);
+      set_mcycle(r.mcycle);
+      for (uint32_t c = 0; c < r.num_mhpmcounters; ++c) {
+        set_csr(kRetireRecordMhpmCounterCsr + c, r.mhpmcounters[c]);
+        set_csr(kRetireRecordMhpmCounterhCsr + c, r.mhpmcountersh[c]);
+      }
+      set_ic_scr_key_valid(r.ic_scr_key_valid);
+
+      if (!step(r.write_reg, r.write_reg_data, r.pc, r.sync_trap,
+                r.suppress_reg_write)) {
+        return i;
+      }
+    }
+
+    return n;
+  }
+
   // When more than one of `set_mip`, `set_nmi` or `set_debug_req` is called
   // before `step` which one takes effect is chosen by the co-simulator. Which
   // should take priority is architecturally defined by the RISC-V
@@ -6,61 +6,258 @@
 
 #include <svdpi.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
 
 #include "cosim.h"
 
+// Log of DPI calls, only written to when `recording` is set
+static CosimLogWriter record_log;
+static bool recording = false;
+
+// Count of riscv_cosim_* calls made, see `cosim_dpi_get_num_calls`
+static uint64_t num_dpi_calls = 0;
+
+uint64_t cosim_dpi_get_num_calls() { return num_dpi_calls; }
+
+// Performance counter (mhpmcounter3-31 and their upper halves) values last
+// written to `record_log`, indexed by the bottom 8 bits of the CSR number.
+// Both testbenches set every counter before every instruction but most don't
+// change, and spike only changes them when the program writes one, so a
+// counter is only recorded when it differs from the value last recorded.
+static uint32_t recorded_counters[256];
+static bool recorded_counters_valid[256];
+
+static void record_csr(int csr_num, uint32_t csr_val) {
+  bool is_counter = ((csr_num & ~0x9f) == 0xb00) && ((csr_num & 0x1f) >= 3);
+
+  if (is_counter) {
+    int idx = csr_num & 0xff;
+    if (recorded_counters_valid[idx] && (recorded_counters[idx] == csr_val)) {
+      return;
+    }
+
+    recorded_counters[idx] = csr_val;
+    recorded_counters_valid[idx] = true;
+  }
+
+  record_log.set_csr(csr_num, csr_val);
+}
+
+static void record_retire(const RetireRecord &r, bool step_passed) {
+  // What spike does with NMI, MIP and debug request depends on its state at
+  // each step, so these are recorded for every instruction.
+  record_log.set_flag(kCosimLogSetNmi, r.nmi);
+  record_log.set_flag(kCosimLogSetNmiInt, r.nmi_int);
+  record_log.set_mip(r.pre_mip, r.post_mip);
+  record_log.set_flag(kCosimLogSetDebugReq, r.debug_req);
+  record_log.set_mcycle(r.mcycle);
+  for (uint32_t c = 0; c < r.num_mhpmcounters; ++c) {
+    record_csr(kRetireRecordMhpmCounterCsr + c, r.mhpmcounters[c]);
+    record_csr(kRetireRecordMhpmCounterhCsr + c, r.mhpmcountersh[c]);
+  }
+  record_log.set_flag(kCosimLogSetIcScrKeyValid, r.ic_scr_key_valid);
+  record_log.step(r.write_reg, r.write_reg_data, r.pc, r.sync_trap,
+                  r.suppress_reg_write, step_passed);
+}
+
+bool cosim_dpi_start_recording(const std::string &path,
+                               const CosimLogConfig &config) {
+  std::string record_path = path;
+  if (record_path.empty()) {
+    const char *env_path = getenv("IBEX_COSIM_RECORD");
+    if (!env_path || !env_path[0]) {
+      return true;
+    }
+
+    record_path = env_path;
+  }
+
+  recording = record_log.open(record_path, config);
+  std::fill(std::begin(recorded_counters_valid),
+            std::end(recorded_counters_valid), false);
+  if (!recording) {
+    std::cerr << "WARNING: Could not open co-simulation record file "
+              << record_path << ", recording disabled" << std::endl;
+    return false;
+  }
+
+  std::cout << "Recording co-simulation to " << record_path << std::endl;
+
+  return true;
+}
+
+void cosim_dpi_stop_recording() {
+  record_log.close();
+  recording = false;
+}
+
+void cosim_dpi_add_memory(Cosim *cosim, uint32_t base_addr, size_t size) {
+  assert(cosim);
+
+  if (recording) {
+    record_log.add_memory(base_addr, size);
+  }
+
+  cosim->add_memory(base_addr, size);
+}
+
+bool cosim_dpi_backdoor_write_mem(Cosim *cosim, uint32_t addr, size_t len,
+                                  const uint8_t *data_in) {
+  assert(cosim);
+
+  if (recording) {
+    record_log.backdoor_write_mem(addr, len, data_in);
+  }
+
+  return cosim->backdoor_write_mem(addr, len, data_in);
+}
+
 int riscv_cosim_step(Cosim *cosim, const svBitVecVal *write_reg,
                      const svBitVecVal *write_reg_data, const svBitVecVal *pc,
                      svBit sync_trap, svBit suppress_reg_write) {
   assert(cosim);
+  ++num_dpi_calls;
 
-  return cosim->step(write_reg[0], write_reg_data[0], pc[0], sync_trap,
-                     suppress_reg_write)
-             ? 1
-             : 0;
+  bool passed = cosim->step(write_reg[0], write_reg_data[0], pc[0], sync_trap,
+                            suppress_reg_write);
+
+  if (recording) {
+    record_log.step(write_reg[0], write_reg_data[0], pc[0], sync_trap,
+                    suppress_reg_write, passed);
+  }
+
+  return passed ? 1 : 0;
+}
+
+int riscv_cosim_step_batch(Cosim *cosim, const svBitVecVal *records,
+                           int num_records) {
+  assert(cosim);
+  ++num_dpi_calls;
+  assert(num_records >= 0 && num_records <= kCosimDpiMaxBatch);
+
+  RetireRecord batch[kCosimDpiMaxBatch];
+
+  for (int i = 0; i < num_records; ++i) {
+    const svBitVecVal *words = &records[i * kCosimDpiRetireRecordWords];
+    RetireRecord &r = batch[i];
+
+    r.pc = words[0];
+    r.write_reg_data = words[1];
+    r.pre_mip = words[2];
+    r.post_mip = words[3];
+    r.mcycle = words[4] | (uint64_t)words[5] << 32;
+
+    uint32_t flags = words[6 + 2 * kRetireRecordMhpmCounters];
+    r.write_reg = flags & 0x1f;
+    r.sync_trap = (flags >> 5) & 1;
+    r.suppress_reg_write = (flags >> 6) & 1;
+    r.nmi = (flags >> 7) & 1;
+    r.nmi_int = (flags >> 8) & 1;
+    r.debug_req = (flags >> 9) & 1;
+    r.ic_scr_key_valid = (flags >> 10) & 1;
+    r.num_mhpmcounters = (flags >> 11) & 0x1f;
+    assert(r.num_mhpmcounters <= kRetireRecordMhpmCounters);
+
+    for (uint32_t c = 0; c < r.num_mhpmcounters; ++c) {
+      r.mhpmcounters[c] = words[6 + c];
+      r.mhpmcountersh[c] = words[6 + kRetireRecordMhpmCounters + c];
+    }
+  }
+
+  size_t num_passed = cosim->step_batch(batch, num_records);
+
+  if (recording) {
+    for (size_t i = 0; i < num_passed; ++i) {
+      record_retire(batch[i], true);
+    }
+
+    if (num_passed < static_cast<size_t>(num_records)) {
+      record_retire(batch[num_passed], false);
+    }
+  }
+
+  return num_passed;
 }
 
 void riscv_cosim_set_mip(Cosim *cosim, const svBitVecVal *pre_mip,
                          const svBitVecVal *post_mip) {
   assert(cosim);
+  ++num_dpi_calls;
+
+  if (recording) {
+    record_log.set_mip(pre_mip[0], post_mip[0]);
+  }
 
   cosim->set_mip(pre_mip[0], post_mip[0]);
 }
 
 void riscv_cosim_set_nmi(Cosim *cosim, svBit nmi) {
   assert(cosim);
+  ++num_dpi_calls;
+
+  if (recording) {
+    record_log.set_flag(kCosimLogSetNmi, nmi);
+  }
 
   cosim->set_nmi(nmi);
 }
 
 void riscv_cosim_set_nmi_int(Cosim *cosim, svBit nmi_int) {
   assert(cosim);
+  ++num_dpi_calls;
+
+  if (recording) {
+    record_log.set_flag(kCosimLogSetNmiInt, nmi_int);
+  }
 
   cosim->set_nmi_int(nmi_int);
 }
 void riscv_cosim_set_debug_req(Cosim *cosim, svBit debug_req) {
   assert(cosim);
+  ++num_dpi_calls;
+
+  if (recording) {
+    record_log.set_flag(kCosimLogSetDebugReq, debug_req);
+  }
 
   cosim->set_debug_req(debug_req);
 }
 
 void riscv_cosim_set_mcycle(Cosim *cosim, svBitVecVal *mcycle) {
   assert(cosim);
+  ++num_dpi_calls;
 
   uint64_t mcycle_full = mcycle[0] | (uint64_t)mcycle[1] << 32;
+
+  if (recording) {
+    record_log.set_mcycle(mcycle_full);
+  }
+
   cosim->set_mcycle(mcycle_full);
 }
 
 void riscv_cosim_set_csr(Cosim *cosim, const int csr_id,
                          const svBitVecVal *csr_val) {
   assert(cosim);
+  ++num_dpi_calls;
+
+  if (recording) {
+    record_csr(csr_id, (uint32_t)csr_val[0]);
+  }
 
   cosim->set_csr(csr_id, (uint32_t)csr_val[0]);
 }
 
 void riscv_cosim_set_ic_scr_key_valid(Cosim *cosim, svBit valid) {
   assert(cosim);
+  ++num_dpi_calls;
+
+  if (recording) {
+    record_log.set_flag(kCosimLogSetIcScrKeyValid, valid);
+  }
 
   cosim->set_ic_scr_key_valid(valid);
 }
@@ -73,8 +270,9 @@ void riscv_cosim_notify_dside_access(Cosim *cosim, svBit store,
                                      svBit misaligned_first_saw_error,
                                      svBit m_mode_access) {
   assert(cosim);
+  ++num_dpi_calls;
 
-  cosim->notify_dside_access(DSideAccessInfo{
+  DSideAccessInfo access_info{
       .store = store != 0,
       .data = data[0],
       .addr = addr[0],
@@ -83,23 +281,36 @@ void riscv_cosim_notify_dside_access(Cosim *cosim, svBit store,
       .misaligned_first = misaligned_first != 0,
       .misaligned_second = misaligned_second != 0,
       .misaligned_first_saw_error = misaligned_first_saw_error != 0,
-      .m_mode_access = m_mode_access != 0});
+      .m_mode_access = m_mode_access != 0};
+
+  if (recording) {
+    record_log.notify_dside_access(access_info);
+  }
+
+  cosim->notify_dside_access(access_info);
 }
 
 void riscv_cosim_set_iside_error(Cosim *cosim, svBitVecVal *addr) {
   assert(cosim);
+  ++num_dpi_calls;
+
+  if (recording) {
+    record_log.set_iside_error(addr[0]);
+  }
 
   cosim->set_iside_error(addr[0]);
 }
 
 int riscv_cosim_get_num_errors(Cosim *cosim) {
   assert(cosim);
+  ++num_dpi_calls;
 
   return cosim->get_errors().size();
 }
 
 const char *riscv_cosim_get_error(Cosim *cosim, int index) {
   assert(cosim);
+  ++num_dpi_calls;
 
   if (index >= cosim->get_errors().size()) {
     return nullptr;
@@ -110,6 +321,11 @@ const char *riscv_cosim_get_error(Cosim *cosim, int index) {
 
 void riscv_cosim_clear_errors(Cosim *cosim) {
   assert(cosim);
+  ++num_dpi_calls;
+
+  if (recording) {
+    record_log.clear_errors();
+  }
 
   cosim->clear_errors();
 }
@@ -117,12 +333,14 @@ void riscv_cosim_clear_errors(Cosim *cosim) {
 void riscv_cosim_write_mem_byte(Cosim *cosim, const svBitVecVal *addr,
                                 const svBitVecVal *d) {
   assert(cosim);
+  ++num_dpi_calls;
   uint8_t byte = d[0] & 0xff;
-  cosim->backdoor_write_mem(addr[0], 1, &byte);
+  cosim_dpi_backdoor_write_mem(cosim, addr[0], 1, &byte);
 }
 
 unsigned int riscv_cosim_get_insn_cnt(Cosim *cosim) {
   assert(cosim);
+  ++num_dpi_calls;
 
   return cosim->get_insn_cnt();
 }
@@ -8,15 +8,62 @@
 #include <stdint.h>
 #include <svdpi.h>
 
+#include <string>
+
 #include "cosim.h"
+#include "cosim_log.h"
 
 // This adapts the C++ interface of the `Cosim` class to be used via DPI. See
 // the documentation in cosim.h for further details
 
+// Record every call made through the DPI functions below to a binary log at
+// `path` (see cosim_log.h), which `dv/cosim/replay/cosim_replay` can replay
+// without the RTL. If `path` is empty the IBEX_COSIM_RECORD environment
+// variable gives the path, when that isn't set either nothing is recorded.
+// Returns false if the log couldn't be opened.
+//
+// Calls a testbench makes directly from C++ rather than via DPI must go through
+// `cosim_dpi_add_memory`/`cosim_dpi_backdoor_write_mem` to be recorded.
+bool cosim_dpi_start_recording(const std::string &path,
+                               const CosimLogConfig &config);
+void cosim_dpi_stop_recording();
+
+void cosim_dpi_add_memory(Cosim *cosim, uint32_t base_addr, size_t size);
+bool cosim_dpi_backdoor_write_mem(Cosim *cosim, uint32_t addr, size_t len,
+                                  const uint8_t *data_in);
+
+// Number of `riscv_cosim_*` calls made so far, to measure DPI overhead
+uint64_t cosim_dpi_get_num_calls();
+
+// Size in 32-bit words of a packed retire record passed to
+// `riscv_cosim_step_batch` and the most records one call can take. These must
+// match `CosimRetireRecordWords` and `CosimMaxBatch` in `cosim_dpi.svh`.
+//
+// A record holds a `RetireRecord` as the words:
+//
+//  0     pc
+//  1     write_reg_data
+//  2     pre_mip
+//  3     post_mip
+//  4-5   mcycle (low word first)
+//  6-34  mhpmcounter3 to mhpmcounter31
+//  35-63 mhpmcounter3h to mhpmcounter31h
+//  64    write_reg [4:0], sync_trap [5], suppress_reg_write [6], nmi [7],
+//        nmi_int [8], debug_req [9], ic_scr_key_valid [10],
+//        num_mhpmcounters [15:11]
+//
+// Only the first num_mhpmcounters of each counter range are read.
+static const int kCosimDpiRetireRecordWords = 65;
+static const int kCosimDpiMaxBatch = 64;
+
 extern "C" {
 int riscv_cosim_step(Cosim *cosim, const svBitVecVal *write_reg,
                      const svBitVecVal *write_reg_data, const svBitVecVal *pc,
                      svBit sync_trap, svBit suppress_reg_write);
+// Apply `num_records` packed retire records with `Cosim::step_batch`. Returns
+// the number that stepped without error.
+int riscv_cosim_step_batch(Cosim *cosim, const svBitVecVal *records,
+                           int num_records);
 void riscv_cosim_set_mip(Cosim *cosim, const svBitVecVal *pre_mip,
                          const svBitVecVal *post_mip);
 void riscv_cosim_set_nmi(Cosim *cosim, svBit nmi);
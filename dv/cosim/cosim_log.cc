@@ -0,0 +1,356 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "cosim_log.h"
+
+#include <cassert>
+#include <cstring>
+
+static const char kCosimLogMagic[8] = {'I', 'B', 'X', 'C', 'O', 'S', 'I', 'M'};
+static const uint32_t kCosimLogVersion = 2;
+
+// Flag bits of a kCosimLogStep record
+static const uint8_t kStepSyncTrap = 0x1;
+static const uint8_t kStepSuppressRegWrite = 0x2;
+static const uint8_t kStepPassed = 0x4;
+
+// Flag bits of a kCosimLogNotifyDsideAccess record
+static const uint8_t kDsideStore = 0x01;
+static const uint8_t kDsideError = 0x02;
+static const uint8_t kDsideMisalignedFirst = 0x04;
+static const uint8_t kDsideMisalignedSecond = 0x08;
+static const uint8_t kDsideMisalignedFirstSawError = 0x10;
+static const uint8_t kDsideMModeAccess = 0x20;
+
+CosimLogWriter::CosimLogWriter() : file(nullptr) {}
+
+CosimLogWriter::~CosimLogWriter() { close(); }
+
+bool CosimLogWriter::open(const std::string &path,
+                          const CosimLogConfig &config) {
+  close();
+
+  file = fopen(path.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+
+  fwrite(kCosimLogMagic, 1, sizeof(kCosimLogMagic), file);
+  put_u32(kCosimLogVersion);
+
+  put_u32(config.isa_string.size());
+  fwrite(config.isa_string.data(), 1, config.isa_string.size(), file);
+  put_u32(config.start_pc);
+  put_u32(config.start_mtvec);
+  put_u8(config.secure_ibex);
+  put_u8(config.icache_en);
+  put_u8(config.dcache_en);
+  put_u32(config.pmp_num_regions);
+  put_u32(config.pmp_granularity);
+  put_u32(config.mhpm_counter_num);
+
+  return !ferror(file);
+}
+
+void CosimLogWriter::close() {
+  if (file) {
+    fclose(file);
+    file = nullptr;
+  }
+}
+
+void CosimLogWriter::put_u8(uint8_t val) { fputc(val, file); }
+
+void CosimLogWriter::put_u32(uint32_t val) {
+  uint8_t bytes[4] = {static_cast<uint8_t>(val), static_cast<uint8_t>(val >> 8),
+                      static_cast<uint8_t>(val >> 16),
+                      static_cast<uint8_t>(val >> 24)};
+  fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+void CosimLogWriter::put_u64(uint64_t val) {
+  put_u32(val & 0xffffffff);
+  put_u32(val >> 32);
+}
+
+void CosimLogWriter::add_memory(uint32_t base_addr, size_t size) {
+  put_u8(kCosimLogAddMemory);
+  put_u32(base_addr);
+  put_u32(size);
+}
+
+void CosimLogWriter::backdoor_write_mem(uint32_t addr, size_t len,
+                                        const uint8_t *data) {
+  put_u8(kCosimLogBackdoorWriteMem);
+  put_u32(addr);
+  put_u32(len);
+  fwrite(data, 1, len, file);
+}
+
+void CosimLogWriter::step(uint32_t write_reg, uint32_t write_reg_data,
+                          uint32_t pc, bool sync_trap, bool suppress_reg_write,
+                          bool step_passed) {
+  put_u8(kCosimLogStep);
+  put_u8(write_reg);
+  put_u32(write_reg_data);
+  put_u32(pc);
+  put_u8((sync_trap ? kStepSyncTrap : 0) |
+         (suppress_reg_write ? kStepSuppressRegWrite : 0) |
+         (step_passed ? kStepPassed : 0));
+}
+
+void CosimLogWriter::set_mip(uint32_t pre_mip, uint32_t post_mip) {
+  put_u8(kCosimLogSetMip);
+  put_u32(pre_mip);
+  put_u32(post_mip);
+}
+
+void CosimLogWriter::set_flag(CosimLogRecordType type, bool flag) {
+  assert(type == kCosimLogSetNmi || type == kCosimLogSetNmiInt ||
+         type == kCosimLogSetDebugReq || type == kCosimLogSetIcScrKeyValid);
+
+  put_u8(type);
+  put_u8(flag);
+}
+
+void CosimLogWriter::set_mcycle(uint64_t mcycle) {
+  put_u8(kCosimLogSetMcycle);
+  put_u64(mcycle);
+}
+
+void CosimLogWriter::set_csr(int csr_num, uint32_t csr_val) {
+  put_u8(kCosimLogSetCsr);
+  put_u32(csr_num);
+  put_u32(csr_val);
+}
+
+void CosimLogWriter::notify_dside_access(const DSideAccessInfo &access_info) {
+  put_u8(kCosimLogNotifyDsideAccess);
+  put_u32(access_info.addr);
+  put_u32(access_info.data);
+  put_u8(access_info.be);
+  put_u8((access_info.store ? kDsideStore : 0) |
+         (access_info.error ? kDsideError : 0) |
+         (access_info.misaligned_first ? kDsideMisalignedFirst : 0) |
+         (access_info.misaligned_second ? kDsideMisalignedSecond : 0) |
+         (access_info.misaligned_first_saw_error ? kDsideMisalignedFirstSawError
+                                                 : 0) |
+         (access_info.m_mode_access ? kDsideMModeAccess : 0));
+}
+
+void CosimLogWriter::set_iside_error(uint32_t addr) {
+  put_u8(kCosimLogSetIsideError);
+  put_u32(addr);
+}
+
+void CosimLogWriter::clear_errors() { put_u8(kCosimLogClearErrors); }
+
+CosimLogReader::CosimLogReader() : file(nullptr), read_error(false) {}
+
+CosimLogReader::~CosimLogReader() {
+  if (file) {
+    fclose(file);
+  }
+}
+
+bool CosimLogReader::open(const std::string &path, CosimLogConfig &config) {
+  file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+
+  char magic[sizeof(kCosimLogMagic)];
+  uint32_t version;
+  if ((fread(magic, 1, sizeof(magic), file) != sizeof(magic)) ||
+      (memcmp(magic, kCosimLogMagic, sizeof(magic)) != 0) ||
+      !get_u32(version) || (version != kCosimLogVersion)) {
+    return false;
+  }
+
+  uint32_t isa_len;
+  if (!get_u32(isa_len)) {
+    return false;
+  }
+
+  config.isa_string.resize(isa_len);
+  if (fread(&config.isa_string[0], 1, isa_len, file) != isa_len) {
+    return false;
+  }
+
+  uint8_t secure_ibex, icache_en, dcache_en;
+  if (!get_u32(config.start_pc) || !get_u32(config.start_mtvec) ||
+      !get_u8(secure_ibex) || !get_u8(icache_en) || !get_u8(dcache_en) ||
+      !get_u32(config.pmp_num_regions) || !get_u32(config.pmp_granularity) ||
+      !get_u32(config.mhpm_counter_num)) {
+    return false;
+  }
+
+  config.secure_ibex = secure_ibex;
+  config.icache_en = icache_en;
+  config.dcache_en = dcache_en;
+
+  return true;
+}
+
+bool CosimLogReader::get_u8(uint8_t &val) {
+  int c = fgetc(file);
+  if (c == EOF) {
+    return false;
+  }
+
+  val = c;
+  return true;
+}
+
+bool CosimLogReader::get_u32(uint32_t &val) {
+  uint8_t bytes[4];
+  if (fread(bytes, 1, sizeof(bytes), file) != sizeof(bytes)) {
+    return false;
+  }
+
+  val = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+        (static_cast<uint32_t>(bytes[3]) << 24);
+  return true;
+}
+
+bool CosimLogReader::get_u64(uint64_t &val) {
+  uint32_t lo, hi;
+  if (!get_u32(lo) || !get_u32(hi)) {
+    return false;
+  }
+
+  val = lo | (static_cast<uint64_t>(hi) << 32);
+  return true;
+}
+
+bool CosimLogReader::next(CosimLogRecord &record) {
+  uint8_t type;
+  if (!get_u8(type)) {
+    // Clean end of log
+    return false;
+  }
+
+  record.type = static_cast<CosimLogRecordType>(type);
+
+  bool ok;
+  uint8_t u8_val = 0, flags = 0;
+  uint32_t u32_val = 0;
+
+  switch (record.type) {
+    case kCosimLogAddMemory:
+      ok = get_u32(record.addr) && get_u32(record.len);
+      break;
+    case kCosimLogBackdoorWriteMem:
+      ok = get_u32(record.addr) && get_u32(record.len);
+      if (ok) {
+        record.data.resize(record.len);
+        ok = fread(record.data.data(), 1, record.len, file) == record.len;
+      }
+      break;
+    case kCosimLogStep:
+      ok = get_u8(u8_val) && get_u32(record.write_reg_data) &&
+           get_u32(record.pc) && get_u8(flags);
+      if (ok) {
+        record.write_reg = u8_val;
+        record.sync_trap = flags & kStepSyncTrap;
+        record.suppress_reg_write = flags & kStepSuppressRegWrite;
+        record.step_passed = flags & kStepPassed;
+      }
+      break;
+    case kCosimLogSetMip:
+      ok = get_u32(record.pre_mip) && get_u32(record.post_mip);
+      break;
+    case kCosimLogSetNmi:
+    case kCosimLogSetNmiInt:
+    case kCosimLogSetDebugReq:
+    case kCosimLogSetIcScrKeyValid:
+      ok = get_u8(u8_val);
+      record.flag = u8_val != 0;
+      break;
+    case kCosimLogSetMcycle:
+      ok = get_u64(record.mcycle);
+      break;
+    case kCosimLogSetCsr:
+      ok = get_u32(u32_val) && get_u32(record.csr_val);
+      record.csr_num = u32_val;
+      break;
+    case kCosimLogNotifyDsideAccess:
+      ok = get_u32(record.dside_access.addr) &&
+           get_u32(record.dside_access.data) && get_u8(u8_val) &&
+           get_u8(flags);
+      if (ok) {
+        record.dside_access.be = u8_val;
+        record.dside_access.store = flags & kDsideStore;
+        record.dside_access.error = flags & kDsideError;
+        record.dside_access.misaligned_first = flags & kDsideMisalignedFirst;
+        record.dside_access.misaligned_second = flags & kDsideMisalignedSecond;
+        record.dside_access.misaligned_first_saw_error =
+            flags & kDsideMisalignedFirstSawError;
+        record.dside_access.m_mode_access = flags & kDsideMModeAccess;
+      }
+      break;
+    case kCosimLogSetIsideError:
+      ok = get_u32(record.addr);
+      break;
+    case kCosimLogClearErrors:
+      ok = true;
+      break;
+    default:
+      ok = false;
+      break;
+  }
+
+  if (!ok) {
+    read_error = true;
+  }
+
+  return ok;
+}
+
+bool cosim_log_replay(Cosim *cosim, const CosimLogRecord &record) {
+  switch (record.type) {
+    case kCosimLogAddMemory:
+      cosim->add_memory(record.addr, record.len);
+      break;
+    case kCosimLogBackdoorWriteMem:
+      cosim->backdoor_write_mem(record.addr, record.data.size(),
+                                record.data.data());
+      break;
+    case kCosimLogStep:
+      return cosim->step(record.write_reg, record.write_reg_data, record.pc,
+                         record.sync_trap, record.suppress_reg_write);
+    case kCosimLogSetMip:
+      cosim->set_mip(record.pre_mip, record.post_mip);
+      break;
+    case kCosimLogSetNmi:
+      cosim->set_nmi(record.flag);
+      break;
+    case kCosimLogSetNmiInt:
+      cosim->set_nmi_int(record.flag);
+      break;
+    case kCosimLogSetDebugReq:
+      cosim->set_debug_req(record.flag);
+      break;
+    case kCosimLogSetMcycle:
+      cosim->set_mcycle(record.mcycle);
+      break;
+    case kCosimLogSetCsr:
+      cosim->set_csr(record.csr_num, record.csr_val);
+      break;
+    case kCosimLogSetIcScrKeyValid:
+      cosim->set_ic_scr_key_valid(record.flag);
+      break;
+    case kCosimLogNotifyDsideAccess:
+      cosim->notify_dside_access(record.dside_access);
+      break;
+    case kCosimLogSetIsideError:
+      cosim->set_iside_error(record.addr);
+      break;
+    case kCosimLogClearErrors:
+      cosim->clear_errors();
+      break;
+  }
+
+  return true;
+}
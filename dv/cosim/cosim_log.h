@@ -0,0 +1,149 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef COSIM_LOG_H_
+#define COSIM_LOG_H_
+
+#include <stdint.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "cosim.h"
+
+// Binary log of the calls made on a `Cosim` during a simulation. A log holds
+// everything needed to construct and drive a co-simulator without the RTL
+// that produced it, so the checker can be run (and timed) in isolation.
+//
+// A log starts with a header (magic, version and the co-simulator
+// configuration) followed by one record per call. Each record is a one byte
+// type followed by a fixed payload for that type, all values little-endian.
+// Backdoor memory writes are followed by the bytes written.
+
+// Configuration the co-simulator was constructed with, see the `SpikeCosim`
+// constructor.
+struct CosimLogConfig {
+  std::string isa_string;
+  uint32_t start_pc;
+  uint32_t start_mtvec;
+  bool secure_ibex;
+  bool icache_en;
+  bool dcache_en;
+  uint32_t pmp_num_regions;
+  uint32_t pmp_granularity;
+  uint32_t mhpm_counter_num;
+};
+
+enum CosimLogRecordType : uint8_t {
+  kCosimLogAddMemory = 1,
+  kCosimLogBackdoorWriteMem,
+  kCosimLogStep,
+  kCosimLogSetMip,
+  kCosimLogSetNmi,
+  kCosimLogSetNmiInt,
+  kCosimLogSetDebugReq,
+  kCosimLogSetMcycle,
+  kCosimLogSetCsr,
+  kCosimLogSetIcScrKeyValid,
+  kCosimLogNotifyDsideAccess,
+  kCosimLogSetIsideError,
+  kCosimLogClearErrors,
+};
+
+// A single decoded record. Only the fields relevant to `type` are valid:
+//
+// - kCosimLogAddMemory: `addr`, `len`
+// - kCosimLogBackdoorWriteMem: `addr`, `data`
+// - kCosimLogStep: `write_reg`, `write_reg_data`, `pc`, `sync_trap`,
+//   `suppress_reg_write`, `step_passed` (the result the step originally gave)
+// - kCosimLogSetMip: `pre_mip`, `post_mip`
+// - kCosimLogSetNmi/SetNmiInt/SetDebugReq/SetIcScrKeyValid: `flag`
+// - kCosimLogSetMcycle: `mcycle`
+// - kCosimLogSetCsr: `csr_num`, `csr_val`
+// - kCosimLogNotifyDsideAccess: `dside_access`
+// - kCosimLogSetIsideError: `addr`
+struct CosimLogRecord {
+  CosimLogRecordType type;
+
+  uint32_t addr;
+  uint32_t len;
+  std::vector<uint8_t> data;
+
+  uint32_t write_reg;
+  uint32_t write_reg_data;
+  uint32_t pc;
+  bool sync_trap;
+  bool suppress_reg_write;
+  bool step_passed;
+
+  uint32_t pre_mip;
+  uint32_t post_mip;
+  bool flag;
+  uint64_t mcycle;
+  int csr_num;
+  uint32_t csr_val;
+
+  DSideAccessInfo dside_access;
+};
+
+class CosimLogWriter {
+ public:
+  CosimLogWriter();
+  ~CosimLogWriter();
+
+  // Open `path` and write the log header. Returns false if the file can't be
+  // written.
+  bool open(const std::string &path, const CosimLogConfig &config);
+  void close();
+
+  void add_memory(uint32_t base_addr, size_t size);
+  void backdoor_write_mem(uint32_t addr, size_t len, const uint8_t *data);
+  void step(uint32_t write_reg, uint32_t write_reg_data, uint32_t pc,
+            bool sync_trap, bool suppress_reg_write, bool step_passed);
+  void set_mip(uint32_t pre_mip, uint32_t post_mip);
+  void set_flag(CosimLogRecordType type, bool flag);
+  void set_mcycle(uint64_t mcycle);
+  void set_csr(int csr_num, uint32_t csr_val);
+  void notify_dside_access(const DSideAccessInfo &access_info);
+  void set_iside_error(uint32_t addr);
+  void clear_errors();
+
+ private:
+  FILE *file;
+
+  void put_u8(uint8_t val);
+  void put_u32(uint32_t val);
+  void put_u64(uint64_t val);
+};
+
+class CosimLogReader {
+ public:
+  CosimLogReader();
+  ~CosimLogReader();
+
+  // Open `path` and read the log header into `config`. Returns false if the
+  // file can't be read or isn't a co-simulation log.
+  bool open(const std::string &path, CosimLogConfig &config);
+
+  // Read the next record. Returns false at the end of the log or if the log
+  // is malformed, use `error` to tell the two apart.
+  bool next(CosimLogRecord &record);
+
+  bool error() const { return read_error; }
+
+ private:
+  FILE *file;
+  bool read_error;
+
+  bool get_u8(uint8_t &val);
+  bool get_u32(uint32_t &val);
+  bool get_u64(uint64_t &val);
+};
+
+// Apply a record to `cosim`. For a step record returns the result of the step,
+// otherwise returns true.
+bool cosim_log_replay(Cosim *cosim, const CosimLogRecord &record);
+
+#endif  // COSIM_LOG_H_
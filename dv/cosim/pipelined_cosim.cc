@@ -0,0 +1,253 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "pipelined_cosim.h"
+
+#include <cassert>
+#include <sstream>
+
+// Each retired instruction produces a few dozen queued calls (the simple system
+// checker sets 20 performance counter CSRs per instruction), size the queue
+// so it is the step limit rather than the queue capacity that throttles the
+// simulation.
+static const size_t kRecordsPerStep = 32;
+
+static size_t QueueCapacity(unsigned int max_lag) {
+  size_t want = static_cast<size_t>(max_lag) * kRecordsPerStep;
+  size_t capacity = 1024;
+  while (capacity < want) {
+    capacity <<= 1;
+  }
+
+  return capacity;
+}
+
+PipelinedCosim::PipelinedCosim(Cosim *cosim, unsigned int max_lag)
+    : cosim(cosim),
+      max_lag(max_lag),
+      queue(QueueCapacity(max_lag)),
+      records_queued(0),
+      steps_queued(0),
+      records_done(0),
+      steps_done(0),
+      failed(false),
+      checker_mcycle(0),
+      stop(false) {
+  assert(max_lag != 0);
+  checker = std::thread(&PipelinedCosim::checker_loop, this);
+}
+
+PipelinedCosim::~PipelinedCosim() {
+  stop.store(true, std::memory_order_release);
+  checker.join();
+}
+
+CosimLogRecord &PipelinedCosim::claim() {
+  CosimLogRecord *record;
+  while ((record = queue.claim()) == nullptr) {
+    std::this_thread::yield();
+  }
+
+  return *record;
+}
+
+void PipelinedCosim::publish() {
+  queue.publish();
+  ++records_queued;
+}
+
+void PipelinedCosim::drain() {
+  while (records_done.load(std::memory_order_acquire) != records_queued) {
+    std::this_thread::yield();
+  }
+}
+
+void PipelinedCosim::checker_loop() {
+  while (true) {
+    CosimLogRecord *record = queue.front();
+    if (!record) {
+      if (stop.load(std::memory_order_acquire)) {
+        break;
+      }
+
+      std::this_thread::yield();
+      continue;
+    }
+
+    // After a mismatch records are only consumed, so the producer never
+    // blocks waiting on a checker that has stopped checking.
+    if (!failed.load(std::memory_order_relaxed)) {
+      if (record->type == kCosimLogSetMcycle) {
+        checker_mcycle = record->mcycle;
+      }
+
+      if (!cosim_log_replay(cosim, *record)) {
+        record_mismatch(*record);
+      }
+    }
+
+    bool is_step = record->type == kCosimLogStep;
+
+    queue.pop();
+    records_done.fetch_add(1, std::memory_order_release);
+    if (is_step) {
+      steps_done.fetch_add(1, std::memory_order_release);
+    }
+  }
+}
+
+void PipelinedCosim::record_mismatch(const CosimLogRecord &step) {
+  std::stringstream context;
+  context << "Co-simulation mismatch at step "
+          << steps_done.load(std::memory_order_relaxed) + 1 << ", PC "
+          << std::hex << step.pc << std::dec << " (mcycle " << checker_mcycle
+          << ")";
+
+  errors.push_back(context.str());
+  for (auto &err : cosim->get_errors()) {
+    errors.push_back(err);
+  }
+
+  failed.store(true, std::memory_order_release);
+}
+
+void PipelinedCosim::add_memory(uint32_t base_addr, size_t size) {
+  drain();
+  cosim->add_memory(base_addr, size);
+}
+
+bool PipelinedCosim::backdoor_write_mem(uint32_t addr, size_t len,
+                                        const uint8_t *data_in) {
+  drain();
+  return cosim->backdoor_write_mem(addr, len, data_in);
+}
+
+bool PipelinedCosim::backdoor_read_mem(uint32_t addr, size_t len,
+                                       uint8_t *data_out) {
+  drain();
+  return cosim->backdoor_read_mem(addr, len, data_out);
+}
+
+bool PipelinedCosim::step(uint32_t write_reg, uint32_t write_reg_data,
+                          uint32_t pc, bool sync_trap,
+                          bool suppress_reg_write) {
+  if (failed.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  // Bound how far the simulation runs ahead of the checker
+  while (steps_queued - steps_done.load(std::memory_order_acquire) >=
+         max_lag) {
+    if (failed.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    std::this_thread::yield();
+  }
+
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogStep;
+  record.write_reg = write_reg;
+  record.write_reg_data = write_reg_data;
+  record.pc = pc;
+  record.sync_trap = sync_trap;
+  record.suppress_reg_write = suppress_reg_write;
+  publish();
+
+  ++steps_queued;
+
+  return true;
+}
+
+void PipelinedCosim::set_mip(uint32_t pre_mip, uint32_t post_mip) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogSetMip;
+  record.pre_mip = pre_mip;
+  record.post_mip = post_mip;
+  publish();
+}
+
+void PipelinedCosim::set_nmi(bool nmi) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogSetNmi;
+  record.flag = nmi;
+  publish();
+}
+
+void PipelinedCosim::set_nmi_int(bool nmi_int) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogSetNmiInt;
+  record.flag = nmi_int;
+  publish();
+}
+
+void PipelinedCosim::set_debug_req(bool debug_req) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogSetDebugReq;
+  record.flag = debug_req;
+  publish();
+}
+
+void PipelinedCosim::set_mcycle(uint64_t mcycle) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogSetMcycle;
+  record.mcycle = mcycle;
+  publish();
+}
+
+void PipelinedCosim::set_csr(const int csr_num, const uint32_t new_val) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogSetCsr;
+  record.csr_num = csr_num;
+  record.csr_val = new_val;
+  publish();
+}
+
+void PipelinedCosim::set_ic_scr_key_valid(bool valid) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogSetIcScrKeyValid;
+  record.flag = valid;
+  publish();
+}
+
+void PipelinedCosim::notify_dside_access(const DSideAccessInfo &access_info) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogNotifyDsideAccess;
+  record.dside_access = access_info;
+  publish();
+}
+
+void PipelinedCosim::set_iside_error(uint32_t addr) {
+  CosimLogRecord &record = claim();
+  record.type = kCosimLogSetIsideError;
+  record.addr = addr;
+  publish();
+}
+
+const std::vector<std::string> &PipelinedCosim::get_errors() {
+  if (failed.load(std::memory_order_acquire)) {
+    return errors;
+  }
+
+  drain();
+
+  if (failed.load(std::memory_order_acquire)) {
+    return errors;
+  }
+
+  return cosim->get_errors();
+}
+
+void PipelinedCosim::clear_errors() {
+  drain();
+
+  cosim->clear_errors();
+  errors.clear();
+  failed.store(false, std::memory_order_release);
+}
+
+unsigned int PipelinedCosim::get_insn_cnt() {
+  drain();
+  return cosim->get_insn_cnt();
+}
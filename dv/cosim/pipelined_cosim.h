@@ -0,0 +1,91 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef PIPELINED_COSIM_H_
+#define PIPELINED_COSIM_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cosim.h"
+#include "cosim_log.h"
+#include "spsc_queue.h"
+
+// A `Cosim` that checks on a separate thread so the simulation doesn't wait
+// for the co-simulator on every retired instruction.
+//
+// Calls that only feed the co-simulator (`step`, `set_mip`,
+// `notify_dside_access` etc.) are queued as `CosimLogRecord`s on a lock-free
+// single producer, single consumer queue and applied in order to the wrapped
+// `Cosim` by a checker thread. `step` returns true as soon as the record is
+// queued. Once the checker sees a mismatch every further `step` returns false,
+// with `get_errors` describing the failing instruction (its index, PC and the
+// mcycle it retired at) followed by the wrapped co-simulator's errors. The
+// simulation can run at most `max_lag` steps ahead of the checker, which
+// bounds how far past a mismatch the simulation continues.
+//
+// Calls that read co-simulator state or write its memory (`backdoor_*`,
+// `add_memory`, `get_insn_cnt`, ...) first wait for the checker to drain the
+// queue. All calls must come from a single thread.
+class PipelinedCosim : public Cosim {
+ public:
+  PipelinedCosim(Cosim *cosim, unsigned int max_lag);
+  ~PipelinedCosim();
+
+  void add_memory(uint32_t base_addr, size_t size) override;
+  bool backdoor_write_mem(uint32_t addr, size_t len,
+                          const uint8_t *data_in) override;
+  bool backdoor_read_mem(uint32_t addr, size_t len, uint8_t *data_out) override;
+  bool step(uint32_t write_reg, uint32_t write_reg_data, uint32_t pc,
+            bool sync_trap, bool suppress_reg_write) override;
+  void set_mip(uint32_t pre_mip, uint32_t post_mip) override;
+  void set_nmi(bool nmi) override;
+  void set_nmi_int(bool nmi_int) override;
+  void set_debug_req(bool debug_req) override;
+  void set_mcycle(uint64_t mcycle) override;
+  void set_csr(const int csr_num, const uint32_t new_val) override;
+  void set_ic_scr_key_valid(bool valid) override;
+  void notify_dside_access(const DSideAccessInfo &access_info) override;
+  void set_iside_error(uint32_t addr) override;
+  const std::vector<std::string> &get_errors() override;
+  void clear_errors() override;
+  unsigned int get_insn_cnt() override;
+
+ private:
+  Cosim *cosim;
+  unsigned int max_lag;
+  SpscQueue<CosimLogRecord> queue;
+
+  // Producer side counts
+  uint64_t records_queued;
+  uint64_t steps_queued;
+
+  // Checker side counts, read by the producer to wait for space or a drain
+  std::atomic<uint64_t> records_done;
+  std::atomic<uint64_t> steps_done;
+
+  // Set by the checker after it has filled in `errors` for a mismatch
+  std::atomic<bool> failed;
+  std::vector<std::string> errors;
+
+  // Most recent mcycle the checker has applied, for error context
+  uint64_t checker_mcycle;
+
+  std::atomic<bool> stop;
+  std::thread checker;
+
+  // Wait for a free queue entry and return it
+  CosimLogRecord &claim();
+  void publish();
+  void drain();
+
+  void checker_loop();
+  void record_mismatch(const CosimLogRecord &step);
+};
+
+#endif  // PIPELINED_COSIM_H_
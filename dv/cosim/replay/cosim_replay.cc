@@ -0,0 +1,303 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Replays a co-simulation log recorded from the DPI layer (see
+// `cosim_dpi_start_recording`) through a fresh `SpikeCosim`, without the RTL
+// simulation that produced it. A failing test can be recorded once and its
+// co-simulation mismatch then reproduced, traced and debugged in seconds.
+//
+// Replay stops at the first step whose result differs from the recording and
+// prints that step along with the calls that led up to it. Exits with 0 if the
+// whole log replays as recorded and 1 otherwise.
+
+#include <getopt.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "cosim_log.h"
+#include "spike_cosim.h"
+
+// Number of steps before a mismatch whose records are printed with it
+static const size_t kHistorySteps = 4;
+
+static void PrintUsage(const char *prog) {
+  std::cout << "Usage: " << prog << " [options] LOG\n\n"
+            << "Options:\n"
+            << "  --stop-at=N         Stop after replaying N steps, 0 stops "
+               "before the first\n"
+            << "  --trace=FILE        Write the spike instruction trace to "
+               "FILE\n"
+            << "  --direct-fetch      Enable SpikeCosim direct instruction "
+               "fetch\n"
+            << "  --progress=N        Report progress every N steps\n"
+            << "  -h, --help          Show this help\n";
+}
+
+static bool ParseCount(const char *arg, const char *opt_name, bool allow_zero,
+                       uint64_t &val) {
+  char *arg_end;
+  val = strtoull(arg, &arg_end, 0);
+  if (!*arg || *arg_end || (!allow_zero && val == 0)) {
+    std::cerr << "ERROR: Bad --" << opt_name << " argument: `" << arg
+              << "' is not a " << (allow_zero ? "non-negative" : "positive")
+              << " integer." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+static std::string DescribeRecord(const CosimLogRecord &record) {
+  std::stringstream desc;
+  desc << std::hex;
+
+  switch (record.type) {
+    case kCosimLogAddMemory:
+      desc << "add_memory(0x" << record.addr << ", 0x" << record.len << ")";
+      break;
+    case kCosimLogBackdoorWriteMem:
+      desc << "backdoor_write_mem(0x" << record.addr << ", " << std::dec
+           << record.data.size() << " bytes)";
+      break;
+    case kCosimLogStep:
+      desc << "step(x" << std::dec << record.write_reg << std::hex << " = 0x"
+           << record.write_reg_data << ", pc 0x" << record.pc
+           << (record.sync_trap ? ", sync_trap" : "")
+           << (record.suppress_reg_write ? ", suppress_reg_write" : "")
+           << ") " << (record.step_passed ? "passed" : "failed")
+           << " when recorded";
+      break;
+    case kCosimLogSetMip:
+      desc << "set_mip(0x" << record.pre_mip << ", 0x" << record.post_mip
+           << ")";
+      break;
+    case kCosimLogSetNmi:
+      desc << "set_nmi(" << record.flag << ")";
+      break;
+    case kCosimLogSetNmiInt:
+      desc << "set_nmi_int(" << record.flag << ")";
+      break;
+    case kCosimLogSetDebugReq:
+      desc << "set_debug_req(" << record.flag << ")";
+      break;
+    case kCosimLogSetMcycle:
+      desc << "set_mcycle(" << std::dec << record.mcycle << ")";
+      break;
+    case kCosimLogSetCsr:
+      desc << "set_csr(0x" << record.csr_num << ", 0x" << record.csr_val << ")";
+      break;
+    case kCosimLogSetIcScrKeyValid:
+      desc << "set_ic_scr_key_valid(" << record.flag << ")";
+      break;
+    case kCosimLogNotifyDsideAccess:
+      desc << "notify_dside_access("
+           << (record.dside_access.store ? "store" : "load") << " 0x"
+           << record.dside_access.addr << " data 0x"
+           << record.dside_access.data << " be 0x" << record.dside_access.be
+           << (record.dside_access.error ? " error" : "")
+           << (record.dside_access.misaligned_first ? " misaligned_first" : "")
+           << (record.dside_access.misaligned_second ? " misaligned_second"
+                                                     : "")
+           << ")";
+      break;
+    case kCosimLogSetIsideError:
+      desc << "set_iside_error(0x" << record.addr << ")";
+      break;
+    case kCosimLogClearErrors:
+      desc << "clear_errors()";
+      break;
+    default:
+      desc << "unknown record type " << static_cast<unsigned>(record.type);
+      break;
+  }
+
+  return desc.str();
+}
+
+int main(int argc, char **argv) {
+  const struct option long_options[] = {
+      {"stop-at", required_argument, nullptr, 's'},
+      {"trace", required_argument, nullptr, 't'},
+      {"direct-fetch", no_argument, nullptr, 'd'},
+      {"progress", required_argument, nullptr, 'p'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  uint64_t stop_at = 0;
+  bool stop_at_set = false;
+  uint64_t progress = 0;
+  std::string trace_path;
+  bool direct_fetch = false;
+
+  while (1) {
+    int c = getopt_long(argc, argv, "h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    switch (c) {
+      case 's':
+        if (!ParseCount(optarg, "stop-at", true, stop_at)) {
+          return 1;
+        }
+        stop_at_set = true;
+        break;
+      case 't':
+        trace_path = optarg;
+        break;
+      case 'd':
+        direct_fetch = true;
+        break;
+      case 'p':
+        if (!ParseCount(optarg, "progress", false, progress)) {
+          return 1;
+        }
+        break;
+      case 'h':
+        PrintUsage(argv[0]);
+        return 0;
+      default:
+        PrintUsage(argv[0]);
+        return 1;
+    }
+  }
+
+  if (optind != argc - 1) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  std::string log_path = argv[optind];
+
+  CosimLogReader reader;
+  CosimLogConfig config;
+  if (!reader.open(log_path, config)) {
+    std::cerr << "ERROR: Could not read co-simulation log " << log_path
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "Replaying " << log_path << " (" << config.isa_string
+            << ", start PC 0x" << std::hex << config.start_pc << std::dec
+            << ")" << std::endl;
+
+  auto cosim = std::make_unique<SpikeCosim>(
+      config.isa_string, config.start_pc, config.start_mtvec, trace_path,
+      config.secure_ibex, config.icache_en, config.dcache_en,
+      config.pmp_num_regions, config.pmp_granularity, config.mhpm_counter_num);
+
+  if (direct_fetch) {
+    cosim->enable_direct_fetch();
+  }
+
+  // Records of the last `kHistorySteps` steps, oldest first
+  std::deque<CosimLogRecord> history;
+  size_t history_steps = 0;
+  CosimLogRecord record;
+  uint64_t num_records = 0;
+  uint64_t num_steps = 0;
+  uint64_t mcycle = 0;
+  bool mismatch = false;
+
+  auto start = std::chrono::steady_clock::now();
+
+  while (reader.next(record)) {
+    // --stop-at=0 stops before the first step is applied
+    if (stop_at_set && (stop_at == 0) && (record.type == kCosimLogStep)) {
+      break;
+    }
+
+    ++num_records;
+
+    if (record.type == kCosimLogSetMcycle) {
+      mcycle = record.mcycle;
+    }
+
+    bool passed = cosim_log_replay(cosim.get(), record);
+
+    if (record.type == kCosimLogStep) {
+      ++num_steps;
+
+      if (passed != record.step_passed) {
+        mismatch = true;
+        break;
+      }
+
+      if (progress && (num_steps % progress == 0)) {
+        std::cout << "Replayed " << num_steps << " steps (mcycle " << mcycle
+                  << ")" << std::endl;
+      }
+
+      if (stop_at_set && (num_steps == stop_at)) {
+        break;
+      }
+    }
+
+    history.push_back(record);
+    if (record.type == kCosimLogStep) {
+      ++history_steps;
+    }
+
+    // Drop the oldest step and the records leading up to it
+    if (history_steps > kHistorySteps) {
+      while (history.front().type != kCosimLogStep) {
+        history.pop_front();
+      }
+      history.pop_front();
+      --history_steps;
+    }
+  }
+
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  if (reader.error()) {
+    std::cerr << "ERROR: Malformed record " << num_records + 1 << " in "
+              << log_path << std::endl;
+    return 1;
+  }
+
+  if (mismatch) {
+    std::cout << "MISMATCH: Step " << num_steps << " (record " << num_records
+              << ", mcycle " << mcycle << ") "
+              << (record.step_passed ? "passed when recorded but failed"
+                                     : "failed when recorded but passed")
+              << " on replay\n\nPreceding calls:\n";
+    for (auto &prev : history) {
+      std::cout << "  " << DescribeRecord(prev) << "\n";
+    }
+    std::cout << "> " << DescribeRecord(record) << "\n\n";
+
+    const std::vector<std::string> &errors = cosim->get_errors();
+    if (!errors.empty()) {
+      std::cout << "Errors on replay:\n";
+      for (auto &err : errors) {
+        std::cout << "  " << err << "\n";
+      }
+    }
+
+    std::cout << "\nRerun with --stop-at=" << num_steps - 1
+              << " to inspect the state before the failing step" << std::endl;
+
+    return 1;
+  }
+
+  std::cout << "Replayed " << num_steps << " steps (" << num_records
+            << " records) as recorded in " << std::setprecision(3)
+            << elapsed.count() << " s";
+  if (elapsed.count() > 0) {
+    std::cout << ", " << static_cast<uint64_t>(num_steps / elapsed.count())
+              << " steps/s";
+  }
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,151 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Microbenchmark for the co-simulation checker. Replays a log recorded by the
+// DPI layer (e.g. by running simple_system_cosim with `--cosim-record`) through
+// a fresh `SpikeCosim` and reports how many `Cosim::step` calls per second it
+// manages. The whole log is read into memory first so file I/O
+// isn't timed.
+
+#include <getopt.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cosim_log.h"
+#include "spike_cosim.h"
+
+static void PrintUsage(const char *prog) {
+  std::cout << "Usage: " << prog << " [options] LOG\n\n"
+            << "Options:\n"
+            << "  --repeat=N          Replay the log N times (default 1)\n"
+            << "  --direct-fetch      Enable SpikeCosim direct instruction "
+               "fetch\n"
+            << "  -h, --help          Show this help\n";
+}
+
+int main(int argc, char **argv) {
+  const struct option long_options[] = {
+      {"repeat", required_argument, nullptr, 'r'},
+      {"direct-fetch", no_argument, nullptr, 'd'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  unsigned long repeat = 1;
+  bool direct_fetch = false;
+
+  while (1) {
+    int c = getopt_long(argc, argv, "h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    switch (c) {
+      case 'r': {
+        char *arg_end;
+        repeat = strtoul(optarg, &arg_end, 0);
+        if (*arg_end || repeat == 0) {
+          std::cerr << "ERROR: Bad --repeat argument: `" << optarg
+                    << "' is not a positive integer." << std::endl;
+          return 1;
+        }
+        break;
+      }
+      case 'd':
+        direct_fetch = true;
+        break;
+      case 'h':
+        PrintUsage(argv[0]);
+        return 0;
+      default:
+        PrintUsage(argv[0]);
+        return 1;
+    }
+  }
+
+  if (optind != argc - 1) {
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  std::string log_path = argv[optind];
+
+  CosimLogReader reader;
+  CosimLogConfig config;
+  if (!reader.open(log_path, config)) {
+    std::cerr << "ERROR: Could not read co-simulation log " << log_path
+              << std::endl;
+    return 1;
+  }
+
+  std::vector<CosimLogRecord> records;
+  uint64_t num_steps = 0;
+  CosimLogRecord record;
+  while (reader.next(record)) {
+    if (record.type == kCosimLogStep) {
+      ++num_steps;
+    }
+    records.push_back(record);
+  }
+
+  if (reader.error()) {
+    std::cerr << "ERROR: Malformed record " << records.size() << " in "
+              << log_path << std::endl;
+    return 1;
+  }
+
+  std::chrono::duration<double> total_time(0);
+
+  for (unsigned long r = 0; r < repeat; ++r) {
+    auto cosim = std::make_unique<SpikeCosim>(
+        config.isa_string, config.start_pc, config.start_mtvec, "",
+        config.secure_ibex, config.icache_en, config.dcache_en,
+        config.pmp_num_regions, config.pmp_granularity,
+        config.mhpm_counter_num);
+
+    if (direct_fetch) {
+      cosim->enable_direct_fetch();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < records.size(); ++i) {
+      bool passed = cosim_log_replay(cosim.get(), records[i]);
+
+      if ((records[i].type == kCosimLogStep) &&
+          (passed != records[i].step_passed)) {
+        std::cerr << "ERROR: Step at record " << i << " (PC " << std::hex
+                  << records[i].pc << std::dec << ") "
+                  << (passed ? "passed" : "failed") << " on replay but "
+                  << (records[i].step_passed ? "passed" : "failed")
+                  << " when recorded" << std::endl;
+        for (auto &err : cosim->get_errors()) {
+          std::cerr << "  " << err << std::endl;
+        }
+        return 1;
+      }
+    }
+
+    total_time += std::chrono::steady_clock::now() - start;
+
+    if (r == repeat - 1) {
+      cosim->print_insn_class_stats(std::cout);
+    }
+  }
+
+  std::cout << "Records:        " << records.size() << "\n"
+            << "Steps:          " << num_steps * repeat << "\n"
+            << "Replay time:    " << total_time.count() << " s\n";
+  if (total_time.count() > 0) {
+    std::cout << "Replay speed:   "
+              << static_cast<uint64_t>(num_steps * repeat / total_time.count())
+              << " steps/s\n";
+  }
+
+  return 0;
+}
@@ -5,7 +5,10 @@
 #include "spike_cosim.h"
 
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <new>
 #include <sstream>
 
 #include "riscv/config.h"
@@ -35,10 +38,25 @@
 
 SpikeCosim::SpikeCosim(const std::string &isa_string, uint32_t start_pc,
                        uint32_t start_mtvec, const std::string &trace_log_path,
-                       bool secure_ibex, bool icache_en,
+                       bool secure_ibex, bool icache_en, bool dcache_en,
                        uint32_t pmp_num_regions, uint32_t pmp_granularity,
                        uint32_t mhpm_counter_num)
-    : nmi_mode(false), pending_iside_error(false), insn_cnt(0) {
+    : last_mem(nullptr),
+      direct_fetch(false),
+      nmi_mode(false),
+      pending_iside_error(false),
+      insn_class_cache(kInsnClassCacheEntries),
+      insn_class_hits(0),
+      insn_class_misses(0),
+      insn_class_invalidations(0),
+      insn_class_miss_time(0),
+      insn_cnt(0),
+      last_mcycle(0),
+      bbv_interval_len(0),
+      bbv_interval_insns(0),
+      bbv_interval_start_mcycle(0),
+      bbv_block_id(0),
+      bbv_next_seq_pc(0) {
   FILE *log_file = nullptr;
   if (trace_log_path.length() != 0) {
     log = std::make_unique<log_file_t>(trace_log_path.c_str());
@@ -68,7 +86,7 @@ SpikeCosim::SpikeCosim(const std::string &isa_string, uint32_t start_pc,
   processor->set_pmp_granularity(1 << (pmp_granularity + 2));
   processor->set_ibex_flags(secure_ibex, icache_en);
 
-  initial_proc_setup(start_pc, start_mtvec, mhpm_counter_num);
+  initial_proc_setup(start_pc, start_mtvec, mhpm_counter_num, dcache_en);
 
   if (log) {
     processor->set_debug(true);
@@ -76,8 +94,188 @@ SpikeCosim::SpikeCosim(const std::string &isa_string, uint32_t start_pc,
   }
 }
 
-// always return nullptr so all memory accesses go via mmio_load/mmio_store
-char *SpikeCosim::addr_to_mem(reg_t addr) { return nullptr; }
+SpikeCosim::~SpikeCosim() {
+  // Emit the final (partial) interval so no retired instructions are lost from
+  // the profile.
+  if (bbv_file && bbv_interval_insns != 0) {
+    bbv_end_interval();
+  }
+}
+
+void SpikeCosim::enable_bbv_profile(const std::string &bbv_path,
+                                    uint64_t interval_len) {
+  assert(interval_len != 0);
+
+  bbv_file = std::make_unique<std::ofstream>(bbv_path);
+  bbv_cycles_file = std::make_unique<std::ofstream>(bbv_path + ".cycles");
+
+  if (!bbv_file->is_open() || !bbv_cycles_file->is_open()) {
+    std::cerr << "WARNING: Could not open BBV profile output " << bbv_path
+              << ", BBV profiling disabled" << std::endl;
+    bbv_file.reset();
+    bbv_cycles_file.reset();
+    return;
+  }
+
+  bbv_interval_len = interval_len;
+  bbv_interval_insns = 0;
+  bbv_interval_start_mcycle = last_mcycle;
+  // Force the first retired instruction to start a new block
+  bbv_next_seq_pc = 0xffffffff;
+}
+
+void SpikeCosim::bbv_record_insn(uint32_t pc, uint32_t insn_len) {
+  if (pc != bbv_next_seq_pc) {
+    // Control flow didn't fall through from the previous instruction so this
+    // is the entry of a new block. Block IDs are allocated in order of first
+    // execution, starting from 1 as SimPoint expects.
+    auto block_it = bbv_block_ids.find(pc);
+    if (block_it == bbv_block_ids.end()) {
+      block_it = bbv_block_ids.emplace(pc, bbv_block_ids.size() + 1).first;
+    }
+
+    bbv_block_id = block_it->second;
+  }
+
+  bbv_next_seq_pc = pc + insn_len;
+
+  ++bbv_interval_counts[bbv_block_id];
+
+  if (++bbv_interval_insns == bbv_interval_len) {
+    bbv_end_interval();
+  }
+}
+
+void SpikeCosim::bbv_end_interval() {
+  *bbv_file << "T";
+  for (const auto &block_count : bbv_interval_counts) {
+    *bbv_file << ":" << block_count.first << ":" << block_count.second << " ";
+  }
+  *bbv_file << "\n";
+
+  *bbv_cycles_file << bbv_interval_insns << " "
+                   << (last_mcycle - bbv_interval_start_mcycle) << "\n";
+
+  bbv_interval_counts.clear();
+  bbv_interval_insns = 0;
+  bbv_interval_start_mcycle = last_mcycle;
+}
+
+void SpikeCosim::enable_direct_fetch() { direct_fetch = true; }
+
+SpikeCosim::HostMem::HostMem(uint32_t base_addr, size_t size)
+    : base_addr(base_addr),
+      size(size),
+      data(static_cast<uint8_t *>(calloc(size, 1)), free) {
+  if (!data) {
+    throw std::bad_alloc();
+  }
+
+  if ((base_addr & (PGSIZE - 1)) == 0) {
+    page_state.resize(size >> PGSHIFT, kPageUntouched);
+  }
+}
+
+bool SpikeCosim::HostMem::load(reg_t addr, size_t len, uint8_t *bytes) {
+  if (addr > size || len > size - addr) {
+    return false;
+  }
+
+  memcpy(bytes, &data[addr], len);
+  return true;
+}
+
+bool SpikeCosim::HostMem::store(reg_t addr, size_t len, const uint8_t *bytes) {
+  if (addr > size || len > size - addr) {
+    return false;
+  }
+
+  memcpy(&data[addr], bytes, len);
+  return true;
+}
+
+SpikeCosim::HostMem *SpikeCosim::find_mem(uint32_t addr, size_t len) {
+  // Accesses tend to hit the same memory repeatedly so check the last one
+  // first
+  if (last_mem && last_mem->contains(addr, len)) {
+    return last_mem;
+  }
+
+  for (auto &mem : mems) {
+    if (mem->contains(addr, len)) {
+      last_mem = mem.get();
+      return last_mem;
+    }
+  }
+
+  return nullptr;
+}
+
+void SpikeCosim::mark_dside_page(uint32_t addr) {
+  HostMem *mem = find_mem(addr, 1);
+  if (!mem) {
+    return;
+  }
+
+  size_t page = (addr - mem->base_addr) >> PGSHIFT;
+  if (page >= mem->page_state.size()) {
+    return;
+  }
+
+  if (mem->page_state[page] == kPageDirect) {
+    // Spike may hold the host pointer in its TLB, flush it so any further
+    // accesses to the page go back through addr_to_mem.
+    processor->get_mmu()->flush_tlb();
+  }
+
+  mem->page_state[page] = kPageDside;
+}
+
+char *SpikeCosim::addr_to_mem(reg_t addr) {
+  // Unless direct fetch is enabled always return nullptr so all memory accesses
+  // go via mmio_load/mmio_store. A pending iside error must be seen by
+  // mmio_load so also return nullptr then.
+  if (!direct_fetch || pending_iside_error) {
+    return nullptr;
+  }
+
+  // Spike's MMU calls addr_to_mem on every TLB refill, for fetches, loads and
+  // stores alike, and caches the returned pointer in the TLB of that access
+  // type. It doesn't say which type it is refilling so infer it. A fetch
+  // refill is for the PC itself, or for PC + 2 when a 32-bit instruction
+  // crosses into the next page. Only the instruction at the PC can make a load
+  // or store to exactly those addresses, so refuse if it is a load or store.
+  // Host pointers then only ever reach spike's instruction TLB and every dside
+  // access still goes via mmio_load/mmio_store.
+  uint32_t pc = processor->get_state()->pc & 0xffffffff;
+  bool fetch_addr =
+      (addr == pc) || ((addr == pc + 2) && ((addr & (PGSIZE - 1)) == 0));
+  if (!fetch_addr) {
+    return nullptr;
+  }
+
+  uint32_t insn = read_insn(pc);
+  uint32_t rd;
+  if (insn_is_load(insn, rd) || insn_is_store(insn)) {
+    return nullptr;
+  }
+
+  HostMem *mem = find_mem(addr, 1);
+  if (!mem) {
+    return nullptr;
+  }
+
+  // Spike caches the returned pointer for the whole page so only hand it out
+  // when the page is entirely within the memory and the DUT has never accessed
+  // it on the dside.
+  size_t page = (addr - mem->base_addr) >> PGSHIFT;
+  if (page >= mem->page_state.size() || mem->page_state[page] == kPageDside) {
+    return nullptr;
+  }
+
+  mem->page_state[page] = kPageDirect;
+  return reinterpret_cast<char *>(&mem->data[addr - mem->base_addr]);
+}
 
 bool SpikeCosim::mmio_load(reg_t addr, size_t len, uint8_t *bytes) {
   bool bus_error = !bus.load(addr, len, bytes);
@@ -110,6 +308,8 @@ bool SpikeCosim::mmio_load(reg_t addr, size_t len, uint8_t *bytes) {
 
 bool SpikeCosim::mmio_store(reg_t addr, size_t len, const uint8_t *bytes) {
   bool bus_error = !bus.store(addr, len, bytes);
+  invalidate_insn_class(addr, len);
+
   // If the RTL produced a bus error for the access, or the checking failed
   // produce a memory fault in spike.
   bool dut_error = (check_mem_access(true, addr, len, bytes) != kCheckMemOk);
@@ -122,19 +322,42 @@ void SpikeCosim::proc_reset(unsigned id) {}
 const char *SpikeCosim::get_symbol(uint64_t addr) { return nullptr; }
 
 void SpikeCosim::add_memory(uint32_t base_addr, size_t size) {
-  auto new_mem = std::make_unique<mem_t>(size);
+  auto new_mem = std::make_unique<HostMem>(base_addr, size);
   bus.add_device(base_addr, new_mem.get());
   mems.emplace_back(std::move(new_mem));
 }
 
 bool SpikeCosim::backdoor_write_mem(uint32_t addr, size_t len,
                                     const uint8_t *data_in) {
-  return bus.store(addr, len, data_in);
+  invalidate_insn_class(addr, len);
+
+  HostMem *mem = find_mem(addr, len);
+  if (!mem) {
+    return bus.store(addr, len, data_in);
+  }
+
+  memcpy(&mem->data[addr - mem->base_addr], data_in, len);
+
+  if (direct_fetch) {
+    // Spike may have decoded instructions from the old contents cached
+    // against a direct fetch page, flush them.
+    processor->get_mmu()->flush_tlb();
+  }
+
+  return true;
 }
 
 bool SpikeCosim::backdoor_read_mem(uint32_t addr, size_t len,
                                    uint8_t *data_out) {
-  return bus.load(addr, len, data_out);
+  // Read straight from host memory, this is called several times per step to
+  // classify the retired instruction.
+  HostMem *mem = find_mem(addr, len);
+  if (!mem) {
+    return bus.load(addr, len, data_out);
+  }
+
+  memcpy(data_out, &mem->data[addr - mem->base_addr], len);
+  return true;
 }
 
 // When we call processor->step(), spike advances to the next pc IFF a trap does
@@ -181,10 +404,20 @@ bool SpikeCosim::step(uint32_t write_reg, uint32_t write_reg_data, uint32_t pc,
   // any instruction so needs to execute the next instruction to step a single
   // time. To deal with this if it's a debug ebreak we skip the rest of this
   // function checking a few invariants on the debug ebreak first.
-  if (pc_is_debug_ebreak(pc)) {
+  //
+  // The retired instruction is classified once here (via a PC indexed cache
+  // so the instruction isn't re-read and decoded every time it retires) and
+  // reused for every check below.
+  InsnClassEntry insn_class = lookup_insn_class(pc);
+
+  if ((insn_class.insn_class == kInsnClassEbreak) && ebreak_enters_debug()) {
     return check_debug_ebreak(write_reg, pc, sync_trap);
   }
 
+  if ((insn_class.insn_class == kInsnClassSfpAssist) && !sync_trap) {
+    return step_sfp_assist(write_reg, write_reg_data, pc, insn_class.rd);
+  }
+
   uint32_t initial_spike_pc;
   uint32_t suppressed_write_reg;
   uint32_t suppressed_write_reg_data;
@@ -197,7 +430,8 @@ bool SpikeCosim::step(uint32_t write_reg, uint32_t write_reg_data, uint32_t pc,
     // suppressed the register write).
     //
     // First check retired instruciton to ensure load suppression is correct
-    if (!check_suppress_reg_write(write_reg, pc, suppressed_write_reg)) {
+    if (!check_suppress_reg_write(write_reg, pc, insn_class,
+                                  suppressed_write_reg)) {
       return false;
     }
 
@@ -283,7 +517,7 @@ bool SpikeCosim::step(uint32_t write_reg, uint32_t write_reg_data, uint32_t pc,
   // We reached a retired instruction, so check spike and the dut behaved
   // consistently.
 
-  if (!sync_trap && pc_is_mret(pc)) {
+  if (!sync_trap && (insn_class.insn_class == kInsnClassMret)) {
     change_cpuctrlsts_sync_exc_seen(false);
 
     if (nmi_mode) {
@@ -311,11 +545,41 @@ bool SpikeCosim::step(uint32_t write_reg, uint32_t write_reg_data, uint32_t pc,
     return false;
   }
 
+  if (bbv_file) {
+    bbv_record_insn(pc, insn_class.len);
+  }
+
   // Only increment insn_cnt and return true if there are no errors
   insn_cnt++;
   return true;
 }
 
+// Same as the `Cosim` implementation but calls the `SpikeCosim` methods
+// directly rather than through the vtable, 27 indirect calls per instruction.
+size_t SpikeCosim::step_batch(const RetireRecord *records, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    const RetireRecord &r = records[i];
+
+    SpikeCosim::set_nmi(r.nmi);
+    SpikeCosim::set_nmi_int(r.nmi_int);
+    SpikeCosim::set_mip(r.pre_mip, r.post_mip);
+    SpikeCosim::set_debug_req(r.debug_req);
+    SpikeCosim::set_mcycle(r.mcycle);
+    for (uint32_t c = 0; c < r.num_mhpmcounters; ++c) {
+      SpikeCosim::set_csr(CSR_MHPMCOUNTER3 + c, r.mhpmcounters[c]);
+      SpikeCosim::set_csr(CSR_MHPMCOUNTER3H + c, r.mhpmcountersh[c]);
+    }
+    SpikeCosim::set_ic_scr_key_valid(r.ic_scr_key_valid);
+
+    if (!SpikeCosim::step(r.write_reg, r.write_reg_data, r.pc, r.sync_trap,
+                          r.suppress_reg_write)) {
+      return i;
+    }
+  }
+
+  return n;
+}
+
 bool SpikeCosim::check_retired_instr(uint32_t write_reg,
                                      uint32_t write_reg_data, uint32_t dut_pc,
                                      bool suppress_reg_write) {
@@ -417,8 +681,9 @@ bool SpikeCosim::check_sync_trap(uint32_t write_reg, uint32_t dut_pc,
 
   // If we see an internal NMI, that means we receive an extra memory intf item.
   // Deleting that is necessary since next Load/Store would fail otherwise.
-  if (processor->get_state()->mcause->read() == 0xFFFFFFE0) {
-    pending_dside_accesses.erase(pending_dside_accesses.begin());
+  if ((processor->get_state()->mcause->read() == 0xFFFFFFE0) &&
+      (pending_dside_accesses.size() != 0)) {
+    pending_dside_accesses.pop_front();
   }
 
   // Errors may have been generated outside of step() (e.g. in
@@ -470,8 +735,9 @@ bool SpikeCosim::check_gpr_write(const commit_log_reg_t::value_type &reg_change,
   return true;
 }
 
-bool SpikeCosim::check_suppress_reg_write(uint32_t write_reg, uint32_t pc,
-                                          uint32_t &suppressed_write_reg) {
+bool SpikeCosim::check_suppress_reg_write(
+    uint32_t write_reg, uint32_t pc, const InsnClassEntry &insn_class,
+    uint32_t &suppressed_write_reg) {
   if (write_reg != 0) {
     std::stringstream err_str;
     err_str << "Instruction at " << std::hex << pc
@@ -482,7 +748,7 @@ bool SpikeCosim::check_suppress_reg_write(uint32_t write_reg, uint32_t pc,
     return false;
   }
 
-  if (!pc_is_load(pc, suppressed_write_reg)) {
+  if (insn_class.insn_class != kInsnClassLoad) {
     std::stringstream err_str;
     err_str << "Instruction at " << std::hex << pc
             << " indicated a suppressed register write is it not a load"
@@ -492,6 +758,8 @@ bool SpikeCosim::check_suppress_reg_write(uint32_t write_reg, uint32_t pc,
     return false;
   }
 
+  suppressed_write_reg = insn_class.rd;
+
   return true;
 }
 
@@ -560,13 +828,20 @@ void SpikeCosim::set_cpuctrlsts_double_fault_seen() {
 }
 
 void SpikeCosim::initial_proc_setup(uint32_t start_pc, uint32_t start_mtvec,
-                                    uint32_t mhpm_counter_num) {
+                                    uint32_t mhpm_counter_num, bool dcache_en) {
   processor->get_state()->pc = start_pc;
   processor->get_state()->mtvec->write(start_mtvec);
 
   processor->get_state()->csrmap[CSR_MARCHID] =
       std::make_shared<const_csr_t>(processor.get(), CSR_MARCHID, IBEX_MARCHID);
 
+  // The data cache is invisible to the architectural state, the flush CSR
+  // ignores writes and reads as zero. Without the cache it is illegal.
+  if (dcache_en) {
+    processor->get_state()->csrmap[CSR_IBEX_DCACHEFLUSH] =
+        std::make_shared<const_csr_t>(processor.get(), CSR_IBEX_DCACHEFLUSH, 0);
+  }
+
   processor->set_mmu_capability(IMPL_MMU_SBARE);
 
   for (int i = 0; i < processor->TM.count(); ++i) {
@@ -674,7 +949,7 @@ void SpikeCosim::misaligned_pmp_fixup() {
                   << top_pending_access_info.addr << std::endl;
         std::cout << std::dec;
 
-        pending_dside_accesses.erase(pending_dside_accesses.begin());
+        pending_dside_accesses.pop_front();
       }
     }
   }
@@ -720,26 +995,32 @@ void SpikeCosim::set_debug_req(bool debug_req) {
 }
 
 void SpikeCosim::set_mcycle(uint64_t mcycle) {
-  uint32_t upper_mcycle = mcycle >> 32;
-  uint32_t lower_mcycle = mcycle & 0xffffffff;
+  last_mcycle = mcycle;
+
+  set_counter(CSR_MCYCLE, CSR_MCYCLEH, mcycle);
+}
+
+void SpikeCosim::set_counter(int csr_num, int csrh_num, uint64_t val) {
+  uint32_t upper_val = val >> 32;
+  uint32_t lower_val = val & 0xffffffff;
 
-  // Spike decrements the MCYCLE CSR when you write to it to hack around an
-  // issue it has with incorrectly setting minstret/mcycle when there's an
-  // explicit write to them. There's no backdoor write available via the public
-  // interface to skip this. To complicate matters we can only write 32 bits at
-  // a time and get a decrement each time.
+  // Spike decrements the MCYCLE and MINSTRET CSRs when you write to them to
+  // hack around an issue it has with incorrectly setting minstret/mcycle when
+  // there's an explicit write to them. There's no backdoor write available via
+  // the public interface to skip this. To complicate matters we can only write
+  // 32 bits at a time and get a decrement each time.
 
   // Write the lower half first, incremented twice due to the double decrement
-  processor->get_state()->csrmap[CSR_MCYCLE]->write(lower_mcycle + 2);
+  processor->get_state()->csrmap[csr_num]->write(lower_val + 2);
 
-  if ((processor->get_state()->csrmap[CSR_MCYCLE]->read() & 0xffffffff) == 0) {
+  if ((processor->get_state()->csrmap[csr_num]->read() & 0xffffffff) == 0) {
     // If the lower half is 0 at this point then the upper half will get
     // decremented, so increment it first.
-    upper_mcycle++;
+    upper_val++;
   }
 
   // Set the upper half
-  processor->get_state()->csrmap[CSR_MCYCLEH]->write(upper_mcycle);
+  processor->get_state()->csrmap[csrh_num]->write(upper_val);
 
   // TODO: Do a neater job of this, a more recent spike release should allow us
   // to write all 64 bits at once at least.
@@ -763,7 +1044,20 @@ void SpikeCosim::notify_dside_access(const DSideAccessInfo &access_info) {
   // Address must be 32-bit aligned
   assert((access_info.addr & 0x3) == 0);
 
-  pending_dside_accesses.emplace_back(
+  if (direct_fetch) {
+    mark_dside_page(access_info.addr);
+  }
+
+  if (pending_dside_accesses.full()) {
+    std::stringstream err_str;
+    err_str << "Too many DUT dside accesses pending, dropping access to "
+            << "address " << std::hex << access_info.addr;
+    errors.emplace_back(err_str.str());
+
+    return;
+  }
+
+  pending_dside_accesses.push_back(
       PendingMemAccess{.dut_access_info = access_info, .be_spike = 0});
 }
 
@@ -771,6 +1065,12 @@ void SpikeCosim::set_iside_error(uint32_t addr) {
   // Address must be 32-bit aligned
   assert((addr & 0x3) == 0);
 
+  if (direct_fetch) {
+    // Spike must fetch via mmio_load to see the error, remove any direct fetch
+    // pointers it holds.
+    processor->get_mmu()->flush_tlb();
+  }
+
   pending_iside_error = true;
   pending_iside_err_addr = addr;
 }
@@ -842,7 +1142,7 @@ SpikeCosim::check_mem_result_e SpikeCosim::check_mem_access(
   // Expect that no spike memory accesses cross a 32-bit boundary
   assert(((addr + (len - 1)) & 0xfffffffc) == (addr & 0xfffffffc));
 
-  std::string iss_action = store ? "store" : "load";
+  const char *iss_action = store ? "store" : "load";
 
   // Check if there are any pending DUT accesses to check against
   if (pending_dside_accesses.size() == 0) {
@@ -857,7 +1157,7 @@ SpikeCosim::check_mem_result_e SpikeCosim::check_mem_access(
   auto &top_pending_access = pending_dside_accesses.front();
   auto &top_pending_access_info = top_pending_access.dut_access_info;
 
-  std::string dut_action = top_pending_access_info.store ? "store" : "load";
+  const char *dut_action = top_pending_access_info.store ? "store" : "load";
 
   // Check for an address match
   uint32_t aligned_addr = addr & 0xfffffffc;
@@ -1018,7 +1318,7 @@ SpikeCosim::check_mem_result_e SpikeCosim::check_mem_access(
 
       // Remove the top pending access now so both the first and second DUT
       // accesses for this misaligned access are removed.
-      pending_dside_accesses.erase(pending_dside_accesses.begin());
+      pending_dside_accesses.pop_front();
     }
 
     // For any misaligned access that sees an error immediately indicate to
@@ -1028,23 +1328,36 @@ SpikeCosim::check_mem_result_e SpikeCosim::check_mem_access(
   }
 
   if (pending_access_done) {
-    pending_dside_accesses.erase(pending_dside_accesses.begin());
+    pending_dside_accesses.pop_front();
   }
 
   return pending_access_error ? kCheckMemBusError : kCheckMemOk;
 }
 
-bool SpikeCosim::pc_is_mret(uint32_t pc) {
-  uint32_t insn;
+uint32_t SpikeCosim::read_insn(uint32_t pc) {
+  uint32_t insn = 0;
 
-  if (!backdoor_read_mem(pc, 4, reinterpret_cast<uint8_t *>(&insn))) {
-    return false;
+  if (backdoor_read_mem(pc, 4, reinterpret_cast<uint8_t *>(&insn))) {
+    return insn;
   }
 
-  return insn == 0x30200073;
+  // A compressed instruction may sit in the last two bytes of a memory
+  uint16_t insn_16;
+  if (backdoor_read_mem(pc, 2, reinterpret_cast<uint8_t *>(&insn_16))) {
+    return insn_16;
+  }
+
+  return 0;
+}
+
+bool SpikeCosim::insn_is_mret(uint32_t insn) { return insn == 0x30200073; }
+
+bool SpikeCosim::insn_is_ebreak(uint32_t insn) {
+  // 16-bit c.ebreak or 32-bit ebreak
+  return ((insn & 0xffff) == 0x9002) || (insn == 0x00100073);
 }
 
-bool SpikeCosim::pc_is_debug_ebreak(uint32_t pc) {
+bool SpikeCosim::ebreak_enters_debug() {
   uint32_t dcsr = processor->get_csr(CSR_DCSR);
 
   // ebreak debug entry is controlled by the ebreakm (bit 15) and ebreaku (bit
@@ -1055,23 +1368,92 @@ bool SpikeCosim::pc_is_debug_ebreak(uint32_t pc) {
     return false;
   }
 
-  // First check for 16-bit c.ebreak
-  uint16_t insn_16;
-  if (!backdoor_read_mem(pc, 2, reinterpret_cast<uint8_t *>(&insn_16))) {
-    return false;
+  return true;
+}
+
+SpikeCosim::InsnClassEntry SpikeCosim::lookup_insn_class(uint32_t pc) {
+  InsnClassEntry &entry =
+      insn_class_cache[(pc >> 1) & (kInsnClassCacheEntries - 1)];
+
+  if (entry.valid && entry.pc == pc) {
+    ++insn_class_hits;
+    return entry;
   }
 
-  if (insn_16 == 0x9002) {
-    return true;
+  auto miss_start = std::chrono::steady_clock::now();
+
+  uint32_t insn = read_insn(pc);
+  uint32_t rd = 0;
+
+  entry.pc = pc;
+  entry.rd = 0;
+  entry.len = ((insn & 0x3) == 0x3) ? 4 : 2;
+  entry.valid = true;
+
+  if (insn_is_mret(insn)) {
+    entry.insn_class = kInsnClassMret;
+  } else if (insn_is_ebreak(insn)) {
+    entry.insn_class = kInsnClassEbreak;
+  } else if (insn_is_load(insn, rd)) {
+    entry.insn_class = kInsnClassLoad;
+    entry.rd = rd;
+  } else if (insn_is_sfp_assist(insn, rd)) {
+    entry.insn_class = kInsnClassSfpAssist;
+    entry.rd = rd;
+  } else {
+    entry.insn_class = kInsnClassOther;
   }
 
-  // Not a c.ebreak, check for 32 bit ebreak
-  uint32_t insn_32;
-  if (!backdoor_read_mem(pc, 4, reinterpret_cast<uint8_t *>(&insn_32))) {
-    return false;
+  ++insn_class_misses;
+  insn_class_miss_time += std::chrono::steady_clock::now() - miss_start;
+
+  return entry;
+}
+
+void SpikeCosim::invalidate_insn_class(uint32_t addr, size_t len) {
+  // Writes covering the whole cache (e.g. loading a program) just flush it
+  if (len >= kInsnClassCacheEntries * 2) {
+    for (auto &entry : insn_class_cache) {
+      entry.valid = false;
+    }
+    ++insn_class_invalidations;
+    return;
   }
 
-  return insn_32 == 0x00100073;
+  // Any instruction starting up to 2 bytes before the write may overlap it
+  uint32_t start = (addr - 2) & ~1u;
+  uint32_t num_halfwords = (addr + len - start + 1) / 2;
+
+  for (uint32_t i = 0; i < num_halfwords; ++i) {
+    uint32_t pc = start + i * 2;
+    InsnClassEntry &entry =
+        insn_class_cache[(pc >> 1) & (kInsnClassCacheEntries - 1)];
+
+    if (entry.valid && entry.pc == pc) {
+      entry.valid = false;
+      ++insn_class_invalidations;
+    }
+  }
+}
+
+void SpikeCosim::print_insn_class_stats(std::ostream &os) {
+  uint64_t lookups = insn_class_hits + insn_class_misses;
+  double miss_secs =
+      std::chrono::duration<double>(insn_class_miss_time).count();
+
+  os << "Instruction class cache: " << insn_class_hits << " hits, "
+     << insn_class_misses << " misses";
+  if (lookups != 0) {
+    os << " (" << (100.0 * insn_class_hits / lookups) << "% hit rate)";
+  }
+  os << ", " << insn_class_invalidations << " invalidations";
+  if (insn_class_misses != 0) {
+    // Every hit saves a read and decode of the instruction, estimate the time
+    // saved from the average cost of a miss.
+    os << ", ~" << (miss_secs / insn_class_misses * insn_class_hits)
+       << " s saved";
+  }
+  os << "\n";
 }
 
 bool SpikeCosim::check_debug_ebreak(uint32_t write_reg, uint32_t pc,
@@ -1101,12 +1483,8 @@ bool SpikeCosim::check_debug_ebreak(uint32_t write_reg, uint32_t pc,
   return true;
 }
 
-bool SpikeCosim::pc_is_load(uint32_t pc, uint32_t &rd_out) {
-  uint16_t insn_16;
-
-  if (!backdoor_read_mem(pc, 2, reinterpret_cast<uint8_t *>(&insn_16))) {
-    return false;
-  }
+bool SpikeCosim::insn_is_load(uint32_t insn, uint32_t &rd_out) {
+  uint16_t insn_16 = insn & 0xffff;
 
   // C.LW
   if ((insn_16 & 0xE003) == 0x4000) {
@@ -1120,25 +1498,118 @@ bool SpikeCosim::pc_is_load(uint32_t pc, uint32_t &rd_out) {
     return rd_out != 0;
   }
 
-  uint16_t insn_32;
-
-  if (!backdoor_read_mem(pc, 4, reinterpret_cast<uint8_t *>(&insn_32))) {
-    return false;
-  }
-
   // LB/LH/LW/LBU/LHU
-  if ((insn_32 & 0x7F) == 0x3) {
-    uint32_t func = (insn_32 >> 12) & 0x7;
+  if ((insn & 0x7F) == 0x3) {
+    uint32_t func = (insn >> 12) & 0x7;
     if ((func == 0x3) || (func == 0x6) || (func == 0x7)) {
       // Not valid load encodings
       return false;
     }
 
-    rd_out = (insn_32 >> 7) & 0x1F;
+    rd_out = (insn >> 7) & 0x1F;
     return true;
   }
 
   return false;
 }
 
+bool SpikeCosim::insn_is_store(uint32_t insn) {
+  uint16_t insn_16 = insn & 0xffff;
+
+  // C.SW/C.SWSP
+  if (((insn_16 & 0xE003) == 0xC000) || ((insn_16 & 0xE003) == 0xC002)) {
+    return true;
+  }
+
+  // SB/SH/SW
+  if ((insn & 0x7F) == 0x23) {
+    return ((insn >> 12) & 0x7) <= 0x2;
+  }
+
+  return false;
+}
+
+bool SpikeCosim::insn_is_sfp_assist(uint32_t insn, uint32_t &rd_out) {
+  // custom-0 opcode with funct7 0, funct3 0-6 select the operation. sfp.norm,
+  // sfp.umant and sfp.uexp (funct3 1, 5 and 6) have a single source so rs2
+  // must be 0. Other encodings are illegal in Ibex as they are in spike.
+  if (((insn & 0x7F) != 0x0B) || ((insn >> 25) != 0)) {
+    return false;
+  }
+
+  uint32_t func = (insn >> 12) & 0x7;
+  uint32_t rs2 = (insn >> 20) & 0x1F;
+
+  if ((func == 0x7) ||
+      (((func == 0x1) || (func == 0x5) || (func == 0x6)) && (rs2 != 0))) {
+    return false;
+  }
+
+  rd_out = (insn >> 7) & 0x1F;
+  return true;
+}
+
+bool SpikeCosim::step_sfp_assist(uint32_t write_reg, uint32_t write_reg_data,
+                                 uint32_t pc, uint32_t rd) {
+  // Spike doesn't implement the soft-float assist instructions (it would take
+  // an illegal instruction exception), so step over them here using the result
+  // the DUT wrote. The result itself is checked against SoftFP by the
+  // soft-float assist checker in dv/verilator/fpu_check. As spike isn't
+  // stepped, an interrupt or debug request it would have taken in front of the
+  // instruction isn't taken; the DUT retiring the instruction means it didn't
+  // take one either and any mismatch shows up as a PC mismatch on the next
+  // step. Debug single-step over one of these instructions isn't modelled.
+  uint32_t spike_pc = processor->get_state()->pc & 0xffffffff;
+
+  if (spike_pc != pc) {
+    std::stringstream err_str;
+    err_str << "PC mismatch, DUT retired soft-float assist instruction at: "
+            << std::hex << pc << " , but the ISS is at: " << spike_pc;
+    errors.emplace_back(err_str.str());
+    return false;
+  }
+
+  if (pending_iside_error) {
+    std::stringstream err_str;
+    err_str << "DUT generated an iside error for address: " << std::hex
+            << pending_iside_err_addr << " but the ISS didn't produce one";
+    errors.emplace_back(err_str.str());
+    return false;
+  }
+
+  if (write_reg != rd) {
+    std::stringstream err_str;
+    err_str << "Soft-float assist instruction at " << std::hex << pc
+            << " writes x" << std::dec << rd << " but the DUT wrote x"
+            << write_reg;
+    errors.emplace_back(err_str.str());
+    return false;
+  }
+
+  if (rd != 0) {
+    processor->get_state()->XPR.write(rd, write_reg_data);
+  }
+
+  processor->get_state()->pc = pc + 4;
+
+  // Retire the instruction as spike's own step would
+  uint64_t minstret =
+      (processor->get_state()->csrmap[CSR_MINSTRET]->read() & 0xffffffff) |
+      (static_cast<uint64_t>(
+           processor->get_state()->csrmap[CSR_MINSTRETH]->read() & 0xffffffff)
+       << 32);
+  set_counter(CSR_MINSTRET, CSR_MINSTRETH, minstret + 1);
+
+  if (errors.size() != 0) {
+    return false;
+  }
+
+  if (bbv_file) {
+    bbv_record_insn(pc, 4);
+  }
+
+  insn_cnt++;
+  return true;
+}
+
 unsigned int SpikeCosim::get_insn_cnt() { return insn_cnt; }
@@ -7,9 +7,15 @@
 
 #include <stdint.h>
 
+#include <cassert>
+#include <chrono>
 #include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cosim.h"
@@ -19,6 +25,9 @@
 #include "riscv/simif.h"
 
 #define IBEX_MARCHID 22
+// Ibex custom CSR that flushes the data cache, not known to Spike. It only
+// exists when the core has a data cache.
+#define CSR_IBEX_DCACHEFLUSH 0x7c2
 
 class SpikeCosim : public simif_t, public Cosim {
  private:
@@ -36,7 +45,45 @@ class SpikeCosim : public simif_t, public Cosim {
   std::unique_ptr<processor_t> processor;
   std::unique_ptr<log_file_t> log;
   bus_t bus;
-  std::vector<std::unique_ptr<mem_t>> mems;
+
+  // Memory added with `add_memory`. Unlike spike's own mem_t the storage is a
+  // single contiguous allocation, so pointers into it can be handed to spike
+  // for direct instruction fetch (see `enable_direct_fetch`).
+  class HostMem : public abstract_device_t {
+   public:
+    HostMem(uint32_t base_addr, size_t size);
+
+    // abstract_device_t implementation, `addr` is an offset from `base_addr`
+    bool load(reg_t addr, size_t len, uint8_t *bytes) override;
+    bool store(reg_t addr, size_t len, const uint8_t *bytes) override;
+
+    bool contains(uint32_t addr, size_t len) const {
+      return (addr >= base_addr) && (addr - base_addr <= size) &&
+             (len <= size - (addr - base_addr));
+    }
+
+    uint32_t base_addr;
+    size_t size;
+    // Allocated with calloc so the OS only backs pages that are written, the
+    // UVM testbench adds 4 GiB of memory of which a program touches little.
+    std::unique_ptr<uint8_t[], void (*)(void *)> data;
+    // Direct fetch state of each whole page, see `page_state_e`. Empty if the
+    // memory isn't page aligned.
+    std::vector<uint8_t> page_state;
+  };
+
+  typedef enum {
+    kPageUntouched,  // No host pointer handed out, no dside access seen
+    kPageDirect,     // Host pointer handed to spike for instruction fetch
+    kPageDside       // DUT has made a dside access, always use mmio
+  } page_state_e;
+
+  std::vector<std::unique_ptr<HostMem>> mems;
+  HostMem *last_mem;
+  bool direct_fetch;
+
+  HostMem *find_mem(uint32_t addr, size_t len);
+  void mark_dside_page(uint32_t addr);
   std::vector<std::string> errors;
   bool nmi_mode;
 
@@ -56,7 +103,45 @@ class SpikeCosim : public simif_t, public Cosim {
     uint32_t be_spike;
   };
 
-  std::vector<PendingMemAccess> pending_dside_accesses;
+  // FIFO of DUT dside accesses still to be matched against spike accesses.
+  // Only a handful can be outstanding ahead of the instruction that made them
+  // retiring, so a fixed size ring buffer is used to avoid any allocation as
+  // accesses are notified and consumed.
+  class PendingAccessQueue {
+   public:
+    static const size_t kCapacity = 16;
+
+    PendingAccessQueue() : head(0), count(0) {}
+
+    size_t size() const { return count; }
+    bool full() const { return count == kCapacity; }
+
+    PendingMemAccess &operator[](size_t i) {
+      assert(i < count);
+      return entries[(head + i) & (kCapacity - 1)];
+    }
+
+    PendingMemAccess &front() { return (*this)[0]; }
+
+    void push_back(const PendingMemAccess &access) {
+      assert(!full());
+      entries[(head + count) & (kCapacity - 1)] = access;
+      ++count;
+    }
+
+    void pop_front() {
+      assert(count != 0);
+      head = (head + 1) & (kCapacity - 1);
+      --count;
+    }
+
+   private:
+    PendingMemAccess entries[kCapacity];
+    size_t head;
+    size_t count;
+  };
+
+  PendingAccessQueue pending_dside_accesses;
 
   bool pending_iside_error;
   uint32_t pending_iside_err_addr;
@@ -70,16 +155,64 @@ class SpikeCosim : public simif_t, public Cosim {
   check_mem_result_e check_mem_access(bool store, uint32_t addr, size_t len,
                                       const uint8_t *bytes);
 
-  bool pc_is_mret(uint32_t pc);
-  bool pc_is_load(uint32_t pc, uint32_t &rd_out);
+  // Read the instruction at `pc`, returning 0 if it can't be read.
+  uint32_t read_insn(uint32_t pc);
+
+  bool insn_is_mret(uint32_t insn);
+  bool insn_is_ebreak(uint32_t insn);
+  bool insn_is_load(uint32_t insn, uint32_t &rd_out);
+  bool insn_is_store(uint32_t insn);
+  // Ibex soft-float assist (custom-0 sfp.*) instructions, which spike doesn't
+  // implement, see `step_sfp_assist`
+  bool insn_is_sfp_assist(uint32_t insn, uint32_t &rd_out);
+
+  // Whether an ebreak executed now would enter debug mode (from DCSR)
+  bool ebreak_enters_debug();
+
+  // Classes of instruction `step` needs to treat specially
+  typedef enum : uint8_t {
+    kInsnClassOther,
+    kInsnClassMret,
+    kInsnClassEbreak,
+    kInsnClassLoad,
+    kInsnClassSfpAssist
+  } insn_class_e;
+
+  struct InsnClassEntry {
+    uint32_t pc;
+    uint8_t insn_class;
+    // Destination register, for kInsnClassLoad and kInsnClassSfpAssist
+    uint8_t rd;
+    // Instruction length in bytes (2 or 4)
+    uint8_t len;
+    bool valid;
+  };
+
+  // Direct mapped cache of instruction classes indexed by PC, so a retired
+  // instruction is only read and decoded the first time it is seen. Entries
+  // are invalidated by backdoor writes and spike stores that overlap them.
+  static const size_t kInsnClassCacheEntries = 4096;
+  std::vector<InsnClassEntry> insn_class_cache;
+  uint64_t insn_class_hits;
+  uint64_t insn_class_misses;
+  uint64_t insn_class_invalidations;
+  std::chrono::steady_clock::duration insn_class_miss_time;
 
-  bool pc_is_debug_ebreak(uint32_t pc);
+  InsnClassEntry lookup_insn_class(uint32_t pc);
+  void invalidate_insn_class(uint32_t addr, size_t len);
   bool check_debug_ebreak(uint32_t write_reg, uint32_t pc, bool sync_trap);
+  bool step_sfp_assist(uint32_t write_reg, uint32_t write_reg_data,
+                       uint32_t pc, uint32_t rd);
+
+  // Write a 64-bit counter through its low and high CSRs, compensating for the
+  // decrement spike applies to explicit counter writes
+  void set_counter(int csr_num, int csrh_num, uint64_t val);
 
   bool check_gpr_write(const commit_log_reg_t::value_type &reg_change,
                        uint32_t write_reg, uint32_t write_reg_data);
 
   bool check_suppress_reg_write(uint32_t write_reg, uint32_t pc,
+                                const InsnClassEntry &insn_class,
                                 uint32_t &suppressed_write_reg);
 
   void on_csr_write(const commit_log_reg_t::value_type &reg_change);
@@ -91,7 +224,7 @@ class SpikeCosim : public simif_t, public Cosim {
   void handle_cpuctrl_exception_entry();
 
   void initial_proc_setup(uint32_t start_pc, uint32_t start_mtvec,
-                          uint32_t mhpm_counter_num);
+                          uint32_t mhpm_counter_num, bool dcache_en);
 
   void early_interrupt_handle();
 
@@ -99,11 +232,59 @@ class SpikeCosim : public simif_t, public Cosim {
 
   unsigned int insn_cnt;
 
+  // Most recent value supplied to `set_mcycle`, used to attribute cycles to
+  // basic-block vector intervals.
+  uint64_t last_mcycle;
+
+  // Basic-block vector (BBV) profiling state, see `enable_bbv_profile`. A new
+  // block is started whenever a retired instruction doesn't sequentially
+  // follow the previous one, so blocks are identified by their entry PC.
+  std::unique_ptr<std::ofstream> bbv_file;
+  std::unique_ptr<std::ofstream> bbv_cycles_file;
+  uint64_t bbv_interval_len;
+  uint64_t bbv_interval_insns;
+  uint64_t bbv_interval_start_mcycle;
+  uint32_t bbv_block_id;
+  uint32_t bbv_next_seq_pc;
+  std::unordered_map<uint32_t, uint32_t> bbv_block_ids;
+  std::map<uint32_t, uint64_t> bbv_interval_counts;
+
+  void bbv_record_insn(uint32_t pc, uint32_t insn_len);
+  void bbv_end_interval();
+
  public:
   SpikeCosim(const std::string &isa_string, uint32_t start_pc,
              uint32_t start_mtvec, const std::string &trace_log_path,
-             bool secure_ibex, bool icache_en, uint32_t pmp_num_regions,
-             uint32_t pmp_granularity, uint32_t mhpm_counter_num);
+             bool secure_ibex, bool icache_en, bool dcache_en,
+             uint32_t pmp_num_regions, uint32_t pmp_granularity,
+             uint32_t mhpm_counter_num);
+
+  ~SpikeCosim();
+
+  // Enable basic-block vector profiling of retired instructions.
+  //
+  // Every `interval_len` successfully checked instructions a line is written to
+  // `bbv_path` in the SimPoint `.bb` format (`T:<block id>:<insn count> ...`).
+  // A matching line with the instruction and cycle (mcycle) count of each
+  // interval is written to `<bbv_path>.cycles` so the CPI of each interval is
+  // known. `dv/verilator/simple_system_cosim/util/simpoint.py` consumes both
+  // files.
+  void enable_bbv_profile(const std::string &bbv_path, uint64_t interval_len);
+
+  // Allow spike to fetch instructions directly from host memory.
+  //
+  // By default `addr_to_mem` returns nullptr so every spike memory access,
+  // including instruction fetch, goes through `mmio_load`/`mmio_store`. With
+  // direct fetch enabled a host pointer is returned for instruction fetch TLB
+  // refills from pages the DUT has never made a dside access to, never for a
+  // load or store refill. Spike then fetches from those pages via its TLB and
+  // instruction cache. Once the DUT accesses a page on the dside the pointer is
+  // revoked (by flushing spike's TLB). Every data access is still checked by
+  // `check_mem_access`.
+  void enable_direct_fetch();
+
+  // Print hit rate and estimated time saved by the instruction class cache
+  void print_insn_class_stats(std::ostream &os);
 
   // simif_t implementation
   virtual char *addr_to_mem(reg_t addr) override;
@@ -120,6 +301,7 @@ class SpikeCosim : public simif_t, public Cosim {
   bool backdoor_read_mem(uint32_t addr, size_t len, uint8_t *data_out) override;
   bool step(uint32_t write_reg, uint32_t write_reg_data, uint32_t pc,
             bool sync_trap, bool suppress_reg_write) override;
+  size_t step_batch(const RetireRecord *records, size_t n) override;
 
   bool check_retired_instr(uint32_t write_reg, uint32_t write_reg_data,
                            uint32_t dut_pc, bool suppress_reg_write);
@@ -0,0 +1,70 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Entries are constructed up front and reused; the producer fills an
+// entry in place between `claim` and `publish` and the consumer reads it in
+// place between `front` and `pop`, so nothing is allocated or copied per
+// entry.
+template <typename T>
+class SpscQueue {
+ public:
+  // `capacity` must be a power of two
+  explicit SpscQueue(size_t capacity)
+      : entries(capacity), mask(capacity - 1), head(0), tail(0) {
+    assert(capacity != 0 && (capacity & (capacity - 1)) == 0);
+  }
+
+  // Producer: return the next free entry, or nullptr if the queue is full
+  T *claim() {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == entries.size()) {
+      return nullptr;
+    }
+
+    return &entries[h & mask];
+  }
+
+  // Producer: make the entry returned by the last `claim` visible to the
+  // consumer
+  void publish() {
+    head.store(head.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+  // Consumer: return the oldest entry, or nullptr if the queue is empty
+  T *front() {
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+
+    return &entries[t & mask];
+  }
+
+  // Consumer: release the entry returned by `front` back to the producer
+  void pop() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1,
+               std::memory_order_release);
+  }
+
+ private:
+  std::vector<T> entries;
+  size_t mask;
+
+  // Producer and consumer indices live on separate cache lines so the two
+  // threads don't contend on every access.
+  alignas(64) std::atomic<size_t> head;
+  alignas(64) std::atomic<size_t> tail;
+};
+
+#endif  // SPSC_QUEUE_H_
@@ -18,7 +18,8 @@ RegisterEnvironment *reg_env;
 
 void env_initial(svBitVecVal *seed, svBit PMPEnable,
                  svBitVecVal *PMPGranularity, svBitVecVal *PMPNumRegions,
-                 svBitVecVal *MHPMCounterNum, svBitVecVal *MHPMCounterWidth) {
+                 svBitVecVal *MHPMCounterNum, svBitVecVal *MHPMCounterWidth,
+                 svBitVecVal *NumTransactions, svBit Throughput) {
   // Package up parameters
   CSRParams params;
   params.PMPEnable = PMPEnable;
@@ -26,8 +27,11 @@ void env_initial(svBitVecVal *seed, svBit PMPEnable,
   params.PMPNumRegions = *PMPNumRegions;
   params.MHPMCounterNum = *MHPMCounterNum;
   params.MHPMCounterWidth = *MHPMCounterWidth;
+  TBParams tb_params;
+  tb_params.NumTransactions = *NumTransactions;
+  tb_params.Throughput = Throughput;
   // Create TB environment
-  reg_env = new RegisterEnvironment(params);
+  reg_env = new RegisterEnvironment(params, tb_params);
 
   // Initial setup
   reg_env->OnInitial(*seed);
@@ -10,7 +10,9 @@ package env_dpi;
                             input bit [31:0] PMPGranularity,
                             input bit [31:0] PMPNumRegions,
                             input bit [31:0] MHPMCounterNum,
-                            input bit [31:0] MHPMCounterWidth);
+                            input bit [31:0] MHPMCounterWidth,
+                            input bit [31:0] NumTransactions,
+                            input bit        Throughput);
 
   import "DPI-C"
   function void env_final();
@@ -4,11 +4,12 @@
 
 #include "register_environment.h"
 
-RegisterEnvironment::RegisterEnvironment(CSRParams params)
+RegisterEnvironment::RegisterEnvironment(CSRParams params, TBParams tb_params)
     : params_(params),
       simctrl_(new SimCtrl()),
       reg_model_(new RegisterModel(simctrl_, &params_)),
-      reg_driver_(new RegisterDriver("reg_driver", reg_model_, simctrl_)),
+      reg_driver_(new RegisterDriver("reg_driver", reg_model_, simctrl_,
+                                     tb_params)),
       rst_driver_(new ResetDriver("rstn_driver")) {}
 
 void RegisterEnvironment::OnInitial(unsigned int seed) {
@@ -16,7 +16,7 @@
  */
 class RegisterEnvironment {
  public:
-  RegisterEnvironment(CSRParams params);
+  RegisterEnvironment(CSRParams params, TBParams tb_params);
 
   void OnInitial(unsigned int seed);
   void OnFinal();
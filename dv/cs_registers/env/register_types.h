@@ -13,4 +13,13 @@ struct CSRParams {
   unsigned int MHPMCounterWidth;
 };
 
+// Testbench run-time options, set with plusargs (see tb_cs_registers.sv)
+struct TBParams {
+  // Number of random transactions to drive before the test ends
+  unsigned int NumTransactions;
+  // Drive a transaction every cycle rather than after a random delay and
+  // report the achieved rate, to get through many more transactions per run
+  bool Throughput;
+};
+
 #endif  // REGISTER_TYPES_H_
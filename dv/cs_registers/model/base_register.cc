@@ -9,7 +9,10 @@
 
 BaseRegister::BaseRegister(
     uint32_t addr, std::vector<std::unique_ptr<BaseRegister>> *map_pointer)
-    : register_value_(0), register_address_(addr), map_pointer_(map_pointer) {}
+    : register_value_(0),
+      register_address_(addr),
+      map_pointer_(map_pointer),
+      table_pointer_(nullptr) {}
 
 uint32_t BaseRegister::RegisterWrite(uint32_t newval) {
   uint32_t lock_mask = GetLockMask();
@@ -83,7 +86,16 @@ uint32_t BaseRegister::RegisterRead() { return register_value_; }
 
 uint32_t BaseRegister::GetLockMask() { return 0; }
 
+void BaseRegister::SetRegisterTable(
+    const std::vector<BaseRegister *> *table_pointer) {
+  table_pointer_ = table_pointer;
+}
+
 BaseRegister *BaseRegister::GetRegisterFromMap(uint32_t addr) {
+  if (table_pointer_) {
+    return addr < table_pointer_->size() ? (*table_pointer_)[addr] : nullptr;
+  }
+
   for (auto &reg : *map_pointer_) {
     if (reg->MatchAddr(addr)) {
       return reg.get();
@@ -98,12 +110,11 @@ MSeccfgRegister::MSeccfgRegister(
     : BaseRegister(addr, map_pointer) {}
 
 bool MSeccfgRegister::AnyPmpCfgsLocked() {
-  for (auto &reg : *map_pointer_) {
-    // Iterate through PMPCfgX CSRs, returning true is any has a lock bit set
-    if (reg->MatchAddr(kCSRPMPCfg0, 0xfffffffc)) {
-      if ((reg->RegisterRead() & 0x80808080) != 0) {
-        return true;
-      }
+  // Iterate through PMPCfgX CSRs, returning true is any has a lock bit set
+  for (uint32_t addr = kCSRPMPCfg0; addr <= kCSRPMPCfg3; ++addr) {
+    BaseRegister *reg = GetRegisterFromMap(addr);
+    if (reg && ((reg->RegisterRead() & 0x80808080) != 0)) {
+      return true;
     }
   }
 
@@ -214,13 +225,13 @@ uint32_t PmpAddrRegister::GetLockMask() {
   uint32_t cfg_value = 0;
   uint32_t cfg_plus1_value = 0;
   // Find and read the two CFG registers
-  for (auto it = map_pointer_->begin(); it != map_pointer_->end(); ++it) {
-    if ((*it)->MatchAddr(pmp_cfg_addr)) {
-      cfg_value = (*it)->RegisterRead();
-    }
-    if ((*it)->MatchAddr(pmp_cfg_plus1_addr)) {
-      cfg_plus1_value = (*it)->RegisterRead();
-    }
+  BaseRegister *cfg_reg = GetRegisterFromMap(pmp_cfg_addr);
+  if (cfg_reg) {
+    cfg_value = cfg_reg->RegisterRead();
+  }
+  BaseRegister *cfg_plus1_reg = GetRegisterFromMap(pmp_cfg_plus1_addr);
+  if (cfg_plus1_reg) {
+    cfg_plus1_value = cfg_plus1_reg->RegisterRead();
   }
   // Shift to the relevant bits in the CFG registers
   cfg_value >>= ((pmp_region & 0x3) * 8);
@@ -28,11 +28,16 @@ class BaseRegister {
   virtual bool ProcessTransaction(bool *match, RegisterTransaction *trans);
   virtual bool MatchAddr(uint32_t addr, uint32_t addr_mask = 0xFFFFFFFF);
   virtual uint32_t GetLockMask();
+  uint32_t GetAddr() { return register_address_; }
+  // Use an address indexed table (see `RegisterModel`) to find other
+  // registers rather than searching the register map
+  void SetRegisterTable(const std::vector<BaseRegister *> *table_pointer);
 
  protected:
   uint32_t register_value_;
   uint32_t register_address_;
   std::vector<std::unique_ptr<BaseRegister>> *map_pointer_;
+  const std::vector<BaseRegister *> *table_pointer_;
   BaseRegister *GetRegisterFromMap(uint32_t addr);
 };
 
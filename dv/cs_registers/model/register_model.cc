@@ -4,6 +4,7 @@
 
 #include "register_model.h"
 
+#include <cassert>
 #include <iostream>
 
 RegisterModel::RegisterModel(SimCtrl *sc, CSRParams *params) : simctrl_(sc) {
@@ -95,6 +96,22 @@ RegisterModel::RegisterModel(SimCtrl *sc, CSRParams *params) : simctrl_(sc) {
           std::make_unique<NonImpRegister>(reg_addr, &register_map_));
     }
   }
+
+  BuildRegisterTable();
+}
+
+void RegisterModel::BuildRegisterTable() {
+  register_table_.assign(kNumCSRAddrs, nullptr);
+
+  for (auto &reg : register_map_) {
+    uint32_t addr = reg->GetAddr();
+    assert(addr < kNumCSRAddrs);
+    // The first register at an address takes any transactions for it
+    if (!register_table_[addr]) {
+      register_table_[addr] = reg.get();
+    }
+    reg->SetRegisterTable(&register_table_);
+  }
 }
 
 void RegisterModel::RegisterReset() {
@@ -106,10 +123,11 @@ void RegisterModel::RegisterReset() {
 void RegisterModel::NewTransaction(std::unique_ptr<RegisterTransaction> trans) {
   // TODO add machine mode permissions to registers
   bool matched = false;
-  for (auto it = register_map_.begin(); it != register_map_.end(); ++it) {
-    if ((*it)->ProcessTransaction(&matched, trans.get())) {
-      simctrl_->RequestStop(false);
-    }
+  BaseRegister *reg = trans->csr_addr < kNumCSRAddrs
+                          ? register_table_[trans->csr_addr]
+                          : nullptr;
+  if (reg && reg->ProcessTransaction(&matched, trans.get())) {
+    simctrl_->RequestStop(false);
   }
   if (!matched) {
     // Non existant register
@@ -25,8 +25,16 @@ class RegisterModel {
   void RegisterReset();
 
  private:
+  // Number of addresses in the 12-bit CSR address space
+  static const unsigned int kNumCSRAddrs = 4096;
+
   std::vector<std::unique_ptr<BaseRegister>> register_map_;
+  // Register modelled at each CSR address, nullptr where there is none, so a
+  // transaction is dispatched without searching `register_map_`
+  std::vector<BaseRegister *> register_table_;
   SimCtrl *simctrl_;
+
+  void BuildRegisterTable();
 };
 
 #endif  // REGISTER_MODEL_H_
@@ -10,22 +10,33 @@ extern "C" void reg_register_intf(std::string name, RegisterDriver *intf);
 extern "C" void reg_deregister_intf(std::string name);
 
 RegisterDriver::RegisterDriver(std::string name, RegisterModel *model,
-                               SimCtrl *sc)
-    : name_(name), reg_model_(model), simctrl_(sc) {}
+                               SimCtrl *sc, TBParams tb_params)
+    : tb_params_(tb_params), name_(name), reg_model_(model), simctrl_(sc) {}
 
 void RegisterDriver::OnInitial(unsigned int seed) {
   transactions_driven_ = 0;
   delay_ = 1;
   reg_access_ = false;
   generator_.seed(seed);
-  delay_dist_ = std::uniform_int_distribution<int>(1, 20);
+  // In throughput mode a new transaction is driven every cycle
+  delay_dist_ = std::uniform_int_distribution<int>(
+      1, tb_params_.Throughput ? 1 : 20);
   reg_register_intf(name_, this);
+  start_time_ = std::chrono::steady_clock::now();
 }
 
 void RegisterDriver::OnFinal() {
   reg_deregister_intf(name_);
   std::cout << "[Reg driver] drove: " << transactions_driven_
             << " register transactions" << std::endl;
+  if (tb_params_.Throughput && transactions_driven_ > 0) {
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start_time_;
+    std::cout << "[Reg driver] " << elapsed.count() << " s, "
+              << static_cast<uint64_t>(transactions_driven_ /
+                                       elapsed.count())
+              << " transactions/s" << std::endl;
+  }
 }
 
 void RegisterDriver::Randomize() {
@@ -66,7 +77,7 @@ void RegisterDriver::DriveOutputs(unsigned char *access, uint32_t *op,
 }
 
 void RegisterDriver::OnClock() {
-  if (transactions_driven_ >= 10000) {
+  if (transactions_driven_ >= tb_params_.NumTransactions) {
     simctrl_->RequestStop(true);
   }
   if (--delay_ == 0) {
@@ -7,8 +7,10 @@
 
 #include "register_model.h"
 #include "register_transaction.h"
+#include "register_types.h"
 #include "simctrl.h"
 
+#include <chrono>
 #include <random>
 #include <string>
 
@@ -17,7 +19,8 @@
  */
 class RegisterDriver {
  public:
-  RegisterDriver(std::string name, RegisterModel *model, SimCtrl *sc);
+  RegisterDriver(std::string name, RegisterModel *model, SimCtrl *sc,
+                 TBParams tb_params);
 
   void OnInitial(unsigned int seed);
   void OnClock();
@@ -39,8 +42,10 @@ class RegisterDriver {
   std::uniform_int_distribution<int> delay_dist_;
   uint32_t reg_addr_;
   uint32_t reg_wdata_;
-  int transactions_driven_;
+  unsigned int transactions_driven_;
   RegisterTransaction next_transaction_;
+  TBParams tb_params_;
+  std::chrono::steady_clock::time_point start_time_;
 
   std::string name_;
   RegisterModel *reg_model_;
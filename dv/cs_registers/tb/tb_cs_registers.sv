@@ -90,14 +90,21 @@ module tb_cs_registers #(
   bit stop_simulation;
   bit test_passed;
   bit [31:0] seed;
+  bit [31:0] num_transactions;
+  bit throughput;
 
   initial begin
     if (!$value$plusargs ("ntb_random_seed=%d", seed)) begin
       seed = 32'd0;
     end
+    if (!$value$plusargs ("num_transactions=%d", num_transactions)) begin
+      num_transactions = 32'd10000;
+    end
+    throughput = $test$plusargs ("throughput");
     env_dpi::env_initial(seed,
         PMPEnable, PMPGranularity, PMPNumRegions,
-        MHPMCounterNum, MHPMCounterWidth);
+        MHPMCounterNum, MHPMCounterWidth,
+        num_transactions, throughput);
   end
 
   final begin
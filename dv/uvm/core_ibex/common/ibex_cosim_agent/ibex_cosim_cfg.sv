@@ -14,6 +14,7 @@ class core_ibex_cosim_cfg extends uvm_object;
   bit        relax_cosim_check;
   bit        secure_ibex;
   bit        icache;
+  bit        dcache;
 
   `uvm_object_utils_begin(core_ibex_cosim_cfg)
     `uvm_field_string(isa_string, UVM_DEFAULT)
@@ -26,6 +27,7 @@ class core_ibex_cosim_cfg extends uvm_object;
     `uvm_field_int(mhpm_counter_num, UVM_DEFAULT)
     `uvm_field_int(secure_ibex, UVM_DEFAULT)
     `uvm_field_int(icache, UVM_DEFAULT)
+    `uvm_field_int(dcache, UVM_DEFAULT)
   `uvm_object_utils_end
 
   `uvm_object_new
@@ -72,7 +72,8 @@ class ibex_cosim_scoreboard extends uvm_scoreboard;
 
     // TODO: Ensure log file on reset gets append rather than overwrite?
     cosim_handle = spike_cosim_init(cfg.isa_string, cfg.start_pc, cfg.start_mtvec, cfg.log_file,
-      cfg.pmp_num_regions, cfg.pmp_granularity, cfg.mhpm_counter_num, cfg.secure_ibex, cfg.icache);
+      cfg.pmp_num_regions, cfg.pmp_granularity, cfg.mhpm_counter_num, cfg.secure_ibex, cfg.icache,
+      cfg.dcache);
 
     if (cosim_handle == null) begin
       `uvm_fatal(`gfn, "Could not initialise cosim")
@@ -148,8 +149,9 @@ class ibex_cosim_scoreboard extends uvm_scoreboard;
       riscv_cosim_set_mip(cosim_handle, rvfi_instr.pre_mip, rvfi_instr.post_mip);
       riscv_cosim_set_mcycle(cosim_handle, rvfi_instr.mcycle);
 
-      // Set performance counters through a pseudo-backdoor write
-      for (int i=0; i < 10; i++) begin
+      // Set performance counters through a pseudo-backdoor write. Counters beyond
+      // mhpm_counter_num read as zero in both the DUT and spike.
+      for (int i=0; i < cfg.mhpm_counter_num; i++) begin
         riscv_cosim_set_csr(cosim_handle,
                             ibex_pkg::CSR_MHPMCOUNTER3 + i, rvfi_instr.mhpmcounters[i]);
         riscv_cosim_set_csr(cosim_handle,
@@ -46,7 +46,7 @@ class ibex_rvfi_monitor extends uvm_monitor;
       trans_collected.mcycle           = vif.monitor_cb.ext_mcycle;
       trans_collected.ic_scr_key_valid = vif.monitor_cb.ext_ic_scr_key_valid;
 
-      for (int i=0; i < 10; i++) begin
+      for (int i=0; i < 29; i++) begin
        trans_collected.mhpmcounters[i]  = vif.monitor_cb.ext_mhpmcounters[i];
        trans_collected.mhpmcountersh[i] = vif.monitor_cb.ext_mhpmcountersh[i];
       end
@@ -17,8 +17,8 @@ class ibex_rvfi_seq_item extends uvm_sequence_item;
   bit        rf_wr_suppress;
   bit [63:0] mcycle;
 
-  bit [31:0] mhpmcounters  [10];
-  bit [31:0] mhpmcountersh [10];
+  bit [31:0] mhpmcounters  [29];
+  bit [31:0] mhpmcountersh [29];
   bit        ic_scr_key_valid;
 
   `uvm_object_utils_begin(ibex_rvfi_seq_item)
@@ -7,6 +7,8 @@
 #include <cassert>
 
 #include "cosim.h"
+#include "cosim_dpi.h"
+#include "cosim_log.h"
 #include "spike_cosim.h"
 
 extern "C" {
@@ -15,7 +17,7 @@ void *spike_cosim_init(const char *isa_string, svBitVecVal *start_pc,
                        svBitVecVal *pmp_num_regions,
                        svBitVecVal *pmp_granularity,
                        svBitVecVal *mhpm_counter_num, svBit secure_ibex,
-                       svBit icache) {
+                       svBit icache, svBit dcache) {
   assert(isa_string);
 
   std::string log_file_path;
@@ -26,15 +28,31 @@ void *spike_cosim_init(const char *isa_string, svBitVecVal *start_pc,
 
   SpikeCosim *cosim = new SpikeCosim(
       isa_string, start_pc[0], start_mtvec[0], log_file_path, secure_ibex,
-      icache, pmp_num_regions[0], pmp_granularity[0], mhpm_counter_num[0]);
-  cosim->add_memory(0x80000000, 0x80000000);
-  cosim->add_memory(0x00000000, 0x80000000);
+      icache, dcache, pmp_num_regions[0], pmp_granularity[0],
+      mhpm_counter_num[0]);
+
+  // Record the run for dv/cosim/replay if IBEX_COSIM_RECORD is set
+  CosimLogConfig config = {.isa_string = isa_string,
+                           .start_pc = start_pc[0],
+                           .start_mtvec = start_mtvec[0],
+                           .secure_ibex = secure_ibex != 0,
+                           .icache_en = icache != 0,
+                           .dcache_en = dcache != 0,
+                           .pmp_num_regions = pmp_num_regions[0],
+                           .pmp_granularity = pmp_granularity[0],
+                           .mhpm_counter_num = mhpm_counter_num[0]};
+  cosim_dpi_start_recording("", config);
+
+  cosim_dpi_add_memory(cosim, 0x80000000, 0x80000000);
+  cosim_dpi_add_memory(cosim, 0x00000000, 0x80000000);
   return static_cast<Cosim *>(cosim);
 }
 
 void spike_cosim_release(void *cosim_handle) {
   auto cosim = static_cast<Cosim *>(cosim_handle);
 
+  cosim_dpi_stop_recording();
+
   delete cosim;
 }
 }
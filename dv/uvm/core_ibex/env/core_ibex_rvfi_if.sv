@@ -35,8 +35,8 @@ interface core_ibex_rvfi_if(input logic clk);
   logic [63:0] ext_mcycle;
   logic        ext_irq_valid;
 
-  logic [31:0] ext_mhpmcounters [10];
-  logic [31:0] ext_mhpmcountersh [10];
+  logic [31:0] ext_mhpmcounters [29];
+  logic [31:0] ext_mhpmcountersh [29];
 
   logic        ext_ic_scr_key_valid;
 
@@ -84,9 +84,11 @@ ${PRJ_DIR}/rtl/ibex_controller.sv
 ${PRJ_DIR}/rtl/ibex_csr.sv
 ${PRJ_DIR}/rtl/ibex_cs_registers.sv
 ${PRJ_DIR}/rtl/ibex_counter.sv
+${PRJ_DIR}/rtl/ibex_dcache.sv
 ${PRJ_DIR}/rtl/ibex_decoder.sv
 ${PRJ_DIR}/rtl/ibex_dummy_instr.sv
 ${PRJ_DIR}/rtl/ibex_ex_block.sv
+${PRJ_DIR}/rtl/ibex_fpu.sv
 ${PRJ_DIR}/rtl/ibex_wb_stage.sv
 ${PRJ_DIR}/rtl/ibex_id_stage.sv
 ${PRJ_DIR}/rtl/ibex_icache.sv
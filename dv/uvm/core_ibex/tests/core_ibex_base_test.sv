@@ -90,6 +90,7 @@ class core_ibex_base_test extends uvm_test;
     bit [31:0] mhpm_counter_num;
     bit        secure_ibex;
     bit        icache;
+    bit        dcache;
     bit        disable_spurious_dside_responses;
 
     super.build_phase(phase);
@@ -141,12 +142,17 @@ class core_ibex_base_test extends uvm_test;
       icache = '0;
     end
 
+    if (!uvm_config_db#(bit)::get(null, "", "DCache", dcache)) begin
+      dcache = '0;
+    end
+
     cosim_cfg.pmp_num_regions = pmp_num_regions;
     cosim_cfg.pmp_granularity = pmp_granularity;
     cosim_cfg.mhpm_counter_num = mhpm_counter_num;
     cosim_cfg.relax_cosim_check = cfg.disable_cosim;
     cosim_cfg.secure_ibex = secure_ibex;
     cosim_cfg.icache = icache;
+    cosim_cfg.dcache = dcache;
 
     uvm_config_db#(core_ibex_cosim_cfg)::set(null, "*cosim_agent*", "cosim_cfg", cosim_cfg);
 
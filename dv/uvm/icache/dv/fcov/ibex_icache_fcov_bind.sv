@@ -6,6 +6,9 @@
 // module.
 module ibex_icache_fcov_bind;
   bind ibex_icache ibex_icache_fcov_if#(
-    .NUM_FB(NUM_FB)
+    .NUM_FB      (NUM_FB),
+    .NUM_WAYS    (ICacheNumWays),
+    .LINE_BEATS  (LINE_BEATS),
+    .LINE_BEATS_W(LINE_BEATS_W)
   ) u_ibex_icache_fcov_if (.*);
 endmodule
@@ -3,7 +3,11 @@
 // SPDX-License-Identifier: Apache-2.0
 
 interface ibex_icache_fcov_if import ibex_pkg::*; #(
-  parameter int NUM_FB = 4
+  parameter int NUM_FB       = 4,
+  // Cache geometry, bound from the instance being covered
+  parameter int NUM_WAYS     = IC_NUM_WAYS,
+  parameter int LINE_BEATS   = IC_LINE_BEATS,
+  parameter int LINE_BEATS_W = IC_LINE_BEATS_W
 ) (
   input                   clk_i,
   input                   rst_ni,
@@ -23,7 +27,7 @@ interface ibex_icache_fcov_if import ibex_pkg::*; #(
   input [ADDR_W-1:0]      lookup_addr_ic0,
   input                   lookup_valid_ic1,
   input                   tag_hit_ic1,
-  input [IC_NUM_WAYS-1:0] tag_match_ic1,
+  input [NUM_WAYS-1:0]    tag_match_ic1,
 
   input [NUM_FB-1:0]                    fill_hit_ic1,
   input [NUM_FB-1:0]                    fill_busy_q,
@@ -39,15 +43,16 @@ interface ibex_icache_fcov_if import ibex_pkg::*; #(
   logic [NUM_FB-1:0]                    fill_data_rvd,
   logic [NUM_FB-1:0]                    fill_alloc,
   logic [NUM_FB-1:0][NUM_FB-1:0]        fill_older_q,
-  input [NUM_FB-1:0][IC_LINE_BEATS-1:0] fill_err_q,
-  input [NUM_FB-1:0][IC_LINE_BEATS_W:0] fill_rvd_cnt_q,
-  input [NUM_FB-1:0][IC_LINE_BEATS_W:0] fill_ext_cnt_q,
+  input [NUM_FB-1:0][LINE_BEATS-1:0]    fill_err_q,
+  input [NUM_FB-1:0][LINE_BEATS_W:0]    fill_rvd_cnt_q,
+  input [NUM_FB-1:0][LINE_BEATS_W:0]    fill_ext_cnt_q,
   input [ADDR_W-1:0]                    fill_addr_q [NUM_FB]
 );
-  localparam int IC_NUM_WAYS_W = $clog2(IC_NUM_WAYS);
+  localparam int NUM_WAYS_W = NUM_WAYS > 1 ? $clog2(NUM_WAYS) : 1;
+  localparam int LINE_W     = LINE_BEATS_W + BUS_W;
 
-  function automatic logic [IC_NUM_WAYS_W-1:0] way_num(logic [IC_NUM_WAYS-1:0] way_onehot);
-    for (int i = 0;i < IC_NUM_WAYS; ++i) begin
+  function automatic logic [NUM_WAYS_W-1:0] way_num(logic [NUM_WAYS-1:0] way_onehot);
+    for (int i = 0;i < NUM_WAYS; ++i) begin
       if (way_onehot[i]) begin
         return i;
       end
@@ -102,8 +107,8 @@ interface ibex_icache_fcov_if import ibex_pkg::*; #(
     end
   end
 
-  logic [IC_LINE_BEATS-1:0] data_err_ecc;
-  for (genvar i_beat = 0; i_beat < IC_LINE_BEATS; ++i_beat) begin : g_data_err_ecc
+  logic [LINE_BEATS-1:0] data_err_ecc;
+  for (genvar i_beat = 0; i_beat < LINE_BEATS; ++i_beat) begin : g_data_err_ecc
     assign data_err_ecc[i_beat] = |gen_data_ecc_checking.data_err_ic1[i_beat*2+:2];
   end
 
@@ -178,8 +183,8 @@ interface ibex_icache_fcov_if import ibex_pkg::*; #(
 
   assign icache_inval_start = ~last_icache_inval & icache_inval_i;
 
-  logic [IC_LINE_BEATS_W-1:0] starting_beat;
-  assign starting_beat = lookup_addr_ic0[IC_LINE_W-1:BUS_W];
+  logic [LINE_BEATS_W-1:0] starting_beat;
+  assign starting_beat = lookup_addr_ic0[LINE_W-1:BUS_W];
 
   for (genvar i_fb = 0;i_fb < NUM_FB; ++i_fb) begin : g_fb_cov
     fill_buffer_state_e fill_buffer_state;
@@ -190,7 +195,7 @@ interface ibex_icache_fcov_if import ibex_pkg::*; #(
       fill_ram_done_q[i_fb] | fill_hit_q[i_fb] | ~fill_cache_q[i_fb] | (|fill_err_q[i_fb]);
 
     assign fill_requesting = !fill_ext_done_q[i_fb] && (fill_rvd_cnt_q[i_fb] == '0)
-              && (fill_ext_cnt_q[i_fb] != IC_LINE_BEATS);
+              && (fill_ext_cnt_q[i_fb] != LINE_BEATS);
 
     always_comb begin
       fill_buffer_state = FillBufIdle;
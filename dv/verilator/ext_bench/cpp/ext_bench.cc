@@ -0,0 +1,162 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ext_bench.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <iostream>
+
+#include "verilator_sim_ctrl.h"
+
+class ExtensionBenchmark::CountingExtension : public SimCtrlExtension {
+ public:
+  explicit CountingExtension(bool clocked) : _clocked(clocked), _calls(0) {}
+
+  void OnClock(unsigned long sim_time) override { ++_calls; }
+  bool NeedsOnClock() const override { return _clocked; }
+
+  void Count() { ++_calls; }
+  unsigned long GetCalls() const { return _calls; }
+
+ private:
+  bool _clocked;
+  unsigned long _calls;
+};
+
+ExtensionBenchmark::ExtensionBenchmark(const IData *watch_signal)
+    : _watch_signal(watch_signal), _mode(kModeNone), _count(0) {}
+
+ExtensionBenchmark::~ExtensionBenchmark() {}
+
+bool ExtensionBenchmark::Requested(int argc, char **argv) {
+  static const char kOption[] = "--bench-extensions";
+
+  // Help is included so the option is listed
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], kOption, sizeof kOption - 1) == 0 ||
+        strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ExtensionBenchmark::ParseBenchArg(const std::string &arg) {
+  size_t colon = arg.find(':');
+  if (colon == std::string::npos) {
+    return false;
+  }
+
+  std::string mode = arg.substr(0, colon);
+  if (mode == "clock") {
+    _mode = kModeClock;
+  } else if (mode == "periodic") {
+    _mode = kModePeriodic;
+  } else if (mode == "change") {
+    _mode = kModeChange;
+  } else {
+    return false;
+  }
+
+  const char *count_str = arg.c_str() + colon + 1;
+  char *end;
+  _count = strtoul(count_str, &end, 0);
+  return *count_str && !*end;
+}
+
+bool ExtensionBenchmark::ParseCLIArguments(int argc, char **argv,
+                                           bool &exit_app) {
+  const struct option long_options[] = {
+      {"bench-extensions", required_argument, nullptr, 'b'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, "-:h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 'b':
+        if (!ParseBenchArg(optarg)) {
+          std::cerr << "ERROR: Bad argument for --bench-extensions: `"
+                    << optarg << "'. Expected MODE:N where MODE is clock, "
+                    << "periodic or change." << std::endl;
+          exit_app = true;
+          return false;
+        }
+        break;
+      case 'h':
+        std::cout << "--bench-extensions=MODE:N\n"
+                     "  Attach N no-op extensions called every cycle (MODE\n"
+                     "  clock), every "
+                  << kBenchPeriod
+                  << " cycles (periodic) or on a signal that changes every\n"
+                     "  cycle (change)\n\n";
+        break;
+      default:
+        // Ignore options handled elsewhere
+        break;
+    }
+  }
+
+  return true;
+}
+
+void ExtensionBenchmark::PreExec() {
+  if (_mode == kModeNone) {
+    return;
+  }
+
+  VerilatorSimCtrl &simctrl = VerilatorSimCtrl::GetInstance();
+
+  for (unsigned long i = 0; i < _count; ++i) {
+    _extensions.emplace_back(new CountingExtension(_mode == kModeClock));
+    CountingExtension *ext = _extensions.back().get();
+
+    switch (_mode) {
+      case kModeClock:
+        simctrl.RegisterExtension(ext);
+        break;
+      case kModePeriodic:
+        simctrl.SchedulePeriodic(
+            kBenchPeriod, [ext](unsigned long sim_time) { ext->Count(); });
+        break;
+      case kModeChange:
+        simctrl.ScheduleOnChange(
+            _watch_signal, [ext](unsigned long sim_time) { ext->Count(); });
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void ExtensionBenchmark::PostExec() {
+  if (_mode == kModeNone) {
+    return;
+  }
+
+  unsigned long calls = 0;
+  for (const auto &ext : _extensions) {
+    calls += ext->GetCalls();
+  }
+
+  static const char *const mode_names[] = {"none", "clock", "periodic",
+                                           "change"};
+  std::cout << std::endl
+            << "Extension benchmark: " << _count << " extension(s) in "
+            << mode_names[_mode] << " mode, " << calls << " callback(s)"
+            << std::endl;
+}
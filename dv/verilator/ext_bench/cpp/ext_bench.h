@@ -0,0 +1,60 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef EXT_BENCH_H_
+#define EXT_BENCH_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <verilated.h>
+
+#include "sim_ctrl_extension.h"
+
+// Simulation controller extension that measures what attached extensions cost.
+//
+// With --bench-extensions=MODE:N it attaches N extensions that do nothing but
+// count their callbacks. MODE chooses how they are called:
+//
+//   clock     OnClock every cycle (the traditional extension interface)
+//   periodic  A periodic event every kBenchPeriod cycles
+//   change    A trigger on changes of the signal passed to the constructor,
+//             which should change every cycle so the triggers run as often
+//             as clocked extensions do
+//
+// Comparing the simulation speed reported at the end of runs with different
+// modes and counts shows the per-cycle overhead of each kind of extension. Only
+// register the extension when Requested() is true, so that it costs nothing in
+// normal runs.
+class ExtensionBenchmark : public SimCtrlExtension {
+ public:
+  static constexpr unsigned long kBenchPeriod = 1000;
+
+  explicit ExtensionBenchmark(const IData *watch_signal);
+  ~ExtensionBenchmark();
+
+  // Return true if argv asks for the benchmark with --bench-extensions (or for
+  // help)
+  static bool Requested(int argc, char **argv);
+
+  bool ParseCLIArguments(int argc, char **argv, bool &exit_app) override;
+  void PreExec() override;
+  void PostExec() override;
+  bool NeedsOnClock() const override { return false; }
+
+ private:
+  class CountingExtension;
+
+  enum Mode { kModeNone, kModeClock, kModePeriodic, kModeChange };
+
+  const IData *_watch_signal;
+  Mode _mode;
+  unsigned long _count;
+  std::vector<std::unique_ptr<CountingExtension>> _extensions;
+
+  bool ParseBenchArg(const std::string &arg);
+};
+
+#endif  // EXT_BENCH_H_
@@ -0,0 +1,282 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <cstdint>
+#include <iostream>
+
+#include <svdpi.h>
+
+// SoftFP is compiled into the checker directly, it isn't otherwise part of the
+// simulator build
+extern "C" {
+#include "softfp.c"
+}
+
+namespace {
+
+// Must match ibex_pkg::fp_op_e
+enum FpOp {
+  kFpOpAdd,
+  kFpOpSub,
+  kFpOpMul,
+  kFpOpDiv,
+  kFpOpSqrt,
+  kFpOpMadd,
+  kFpOpMsub,
+  kFpOpNmsub,
+  kFpOpNmadd,
+  kFpOpSgnj,
+  kFpOpSgnjn,
+  kFpOpSgnjx,
+  kFpOpMin,
+  kFpOpMax,
+  kFpOpEq,
+  kFpOpLt,
+  kFpOpLe,
+  kFpOpClass,
+  kFpOpCvtWS,
+  kFpOpCvtWuS,
+  kFpOpCvtSW,
+  kFpOpCvtSWu
+};
+
+const uint32_t kSignMask = 0x80000000;
+
+unsigned long checked_ops = 0;
+unsigned long checked_sfp_ops = 0;
+
+bool is_inf(uint32_t a) { return (a & 0x7fffffff) == 0x7f800000; }
+bool is_zero(uint32_t a) { return (a & 0x7fffffff) == 0; }
+
+uint32_t fma_ref(uint32_t a, uint32_t b, uint32_t c, RoundingModeEnum rm,
+                 uint32_t *fflags) {
+  uint32_t result = fma_sf32(a, b, c, rm, fflags);
+
+  // RISC-V raises invalid for inf * 0 even when the addend is a quiet NaN,
+  // SoftFP returns the NaN without it
+  if ((is_inf(a) && is_zero(b)) || (is_zero(a) && is_inf(b))) {
+    *fflags |= FFLAG_INVALID_OP;
+  }
+
+  return result;
+}
+
+// Float to integer conversions of the operands where saturation applies, with
+// the results the RISC-V F extension gives in every rounding mode. These are
+// checked against this table rather than SoftFP so a disagreement in either is
+// caught.
+struct CvtDirected {
+  uint32_t a;
+  uint32_t w_result;
+  uint32_t w_fflags;
+  uint32_t wu_result;
+  uint32_t wu_fflags;
+};
+
+const CvtDirected cvt_directed[] = {
+    // Quiet and signalling NaNs of either sign convert like +inf
+    {0x7fc00000, 0x7fffffff, FFLAG_INVALID_OP, 0xffffffff, FFLAG_INVALID_OP},
+    {0xffc00000, 0x7fffffff, FFLAG_INVALID_OP, 0xffffffff, FFLAG_INVALID_OP},
+    {0x7f800001, 0x7fffffff, FFLAG_INVALID_OP, 0xffffffff, FFLAG_INVALID_OP},
+    // +inf and -inf
+    {0x7f800000, 0x7fffffff, FFLAG_INVALID_OP, 0xffffffff, FFLAG_INVALID_OP},
+    {0xff800000, 0x80000000, FFLAG_INVALID_OP, 0x00000000, FFLAG_INVALID_OP},
+    // 2^31 and -2^31
+    {0x4f000000, 0x7fffffff, FFLAG_INVALID_OP, 0x80000000, 0},
+    {0xcf000000, 0x80000000, 0, 0x00000000, FFLAG_INVALID_OP},
+};
+
+const CvtDirected *find_cvt_directed(uint32_t a) {
+  for (const CvtDirected &d : cvt_directed) {
+    if (d.a == a) {
+      return &d;
+    }
+  }
+
+  return nullptr;
+}
+
+unsigned long checked_cvt_directed = 0;
+
+// Result and flags the RISC-V F extension gives for an operation, using
+// SoftFP where it agrees with the specification
+uint32_t fpu_ref(unsigned int op, RoundingModeEnum rm, uint32_t a, uint32_t b,
+                 uint32_t c, uint32_t *fflags) {
+  *fflags = 0;
+
+  switch (op) {
+    case kFpOpAdd:
+      return add_sf32(a, b, rm, fflags);
+    case kFpOpSub:
+      return sub_sf32(a, b, rm, fflags);
+    case kFpOpMul:
+      return mul_sf32(a, b, rm, fflags);
+    case kFpOpDiv:
+      return div_sf32(a, b, rm, fflags);
+    case kFpOpSqrt:
+      return sqrt_sf32(a, rm, fflags);
+    case kFpOpMadd:
+      return fma_ref(a, b, c, rm, fflags);
+    case kFpOpMsub:
+      return fma_ref(a, b, c ^ kSignMask, rm, fflags);
+    case kFpOpNmsub:
+      return fma_ref(a ^ kSignMask, b, c, rm, fflags);
+    case kFpOpNmadd:
+      return fma_ref(a ^ kSignMask, b, c ^ kSignMask, rm, fflags);
+    case kFpOpSgnj:
+      return (a & ~kSignMask) | (b & kSignMask);
+    case kFpOpSgnjn:
+      return (a & ~kSignMask) | (~b & kSignMask);
+    case kFpOpSgnjx:
+      return a ^ (b & kSignMask);
+    case kFpOpMin:
+    case kFpOpMax: {
+      uint32_t result = op == kFpOpMin ? min_sf32(a, b, fflags)
+                                       : max_sf32(a, b, fflags);
+      // RISC-V returns the other operand when only one is a NaN
+      if (isnan_sf32(a) && !isnan_sf32(b)) {
+        return b;
+      }
+      if (isnan_sf32(b) && !isnan_sf32(a)) {
+        return a;
+      }
+      return result;
+    }
+    case kFpOpEq:
+      return eq_quiet_sf32(a, b, fflags);
+    case kFpOpLt:
+      return lt_sf32(a, b, fflags);
+    case kFpOpLe:
+      return le_sf32(a, b, fflags);
+    case kFpOpClass:
+      return fclass_sf32(a);
+    case kFpOpCvtWS:
+    case kFpOpCvtWuS: {
+      const CvtDirected *d = find_cvt_directed(a);
+      if (d) {
+        ++checked_cvt_directed;
+        *fflags = op == kFpOpCvtWS ? d->w_fflags : d->wu_fflags;
+        return op == kFpOpCvtWS ? d->w_result : d->wu_result;
+      }
+
+      return op == kFpOpCvtWS ? cvt_sf32_i32(a, rm, fflags)
+                              : cvt_sf32_u32(a, rm, fflags);
+    }
+    case kFpOpCvtSW:
+      return cvt_i32_sf32(a, rm, fflags);
+    case kFpOpCvtSWu:
+      return cvt_u32_sf32(a, rm, fflags);
+    default:
+      return 0;
+  }
+}
+
+// Must match the funct3 encodings of the soft-float assist instructions
+enum SfpOp {
+  kSfpOpSrs,
+  kSfpOpNorm,
+  kSfpOpNexp,
+  kSfpOpRpack,
+  kSfpOpRpflags,
+  kSfpOpUmant,
+  kSfpOpUexp
+};
+
+// Result of a soft-float assist instruction, from the SoftFP helper it
+// implements
+uint32_t sfp_ref(unsigned int op, uint32_t a, uint32_t b) {
+  // sfp.norm shift, SoftFP leaves bit 31 of the mantissa clear
+  int norm_shift = a & kSignMask ? 0 : clz32(a) - 1;
+
+  switch (op) {
+    case kSfpOpSrs:
+      // The shift is unsigned, anything from 32 up leaves only the sticky bit
+      return rshift_rnd32(a, b >= 32 ? 32 : b);
+    case kSfpOpNorm:
+      return a << norm_shift;
+    case kSfpOpNexp:
+      return b - norm_shift;
+    case kSfpOpRpack:
+    case kSfpOpRpflags: {
+      // Exponents below -31 or above 1023 give the same result as those
+      // limits, clamp so SoftFP's int arithmetic can't overflow
+      int32_t exp = static_cast<int32_t>(b);
+      exp = exp < -32 ? -32 : exp > 1023 ? 1023 : exp;
+
+      uint32_t fflags = 0;
+      uint32_t result =
+          roundpack_sf32(a >> 31, exp, a & ~kSignMask, RM_RNE, &fflags);
+      return op == kSfpOpRpack ? result : fflags;
+    }
+    case kSfpOpUmant:
+    case kSfpOpUexp: {
+      int32_t exp = (a >> 23) & 0xff;
+      uint32_t mant = a & 0x7fffff;
+      if (exp == 0) {
+        mant = normalize_subnormal_sf32(&exp, mant);
+      } else {
+        mant |= 1 << 23;
+      }
+      return op == kSfpOpUmant ? mant : static_cast<uint32_t>(exp);
+    }
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+// Check a soft-float assist instruction result, returns false (after printing
+// the expected result) on a mismatch
+svBit ibex_sfp_check(unsigned int funct3, unsigned int a, unsigned int b,
+                     unsigned int result) {
+  uint32_t exp_result = sfp_ref(funct3, a, b);
+
+  ++checked_sfp_ops;
+
+  if (result == exp_result) {
+    return 1;
+  }
+
+  std::cerr << std::hex << "Soft-float assist result " << result
+            << ", expected " << exp_result << std::dec << std::endl;
+  return 0;
+}
+
+void ibex_sfp_check_report() {
+  std::cout << "Soft-float assist checker: " << checked_sfp_ops
+            << " instructions matched SoftFP" << std::endl;
+}
+
+
+// Check an FPU result, returns false (after printing the expected result) on a
+// mismatch. `c` is only used by the fused multiply-adds.
+svBit ibex_fpu_check(unsigned int op, unsigned int rm, unsigned int a,
+                     unsigned int b, unsigned int c, unsigned int result,
+                     unsigned int fflags) {
+  uint32_t exp_fflags;
+  uint32_t exp_result =
+      fpu_ref(op, static_cast<RoundingModeEnum>(rm), a, b, c, &exp_fflags);
+
+  ++checked_ops;
+
+  if (result == exp_result && fflags == exp_fflags) {
+    return 1;
+  }
+
+  std::cerr << std::hex << "FPU result " << result << " fflags " << fflags
+            << ", expected " << exp_result << " fflags " << exp_fflags
+            << std::dec << std::endl;
+  return 0;
+}
+
+void ibex_fpu_check_report() {
+  std::cout << "FPU checker: " << checked_ops
+            << " operations matched SoftFP (" << checked_cvt_directed
+            << " saturating conversions against the directed table)"
+            << std::endl;
+}
+}
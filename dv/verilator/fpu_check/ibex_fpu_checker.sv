@@ -0,0 +1,62 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * FPU checker
+ *
+ * Bound into every ibex_fpu instance (see ibex_fpu_checker_bind.sv). Each result the ID stage
+ * accepts from the FPU is compared, together with its exception flags, against the SoftFP library
+ * (see cpp/ibex_fpu_checker.cc). Simulation stops on the first mismatch.
+ */
+module ibex_fpu_checker (
+  input logic             clk_i,
+  input logic             rst_ni,
+  input logic             fp_en_i,
+  input ibex_pkg::fp_op_e operator_i,
+  input ibex_pkg::fp_rm_e rm_i,
+  input logic [31:0]      op_a_i,
+  input logic [31:0]      op_b_i,
+  input logic             fpu_ready_id_i,
+  input logic [31:0]      fpu_result_o,
+  input logic [4:0]       fflags_o,
+  input logic             valid_o
+);
+  import "DPI-C" function bit ibex_fpu_check(int unsigned op, int unsigned rm,
+    int unsigned a, int unsigned b, int unsigned c, int unsigned result, int unsigned fflags);
+  import "DPI-C" function void ibex_fpu_check_report();
+
+  logic        op_busy;
+  logic [31:0] rs1_q, rs2_q;
+  logic [31:0] rs1, rs2;
+
+  // Operand A carries rs3 after the first cycle of the fused multiply-adds, so capture the
+  // operands as an operation starts. Single cycle operations complete in that same cycle.
+  assign rs1 = op_busy ? rs1_q : op_a_i;
+  assign rs2 = op_busy ? rs2_q : op_b_i;
+
+  always @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      op_busy <= 1'b0;
+    end else if (fp_en_i && valid_o && fpu_ready_id_i) begin
+      op_busy <= 1'b0;
+    end else if (fp_en_i && !op_busy) begin
+      op_busy <= 1'b1;
+      rs1_q   <= op_a_i;
+      rs2_q   <= op_b_i;
+    end
+  end
+
+  always @(posedge clk_i) begin
+    if (rst_ni && fp_en_i && valid_o && fpu_ready_id_i) begin
+      if (!ibex_fpu_check(operator_i, rm_i, rs1, rs2, op_a_i, fpu_result_o, fflags_o)) begin
+        $fatal(1, "FPU mismatch at time %t: %s rm %0d on %x %x %x", $time(), operator_i.name(),
+          rm_i, rs1, rs2, op_a_i);
+      end
+    end
+  end
+
+  final begin
+    ibex_fpu_check_report();
+  end
+endmodule
@@ -0,0 +1,19 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+module ibex_fpu_checker_bind;
+  bind ibex_fpu ibex_fpu_checker u_ibex_fpu_checker_bind (
+    .clk_i,
+    .rst_ni,
+    .fp_en_i,
+    .operator_i,
+    .rm_i,
+    .op_a_i,
+    .op_b_i,
+    .fpu_ready_id_i,
+    .fpu_result_o,
+    .fflags_o,
+    .valid_o
+  );
+endmodule
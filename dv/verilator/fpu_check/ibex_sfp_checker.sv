@@ -0,0 +1,46 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Soft-float assist checker
+ *
+ * Bound into every ibex_core instance (see ibex_sfp_checker_bind.sv). Each retired soft-float
+ * assist instruction (custom-0, see SoftFloatAssist) is compared against the SoftFP helper it
+ * implements (see cpp/ibex_fpu_checker.cc). The co-simulation reference model doesn't decode
+ * custom-0, so this is the only check of their results. Simulation stops on the first mismatch.
+ */
+module ibex_sfp_checker (
+  input logic        clk_i,
+  input logic        rst_ni,
+  input logic        rvfi_valid,
+  input logic [31:0] rvfi_insn,
+  input logic        rvfi_trap,
+  input logic [31:0] rvfi_rs1_rdata,
+  input logic [31:0] rvfi_rs2_rdata,
+  input logic [4:0]  rvfi_rd_addr,
+  input logic [31:0] rvfi_rd_wdata
+);
+  import "DPI-C" function bit ibex_sfp_check(int unsigned funct3, int unsigned a, int unsigned b,
+    int unsigned result);
+  import "DPI-C" function void ibex_sfp_check_report();
+
+  logic is_sfp;
+
+  // custom-0 with funct7 zero, funct3 7 is not allocated and so traps
+  assign is_sfp = (rvfi_insn[6:0] == 7'b0001011) && (rvfi_insn[31:25] == 7'b0) &&
+                  (rvfi_insn[14:12] != 3'b111);
+
+  always @(posedge clk_i) begin
+    if (rst_ni && rvfi_valid && !rvfi_trap && is_sfp && (rvfi_rd_addr != 5'd0)) begin
+      if (!ibex_sfp_check(rvfi_insn[14:12], rvfi_rs1_rdata, rvfi_rs2_rdata, rvfi_rd_wdata)) begin
+        $fatal(1, "Soft-float assist mismatch at time %t: funct3 %0d on %x %x", $time(),
+          rvfi_insn[14:12], rvfi_rs1_rdata, rvfi_rs2_rdata);
+      end
+    end
+  end
+
+  final begin
+    ibex_sfp_check_report();
+  end
+endmodule
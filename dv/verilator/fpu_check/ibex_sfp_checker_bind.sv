@@ -0,0 +1,17 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+module ibex_sfp_checker_bind;
+  bind ibex_core ibex_sfp_checker u_ibex_sfp_checker_bind (
+    .clk_i,
+    .rst_ni,
+    .rvfi_valid,
+    .rvfi_insn,
+    .rvfi_trap,
+    .rvfi_rs1_rdata,
+    .rvfi_rs2_rdata,
+    .rvfi_rd_addr,
+    .rvfi_rd_wdata
+  );
+endmodule
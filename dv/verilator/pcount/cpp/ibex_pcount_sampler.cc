@@ -0,0 +1,177 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ibex_pcount_sampler.h"
+
+#include <cassert>
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+
+#include "ibex_pcounts.h"
+#include "verilator_sim_ctrl.h"
+
+extern "C" {
+extern unsigned long long mhpmcounter_get(int index);
+}
+
+// The sampler that pcount_sample_marker() reports to, if sampling is enabled
+static PcountSampler *active_sampler = nullptr;
+
+// DPI import, called from ibex_simple_system.sv when software writes a marker
+extern "C" void pcount_sample_marker(unsigned int marker) {
+  if (active_sampler) {
+    active_sampler->OnMarker(marker);
+  }
+}
+
+PcountSampler::PcountSampler(const std::string &scope)
+    : _scope_name(scope),
+      _scope(nullptr),
+      _period(kDefaultPeriod),
+      _num_samples(0) {}
+
+PcountSampler::~PcountSampler() {
+  if (active_sampler == this) {
+    active_sampler = nullptr;
+  }
+}
+
+bool PcountSampler::ParseCLIArguments(int argc, char **argv, bool &exit_app) {
+  const struct option long_options[] = {
+      {"pcount-samples", required_argument, nullptr, 's'},
+      {"pcount-sample-period", required_argument, nullptr, 'p'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, "-:h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    switch (c) {
+      case 's':
+        _path = optarg;
+        break;
+      case 'p': {
+        char *end;
+        _period = strtoul(optarg, &end, 0);
+        if (!*optarg || *end) {
+          std::cerr << "ERROR: Bad argument for --pcount-sample-period: `"
+                    << optarg << "' is not a number of cycles." << std::endl;
+          exit_app = true;
+          return false;
+        }
+        break;
+      }
+      case 'h':
+        std::cout << "--pcount-samples=FILE\n"
+                     "  Write performance counter samples to FILE, every\n"
+                     "  --pcount-sample-period cycles and at each software\n"
+                     "  marker\n\n"
+                     "--pcount-sample-period=N\n"
+                     "  Cycles between performance counter samples (default "
+                  << kDefaultPeriod << ", 0 for markers only)\n\n";
+        break;
+      default:
+        // Ignore options handled elsewhere
+        break;
+    }
+  }
+
+  return true;
+}
+
+void PcountSampler::PreExec() {
+  if (_path.empty()) {
+    return;
+  }
+
+  _scope = svGetScopeFromName(_scope_name.c_str());
+  assert(_scope);
+
+  _out.open(_path);
+  if (!_out) {
+    std::cerr << "WARNING: Could not open " << _path
+              << " for performance counter samples." << std::endl;
+    return;
+  }
+
+  svScope prev_scope = svSetScope(_scope);
+  for (int i = 0; i < ibex_counter_names.size(); ++i) {
+    if (has_hpm_counter(i)) {
+      _counters.push_back(i);
+    }
+  }
+  svSetScope(prev_scope);
+
+  _last.assign(_counters.size(), 0);
+
+  _out << "cycle,trigger,marker";
+  for (int i : _counters) {
+    _out << "," << ibex_counter_names[i];
+  }
+  _out << "\n";
+
+  active_sampler = this;
+
+  if (_period) {
+    VerilatorSimCtrl::GetInstance().SchedulePeriodic(
+        _period,
+        [this](unsigned long sim_time) {
+          Sample(sim_time, "period", false, 0);
+        },
+        _period);
+  }
+}
+
+void PcountSampler::PostExec() {
+  if (active_sampler != this) {
+    return;
+  }
+
+  Sample(VerilatorSimCtrl::GetInstance().GetTime(), "final", false, 0);
+  active_sampler = nullptr;
+  _out.close();
+
+  std::cout << "Wrote " << _num_samples << " performance counter samples to "
+            << _path << std::endl;
+}
+
+void PcountSampler::OnMarker(uint32_t marker) {
+  // This is called in the middle of evaluating the design, so wait for the
+  // next rising edge to read counters that are consistent with each other.
+  VerilatorSimCtrl::GetInstance().ScheduleAt(
+      0, [this, marker](unsigned long sim_time) {
+        Sample(sim_time, "marker", true, marker);
+      });
+}
+
+void PcountSampler::Sample(unsigned long sim_time, const char *trigger,
+                           bool has_marker, uint32_t marker) {
+  _out << sim_time / 2 << "," << trigger << ",";
+  if (has_marker) {
+    _out << "0x" << std::hex << marker << std::dec;
+  }
+
+  svScope prev_scope = svSetScope(_scope);
+  for (size_t j = 0; j < _counters.size(); ++j) {
+    uint64_t value = mhpmcounter_get(_counters[j]);
+    uint64_t delta = value >= _last[j] ? value - _last[j] : value;
+    _last[j] = value;
+
+    _out << "," << delta;
+  }
+  svSetScope(prev_scope);
+
+  _out << "\n";
+  ++_num_samples;
+}
@@ -0,0 +1,77 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef IBEX_PCOUNT_SAMPLER_H_
+#define IBEX_PCOUNT_SAMPLER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <svdpi.h>
+
+#include "sim_ctrl_extension.h"
+
+// Simulation controller extension that records the performance counters over
+// time, so phases of a program (where fetch or divide stalls spike, say) can
+// be seen rather than just end of run totals.
+//
+// With --pcount-samples=FILE the counters are sampled every
+// --pcount-sample-period cycles (default kDefaultPeriod, 0 disables periodic
+// samples) and whenever software writes a marker to the simulator control
+// peripheral (see pcount_marker() in simple_system_common.h). A final sample
+// is taken at the end of the simulation.
+//
+// FILE is a CSV with a header line naming the columns and one line per
+// sample:
+//
+//   cycle,trigger,marker,<counter>,<counter>,...
+//
+// cycle is the simulation cycle of the sample, trigger is one of "period",
+// "marker" or "final" and marker is the value written by software (empty for
+// other triggers). Each counter column holds the increase of that counter
+// since the previous sample, so the columns sum to the totals reported at the
+// end of the simulation. Only counters that exist in the simulated core are
+// included. A counter that went backwards (because software reset it) is
+// reported as its new value.
+//
+// dv/verilator/pcount/pcount_reduce.py turns the samples into per-interval
+// IPC and stall breakdowns.
+class PcountSampler : public SimCtrlExtension {
+ public:
+  static constexpr unsigned long kDefaultPeriod = 10000;
+
+  // scope is the SystemVerilog scope of the mhpmcounter_get and
+  // mhpmcounter_num DPI exports
+  explicit PcountSampler(const std::string &scope);
+  ~PcountSampler();
+
+  bool ParseCLIArguments(int argc, char **argv, bool &exit_app) override;
+  void PreExec() override;
+  void PostExec() override;
+  bool NeedsOnClock() const override { return false; }
+
+  // Called through the pcount_sample_marker DPI import when software writes a
+  // marker. The sample is taken on the next rising clock edge.
+  void OnMarker(uint32_t marker);
+
+ private:
+  std::string _scope_name;
+  svScope _scope;
+  std::string _path;
+  unsigned long _period;
+  std::ofstream _out;
+
+  // Indices into ibex_counter_names of the counters that exist, and their
+  // values at the previous sample
+  std::vector<int> _counters;
+  std::vector<uint64_t> _last;
+  uint64_t _num_samples;
+
+  void Sample(unsigned long sim_time, const char *trigger, bool has_marker,
+              uint32_t marker);
+};
+
+#endif  // IBEX_PCOUNT_SAMPLER_H_
@@ -31,9 +31,19 @@ const std::vector<std::string> ibex_counter_names = {
     "Taken Conditional Branches",
     "Compressed Instructions",
     "Multiply Wait",
-    "Divide Wait"};
-
-static bool has_hpm_counter(int index) {
+    "Divide Wait",
+    "FP Wait",
+    "Branch Mispredicts",
+    "RAS Hits",
+    "ICache Hits",
+    "ICache Misses",
+    "ICache Useful Prefetches",
+    "DCache Hits",
+    "DCache Misses",
+    "DCache Writebacks",
+    "Fused Instruction Pairs"};
+
+bool has_hpm_counter(int index) {
   // The "cycles" and "instructions retired" counters are special and always
   // exist.
   if (index == 0 || index == 2)
@@ -11,6 +11,12 @@
 
 extern const std::vector<std::string> ibex_counter_names;
 
+/**
+ * Returns true if the counter at index in ibex_counter_names exists in the
+ * simulated core (and so can be read with mhpmcounter_get)
+ */
+bool has_hpm_counter(int index);
+
 /**
  * Returns a formatted string of performance counter values
  *
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Reduce performance counter samples to per-interval IPC and stalls
+
+Reads the CSV written by the simple system with --pcount-samples (see
+dv/verilator/pcount/cpp/ibex_pcount_sampler.h). Each sample closes an
+interval that started at the previous sample. For every interval this prints
+the cycles, instructions retired, IPC and the fraction of cycles spent in each
+kind of stall that the simulated core counts.
+
+Intervals are labelled with the region they ran in: the value of the most
+recent software marker before the interval started. With --by-region the
+intervals of each region are summed instead, giving a per-region profile.
+'''
+
+import argparse
+import csv
+import sys
+
+# Counters (as named in ibex_counter_names) reported as stall fractions, with
+# the column headings used for them
+_STALLS = [
+    ('Fetch Wait', 'fetch'),
+    ('LSU Busy', 'lsu'),
+    ('Multiply Wait', 'mul'),
+    ('Divide Wait', 'div'),
+    ('FP Wait', 'fp'),
+]
+
+
+class Interval:
+    def __init__(self, start, end, region, counts):
+        self.start = start
+        self.end = end
+        self.region = region
+        self.counts = counts
+
+
+def read_intervals(path):
+    '''Read a sample file, returning (counter names, list of Interval)'''
+    with open(path, newline='') as samples:
+        reader = csv.reader(samples)
+        header = next(reader)
+        if header[:3] != ['cycle', 'trigger', 'marker']:
+            raise ValueError('{} is not a performance counter sample file'
+                             .format(path))
+
+        names = header[3:]
+        intervals = []
+        region = ''
+        last_cycle = 0
+
+        for row in reader:
+            cycle = int(row[0])
+            counts = dict(zip(names, (int(val) for val in row[3:])))
+            intervals.append(Interval(last_cycle, cycle, region, counts))
+
+            # A marker starts a new region from this sample on
+            if row[1] == 'marker':
+                region = row[2]
+            last_cycle = cycle
+
+    return names, intervals
+
+
+def merge_by_region(names, intervals):
+    '''Sum intervals with the same region, in order of first appearance'''
+    merged = {}
+    for interval in intervals:
+        if interval.region not in merged:
+            merged[interval.region] = Interval(interval.start, interval.end,
+                                               interval.region,
+                                               dict.fromkeys(names, 0))
+
+        total = merged[interval.region]
+        total.end = interval.end
+        for name in names:
+            total.counts[name] += interval.counts[name]
+
+    return list(merged.values())
+
+
+def interval_row(names, interval, show_span):
+    '''Return the output columns for an interval'''
+    cycles = interval.counts.get('Cycles', 0)
+    instrs = interval.counts.get('Instructions Retired', 0)
+
+    row = []
+    if show_span:
+        row += [str(interval.start), str(interval.end)]
+    row += [interval.region or '-', str(cycles), str(instrs),
+            '{:.3f}'.format(instrs / cycles) if cycles else '-']
+
+    for name, _ in _STALLS:
+        if name in names and cycles:
+            row.append('{:.1%}'.format(interval.counts[name] / cycles))
+        elif name in names:
+            row.append('-')
+
+    return row
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('samples',
+                        help='Sample file written with --pcount-samples')
+    parser.add_argument('--by-region', action='store_true',
+                        help='Sum the intervals of each marker region')
+    parser.add_argument('--csv', action='store_true',
+                        help='Write CSV rather than an aligned table')
+    args = parser.parse_args()
+
+    try:
+        names, intervals = read_intervals(args.samples)
+    except (OSError, ValueError, StopIteration) as err:
+        print('ERROR: Could not read {}: {}'.format(args.samples, err),
+              file=sys.stderr)
+        return 1
+
+    # Samples taken in the same cycle (a marker on a sampling period, say)
+    # leave an empty interval behind
+    intervals = [i for i in intervals if i.end > i.start]
+
+    show_span = not args.by_region
+    if args.by_region:
+        intervals = merge_by_region(names, intervals)
+
+    header = ['start', 'end'] if show_span else []
+    header += ['region', 'cycles', 'instrs', 'ipc']
+    header += [heading for name, heading in _STALLS if name in names]
+
+    rows = [interval_row(names, i, show_span) for i in intervals]
+
+    if args.csv:
+        writer = csv.writer(sys.stdout)
+        writer.writerow(header)
+        writer.writerows(rows)
+        return 0
+
+    widths = [max(len(row[col]) for row in [header] + rows)
+              for col in range(len(header))]
+    for row in [header] + rows:
+        print('  '.join(val.rjust(width) for val, width in zip(row, widths)))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
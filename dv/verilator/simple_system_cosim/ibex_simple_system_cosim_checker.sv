@@ -5,6 +5,7 @@
 module ibex_simple_system_cosim_checker #(
   parameter bit                 SecureIbex     = 1'b0,
   parameter bit                 ICache         = 1'b0,
+  parameter bit                 DCache         = 1'b0,
   parameter bit                 PMPEnable      = 1'b0,
   parameter int unsigned        PMPGranularity = 0,
   parameter int unsigned        PMPNumRegions  = 4,
@@ -25,91 +26,223 @@ module ibex_simple_system_cosim_checker #(
   input logic        host_dmem_err
 );
   import "DPI-C" function chandle get_spike_cosim;
-  import "DPI-C" function void create_cosim(bit secure_ibex, bit icache_en,
+  import "DPI-C" function void create_cosim(bit secure_ibex, bit icache_en, bit dcache_en,
     bit [31:0] pmp_num_regions, bit [31:0] pmp_granularity, bit [31:0] mhpm_counter_num);
+  import "DPI-C" function int unsigned get_cosim_batch_size();
 
   import ibex_pkg::*;
 
   chandle cosim_handle;
 
+  // With the data cache the bus only carries line fills, write backs and uncached accesses. The
+  // accesses the co-simulator checks are the ones the LSU makes to the cache.
+  logic        dmem_req;
+  logic        dmem_gnt;
+  logic        dmem_we;
+  logic [31:0] dmem_addr;
+  logic [3:0]  dmem_be;
+  logic [31:0] dmem_wdata;
+  logic        dmem_rvalid;
+  logic [31:0] dmem_rdata;
+  logic        dmem_err;
+
+  if (DCache) begin : g_dcache_dside
+    assign dmem_req    = u_top.u_ibex_top.u_ibex_core.lsu_data_req;
+    assign dmem_gnt    = u_top.u_ibex_top.u_ibex_core.lsu_data_gnt;
+    assign dmem_we     = u_top.u_ibex_top.u_ibex_core.lsu_data_we;
+    assign dmem_addr   = u_top.u_ibex_top.u_ibex_core.lsu_data_addr;
+    assign dmem_be     = u_top.u_ibex_top.u_ibex_core.lsu_data_be;
+    assign dmem_wdata  = u_top.u_ibex_top.u_ibex_core.lsu_data_wdata;
+    assign dmem_rvalid = u_top.u_ibex_top.u_ibex_core.lsu_data_rvalid;
+    assign dmem_rdata  = u_top.u_ibex_top.u_ibex_core.lsu_data_rdata;
+    assign dmem_err    = u_top.u_ibex_top.u_ibex_core.lsu_data_err;
+
+    logic unused_host_dmem;
+    assign unused_host_dmem = ^{host_dmem_req, host_dmem_gnt, host_dmem_we, host_dmem_addr,
+                                host_dmem_be, host_dmem_wdata, host_dmem_rvalid, host_dmem_rdata,
+                                host_dmem_err};
+  end else begin : g_bus_dside
+    assign dmem_req    = host_dmem_req;
+    assign dmem_gnt    = host_dmem_gnt;
+    assign dmem_we     = host_dmem_we;
+    assign dmem_addr   = host_dmem_addr;
+    assign dmem_be     = host_dmem_be;
+    assign dmem_wdata  = host_dmem_wdata;
+    assign dmem_rvalid = host_dmem_rvalid;
+    assign dmem_rdata  = host_dmem_rdata;
+    assign dmem_err    = host_dmem_err;
+  end
+
+  // With LoadPipelining the LSU can have two accesses outstanding and drops the response to a load
+  // that didn't execute. Responses are in order, so accesses are queued when granted and dropped
+  // responses are never notified to the co-simulator.
+  typedef struct packed {
+    logic        store;
+    logic [31:0] addr;
+    logic [3:0]  be;
+    logic [31:0] store_data;
+    logic        misaligned_first;
+    logic        misaligned_second;
+    logic        misaligned_first_saw_error;
+    logic        m_mode_access;
+  } dside_access_t;
+
+  dside_access_t outstanding_accesses[$];
+  dside_access_t outstanding;
+  logic          dmem_dropped;
+
+  assign dmem_dropped = u_top.u_ibex_top.u_ibex_core.load_store_unit_i.resp_dropped;
+
+  // Retired instructions are packed into `retire_batch` and handed to the co-simulator in a single
+  // `riscv_cosim_step_batch` call once `retire_batch_size` have accumulated, rather than making a
+  // DPI call for each piece of side-band state of every instruction. The batch is also flushed
+  // before any dside access is notified so the co-simulator sees calls in the same order as it
+  // would without batching. The time each record retired is kept alongside it so a mismatch is
+  // reported at the time the instruction retired rather than when the batch was flushed.
+  typedef bit [CosimRetireRecordWords-1:0][31:0] retire_record_t;
+
+  retire_record_t retire_batch [CosimMaxBatch];
+  time            retire_batch_time [CosimMaxBatch];
+  int unsigned    retire_batch_count;
+  int unsigned    retire_batch_size;
+
   initial begin
     localparam int unsigned LocalPMPGranularity = PMPEnable ? PMPGranularity : 0;
     localparam int unsigned LocalPMPNumRegions  = PMPEnable ? PMPNumRegions  : 0;
 
-    create_cosim(SecureIbex, ICache, LocalPMPNumRegions, LocalPMPGranularity, MHPMCounterNum);
+    create_cosim(SecureIbex, ICache, DCache, LocalPMPNumRegions, LocalPMPGranularity,
+                 MHPMCounterNum);
     cosim_handle = get_spike_cosim();
+
+    retire_batch_count = 0;
+    retire_batch_size  = get_cosim_batch_size();
+    if (retire_batch_size == 0 || retire_batch_size > CosimMaxBatch) begin
+      $fatal(1, "Co-simulation batch size %0d must be between 1 and %0d", retire_batch_size,
+        CosimMaxBatch);
+    end
   end
 
+  // Pack the instruction retiring this cycle, see `cosim_dpi.h` for the layout
+  function automatic retire_record_t pack_retire_record();
+    retire_record_t record = '0;
+
+    record[0] = u_top.rvfi_pc_rdata;
+    record[1] = u_top.rvfi_rd_wdata;
+    record[2] = u_top.rvfi_ext_pre_mip;
+    record[3] = u_top.rvfi_ext_post_mip;
+    record[4] = u_top.rvfi_ext_mcycle[31:0];
+    record[5] = u_top.rvfi_ext_mcycle[63:32];
+    for (int i = 0; i < MHPMCounterNum; i++) begin
+      record[6 + i]                                 = u_top.rvfi_ext_mhpmcounters[i];
+      record[6 + CosimRetireRecordMhpmCounters + i] = u_top.rvfi_ext_mhpmcountersh[i];
+    end
+    record[64][4:0]   = u_top.rvfi_rd_addr;
+    record[64][5]     = u_top.rvfi_trap;
+    record[64][6]     = u_top.rvfi_ext_rf_wr_suppress;
+    record[64][7]     = u_top.rvfi_ext_nmi;
+    record[64][8]     = u_top.rvfi_ext_nmi_int;
+    record[64][9]     = u_top.rvfi_ext_debug_req;
+    record[64][10]    = u_top.rvfi_ext_ic_scr_key_valid;
+    record[64][15:11] = 5'(MHPMCounterNum);
+
+    return record;
+  endfunction
+
+  function automatic void flush_retire_batch();
+    int unsigned num_passed;
+
+    if (retire_batch_count == 0) begin
+      return;
+    end
+
+    num_passed = riscv_cosim_step_batch(cosim_handle, retire_batch, retire_batch_count);
+    if (num_passed != retire_batch_count) begin
+      $display("FAILURE: Co-simulation mismatch at time %t, PC %x",
+        retire_batch_time[num_passed], retire_batch[num_passed][0]);
+      for (int i = 0;i < riscv_cosim_get_num_errors(cosim_handle); ++i) begin
+        $display(riscv_cosim_get_error(cosim_handle, i));
+      end
+      riscv_cosim_clear_errors(cosim_handle);
+
+      $fatal(1, "Co-simulation mismatch seen");
+    end
+
+    retire_batch_count = 0;
+  endfunction
+
   always @(posedge clk_i) begin
     if (u_top.rvfi_valid) begin
-      riscv_cosim_set_nmi(cosim_handle, u_top.rvfi_ext_nmi);
-      riscv_cosim_set_nmi_int(cosim_handle, u_top.rvfi_ext_nmi_int);
-      riscv_cosim_set_mip(cosim_handle, u_top.rvfi_ext_pre_mip, u_top.rvfi_ext_post_mip);
-      riscv_cosim_set_debug_req(cosim_handle, u_top.rvfi_ext_debug_req);
-      riscv_cosim_set_mcycle(cosim_handle, u_top.rvfi_ext_mcycle);
-      for (int i=0; i < 10; i++) begin
-        riscv_cosim_set_csr(cosim_handle, int'(CSR_MHPMCOUNTER3) + i,
-          u_top.rvfi_ext_mhpmcounters[i]);
-        riscv_cosim_set_csr(cosim_handle, int'(CSR_MHPMCOUNTER3H) + i,
-          u_top.rvfi_ext_mhpmcountersh[i]);
-      end
-      riscv_cosim_set_ic_scr_key_valid(cosim_handle, u_top.rvfi_ext_ic_scr_key_valid);
-
-      if (riscv_cosim_step(cosim_handle, u_top.rvfi_rd_addr, u_top.rvfi_rd_wdata,
-                           u_top.rvfi_pc_rdata, u_top.rvfi_trap,
-                           u_top.rvfi_ext_rf_wr_suppress) == 0)
-      begin
-        $display("FAILURE: Co-simulation mismatch at time %t", $time());
-        for (int i = 0;i < riscv_cosim_get_num_errors(cosim_handle); ++i) begin
-          $display(riscv_cosim_get_error(cosim_handle, i));
+      retire_batch[retire_batch_count]      = pack_retire_record();
+      retire_batch_time[retire_batch_count] = $time();
+
+      // A fused instruction pair retires as one, the co-simulator steps through its two
+      // instructions separately. The first writes the intermediate value to rd. No interrupt,
+      // NMI or debug request can be taken between the two, so the second keeps the first's
+      // pre_mip and doesn't repeat its NMI and debug request flags.
+      if (u_top.rvfi_ext_fused) begin
+        retire_batch[retire_batch_count][1] = u_top.rvfi_ext_fused_rd_wdata;
+        retire_batch_count++;
+
+        if (retire_batch_count >= retire_batch_size) begin
+          flush_retire_batch();
         end
-        riscv_cosim_clear_errors(cosim_handle);
 
-        $fatal(1, "Co-simulation mismatch seen");
+        retire_batch[retire_batch_count]          = pack_retire_record();
+        retire_batch[retire_batch_count][0]       = u_top.rvfi_pc_rdata + 32'd4;
+        retire_batch[retire_batch_count][64][9:7] = 3'b000;
+        retire_batch_time[retire_batch_count]     = $time();
+      end
+
+      retire_batch_count++;
+    end
+
+    if (rst_ni && dmem_rvalid) begin
+      outstanding = outstanding_accesses.pop_front();
+
+      if (!dmem_dropped) begin
+        flush_retire_batch();
+
+        riscv_cosim_notify_dside_access(cosim_handle, outstanding.store, outstanding.addr,
+          outstanding.store ? outstanding.store_data : dmem_rdata, outstanding.be,
+          dmem_err, outstanding.misaligned_first, outstanding.misaligned_second,
+          outstanding.misaligned_first_saw_error, outstanding.m_mode_access);
       end
     end
+
+    if (retire_batch_count >= retire_batch_size) begin
+      flush_retire_batch();
+    end
   end
 
-  logic outstanding_store;
-  logic [31:0] outstanding_addr;
-  logic [3:0] outstanding_be;
-  logic [31:0] outstanding_store_data;
-  logic outstanding_misaligned_first;
-  logic outstanding_misaligned_second;
-  logic outstanding_misaligned_first_saw_error;
-  logic outstanding_m_mode_access;
+  // Check whatever is left in the batch when the simulation ends. A mismatch here is left in the
+  // co-simulator errors for the testbench to report.
+  final begin
+    if (retire_batch_count != 0) begin
+      void'(riscv_cosim_step_batch(cosim_handle, retire_batch, retire_batch_count));
+    end
+  end
 
   always @(posedge clk_i or negedge rst_ni) begin
     if (!rst_ni) begin
-      outstanding_store <= 1'b0;
-    end else begin
-      if (host_dmem_req && host_dmem_gnt) begin
-        outstanding_store      <= host_dmem_we;
-        outstanding_addr       <= host_dmem_addr;
-        outstanding_be         <= host_dmem_be;
-        outstanding_store_data <= host_dmem_wdata;
-        outstanding_misaligned_first <=
+      outstanding_accesses.delete();
+    end else if (dmem_req && dmem_gnt) begin
+      outstanding_accesses.push_back('{
+        store:            dmem_we,
+        addr:             dmem_addr,
+        be:               dmem_be,
+        store_data:       dmem_wdata,
+        misaligned_first:
           u_top.u_ibex_top.u_ibex_core.load_store_unit_i.handle_misaligned_d |
           ((u_top.u_ibex_top.u_ibex_core.load_store_unit_i.lsu_type_i == 2'b01) &
-           (u_top.u_ibex_top.u_ibex_core.load_store_unit_i.data_offset == 2'b01));
-
-        outstanding_misaligned_second <=
-          u_top.u_ibex_top.u_ibex_core.load_store_unit_i.addr_incr_req_o;
-
-        outstanding_misaligned_first_saw_error <=
+           (u_top.u_ibex_top.u_ibex_core.load_store_unit_i.data_offset == 2'b01)),
+        misaligned_second:
+          u_top.u_ibex_top.u_ibex_core.load_store_unit_i.addr_incr_req_o,
+        misaligned_first_saw_error:
           u_top.u_ibex_top.u_ibex_core.load_store_unit_i.addr_incr_req_o &
-          u_top.u_ibex_top.u_ibex_core.load_store_unit_i.lsu_err_d;
-
-        outstanding_m_mode_access <=
-          u_top.u_ibex_top.u_ibex_core.priv_mode_lsu == ibex_pkg::PRIV_LVL_M;
-      end
-
-      if (host_dmem_rvalid) begin
-        riscv_cosim_notify_dside_access(cosim_handle, outstanding_store, outstanding_addr,
-          outstanding_store ? outstanding_store_data : host_dmem_rdata, outstanding_be,
-          host_dmem_err, outstanding_misaligned_first, outstanding_misaligned_second,
-          outstanding_misaligned_first_saw_error, outstanding_m_mode_access);
-      end
+          u_top.u_ibex_top.u_ibex_core.load_store_unit_i.lsu_err_d,
+        m_mode_access:
+          u_top.u_ibex_top.u_ibex_core.priv_mode_lsu == ibex_pkg::PRIV_LVL_M
+      });
     end
   end
 endmodule
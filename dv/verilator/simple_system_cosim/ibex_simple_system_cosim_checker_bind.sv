@@ -6,6 +6,7 @@ module ibex_simple_system_cosim_checker_bind;
   bind ibex_simple_system ibex_simple_system_cosim_checker#(
       .SecureIbex,
       .ICache,
+      .DCache,
       .PMPEnable,
       .PMPGranularity,
       .PMPNumRegions,
@@ -14,15 +15,16 @@ module ibex_simple_system_cosim_checker_bind;
       .clk_i            (IO_CLK),
       .rst_ni           (IO_RST_N),
 
-      .host_dmem_req    (host_req[CoreD]),
-      .host_dmem_gnt    (host_gnt[CoreD]),
-      .host_dmem_we     (host_we[CoreD]),
-      .host_dmem_addr   (host_addr[CoreD]),
-      .host_dmem_be     (host_be[CoreD]),
-      .host_dmem_wdata  (host_wdata[CoreD]),
+      // The core side of the memory timing model, whose responses line up with the LSU's
+      .host_dmem_req    (data_req),
+      .host_dmem_gnt    (data_gnt),
+      .host_dmem_we     (data_we),
+      .host_dmem_addr   (data_addr),
+      .host_dmem_be     (data_be),
+      .host_dmem_wdata  (data_wdata),
 
-      .host_dmem_rvalid (host_rvalid[CoreD]),
-      .host_dmem_rdata  (host_rdata[CoreD]),
-      .host_dmem_err    (host_err[CoreD])
+      .host_dmem_rvalid (data_rvalid),
+      .host_dmem_rdata  (data_rdata),
+      .host_dmem_err    (data_err)
     );
 endmodule
@@ -2,10 +2,19 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <getopt.h>
 #include <svdpi.h>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
+#include <string>
+#include <thread>
 #include "cosim.h"
+#include "cosim_dpi.h"
+#include "cosim_log.h"
+#include "pipelined_cosim.h"
 #include "ibex_simple_system.h"
 #include "spike_cosim.h"
 #include "verilator_memutil.h"
@@ -15,27 +24,111 @@ class SimpleSystemCosim : public SimpleSystem {
   std::unique_ptr<SpikeCosim> _cosim;
 
   SimpleSystemCosim(const char *ram_hier_path, int ram_size_words)
-      : SimpleSystem(ram_hier_path, ram_size_words), _cosim(nullptr) {}
+      : SimpleSystem(ram_hier_path, ram_size_words),
+        _cosim(nullptr),
+        _bbv_interval(kDefaultBBVInterval),
+        _direct_fetch(false),
+        _pipeline_lag(0),
+        _batch_size(1) {}
 
-  ~SimpleSystemCosim() {}
+  ~SimpleSystemCosim() { cosim_dpi_stop_recording(); }
+
+  // Checker thread wrapping `_cosim` when `--cosim-pipeline` is used. Declared
+  // last so its thread is stopped before the Cosim it drives is destroyed.
+  std::unique_ptr<PipelinedCosim> _pipeline;
+
+  void CreateCosim(bool secure_ibex, bool icache_en, bool dcache_en,
+                   uint32_t pmp_num_regions, uint32_t pmp_granularity,
+                   uint32_t mhpm_counter_num) {
+    CosimLogConfig config = {.isa_string = GetIsaString(),
+                             .start_pc = 0x100080,
+                             .start_mtvec = 0x100001,
+                             .secure_ibex = secure_ibex,
+                             .icache_en = icache_en,
+                             .dcache_en = dcache_en,
+                             .pmp_num_regions = pmp_num_regions,
+                             .pmp_granularity = pmp_granularity,
+                             .mhpm_counter_num = mhpm_counter_num};
 
-  void CreateCosim(bool secure_ibex, bool icache_en, uint32_t pmp_num_regions,
-                   uint32_t pmp_granularity, uint32_t mhpm_counter_num) {
     _cosim = std::make_unique<SpikeCosim>(
-        GetIsaString(), 0x100080, 0x100001, "simple_system_cosim.log",
-        secure_ibex, icache_en, pmp_num_regions, pmp_granularity,
-        mhpm_counter_num);
+        config.isa_string, config.start_pc, config.start_mtvec,
+        "simple_system_cosim.log", config.secure_ibex, config.icache_en,
+        config.dcache_en, config.pmp_num_regions, config.pmp_granularity,
+        config.mhpm_counter_num);
+
+    // Calls from the checker are recorded in the DPI layer, with no path given
+    // this falls back to IBEX_COSIM_RECORD.
+    cosim_dpi_start_recording(_record_path, config);
+
+    if (_pipeline_lag != 0) {
+      // With a single CPU the checker thread can't overlap the simulation and
+      // queueing each call only adds overhead.
+      if (std::thread::hardware_concurrency() < 2) {
+        std::cerr << "WARNING: --cosim-pipeline on a single CPU host will slow "
+                     "the simulation down"
+                  << std::endl;
+      }
+
+      _pipeline = std::make_unique<PipelinedCosim>(GetCosim(), _pipeline_lag);
+    }
 
-    _cosim->add_memory(0x100000, 1024 * 1024);
-    _cosim->add_memory(0x20000, 4096);
+    cosim_dpi_add_memory(GetCosim(), 0x100000, 1024 * 1024);
+    cosim_dpi_add_memory(GetCosim(), 0x20000, 4096);
 
     CopyMemAreaToCosim(&_ram, 0x100000);
+
+    if (!_bbv_path.empty()) {
+      _cosim->enable_bbv_profile(_bbv_path, _bbv_interval);
+    }
+
+    if (_direct_fetch) {
+      _cosim->enable_direct_fetch();
+    }
+
+    _cosim_start = std::chrono::steady_clock::now();
+  }
+
+  unsigned int GetBatchSize() const { return _batch_size; }
+
+  // The Cosim the testbench drives
+  Cosim *GetCosim() {
+    if (_pipeline) {
+      return _pipeline.get();
+    }
+
+    return _cosim.get();
   }
 
  protected:
+  static constexpr uint64_t kDefaultBBVInterval = 100000;
+  static constexpr unsigned int kDefaultPipelineLag = 1024;
+
+  // Basic-block vector profile output, empty if profiling is disabled
+  std::string _bbv_path;
+  uint64_t _bbv_interval;
+
+  // Let spike fetch instructions directly from its memory model, see
+  // SpikeCosim::enable_direct_fetch
+  bool _direct_fetch;
+
+  std::chrono::steady_clock::time_point _cosim_start;
+
+  // Maximum number of steps the simulation may run ahead of the checker
+  // thread, 0 if checking isn't pipelined
+  unsigned int _pipeline_lag;
+
+  // Number of retired instructions the checker passes to the co-simulator in
+  // each riscv_cosim_step_batch call
+  unsigned int _batch_size;
+
+  // Log of Cosim calls for cosim_replay and cosim_step_bench, empty to use
+  // IBEX_COSIM_RECORD
+  std::string _record_path;
+
   void CopyMemAreaToCosim(MemArea *area, uint32_t base_addr) {
     auto mem_data = area->Read(0, area->GetSizeWords());
-    _cosim->backdoor_write_mem(base_addr, area->GetSizeBytes(), &mem_data[0]);
+    cosim_dpi_backdoor_write_mem(GetCosim(), base_addr, area->GetSizeBytes(),
+                                 &mem_data[0]);
   }
 
   virtual int Setup(int argc, char **argv, bool &exit_app) override {
@@ -44,12 +137,121 @@ class SimpleSystemCosim : public SimpleSystem {
       return ret_code;
     }
 
+    if (!ParseCosimArgs(argc, argv)) {
+      exit_app = true;
+      return 1;
+    }
+
     return 0;
   }
 
+  // Parse co-simulation specific command line arguments. Unrecognised
+  // arguments are ignored as they are consumed by the simulation controller
+  // and its extensions.
+  bool ParseCosimArgs(int argc, char **argv) {
+    const struct option long_options[] = {
+        {"bbv-profile", required_argument, nullptr, 'b'},
+        {"bbv-interval", required_argument, nullptr, 'i'},
+        {"cosim-direct-fetch", no_argument, nullptr, 'd'},
+        {"cosim-record", required_argument, nullptr, 'r'},
+        {"cosim-pipeline", optional_argument, nullptr, 'p'},
+        {"cosim-batch", required_argument, nullptr, 'n'},
+        {nullptr, no_argument, nullptr, 0}};
+
+    optind = 1;
+    opterr = 0;
+    while (1) {
+      int c = getopt_long(argc, argv, "-:", long_options, nullptr);
+      if (c == -1) {
+        break;
+      }
+
+      switch (c) {
+        case 'b':
+          _bbv_path = optarg;
+          break;
+        case 'i': {
+          char *arg_end;
+          _bbv_interval = strtoull(optarg, &arg_end, 0);
+          if (*arg_end || _bbv_interval == 0) {
+            std::cerr << "ERROR: Bad --bbv-interval argument: `" << optarg
+                      << "' is not a positive integer." << std::endl;
+            return false;
+          }
+          break;
+        }
+        case 'd':
+          _direct_fetch = true;
+          break;
+        case 'r':
+          _record_path = optarg;
+          break;
+        case 'p': {
+          _pipeline_lag = kDefaultPipelineLag;
+          if (optarg) {
+            char *arg_end;
+            _pipeline_lag = strtoul(optarg, &arg_end, 0);
+            if (*arg_end || _pipeline_lag == 0) {
+              std::cerr << "ERROR: Bad --cosim-pipeline argument: `" << optarg
+                        << "' is not a positive integer." << std::endl;
+              return false;
+            }
+          }
+          break;
+        }
+        case 'n': {
+          char *arg_end;
+          _batch_size = strtoul(optarg, &arg_end, 0);
+          if (*arg_end || _batch_size == 0 ||
+              _batch_size > kCosimDpiMaxBatch) {
+            std::cerr << "ERROR: Bad --cosim-batch argument: `" << optarg
+                      << "' is not between 1 and " << kCosimDpiMaxBatch << "."
+                      << std::endl;
+            return false;
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+
+    return true;
+  }
+
   virtual bool Finish() {
-    std::cout << "Co-simulation matched " << _cosim->get_insn_cnt()
-              << " instructions\n";
+    // The checker thread may still be working through the final steps or the
+    // checker's last batch was only stepped as the simulation ended, a mismatch
+    // in those hasn't been reported by the testbench yet.
+    const std::vector<std::string> &errors = GetCosim()->get_errors();
+    if (!errors.empty()) {
+      std::cout << "FAILURE: Co-simulation mismatch at end of simulation\n";
+      for (auto &err : errors) {
+        std::cout << err << "\n";
+      }
+
+      return false;
+    }
+
+    unsigned int insn_cnt = GetCosim()->get_insn_cnt();
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - _cosim_start;
+
+    std::cout << "Co-simulation matched " << insn_cnt << " instructions\n";
+    std::cout << "Co-simulation wall time: " << elapsed.count() << " s\n";
+    if (elapsed.count() > 0) {
+      std::cout << "Co-simulation speed: "
+                << static_cast<uint64_t>(insn_cnt / elapsed.count())
+                << " steps/s\n";
+    }
+    if (insn_cnt > 0) {
+      uint64_t dpi_calls = cosim_dpi_get_num_calls();
+      std::cout << "Co-simulation DPI calls: " << dpi_calls << " ("
+                << static_cast<double>(dpi_calls) / insn_cnt
+                << " per instruction, batch size " << _batch_size << ")\n";
+    }
+    _cosim->print_insn_class_stats(std::cout);
 
     return SimpleSystem::Finish();
   }
@@ -64,16 +266,23 @@ void *get_spike_cosim() {
   assert(simple_system_cosim);
   assert(simple_system_cosim->_cosim);
 
-  return static_cast<Cosim *>(simple_system_cosim->_cosim.get());
+  return simple_system_cosim->GetCosim();
+}
+
+unsigned int get_cosim_batch_size() {
+  assert(simple_system_cosim);
+
+  return simple_system_cosim->GetBatchSize();
 }
 
-void create_cosim(svBit secure_ibex, svBit icache_en,
+void create_cosim(svBit secure_ibex, svBit icache_en, svBit dcache_en,
                   const svBitVecVal *pmp_num_regions,
                   const svBitVecVal *pmp_granularity,
                   const svBitVecVal *mhpm_counter_num) {
   assert(simple_system_cosim);
-  simple_system_cosim->CreateCosim(secure_ibex, icache_en, pmp_num_regions[0],
-                                   pmp_granularity[0], mhpm_counter_num[0]);
+  simple_system_cosim->CreateCosim(secure_ibex, icache_en, dcache_en,
+                                   pmp_num_regions[0], pmp_granularity[0],
+                                   mhpm_counter_num[0]);
 }
 }
 
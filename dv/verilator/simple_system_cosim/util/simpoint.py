@@ -0,0 +1,319 @@
+#!/usr/bin/env python3
+
+# Copyright lowRISC contributors.
+# Licensed under the Apache License, Version 2.0, see LICENSE for details.
+# SPDX-License-Identifier: Apache-2.0
+
+'''Choose representative simulation points from a basic-block vector profile
+
+Reads a basic-block vector (BBV) profile in SimPoint `.bb` format, as written
+by the simple system co-simulation with `--bbv-profile`, clusters the
+intervals and picks one representative interval per cluster. The chosen
+intervals and their weights are written in the SimPoint `.simpoints` /
+`.weights` formats.
+
+When the matching `.cycles` file is available the weighted CPI of the chosen
+intervals is reported alongside the CPI of the full run, the actual error of
+the estimate and a 95% confidence bound on that error derived from the CPI
+spread within each cluster.
+
+The CPI of each chosen interval comes from the full run that recorded the
+profile, so the estimate validates the choice of intervals. No sampled
+simulation of the intervals is run, the simple system can't checkpoint or
+fast-forward the RTL to the start of an interval.
+'''
+
+import argparse
+import math
+import random
+import sys
+from typing import Dict, List, Optional, Tuple
+
+# Dimension the BBVs are randomly projected down to before clustering. This
+# matches the SimPoint default.
+_PROJECTED_DIMS = 15
+
+BBV = Dict[int, int]
+Point = List[float]
+
+
+def read_bbv(path: str) -> List[BBV]:
+    '''Read a SimPoint `.bb` file, returning one {block: count} per interval'''
+    intervals = []
+    with open(path) as bb_file:
+        for line_num, line in enumerate(bb_file, 1):
+            line = line.strip()
+            if not line:
+                continue
+
+            if not line.startswith('T'):
+                raise ValueError(f'{path}:{line_num}: Expected line to '
+                                 f'start with "T"')
+
+            bbv = {}
+            for entry in line[1:].split():
+                _, block, count = entry.split(':')
+                bbv[int(block)] = int(count)
+
+            intervals.append(bbv)
+
+    return intervals
+
+
+def read_cycles(path: str) -> List[Tuple[int, int]]:
+    '''Read a `.cycles` file, returning (insns, cycles) per interval'''
+    cycles = []
+    with open(path) as cycles_file:
+        for line in cycles_file:
+            if line.strip():
+                insns, cyc = line.split()
+                cycles.append((int(insns), int(cyc)))
+
+    return cycles
+
+
+def project(intervals: List[BBV], dims: int, seed: int) -> List[Point]:
+    '''Normalise each BBV and randomly project it down to `dims` dimensions'''
+    rng = random.Random(seed)
+    projection: Dict[int, Point] = {}
+
+    points = []
+    for bbv in intervals:
+        total = sum(bbv.values())
+        point = [0.0] * dims
+        for block, count in bbv.items():
+            row = projection.get(block)
+            if row is None:
+                row = [rng.uniform(-1.0, 1.0) for _ in range(dims)]
+                projection[block] = row
+
+            frac = count / total
+            for i in range(dims):
+                point[i] += frac * row[i]
+
+        points.append(point)
+
+    return points
+
+
+def dist2(a: Point, b: Point) -> float:
+    return sum((x - y) * (x - y) for x, y in zip(a, b))
+
+
+def kmeans(points: List[Point], k: int, seed: int,
+           max_iters: int = 100) -> Tuple[List[int], List[Point]]:
+    '''Cluster `points` into `k` clusters using k-means++ initialisation
+
+    Returns the cluster index of each point and the cluster centroids.
+    '''
+    rng = random.Random(seed)
+
+    centroids = [list(rng.choice(points))]
+    while len(centroids) < k:
+        weights = [min(dist2(p, c) for c in centroids) for p in points]
+        total = sum(weights)
+        if total == 0:
+            break
+
+        target = rng.uniform(0, total)
+        acc = 0.0
+        for p, w in zip(points, weights):
+            acc += w
+            if acc >= target:
+                centroids.append(list(p))
+                break
+
+    labels = [0] * len(points)
+    for iteration in range(max_iters):
+        new_labels = [min(range(len(centroids)),
+                          key=lambda c: dist2(p, centroids[c]))
+                      for p in points]
+
+        if new_labels == labels and iteration != 0:
+            break
+
+        labels = new_labels
+        for c in range(len(centroids)):
+            members = [p for p, lbl in zip(points, labels) if lbl == c]
+            if members:
+                centroids[c] = [sum(coords) / len(members)
+                                for coords in zip(*members)]
+
+    return labels, centroids
+
+
+def bic(points: List[Point], labels: List[int],
+        centroids: List[Point]) -> float:
+    '''Bayesian information criterion of a clustering (spherical Gaussians)'''
+    n = len(points)
+    k = len(centroids)
+    d = len(points[0])
+
+    sse = sum(dist2(p, centroids[lbl]) for p, lbl in zip(points, labels))
+    if n <= k or sse == 0:
+        return math.inf
+
+    variance = sse / (d * (n - k))
+
+    log_likelihood = 0.0
+    for c in range(k):
+        n_c = labels.count(c)
+        if n_c == 0:
+            continue
+
+        log_likelihood += (n_c * math.log(n_c) - n_c * math.log(n) -
+                           n_c * d / 2 * math.log(2 * math.pi * variance) -
+                           d * (n_c - 1) / 2)
+
+    num_params = k - 1 + k * d + 1
+    return log_likelihood - num_params / 2 * math.log(n)
+
+
+def choose_clustering(points: List[Point], max_k: int,
+                      seed: int) -> Tuple[List[int], List[Point]]:
+    '''Pick the smallest k whose BIC is within 90% of the best seen
+
+    This is the heuristic SimPoint uses to trade off the number of simulation
+    points against how well they represent the whole run.
+    '''
+    max_k = min(max_k, len(points))
+    results = []
+    for k in range(1, max_k + 1):
+        labels, centroids = kmeans(points, k, seed)
+        results.append((bic(points, labels, centroids), labels, centroids))
+
+    scores = [score for score, _, _ in results if math.isfinite(score)]
+    if not scores:
+        # Every interval is identical (or each is its own cluster), the first
+        # clustering is as good as any.
+        return results[0][1], results[0][2]
+
+    lo, hi = min(scores), max(scores)
+    threshold = lo + 0.9 * (hi - lo)
+    for score, labels, centroids in results:
+        if not math.isfinite(score) or score >= threshold:
+            return labels, centroids
+
+    return results[-1][1], results[-1][2]
+
+
+def pick_simpoints(points: List[Point], labels: List[int],
+                   centroids: List[Point],
+                   insns: List[int]) -> List[Tuple[int, int, float]]:
+    '''Pick the interval closest to each centroid
+
+    Returns (interval, cluster, weight) for each non-empty cluster, where the
+    weight is the fraction of all retired instructions in that cluster.
+    '''
+    total_insns = sum(insns)
+    simpoints = []
+    for c, centroid in enumerate(centroids):
+        members = [i for i, lbl in enumerate(labels) if lbl == c]
+        if not members:
+            continue
+
+        rep = min(members, key=lambda i: dist2(points[i], centroid))
+        weight = sum(insns[i] for i in members) / total_insns
+        simpoints.append((rep, c, weight))
+
+    return simpoints
+
+
+def estimate_cpi(simpoints: List[Tuple[int, int, float]], labels: List[int],
+                 cycles: List[Tuple[int, int]]) -> Tuple[float, float, float]:
+    '''Estimate CPI from the simulation points
+
+    Returns the weighted CPI estimate, the CPI of the full run and a 95%
+    confidence bound on the estimate error. The bound treats each
+    representative as a single sample from its cluster, so its variance is the
+    CPI variance within that cluster.
+    '''
+    cpi = [cyc / insns if insns else 0.0 for insns, cyc in cycles]
+
+    estimate = sum(weight * cpi[rep] for rep, _, weight in simpoints)
+
+    total_insns = sum(insns for insns, _ in cycles)
+    total_cycles = sum(cyc for _, cyc in cycles)
+    full = total_cycles / total_insns
+
+    variance = 0.0
+    for _, c, weight in simpoints:
+        members = [cpi[i] for i, lbl in enumerate(labels) if lbl == c]
+        mean = sum(members) / len(members)
+        var_c = sum((x - mean) ** 2 for x in members) / len(members)
+        variance += weight * weight * var_c
+
+    return estimate, full, 1.96 * math.sqrt(variance)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('bbv', help='BBV profile (.bb) to read')
+    parser.add_argument('--cycles',
+                        help='Per-interval cycle counts (default: BBV.cycles '
+                             'if it exists)')
+    parser.add_argument('--max-k', type=int, default=30,
+                        help='Maximum number of clusters to consider')
+    parser.add_argument('--seed', type=int, default=1,
+                        help='Seed for projection and k-means')
+    parser.add_argument('--out',
+                        help='Output prefix for .simpoints and .weights '
+                             '(default: BBV without its extension)')
+    args = parser.parse_args()
+
+    intervals = read_bbv(args.bbv)
+    if not intervals:
+        print(f'No intervals found in {args.bbv}', file=sys.stderr)
+        return 1
+
+    cycles_path = args.cycles
+    if cycles_path is None:
+        cycles_path = args.bbv + '.cycles'
+
+    cycles: Optional[List[Tuple[int, int]]]
+    try:
+        cycles = read_cycles(cycles_path)
+    except FileNotFoundError:
+        if args.cycles is not None:
+            raise
+        cycles = None
+
+    if cycles is not None and len(cycles) != len(intervals):
+        print(f'{cycles_path} has {len(cycles)} intervals but {args.bbv} '
+              f'has {len(intervals)}', file=sys.stderr)
+        return 1
+
+    points = project(intervals, _PROJECTED_DIMS, args.seed)
+    labels, centroids = choose_clustering(points, args.max_k, args.seed)
+    insns = [sum(bbv.values()) for bbv in intervals]
+    simpoints = pick_simpoints(points, labels, centroids, insns)
+
+    out = args.out
+    if out is None:
+        out = args.bbv.rsplit('.', 1)[0]
+
+    with open(out + '.simpoints', 'w') as sp_file, \
+            open(out + '.weights', 'w') as w_file:
+        for rep, c, weight in simpoints:
+            sp_file.write(f'{rep} {c}\n')
+            w_file.write(f'{weight:.6f} {c}\n')
+
+    print(f'Intervals:         {len(intervals)}')
+    print(f'Simulation points: {len(simpoints)}')
+    for rep, c, weight in simpoints:
+        print(f'  interval {rep:6d} (cluster {c:3d}) weight {weight:.4f}')
+
+    if cycles is not None:
+        estimate, full, bound = estimate_cpi(simpoints, labels, cycles)
+        sampled_insns = sum(cycles[rep][0] for rep, _, _ in simpoints)
+        total_insns = sum(i for i, _ in cycles)
+        print(f'Simulated fraction: {sampled_insns / total_insns:.2%}')
+        print(f'Estimated CPI:      {estimate:.4f} +/- {bound:.4f} (95%)')
+        print(f'Full run CPI:       {full:.4f}')
+        print(f'Estimate error:     {(estimate - full) / full:+.2%}')
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -3,7 +3,10 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <getopt.h>
 #include <iostream>
 
 #include "Vibex_simple_system__Syms.h"
@@ -13,8 +16,186 @@
 #include "verilator_memutil.h"
 #include "verilator_sim_ctrl.h"
 
+// DPI exports, defined in ibex_simple_system.sv and timer.sv
+extern "C" {
+extern svBit simple_system_core_idle();
+extern unsigned long long timer_cycles_to_interrupt();
+extern void timer_skip_cycles(unsigned long long cycles);
+extern void mem_timing_set_region(unsigned int index, unsigned int base,
+                                  unsigned int mask, unsigned int read_latency,
+                                  unsigned int write_latency);
+extern void mem_timing_set(unsigned int jitter, unsigned int stall_pct,
+                           unsigned int bw_accesses, unsigned int bw_window,
+                           unsigned int seed);
+}
+
+void SimpleSystemIdleSkip::PreExec() {
+  _top_scope = svGetScopeFromName("TOP.ibex_simple_system");
+  _timer_scope = svGetScopeFromName("TOP.ibex_simple_system.u_timer");
+  assert(_top_scope && _timer_scope);
+}
+
+unsigned long SimpleSystemIdleSkip::IdleCycles(unsigned long sim_time) {
+  svScope prev_scope = svSetScope(_top_scope);
+  bool idle = simple_system_core_idle();
+
+  unsigned long long cycles = 0;
+  if (idle) {
+    // The timer interrupt is raised the cycle after mtime reaches mtimecmp.
+    // Stop one cycle short of that so the core wakes up in a simulated cycle.
+    svSetScope(_timer_scope);
+    cycles = timer_cycles_to_interrupt();
+    cycles = cycles > 0 ? cycles - 1 : 0;
+  }
+
+  svSetScope(prev_scope);
+  return cycles;
+}
+
+void SimpleSystemIdleSkip::SkipCycles(unsigned long cycles) {
+  svScope prev_scope = svSetScope(_timer_scope);
+  timer_skip_cycles(cycles);
+  svSetScope(prev_scope);
+}
+
+// Parse an unsigned number no larger than max, up to the first character in
+// stop (or the end of the string). Returns false if there isn't one.
+static bool ParseNumber(const char *&str, const char *stop, unsigned long max,
+                        uint32_t &value) {
+  char *end;
+  unsigned long parsed = strtoul(str, &end, 0);
+  if (end == str || parsed > max || (*end && !strchr(stop, *end))) {
+    return false;
+  }
+
+  value = parsed;
+  str = *end ? end + 1 : end;
+  return true;
+}
+
+SimpleSystemMemTiming::SimpleSystemMemTiming()
+    : _jitter(0), _stall_pct(0), _bw_accesses(0), _bw_window(0), _seed(0) {}
+
+bool SimpleSystemMemTiming::ParseRegion(const char *arg) {
+  uint32_t size;
+  Region region;
+
+  if (!ParseNumber(arg, ":", 0xffffffff, region.base) ||
+      !ParseNumber(arg, ":", 0xffffffff, size) ||
+      !ParseNumber(arg, ":", 0xffff, region.read_latency)) {
+    return false;
+  }
+
+  region.write_latency = region.read_latency;
+  if (*arg && !ParseNumber(arg, "", 0xffff, region.write_latency)) {
+    return false;
+  }
+
+  // The region is matched with a mask, so must be naturally aligned
+  if (size == 0 || (size & (size - 1)) || (region.base & (size - 1)) ||
+      region.read_latency == 0 || region.write_latency == 0) {
+    return false;
+  }
+
+  region.mask = ~(size - 1);
+  _regions.push_back(region);
+  return true;
+}
+
+bool SimpleSystemMemTiming::ParseCLIArguments(int argc, char **argv,
+                                              bool &exit_app) {
+  const struct option long_options[] = {
+      {"mem-region", required_argument, nullptr, 'r'},
+      {"mem-jitter", required_argument, nullptr, 'j'},
+      {"mem-stall", required_argument, nullptr, 's'},
+      {"mem-bandwidth", required_argument, nullptr, 'b'},
+      {"mem-seed", required_argument, nullptr, 'e'},
+      {"help", no_argument, nullptr, 'h'},
+      {nullptr, no_argument, nullptr, 0}};
+
+  // Reset the command parsing index in-case other utils have already parsed
+  // some arguments
+  optind = 1;
+  while (1) {
+    int c = getopt_long(argc, argv, "-:h", long_options, nullptr);
+    if (c == -1) {
+      break;
+    }
+
+    // Disable error reporting by getopt
+    opterr = 0;
+
+    const char *arg = optarg;
+    bool ok = true;
+    switch (c) {
+      case 'r':
+        ok = _regions.size() < static_cast<size_t>(kNumRegions) &&
+             ParseRegion(arg);
+        break;
+      case 'j':
+        ok = ParseNumber(arg, "", 0xffff, _jitter);
+        break;
+      case 's':
+        ok = ParseNumber(arg, "", 99, _stall_pct);
+        break;
+      case 'b':
+        ok = ParseNumber(arg, "/", 0xffff, _bw_accesses) &&
+             ParseNumber(arg, "", 0xffff, _bw_window) && _bw_accesses != 0 &&
+             _bw_window != 0;
+        break;
+      case 'e':
+        ok = ParseNumber(arg, "", 0xffffffff, _seed);
+        break;
+      case 'h':
+        std::cout << "--mem-region=BASE:SIZE:READ[:WRITE]\n"
+                     "  Reads from (writes to) the SIZE bytes at BASE take\n"
+                     "  READ (WRITE) cycles, up to "
+                  << kNumRegions
+                  << " regions\n\n"
+                     "--mem-jitter=N\n"
+                     "  Add 0 to N random cycles to every memory access\n\n"
+                     "--mem-stall=PERCENT\n"
+                     "  Withhold the memory grant in PERCENT of cycles\n\n"
+                     "--mem-bandwidth=N/CYCLES\n"
+                     "  Grant at most N accesses per port every CYCLES\n"
+                     "  cycles\n\n"
+                     "--mem-seed=SEED\n"
+                     "  Seed for the random jitter and stalls\n\n";
+        break;
+      default:
+        // Ignore options handled elsewhere
+        break;
+    }
+
+    if (!ok) {
+      std::cerr << "ERROR: Bad memory timing argument `" << optarg << "'."
+                << std::endl;
+      exit_app = true;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void SimpleSystemMemTiming::PreExec() {
+  svScope scope = svGetScopeFromName("TOP.ibex_simple_system");
+  assert(scope);
+
+  svScope prev_scope = svSetScope(scope);
+  for (size_t i = 0; i < _regions.size(); ++i) {
+    const Region &region = _regions[i];
+    mem_timing_set_region(i, region.base, region.mask, region.read_latency,
+                          region.write_latency);
+  }
+  mem_timing_set(_jitter, _stall_pct, _bw_accesses, _bw_window, _seed);
+  svSetScope(prev_scope);
+}
+
 SimpleSystem::SimpleSystem(const char *ram_hier_path, int ram_size_words)
-    : _ram(ram_hier_path, ram_size_words, 4) {}
+    : _ext_bench(&_top.ibex_simple_system->sim_cycle_cnt_q),
+      _pcount_sampler("TOP.ibex_simple_system"),
+      _ram(ram_hier_path, ram_size_words, 4) {}
 
 int SimpleSystem::Main(int argc, char **argv) {
   bool exit_app;
@@ -62,6 +243,9 @@ std::string SimpleSystem::GetIsaString() const {
       break;
   }
 
+  if (top.ibex_simple_system->RV32F)
+    extensions += "_Zfinx";
+
   return base + extensions;
 }
 
@@ -73,6 +257,12 @@ int SimpleSystem::Setup(int argc, char **argv, bool &exit_app) {
 
   _memutil.RegisterMemoryArea("ram", kRAM_BaseAddr, &_ram);
   simctrl.RegisterExtension(&_memutil);
+  simctrl.RegisterExtension(&_idle_skip);
+  simctrl.RegisterExtension(&_mem_timing);
+  if (ExtensionBenchmark::Requested(argc, argv)) {
+    simctrl.RegisterExtension(&_ext_bench);
+  }
+  simctrl.RegisterExtension(&_pcount_sampler);
 
   exit_app = false;
   return simctrl.ParseCommandArgs(argc, argv, exit_app);
@@ -2,9 +2,81 @@
 // Licensed under the Apache License, Version 2.0, see LICENSE for details.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <cstdint>
+#include <vector>
+
+#include <svdpi.h>
+
+#include "ext_bench.h"
+#include "ibex_pcount_sampler.h"
+#include "sim_ctrl_extension.h"
 #include "verilated_toplevel.h"
 #include "verilator_memutil.h"
 
+// Simulation controller extension that lets idle cycles be skipped (with
+// --skip-idle-cycles) while the core is asleep waiting for the timer interrupt.
+// The timer's mtime is advanced to match.
+class SimpleSystemIdleSkip : public SimCtrlExtension {
+ public:
+  SimpleSystemIdleSkip() : _top_scope(nullptr), _timer_scope(nullptr) {}
+
+  void PreExec() override;
+  bool NeedsOnClock() const override { return false; }
+  unsigned long IdleCycles(unsigned long sim_time) override;
+  void SkipCycles(unsigned long cycles) override;
+
+ private:
+  svScope _top_scope;
+  svScope _timer_scope;
+};
+
+// Simulation controller extension that configures the memory timing models
+// (shared/rtl/sim/mem_timing.sv) in front of the instruction and data ports,
+// so performance features can be evaluated against slower memory than the
+// single cycle RAM. Without any of its options the timing is unchanged.
+//
+//   --mem-region=BASE:SIZE:READ[:WRITE]
+//     Reads from (writes to) the SIZE bytes at BASE take READ (WRITE) cycles
+//     from the grant to the response. SIZE must be a power of two and BASE a
+//     multiple of it. Can be given up to kNumRegions times, the first region
+//     containing an address is used.
+//   --mem-jitter=N
+//     Add 0 to N random cycles to the latency of every access.
+//   --mem-stall=PERCENT
+//     Withhold the grant in PERCENT of the cycles a request is made.
+//   --mem-bandwidth=N/CYCLES
+//     Grant at most N accesses on each port in every CYCLES cycles.
+//   --mem-seed=SEED
+//     Seed for the random jitter and stalls.
+class SimpleSystemMemTiming : public SimCtrlExtension {
+ public:
+  // Must match MemTimingNumRegions in ibex_simple_system.sv
+  static constexpr int kNumRegions = 4;
+
+  SimpleSystemMemTiming();
+
+  bool ParseCLIArguments(int argc, char **argv, bool &exit_app) override;
+  void PreExec() override;
+  bool NeedsOnClock() const override { return false; }
+
+ private:
+  struct Region {
+    uint32_t base;
+    uint32_t mask;
+    uint32_t read_latency;
+    uint32_t write_latency;
+  };
+
+  std::vector<Region> _regions;
+  uint32_t _jitter;
+  uint32_t _stall_pct;
+  uint32_t _bw_accesses;
+  uint32_t _bw_window;
+  uint32_t _seed;
+
+  bool ParseRegion(const char *arg);
+};
+
 class SimpleSystem {
  public:
   static constexpr uint32_t kRAM_BaseAddr = 0x100000u;
@@ -21,6 +93,10 @@ class SimpleSystem {
  protected:
   ibex_simple_system _top;
   VerilatorMemUtil _memutil;
+  SimpleSystemIdleSkip _idle_skip;
+  SimpleSystemMemTiming _mem_timing;
+  ExtensionBenchmark _ext_bench;
+  PcountSampler _pcount_sampler;
   MemArea _ram;
 
   virtual int Setup(int argc, char **argv, bool &exit_app);
@@ -14,6 +14,10 @@
   `define RV32B ibex_pkg::RV32BNone
 `endif
 
+`ifndef RV32F
+  `define RV32F ibex_pkg::RV32FNone
+`endif
+
 `ifndef RegFile
   `define RegFile ibex_pkg::RegFileFF
 `endif
@@ -44,14 +48,28 @@ module ibex_simple_system (
   parameter int unsigned        MHPMCounterWidth         = 40;
   parameter bit                 RV32E                    = 1'b0;
   parameter ibex_pkg::rv32m_e   RV32M                    = `RV32M;
+  parameter bit                 RV32MFastDiv             = 1'b0;
   parameter ibex_pkg::rv32b_e   RV32B                    = `RV32B;
+  parameter ibex_pkg::rv32f_e   RV32F                    = `RV32F;
+  parameter bit                 SoftFloatAssist          = 1'b0;
   parameter ibex_pkg::regfile_e RegFile                  = `RegFile;
   parameter bit                 BranchTargetALU          = 1'b0;
   parameter bit                 WritebackStage           = 1'b0;
+  parameter bit                 LoadPipelining           = 1'b0;
+  parameter bit                 MacroOpFusion            = 1'b0;
   parameter bit                 ICache                   = 1'b0;
   parameter bit                 DbgTriggerEn             = 1'b0;
   parameter bit                 ICacheECC                = 1'b0;
+  parameter int unsigned        ICacheSizeBytes          = 4096;
+  parameter int unsigned        ICacheNumWays            = 2;
+  parameter int unsigned        ICacheLineSize           = 64;
+  parameter bit                 ICachePrefetch           = 1'b0;
+  parameter bit                 DCache                   = 1'b0;
+  parameter int unsigned        DCacheSizeBytes          = 1024;
+  parameter int unsigned        DCacheNumWays            = 2;
   parameter bit                 BranchPredictor          = 1'b0;
+  parameter bit                 BranchPredictorDynamic   = 1'b0;
+  parameter bit                 ReturnAddrStack          = 1'b0;
   parameter                     SRAMInitFile             = "";
 
   logic clk_sys = 1'b0, rst_sys_n;
@@ -72,6 +90,12 @@ module ibex_simple_system (
   // interrupts
   logic timer_irq;
 
+  logic core_sleep;
+
+  // performance counter sample markers written by software
+  logic        pcount_marker_valid;
+  logic [31:0] pcount_marker;
+
   // host and device signals
   logic           host_req    [NrHosts];
   logic           host_gnt    [NrHosts];
@@ -114,8 +138,40 @@ module ibex_simple_system (
   logic [31:0] instr_rdata;
   logic instr_err;
 
-  assign instr_gnt = instr_req;
-  assign instr_err = '0;
+  // Data signals, between the core and the memory timing model in front of the bus
+  logic data_req;
+  logic data_gnt;
+  logic data_rvalid;
+  logic data_we;
+  logic [3:0] data_be;
+  logic [31:0] data_addr;
+  logic [31:0] data_wdata;
+  logic [31:0] data_rdata;
+  logic data_err;
+
+  // Instruction fetches from the RAM, after the memory timing model
+  logic ram_instr_req;
+  logic ram_instr_rvalid;
+  logic [31:0] ram_instr_rdata;
+
+  logic instr_mem_busy;
+  logic data_mem_busy;
+
+  // Memory timing model configuration, set from the simulator command line through the
+  // mem_timing_set_* DPI exports (see SimpleSystemMemTiming in ibex_simple_system.h). The defaults
+  // leave the timing of the RAM and peripherals unchanged.
+  localparam int unsigned MemTimingNumRegions = 4;
+
+  logic        mem_region_en         [MemTimingNumRegions] = '{default: 1'b0};
+  logic [31:0] mem_region_base       [MemTimingNumRegions] = '{default: 32'h0};
+  logic [31:0] mem_region_mask       [MemTimingNumRegions] = '{default: 32'h0};
+  logic [15:0] mem_region_rd_latency [MemTimingNumRegions] = '{default: 16'h0};
+  logic [15:0] mem_region_wr_latency [MemTimingNumRegions] = '{default: 16'h0};
+  logic [15:0] mem_jitter      = '0;
+  logic [ 6:0] mem_stall_pct   = '0;
+  logic [15:0] mem_bw_accesses = '0;
+  logic [15:0] mem_bw_window   = '0;
+  logic [31:0] mem_seed        = '0;
 
   `ifdef VERILATOR
     assign clk_sys = IO_CLK;
@@ -173,7 +229,7 @@ module ibex_simple_system (
     logic [31:0] unused_instr_rdata;
 
     prim_secded_inv_39_32_enc u_data_rdata_intg_gen (
-      .data_i (host_rdata[CoreD]),
+      .data_i (data_rdata),
       .data_o ({data_rdata_intg, unused_data_rdata})
     );
 
@@ -196,13 +252,33 @@ module ibex_simple_system (
       .MHPMCounterWidth( MHPMCounterWidth ),
       .RV32E           ( RV32E            ),
       .RV32M           ( RV32M            ),
+      .RV32MFastDiv    ( RV32MFastDiv     ),
       .RV32B           ( RV32B            ),
+      .RV32F           ( RV32F            ),
+      .SoftFloatAssist ( SoftFloatAssist  ),
       .RegFile         ( RegFile          ),
       .BranchTargetALU ( BranchTargetALU  ),
       .ICache          ( ICache           ),
       .ICacheECC       ( ICacheECC        ),
+      .ICacheSizeBytes ( ICacheSizeBytes  ),
+      .ICacheNumWays   ( ICacheNumWays    ),
+      .ICacheLineSize  ( ICacheLineSize   ),
+      .ICachePrefetch  ( ICachePrefetch   ),
+      .DCache          ( DCache           ),
+      .DCacheSizeBytes ( DCacheSizeBytes  ),
+      .DCacheNumWays   ( DCacheNumWays    ),
+      // Only the RAM is cached
+      .DCacheRegionBase( 32'h00100000     ),
+      .DCacheRegionMask( 32'hFFF00000     ),
       .WritebackStage  ( WritebackStage   ),
+      .LoadPipelining  ( LoadPipelining   ),
+      // Only loads from the RAM are requested early, the peripherals have side effects
+      .LoadPipeliningRegionBase ( 32'h00100000 ),
+      .LoadPipeliningRegionMask ( 32'hFFF00000 ),
+      .MacroOpFusion   ( MacroOpFusion    ),
       .BranchPredictor ( BranchPredictor  ),
+      .BranchPredictorDynamic ( BranchPredictorDynamic ),
+      .ReturnAddrStack ( ReturnAddrStack  ),
       .DbgTriggerEn    ( DbgTriggerEn     ),
       .DmBaseAddr      ( 32'h00100000     ),
       .DmAddrMask      ( 32'h00000003     ),
@@ -228,17 +304,17 @@ module ibex_simple_system (
       .instr_rdata_intg_i     (instr_rdata_intg),
       .instr_err_i            (instr_err),
 
-      .data_req_o             (host_req[CoreD]),
-      .data_gnt_i             (host_gnt[CoreD]),
-      .data_rvalid_i          (host_rvalid[CoreD]),
-      .data_we_o              (host_we[CoreD]),
-      .data_be_o              (host_be[CoreD]),
-      .data_addr_o            (host_addr[CoreD]),
-      .data_wdata_o           (host_wdata[CoreD]),
+      .data_req_o             (data_req),
+      .data_gnt_i             (data_gnt),
+      .data_rvalid_i          (data_rvalid),
+      .data_we_o              (data_we),
+      .data_be_o              (data_be),
+      .data_addr_o            (data_addr),
+      .data_wdata_o           (data_wdata),
       .data_wdata_intg_o      (),
-      .data_rdata_i           (host_rdata[CoreD]),
+      .data_rdata_i           (data_rdata),
       .data_rdata_intg_i      (data_rdata_intg),
-      .data_err_i             (host_err[CoreD]),
+      .data_err_i             (data_err),
 
       .irq_software_i         (1'b0),
       .irq_timer_i            (timer_irq),
@@ -259,9 +335,86 @@ module ibex_simple_system (
       .alert_minor_o          (),
       .alert_major_internal_o (),
       .alert_major_bus_o      (),
-      .core_sleep_o           ()
+      .core_sleep_o           (core_sleep)
+    );
+
+  // Memory timing models, making the RAM and peripherals respond as configured
+  mem_timing #(
+    .NumRegions (MemTimingNumRegions),
+    .RndSeed    (32'h2545F491)
+    ) u_instr_mem_timing (
+      .clk_i                   (clk_sys),
+      .rst_ni                  (rst_sys_n),
+
+      .host_req_i              (instr_req),
+      .host_gnt_o              (instr_gnt),
+      .host_we_i               (1'b0),
+      .host_addr_i             (instr_addr),
+      .host_rvalid_o           (instr_rvalid),
+      .host_rdata_o            (instr_rdata),
+      .host_err_o              (instr_err),
+
+      .device_req_o            (ram_instr_req),
+      .device_rvalid_i         (ram_instr_rvalid),
+      .device_rdata_i          (ram_instr_rdata),
+      .device_err_i            (1'b0),
+
+      .busy_o                  (instr_mem_busy),
+
+      .cfg_region_en_i         (mem_region_en),
+      .cfg_region_base_i       (mem_region_base),
+      .cfg_region_mask_i       (mem_region_mask),
+      .cfg_region_rd_latency_i (mem_region_rd_latency),
+      .cfg_region_wr_latency_i (mem_region_wr_latency),
+      .cfg_jitter_i            (mem_jitter),
+      .cfg_stall_pct_i         (mem_stall_pct),
+      .cfg_bw_accesses_i       (mem_bw_accesses),
+      .cfg_bw_window_i         (mem_bw_window),
+      .cfg_seed_i              (mem_seed)
+    );
+
+  mem_timing #(
+    .NumRegions (MemTimingNumRegions),
+    .RndSeed    (32'h9E3779B9)
+    ) u_data_mem_timing (
+      .clk_i                   (clk_sys),
+      .rst_ni                  (rst_sys_n),
+
+      .host_req_i              (data_req),
+      .host_gnt_o              (data_gnt),
+      .host_we_i               (data_we),
+      .host_addr_i             (data_addr),
+      .host_rvalid_o           (data_rvalid),
+      .host_rdata_o            (data_rdata),
+      .host_err_o              (data_err),
+
+      .device_req_o            (host_req[CoreD]),
+      .device_rvalid_i         (host_rvalid[CoreD]),
+      .device_rdata_i          (host_rdata[CoreD]),
+      .device_err_i            (host_err[CoreD]),
+
+      .busy_o                  (data_mem_busy),
+
+      .cfg_region_en_i         (mem_region_en),
+      .cfg_region_base_i       (mem_region_base),
+      .cfg_region_mask_i       (mem_region_mask),
+      .cfg_region_rd_latency_i (mem_region_rd_latency),
+      .cfg_region_wr_latency_i (mem_region_wr_latency),
+      .cfg_jitter_i            (mem_jitter),
+      .cfg_stall_pct_i         (mem_stall_pct),
+      .cfg_bw_accesses_i       (mem_bw_accesses),
+      .cfg_bw_window_i         (mem_bw_window),
+      .cfg_seed_i              (mem_seed)
     );
 
+  assign host_we[CoreD]    = data_we;
+  assign host_be[CoreD]    = data_be;
+  assign host_addr[CoreD]  = data_addr;
+  assign host_wdata[CoreD] = data_wdata;
+
+  logic unused_host_gnt;
+  assign unused_host_gnt = host_gnt[CoreD];
+
   // SRAM block for instruction and data storage
   ram_2p #(
       .Depth(1024*1024/4),
@@ -278,13 +431,13 @@ module ibex_simple_system (
       .a_rvalid_o  (device_rvalid[Ram]),
       .a_rdata_o   (device_rdata[Ram]),
 
-      .b_req_i     (instr_req),
+      .b_req_i     (ram_instr_req),
       .b_we_i      (1'b0),
       .b_be_i      (4'b0),
       .b_addr_i    (instr_addr),
       .b_wdata_i   (32'b0),
-      .b_rvalid_o  (instr_rvalid),
-      .b_rdata_o   (instr_rdata)
+      .b_rvalid_o  (ram_instr_rvalid),
+      .b_rdata_o   (ram_instr_rdata)
     );
 
   simulator_ctrl #(
@@ -299,7 +452,10 @@ module ibex_simple_system (
       .addr_i    (device_addr[SimCtrl]),
       .wdata_i   (device_wdata[SimCtrl]),
       .rvalid_o  (device_rvalid[SimCtrl]),
-      .rdata_o   (device_rdata[SimCtrl])
+      .rdata_o   (device_rdata[SimCtrl]),
+
+      .marker_valid_o (pcount_marker_valid),
+      .marker_o       (pcount_marker)
     );
 
   timer #(
@@ -320,6 +476,70 @@ module ibex_simple_system (
       .timer_intr_o   (timer_irq)
     );
 
+  // Free-running cycle count, read from C++ (see the verilator_waiver.vlt public entry) by the
+  // extension benchmark as a signal that changes every cycle.
+  logic [31:0] sim_cycle_cnt_q;
+
+  always_ff @(posedge clk_sys or negedge rst_sys_n) begin
+    if (!rst_sys_n) begin
+      sim_cycle_cnt_q <= '0;
+    end else begin
+      sim_cycle_cnt_q <= sim_cycle_cnt_q + 32'd1;
+    end
+  end
+
+  export "DPI-C" function simple_system_core_idle;
+
+  // Return 1 if the core is asleep (in WFI) and has no bus transactions in flight. Nothing happens
+  // in this state until an interrupt arrives, and the only interrupt source is the timer.
+  function automatic bit simple_system_core_idle();
+    return core_sleep & ~instr_req & ~data_req & ~instr_mem_busy & ~data_mem_busy;
+  endfunction
+
+  export "DPI-C" function mem_timing_set_region;
+
+  // Set the latency, in cycles from the grant to the response, of reads and writes on both ports to
+  // addresses where (addr & mask) == base. The lowest numbered region containing an address is
+  // used, addresses outside all regions respond in the next cycle.
+  function automatic void mem_timing_set_region(int unsigned index, int unsigned base,
+                                                int unsigned mask, int unsigned read_latency,
+                                                int unsigned write_latency);
+    if (index < MemTimingNumRegions) begin
+      mem_region_en[index]         = 1'b1;
+      mem_region_base[index]       = base;
+      mem_region_mask[index]       = mask;
+      mem_region_rd_latency[index] = 16'(read_latency);
+      mem_region_wr_latency[index] = 16'(write_latency);
+    end
+  endfunction
+
+  export "DPI-C" function mem_timing_set;
+
+  // Set the random jitter added to the latency, the percentage of cycles the grant is withheld
+  // and the bandwidth limit (accesses per window of cycles) of each port. Call before reset for the
+  // seed to take effect.
+  function automatic void mem_timing_set(int unsigned jitter, int unsigned stall_pct,
+                                         int unsigned bw_accesses, int unsigned bw_window,
+                                         int unsigned seed);
+    mem_jitter      = 16'(jitter);
+    mem_stall_pct   = 7'(stall_pct);
+    mem_bw_accesses = 16'(bw_accesses);
+    mem_bw_window   = 16'(bw_window);
+    mem_seed        = seed;
+  endfunction
+
+`ifdef VERILATOR
+  // Tell the performance counter sampler (see dv/verilator/pcount) that software wrote a marker.
+  // It samples the counters at the following clock edge.
+  import "DPI-C" function void pcount_sample_marker(int unsigned marker);
+
+  always_ff @(posedge clk_sys) begin
+    if (pcount_marker_valid) begin
+      pcount_sample_marker(pcount_marker);
+    end
+  end
+`endif
+
   export "DPI-C" function mhpmcounter_num;
 
   function automatic int unsigned mhpmcounter_num();
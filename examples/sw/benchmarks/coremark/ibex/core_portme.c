@@ -68,6 +68,16 @@ void pcount_read(uint32_t pcount_out[]) {
   PCOUNT_READ(mhpmcounter10, pcount_out[8]);
   PCOUNT_READ(mhpmcounter11, pcount_out[9]);
   PCOUNT_READ(mhpmcounter12, pcount_out[10]);
+  PCOUNT_READ(mhpmcounter13, pcount_out[11]);
+  PCOUNT_READ(mhpmcounter14, pcount_out[12]);
+  PCOUNT_READ(mhpmcounter15, pcount_out[13]);
+  PCOUNT_READ(mhpmcounter16, pcount_out[14]);
+  PCOUNT_READ(mhpmcounter17, pcount_out[15]);
+  PCOUNT_READ(mhpmcounter18, pcount_out[16]);
+  PCOUNT_READ(mhpmcounter19, pcount_out[17]);
+  PCOUNT_READ(mhpmcounter20, pcount_out[18]);
+  PCOUNT_READ(mhpmcounter21, pcount_out[19]);
+  PCOUNT_READ(mhpmcounter22, pcount_out[20]);
 }
 
 const char *pcount_names[] = {"Instructions Retired",
@@ -80,7 +90,17 @@ const char *pcount_names[] = {"Instructions Retired",
                               "Taken Branches",
                               "Compressed Instructions",
                               "Multiply Wait",
-                              "Divide Wait"};
+                              "Divide Wait",
+                              "FP Wait",
+                              "Branch Mispredicts",
+                              "RAS Hits",
+                              "ICache Hits",
+                              "ICache Misses",
+                              "ICache Useful Prefetches",
+                              "DCache Hits",
+                              "DCache Misses",
+                              "DCache Writebacks",
+                              "Fused Instruction Pairs"};
 
 const uint32_t pcount_num = sizeof(pcount_names) / sizeof(char *);
 
@@ -43,6 +43,18 @@ void puthex(uint32_t h);
  */
 void sim_halt();
 
+/**
+ * Marks a point of interest for performance counter sampling. When the
+ * simulator is run with --pcount-samples it records the counters at each
+ * marker, tagged with the given value (for example an ID for the code region
+ * being entered).
+ *
+ * @param marker Value recorded with the sample
+ */
+static inline void pcount_marker(uint32_t marker) {
+  DEV_WRITE(SIM_CTRL_BASE + SIM_CTRL_PCOUNT_MARKER, marker);
+}
+
 /**
  * Enables/disables performance counters.  This effects mcycle and minstret as
  * well as the mhpmcounterN counters.
@@ -8,6 +8,7 @@
 #define SIM_CTRL_BASE 0x20000
 #define SIM_CTRL_OUT 0x0
 #define SIM_CTRL_CTRL 0x8
+#define SIM_CTRL_PCOUNT_MARKER 0x10
 
 #define TIMER_BASE 0x30000
 #define TIMER_MTIME 0x0
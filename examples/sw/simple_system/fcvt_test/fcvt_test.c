@@ -0,0 +1,113 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/*******************************************************************************
+ * Directed test of the saturating float to integer conversions
+ *
+ * Runs fcvt.w.s and fcvt.wu.s on NaNs, infinities and +/-2^31 in every rounding
+ * mode and checks the results and exception flags against those the RISC-V F
+ * extension specifies. Needs a simulator built with RV32F, the FPU checker (see
+ * dv/verilator/fpu_check) checks the same cases as they execute.
+ * ****************************************************************************/
+
+#include "simple_system_common.h"
+
+#define FFLAG_NV 0x10
+
+typedef struct {
+  uint32_t a;
+  uint32_t w_result;
+  uint32_t w_fflags;
+  uint32_t wu_result;
+  uint32_t wu_fflags;
+} cvt_case_t;
+
+static const cvt_case_t cases[] = {
+    // Quiet and signalling NaNs of either sign convert like +inf
+    {0x7fc00000, 0x7fffffff, FFLAG_NV, 0xffffffff, FFLAG_NV},
+    {0xffc00000, 0x7fffffff, FFLAG_NV, 0xffffffff, FFLAG_NV},
+    {0x7f800001, 0x7fffffff, FFLAG_NV, 0xffffffff, FFLAG_NV},
+    // +inf and -inf
+    {0x7f800000, 0x7fffffff, FFLAG_NV, 0xffffffff, FFLAG_NV},
+    {0xff800000, 0x80000000, FFLAG_NV, 0x00000000, FFLAG_NV},
+    // 2^31 and -2^31
+    {0x4f000000, 0x7fffffff, FFLAG_NV, 0x80000000, 0},
+    {0xcf000000, 0x80000000, 0, 0x00000000, FFLAG_NV},
+};
+
+#define NUM_CASES (sizeof(cases) / sizeof(cases[0]))
+#define NUM_RM 5
+
+static uint32_t read_clear_fflags(void) {
+  uint32_t fflags;
+  asm volatile("csrrw %0, fflags, zero" : "=r"(fflags));
+  return fflags;
+}
+
+static void set_frm(uint32_t rm) { asm volatile("csrw frm, %0" : : "r"(rm)); }
+
+static uint32_t fcvt_w_s(uint32_t a) {
+  uint32_t result;
+  asm volatile("fcvt.w.s %0, %1, dyn" : "=r"(result) : "r"(a));
+  return result;
+}
+
+static uint32_t fcvt_wu_s(uint32_t a) {
+  uint32_t result;
+  asm volatile("fcvt.wu.s %0, %1, dyn" : "=r"(result) : "r"(a));
+  return result;
+}
+
+static int check(const char *name, uint32_t a, uint32_t rm, uint32_t result,
+                 uint32_t fflags, uint32_t exp_result, uint32_t exp_fflags) {
+  if (result == exp_result && fflags == exp_fflags) {
+    return 0;
+  }
+
+  puts("FAILURE: ");
+  puts(name);
+  puts(" 0x");
+  puthex(a);
+  puts(" rm 0x");
+  puthex(rm);
+  puts(" gave 0x");
+  puthex(result);
+  puts(" fflags 0x");
+  puthex(fflags);
+  puts(", expected 0x");
+  puthex(exp_result);
+  puts(" fflags 0x");
+  puthex(exp_fflags);
+  putchar('\n');
+  return 1;
+}
+
+int main(void) {
+  int failures = 0;
+
+  for (uint32_t rm = 0; rm < NUM_RM; rm++) {
+    set_frm(rm);
+
+    for (unsigned int i = 0; i < NUM_CASES; i++) {
+      const cvt_case_t *c = &cases[i];
+      uint32_t result;
+
+      read_clear_fflags();
+      result = fcvt_w_s(c->a);
+      failures += check("fcvt.w.s", c->a, rm, result, read_clear_fflags(),
+                        c->w_result, c->w_fflags);
+
+      result = fcvt_wu_s(c->a);
+      failures += check("fcvt.wu.s", c->a, rm, result, read_clear_fflags(),
+                        c->wu_result, c->wu_fflags);
+    }
+  }
+
+  if (failures) {
+    return 1;
+  }
+
+  puts("PASS: saturating conversions match the F extension\n");
+  return 0;
+}
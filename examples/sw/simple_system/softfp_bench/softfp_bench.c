@@ -0,0 +1,89 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// Cycles per SoftFP binary32 operation. Build once as is and once with XSFP=1
+// (using the soft-float assist instructions) to compare the two. Both builds
+// print the same checksum of the results and exception flags.
+
+#include "simple_system_common.h"
+#include "softfp.h"
+
+#include "pcount.h"
+
+// A mix of normal, subnormal and special operands
+static const uint32_t operands[] = {
+    0x3f800000, 0xc0490fdb, 0x3eaaaaab, 0x42f6e979, 0xbd4ccccd, 0x7f7fffff,
+    0x00800000, 0x00400001, 0x807fffff, 0x00000001, 0x4b000001, 0xcf000000,
+    0x3fb504f3, 0x80000000, 0x7f800000, 0x3c23d70a};
+
+#define NUM_OPERANDS (sizeof(operands) / sizeof(operands[0]))
+
+enum {
+  OP_ADD,
+  OP_MUL,
+  OP_DIV,
+  OP_SQRT,
+  OP_FMA,
+  OP_CVT_S_W,
+  OP_CVT_W_S,
+  NUM_OPS
+};
+
+static const char *const op_names[NUM_OPS] = {
+    "fadd.s", "fmul.s", "fdiv.s", "fsqrt.s", "fmadd.s", "fcvt.s.w", "fcvt.w.s"};
+
+static uint32_t checksum;
+
+static uint32_t run_op(int op, uint32_t a, uint32_t b, uint32_t *fflags) {
+  switch (op) {
+    case OP_ADD:
+      return add_sf32(a, b, RM_RNE, fflags);
+    case OP_MUL:
+      return mul_sf32(a, b, RM_RNE, fflags);
+    case OP_DIV:
+      return div_sf32(a, b, RM_RNE, fflags);
+    case OP_SQRT:
+      return sqrt_sf32(a & 0x7fffffff, RM_RNE, fflags);
+    case OP_FMA:
+      return fma_sf32(a, b, a ^ b, RM_RNE, fflags);
+    case OP_CVT_S_W:
+      return cvt_i32_sf32((int32_t)(a ^ b), RM_RNE, fflags);
+    default:
+      return cvt_sf32_i32(a, RM_RNE, fflags);
+  }
+}
+
+int main(void) {
+  pcount_enable(0);
+  pcount_reset();
+
+  for (int op = 0; op < NUM_OPS; op++) {
+    uint32_t cycles_start, cycles;
+
+    pcount_enable(1);
+    cycles_start = pcount_get();
+
+    for (unsigned int i = 0; i < NUM_OPERANDS; i++) {
+      for (unsigned int j = 0; j < NUM_OPERANDS; j++) {
+        uint32_t fflags = 0;
+        uint32_t result = run_op(op, operands[i], operands[j], &fflags);
+        checksum = ((checksum << 1) | (checksum >> 31)) ^ result ^ fflags;
+      }
+    }
+
+    cycles = pcount_get() - cycles_start;
+    pcount_enable(0);
+
+    puts(op_names[op]);
+    puts(" cycles/op: 0x");
+    puthex(cycles / (NUM_OPERANDS * NUM_OPERANDS));
+    putchar('\n');
+  }
+
+  puts("checksum: 0x");
+  puthex(checksum);
+  putchar('\n');
+
+  return 0;
+}
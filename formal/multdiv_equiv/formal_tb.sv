@@ -0,0 +1,173 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+// A formal testbench checking the radix-4 divider (RV32MFastDiv) against the radix-2 long division
+// of ibex_multdiv_fast. Both are given the same division after reset and must return the same
+// result, the radix-4 divider no later than the radix-2 one.
+
+// One ibex_multdiv_fast with the parts of the ALU and ID stage it relies on
+module formal_multdiv_unit #(
+  parameter ibex_pkg::rv32m_e RV32M        = ibex_pkg::RV32MFast,
+  parameter bit               RV32MFastDiv = 1'b0
+) (
+  input  logic             clk_i,
+  input  logic             rst_ni,
+  input  ibex_pkg::md_op_e operator_i,
+  input  logic [1:0]       signed_mode_i,
+  input  logic [31:0]      op_a_i,
+  input  logic [31:0]      op_b_i,
+  input  logic             data_ind_timing_i,
+  output logic             valid_o,
+  output logic [31:0]      result_o
+);
+
+  logic [32:0] alu_operand_a, alu_operand_b;
+  logic [33:0] alu_adder_ext;
+  logic [31:0] alu_adder;
+  logic [33:0] imd_val_q[2];
+  logic [33:0] imd_val_d[2];
+  logic [1:0]  imd_val_we;
+
+  // The ALU adder as the divider uses it, see ibex_alu
+  assign alu_adder_ext = $unsigned(alu_operand_a) + $unsigned(alu_operand_b);
+  assign alu_adder     = alu_adder_ext[32:1];
+
+  // Intermediate value registers, see ibex_id_stage
+  for (genvar i = 0; i < 2; i++) begin : gen_intermediate_val_reg
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        imd_val_q[i] <= '0;
+      end else if (imd_val_we[i]) begin
+        imd_val_q[i] <= imd_val_d[i];
+      end
+    end
+  end
+
+  ibex_multdiv_fast #(
+    .RV32M       (RV32M),
+    .RV32MFastDiv(RV32MFastDiv)
+  ) multdiv_i (
+    .clk_i             (clk_i),
+    .rst_ni            (rst_ni),
+    .mult_en_i         (1'b0),
+    .div_en_i          (1'b1),
+    .mult_sel_i        (1'b0),
+    .div_sel_i         (1'b1),
+    .operator_i        (operator_i),
+    .signed_mode_i     (signed_mode_i),
+    .op_a_i            (op_a_i),
+    .op_b_i            (op_b_i),
+    .alu_adder_ext_i   (alu_adder_ext),
+    .alu_adder_i       (alu_adder),
+    .equal_to_zero_i   (alu_adder == 32'h0),
+    .data_ind_timing_i (data_ind_timing_i),
+    .alu_operand_a_o   (alu_operand_a),
+    .alu_operand_b_o   (alu_operand_b),
+    .imd_val_q_i       (imd_val_q),
+    .imd_val_d_o       (imd_val_d),
+    .imd_val_we_o      (imd_val_we),
+    .multdiv_ready_id_i(1'b1),
+    .multdiv_result_o  (result_o),
+    .valid_o           (valid_o)
+  );
+
+endmodule
+
+module formal_tb #(
+  parameter ibex_pkg::rv32m_e RV32M = ibex_pkg::RV32MFast
+) (
+  input logic             clk_i,
+  input ibex_pkg::md_op_e operator_i,
+  input logic [1:0]       signed_mode_i,
+  input logic [31:0]      op_a_i,
+  input logic [31:0]      op_b_i,
+  input logic             data_ind_timing_i
+);
+
+  import ibex_pkg::*;
+
+  logic             rst_ni = 1'b0;
+  md_op_e           operator_q;
+  logic [1:0]       signed_mode_q;
+  logic [31:0]      op_a_q, op_b_q;
+  logic             data_ind_timing_q;
+
+  // Reset for the first cycle, then hold the operands for the whole division as the ID stage does
+  always_ff @(posedge clk_i) begin
+    rst_ni            <= 1'b1;
+    operator_q        <= operator_i;
+    signed_mode_q     <= signed_mode_i;
+    op_a_q            <= op_a_i;
+    op_b_q            <= op_b_i;
+    data_ind_timing_q <= data_ind_timing_i;
+  end
+
+  always_comb begin
+    assume (operator_i inside {MD_OP_DIV, MD_OP_REM});
+    if (rst_ni) begin
+      assume (operator_i == operator_q);
+      assume (signed_mode_i == signed_mode_q);
+      assume (op_a_i == op_a_q);
+      assume (op_b_i == op_b_q);
+      assume (data_ind_timing_i == data_ind_timing_q);
+    end
+  end
+
+  logic        ref_valid, fast_valid;
+  logic [31:0] ref_result, fast_result;
+
+  formal_multdiv_unit #(
+    .RV32M       (RV32M),
+    .RV32MFastDiv(1'b0)
+  ) u_ref (
+    .clk_i,
+    .rst_ni,
+    .operator_i,
+    .signed_mode_i,
+    .op_a_i,
+    .op_b_i,
+    .data_ind_timing_i,
+    .valid_o (ref_valid),
+    .result_o(ref_result)
+  );
+
+  formal_multdiv_unit #(
+    .RV32M       (RV32M),
+    .RV32MFastDiv(1'b1)
+  ) u_fast (
+    .clk_i,
+    .rst_ni,
+    .operator_i,
+    .signed_mode_i,
+    .op_a_i,
+    .op_b_i,
+    .data_ind_timing_i,
+    .valid_o (fast_valid),
+    .result_o(fast_result)
+  );
+
+  // Results of the first division each unit completes
+  logic        ref_done = 1'b0;
+  logic        fast_done = 1'b0;
+  logic [31:0] ref_done_result, fast_done_result;
+
+  always_ff @(posedge clk_i) begin
+    if (rst_ni && ref_valid && !ref_done) begin
+      ref_done        <= 1'b1;
+      ref_done_result <= ref_result;
+    end
+    if (rst_ni && fast_valid && !fast_done) begin
+      fast_done        <= 1'b1;
+      fast_done_result <= fast_result;
+    end
+  end
+
+  always_comb begin
+    if (ref_done) begin
+      assert (fast_done);
+      assert (fast_done_result == ref_done_result);
+    end
+  end
+
+endmodule
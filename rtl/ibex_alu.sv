@@ -7,7 +7,8 @@
  * Arithmetic logic unit
  */
 module ibex_alu #(
-  parameter ibex_pkg::rv32b_e RV32B = ibex_pkg::RV32BNone
+  parameter ibex_pkg::rv32b_e RV32B           = ibex_pkg::RV32BNone,
+  parameter bit               SoftFloatAssist = 1'b0
 ) (
   input  ibex_pkg::alu_op_e operator_i,
   input  logic [31:0]       operand_a_i,
@@ -1312,6 +1313,134 @@ module ibex_alu #(
     assign imd_val_we_o        = '{default: '0};
   end
 
+  ///////////////////////
+  // Soft-Float Assist //
+  ///////////////////////
+
+  // Single cycle versions of the helpers the SoftFP library spends most of its time in, for
+  // binary32 values. SoftFP keeps intermediate mantissas with their MSB at bit 30 and the 7 bits
+  // below the result LSB for rounding.
+  //
+  // sfp.srs     rd = rs1 >> rs2, ORing the bits shifted out into bit 0 (rshift_rnd())
+  // sfp.norm    rd = rs1 shifted left to bring its MSB to bit 30 (normalize_sf())
+  // sfp.nexp    rd = rs2 - the shift sfp.norm applies to rs1
+  // sfp.rpack   rd = rs1[30:0] rounded to nearest even and packed with sign rs1[31] and signed
+  //             exponent rs2, including subnormal and overflowing results (round_pack_sf())
+  // sfp.rpflags rd = the fflags sfp.rpack raises
+  // sfp.umant   rd = mantissa of rs1 with the hidden bit at bit 23, subnormals normalised
+  //             (normalize_subnormal_sf())
+  // sfp.uexp    rd = biased exponent of rs1, below 1 for normalised subnormals
+
+  logic [31:0] sfp_result;
+
+  if (SoftFloatAssist) begin : g_alu_sfp
+    logic [31:0] sfp_clz_in;
+    logic [5:0]  sfp_clz;
+    logic [4:0]  sfp_norm_shift;
+    logic        sfp_subnormal;
+    logic [4:0]  sfp_unpack_shift;
+
+    logic [31:0] srs_in, srs_amt, srs_result;
+
+    logic        rp_sign;
+    logic [31:0] rp_mant_in;
+    logic [31:0] rp_exp_in;
+    logic        rp_tiny, rp_tiny_subnormal;
+    logic [31:0] rp_mant;
+    logic [6:0]  rp_rnd_bits;
+    logic [24:0] rp_mant_rnd;
+    logic [32:0] rp_exp;
+    logic        rp_overflow;
+    logic [31:0] rp_result;
+    logic [4:0]  rp_fflags;
+
+    // Leading zeros, of the mantissa field only for the unpack instructions
+    assign sfp_subnormal = operand_a_i[30:23] == 8'h00;
+    assign sfp_clz_in    = (operator_i inside {ALU_SFP_UMANT, ALU_SFP_UEXP}) ?
+                           {9'b0, operand_a_i[22:0]} : operand_a_i;
+
+    always_comb begin
+      sfp_clz = 6'd32;
+      for (int unsigned i = 0; i < 32; i++) begin
+        if (sfp_clz_in[i]) begin
+          sfp_clz = 6'(31 - i);
+        end
+      end
+    end
+
+    // sfp.norm brings the MSB to bit 30, the unpack instructions bring it to bit 23
+    assign sfp_norm_shift   = (sfp_clz == 6'd0) ? 5'd0 : 5'(sfp_clz - 6'd1);
+    assign sfp_unpack_shift = 5'(sfp_clz - 6'd8);
+
+    // Sticky right shift, shared with the subnormal path of sfp.rpack
+    assign srs_in  = (operator_i == ALU_SFP_SRS) ? operand_a_i : rp_mant_in;
+    assign srs_amt = (operator_i == ALU_SFP_SRS) ? operand_b_i : 32'd1 - rp_exp_in;
+
+    always_comb begin
+      if (srs_amt >= 32'd32) begin
+        srs_result = {31'b0, |srs_in};
+      end else begin
+        srs_result = (srs_in >> srs_amt[4:0]) |
+                     {31'b0, |(srs_in & ~(32'hffff_ffff << srs_amt[4:0]))};
+      end
+    end
+
+    // Round to nearest even and pack. A result that is tiny before rounding is denormalised
+    // first, underflow is raised when it is also inexact and stays subnormal after rounding.
+    assign rp_sign           = operand_a_i[31];
+    assign rp_mant_in        = {1'b0, operand_a_i[30:0]};
+    assign rp_exp_in         = operand_b_i;
+    assign rp_tiny           = $signed(rp_exp_in) <= 0;
+    assign rp_tiny_subnormal = $signed(rp_exp_in) < 0 || ((rp_mant_in + 32'h40) < 32'h8000_0000);
+
+    assign rp_mant     = rp_tiny ? srs_result : rp_mant_in;
+    assign rp_rnd_bits = rp_mant[6:0];
+
+    always_comb begin
+      rp_mant_rnd = 25'((rp_mant + 32'h40) >> 7);
+      // Ties go to the even result
+      if (rp_rnd_bits == 7'h40) begin
+        rp_mant_rnd[0] = 1'b0;
+      end
+    end
+
+    assign rp_exp      = (rp_tiny ? 33'd1 : {rp_exp_in[31], rp_exp_in}) + {32'b0, rp_mant_rnd[24]};
+    assign rp_overflow = (rp_mant_rnd[24:23] != 2'b00) && ($signed(rp_exp) >= 33'sd255);
+
+    always_comb begin
+      if (rp_mant_rnd[24:23] == 2'b00) begin
+        // Subnormal or zero
+        rp_result = {rp_sign, 8'h00, rp_mant_rnd[22:0]};
+      end else if (rp_overflow) begin
+        rp_result = {rp_sign, 8'hff, 23'b0};
+      end else begin
+        rp_result = {rp_sign, rp_exp[7:0], rp_mant_rnd[22:0]};
+      end
+    end
+
+    // fflags order: NV, DZ, OF, UF, NX
+    assign rp_fflags = {2'b00, rp_overflow, rp_tiny & rp_tiny_subnormal & (rp_rnd_bits != '0),
+                        rp_overflow | (rp_rnd_bits != '0)};
+
+    always_comb begin
+      unique case (operator_i)
+        ALU_SFP_SRS:     sfp_result = srs_result;
+        ALU_SFP_NORM:    sfp_result = operand_a_i << sfp_norm_shift;
+        ALU_SFP_NEXP:    sfp_result = operand_b_i - {27'b0, sfp_norm_shift};
+        ALU_SFP_RPACK:   sfp_result = rp_result;
+        ALU_SFP_RPFLAGS: sfp_result = {27'b0, rp_fflags};
+        ALU_SFP_UMANT:   sfp_result = sfp_subnormal ?
+                                      {9'b0, operand_a_i[22:0]} << sfp_unpack_shift :
+                                      {8'b0, 1'b1, operand_a_i[22:0]};
+        ALU_SFP_UEXP:    sfp_result = sfp_subnormal ? 32'd9 - {26'b0, sfp_clz} :
+                                                      {24'b0, operand_a_i[30:23]};
+        default:         sfp_result = '0;
+      endcase
+    end
+  end else begin : g_no_alu_sfp
+    assign sfp_result = '0;
+  end
+
   ////////////////
   // Result mux //
   ////////////////
@@ -1390,6 +1519,12 @@ module ibex_alu #(
       ALU_CLMUL, ALU_CLMULR,
       ALU_CLMULH: result_o = clmul_result;
 
+      // Soft-Float Assist Operations
+      ALU_SFP_SRS,   ALU_SFP_NORM,
+      ALU_SFP_NEXP,  ALU_SFP_RPACK,
+      ALU_SFP_RPFLAGS,
+      ALU_SFP_UMANT, ALU_SFP_UEXP: result_o = sfp_result;
+
       default: ;
     endcase
   end
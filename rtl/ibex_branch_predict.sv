@@ -13,11 +13,31 @@
  * the lower 16-bits of instr.
  *
  * The predictor is entirely combinational but takes clk/rst_n signals for use by assertions.
+ *
+ * With DynamicPredictor the direction of branches is instead predicted by a table of 2-bit
+ * saturating counters indexed by PC (bimodal), falling back to the static prediction for branches
+ * that have no entry yet. A direct-mapped branch target buffer (BTB) additionally predicts the
+ * target of indirect jumps (jalr, c.jr and c.jalr) it has seen before. Both are trained by the
+ * branches and jumps resolved in ID/EX, a BTB prediction that turns out to have the wrong target is
+ * corrected by ID/EX as a regular jump.
+ *
+ * With ReturnAddrStack calls (jal/jalr/c.jal/c.jalr writing ra) push their return address onto a
+ * small return address stack (RAS) as they are fetched and returns (jalr x0, 0(ra) and c.jr ra) are
+ * predicted to go to the address popped from it. As fetch is speculative a second stack is updated
+ * by the calls and returns resolved in ID/EX, it replaces the speculative one whenever ID/EX
+ * redirects fetch.
  */
 
 `include "prim_assert.sv"
 
-module ibex_branch_predict (
+module ibex_branch_predict #(
+  parameter bit          DynamicPredictor = 1'b0,
+  parameter int unsigned BhtEntries       = 64,
+  parameter int unsigned BtbEntries       = 8,
+  parameter int unsigned BtbTagWidth      = 8,
+  parameter bit          ReturnAddrStack  = 1'b0,
+  parameter int unsigned RasEntries       = 4
+) (
   input  logic clk_i,
   input  logic rst_ni,
 
@@ -25,6 +45,18 @@ module ibex_branch_predict (
   input  logic [31:0] fetch_rdata_i,
   input  logic [31:0] fetch_pc_i,
   input  logic        fetch_valid_i,
+  input  logic        fetch_accept_i,    // Instruction moves on to ID/EX, updates speculative RAS
+
+  // Branch or jump resolved in ID/EX, trains the dynamic predictor
+  input  logic [31:0] update_pc_i,
+  input  logic        update_branch_i,   // Conditional branch resolved...
+  input  logic        update_taken_i,    // ...with this outcome
+  input  logic        update_jump_i,     // Indirect jump resolved...
+  input  logic [31:0] update_target_i,   // ...with this target
+  input  logic        update_ras_push_i, // Call resolved...
+  input  logic [31:0] update_ras_addr_i, // ...with this return address
+  input  logic        update_ras_pop_i,  // Return resolved
+  input  logic        flush_i,           // ID/EX redirected fetch, restore speculative RAS
 
   // Prediction for supplied instruction
   output logic        predict_branch_taken_o,
@@ -46,7 +78,18 @@ module ibex_branch_predict (
   logic instr_cj;
   logic instr_cb;
 
+  logic instr_jr;
+  logic instr_cjr;
+  logic instr_call;
+  logic instr_ret;
+
   logic instr_b_taken;
+  logic instr_b_taken_static;
+  logic instr_jr_taken;
+  logic instr_ret_taken;
+
+  logic [31:0] instr_jr_target;
+  logic [31:0] instr_ret_target;
 
   // Provide short internal name for fetch_rdata_i due to reduce line wrapping
   assign instr = fetch_rdata_i;
@@ -75,6 +118,25 @@ module ibex_branch_predict (
   assign instr_cb = (instr[1:0] == 2'b01) & ((instr[15:13] == 3'b110) | (instr[15:13] == 3'b111));
   assign instr_cj = (instr[1:0] == 2'b01) & ((instr[15:13] == 3'b101) | (instr[15:13] == 3'b001));
 
+  // Returns, only predicted by the RAS
+  assign instr_ret = ReturnAddrStack &
+    (((opcode_e'(instr[6:0]) == OPCODE_JALR) & (instr[31:7] == {12'b0, 5'd1, 3'b0, 5'd0})) |
+     ((instr[1:0] == 2'b10) & (instr[15:12] == 4'b1000) & (instr[11:2] == {5'd1, 5'd0})));
+
+  // Calls, rd is ra (c.jal and c.jalr always write ra)
+  assign instr_call = ReturnAddrStack &
+    ((((opcode_e'(instr[6:0]) == OPCODE_JAL) | (opcode_e'(instr[6:0]) == OPCODE_JALR)) &
+      (instr[11:7] == 5'd1)) |
+     ((instr[1:0] == 2'b01) & (instr[15:13] == 3'b001)) |
+     ((instr[1:0] == 2'b10) & (instr[15:12] == 4'b1001) & (instr[11:7] != 5'b0) &
+      (instr[6:2] == 5'b0)));
+
+  // Indirect jumps, only predicted by the dynamic predictor (c.jr/c.jalr have rs1 != 0, rs2 == 0).
+  // Returns are left to the RAS when there is one.
+  assign instr_jr  = DynamicPredictor & ~instr_ret & (opcode_e'(instr[6:0]) == OPCODE_JALR);
+  assign instr_cjr = DynamicPredictor & ~instr_ret & (instr[1:0] == 2'b10) &
+                     (instr[15:13] == 3'b100) & (instr[11:7] != 5'b0) & (instr[6:2] == 5'b0);
+
   // Select out the branch offset for target calculation based upon the instruction type
   always_comb begin
     branch_imm = imm_b_type;
@@ -88,13 +150,178 @@ module ibex_branch_predict (
     endcase
   end
 
-  `ASSERT_IF(BranchInsTypeOneHot, $onehot0({instr_j, instr_b, instr_cj, instr_cb}), fetch_valid_i)
+  `ASSERT_IF(BranchInsTypeOneHot,
+    $onehot0({instr_j, instr_b, instr_cj, instr_cb, instr_jr, instr_cjr}), fetch_valid_i)
+
+  // Static branch prediction, taken if offset is negative
+  assign instr_b_taken_static = (instr_b & imm_b_type[31]) | (instr_cb & imm_cb_type[31]);
+
+  if (DynamicPredictor) begin : g_dynamic
+    localparam int unsigned BhtIdxW = $clog2(BhtEntries);
+    localparam int unsigned BtbIdxW = $clog2(BtbEntries);
+
+    typedef struct packed {
+      logic [BtbTagWidth-1:0] tag;
+      logic [31:0]            target;
+    } btb_entry_t;
+
+    logic [BhtEntries-1:0] bht_valid_q;
+    logic [1:0]            bht_cnt_q [BhtEntries];
+    logic [BtbEntries-1:0] btb_valid_q;
+    btb_entry_t            btb_q [BtbEntries];
+
+    logic [BhtIdxW-1:0]     fetch_bht_idx, update_bht_idx;
+    logic [BtbIdxW-1:0]     fetch_btb_idx, update_btb_idx;
+    logic [BtbTagWidth-1:0] fetch_btb_tag, update_btb_tag;
+    logic [1:0]             update_cnt;
+
+    // Instructions are halfword aligned, bit 0 of the PC is never used
+    assign fetch_bht_idx  = fetch_pc_i[BhtIdxW:1];
+    assign update_bht_idx = update_pc_i[BhtIdxW:1];
+    assign fetch_btb_idx  = fetch_pc_i[BtbIdxW:1];
+    assign update_btb_idx = update_pc_i[BtbIdxW:1];
+    assign fetch_btb_tag  = fetch_pc_i[BtbIdxW+BtbTagWidth:BtbIdxW+1];
+    assign update_btb_tag = update_pc_i[BtbIdxW+BtbTagWidth:BtbIdxW+1];
+
+    // Branches without an entry (never resolved, or aliasing ones that were) use the static
+    // prediction, the first resolution sets a weak counter in the direction that was taken
+    assign instr_b_taken = bht_valid_q[fetch_bht_idx] ?
+                           (instr_b | instr_cb) & bht_cnt_q[fetch_bht_idx][1] :
+                           instr_b_taken_static;
+
+    always_comb begin
+      update_cnt = bht_cnt_q[update_bht_idx];
+      if (!bht_valid_q[update_bht_idx]) begin
+        update_cnt = update_taken_i ? 2'b10 : 2'b01;
+      end else if (update_taken_i && update_cnt != 2'b11) begin
+        update_cnt = update_cnt + 2'b01;
+      end else if (!update_taken_i && update_cnt != 2'b00) begin
+        update_cnt = update_cnt - 2'b01;
+      end
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        bht_valid_q <= '0;
+        btb_valid_q <= '0;
+      end else begin
+        if (update_branch_i) begin
+          bht_valid_q[update_bht_idx] <= 1'b1;
+        end
+        if (update_jump_i) begin
+          btb_valid_q[update_btb_idx] <= 1'b1;
+        end
+      end
+    end
+
+    always_ff @(posedge clk_i) begin
+      if (update_branch_i) begin
+        bht_cnt_q[update_bht_idx] <= update_cnt;
+      end
+      if (update_jump_i) begin
+        btb_q[update_btb_idx] <= '{tag: update_btb_tag, target: update_target_i};
+      end
+    end
+
+    // Indirect jumps are predicted taken when they hit in the BTB. A partial tag may give a false
+    // hit, which ID/EX corrects like any other wrong target.
+    assign instr_jr_taken  = (instr_jr | instr_cjr) & btb_valid_q[fetch_btb_idx] &
+                             (btb_q[fetch_btb_idx].tag == fetch_btb_tag);
+    assign instr_jr_target = btb_q[fetch_btb_idx].target;
+
+    `ASSERT_INIT(BhtEntriesPow2, BhtEntries == 2**BhtIdxW)
+    `ASSERT_INIT(BtbEntriesPow2, BtbEntries == 2**BtbIdxW)
+  end else begin : g_static
+    logic        unused_update_branch, unused_update_taken, unused_update_jump;
+    logic [31:0] unused_update_pc, unused_update_target;
+
+    assign unused_update_pc     = update_pc_i;
+    assign unused_update_branch = update_branch_i;
+    assign unused_update_taken  = update_taken_i;
+    assign unused_update_jump   = update_jump_i;
+    assign unused_update_target = update_target_i;
+
+    assign instr_b_taken   = instr_b_taken_static;
+    assign instr_jr_taken  = 1'b0;
+    assign instr_jr_target = '0;
+  end
+
+  if (ReturnAddrStack) begin : g_ras
+    localparam int unsigned RasPtrW = RasEntries > 1 ? $clog2(RasEntries) : 1;
+
+    typedef struct packed {
+      logic [RasEntries-1:0][31:0] addr;
+      logic [RasPtrW-1:0]          top;  // Index of the most recent push
+      logic [RasPtrW:0]            num;  // Valid entries, older ones are overwritten when full
+    } ras_t;
+
+    ras_t ras_spec_q, ras_spec_d;
+    ras_t ras_q, ras_d;
+
+    logic [31:0] fetch_ret_addr;
+
+    function automatic ras_t ras_update(ras_t ras, logic push, logic pop, logic [31:0] addr);
+      ras_t ras_new = ras;
+
+      if (push) begin
+        ras_new.top = (ras.top == RasPtrW'(RasEntries - 1)) ? '0 : ras.top + 1'b1;
+        ras_new.addr[ras_new.top] = addr;
+        if (ras.num != (RasPtrW + 1)'(RasEntries)) begin
+          ras_new.num = ras.num + 1'b1;
+        end
+      end else if (pop && (ras.num != '0)) begin
+        ras_new.top = (ras.top == '0) ? RasPtrW'(RasEntries - 1) : ras.top - 1'b1;
+        ras_new.num = ras.num - 1'b1;
+      end
 
-  // Determine branch prediction, taken if offset is negative
-  assign instr_b_taken = (instr_b & imm_b_type[31]) | (instr_cb & imm_cb_type[31]);
+      return ras_new;
+    endfunction
+
+    assign fetch_ret_addr = fetch_pc_i + ((instr[1:0] == 2'b11) ? 32'd4 : 32'd2);
+
+    // RAS following the instructions resolved in ID/EX
+    assign ras_d = ras_update(ras_q, update_ras_push_i, update_ras_pop_i, update_ras_addr_i);
+
+    // RAS following the instructions fetched. A redirect from ID/EX flushes everything fetched
+    // after the instruction in ID/EX so the resolved RAS (including it) is exact.
+    assign ras_spec_d = flush_i                         ? ras_d :
+                        fetch_valid_i && fetch_accept_i ?
+                          ras_update(ras_spec_q, instr_call, instr_ret, fetch_ret_addr) :
+                          ras_spec_q;
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        ras_q      <= '0;
+        ras_spec_q <= '0;
+      end else begin
+        ras_q      <= ras_d;
+        ras_spec_q <= ras_spec_d;
+      end
+    end
+
+    assign instr_ret_taken  = instr_ret & (ras_spec_q.num != '0);
+    assign instr_ret_target = ras_spec_q.addr[ras_spec_q.top];
+
+    `ASSERT_INIT(RasEntriesNonZero, RasEntries > 0)
+  end else begin : g_no_ras
+    logic        unused_fetch_accept, unused_ras_push, unused_ras_pop, unused_flush;
+    logic [31:0] unused_ras_addr;
+
+    assign unused_fetch_accept = fetch_accept_i;
+    assign unused_ras_push     = update_ras_push_i;
+    assign unused_ras_pop      = update_ras_pop_i;
+    assign unused_ras_addr     = update_ras_addr_i;
+    assign unused_flush        = flush_i;
+
+    assign instr_ret_taken  = 1'b0;
+    assign instr_ret_target = '0;
+  end
 
-  // Always predict jumps taken otherwise take prediction from `instr_b_taken`
-  assign predict_branch_taken_o = fetch_valid_i & (instr_j | instr_cj | instr_b_taken);
+  // Always predict direct jumps taken otherwise take prediction from `instr_b_taken`,
+  // `instr_jr_taken` and `instr_ret_taken`
+  assign predict_branch_taken_o = fetch_valid_i & (instr_j | instr_cj | instr_b_taken |
+                                                   instr_jr_taken | instr_ret_taken);
   // Calculate target
-  assign predict_branch_pc_o    = fetch_pc_i + branch_imm;
+  assign predict_branch_pc_o    = instr_ret_taken ? instr_ret_target :
+                                  instr_jr_taken  ? instr_jr_target  : fetch_pc_i + branch_imm;
 endmodule
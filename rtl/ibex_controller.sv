@@ -13,7 +13,8 @@
 module ibex_controller #(
   parameter bit WritebackStage  = 1'b0,
   parameter bit BranchPredictor = 1'b0,
-  parameter bit MemECC          = 1'b0
+  parameter bit MemECC          = 1'b0,
+  parameter bit DCache          = 1'b0
  ) (
   input  logic                  clk_i,
   input  logic                  rst_ni,
@@ -35,6 +36,7 @@ module ibex_controller #(
   input  logic [15:0]           instr_compressed_i,      // instr compressed data for mtval
   input  logic                  instr_is_compressed_i,   // instr is compressed
   input  logic                  instr_bp_taken_i,        // instr was predicted taken branch
+  input  logic                  bp_target_mismatch_i,    // predicted jump has a different target
   input  logic                  instr_fetch_err_i,       // instr has error
   input  logic                  instr_fetch_err_plus2_i, // instr error is x32
   input  logic [31:0]           pc_id_i,                 // instr address
@@ -62,6 +64,8 @@ module ibex_controller #(
   input  logic                  load_err_i,
   input  logic                  store_err_i,
   input  logic                  mem_resp_intg_err_i,
+  input  logic                  dcache_wb_err_i,         // dcache line write back failed
+  input  logic [31:0]           dcache_wb_err_addr_i,
   output logic                  wb_exception_o,          // Instruction in WB taking an exception
   output logic                  id_exception_o,          // Instruction in ID taking an exception
 
@@ -355,12 +359,61 @@ module ibex_controller #(
     assign irq_nm_int       = mem_resp_intg_err_irq_pending_q;
     assign irq_nm_int_cause = NMI_INT_CAUSE_ECC;
     assign irq_nm_int_mtval = mem_resp_intg_err_addr_q;
+
+    logic        unused_dcache_wb_err;
+    logic [31:0] unused_dcache_wb_err_addr;
+
+    assign unused_dcache_wb_err      = dcache_wb_err_i;
+    assign unused_dcache_wb_err_addr = dcache_wb_err_addr_i;
+  end else if (DCache) begin : g_dcache_wb_irq_int
+    logic        dcache_wb_err_irq_pending_q, dcache_wb_err_irq_pending_d;
+    logic [31:0] dcache_wb_err_addr_q, dcache_wb_err_addr_d;
+    logic        entering_nmi;
+    logic        unused_mem_resp_intg_err_i;
+
+    assign entering_nmi               = nmi_mode_d & ~nmi_mode_q;
+    assign unused_mem_resp_intg_err_i = mem_resp_intg_err_i;
+
+    // Data cache write back error internal interrupt. The write back happens after the store that
+    // dirtied the line retired, so the error can only be reported imprecisely. Handled the same
+    // way as the load integrity error above (the two can't be configured together).
+    always_comb begin
+      dcache_wb_err_irq_pending_d = dcache_wb_err_irq_pending_q;
+      dcache_wb_err_addr_d        = dcache_wb_err_addr_q;
+
+      if (dcache_wb_err_irq_pending_q) begin
+        if (entering_nmi & !irq_nm_ext_i) begin
+          dcache_wb_err_irq_pending_d = 1'b0;
+        end
+      end else if (dcache_wb_err_i) begin
+        dcache_wb_err_irq_pending_d = 1'b1;
+        dcache_wb_err_addr_d        = dcache_wb_err_addr_i;
+      end
+    end
+
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        dcache_wb_err_irq_pending_q <= 1'b0;
+        dcache_wb_err_addr_q        <= '0;
+      end else begin
+        dcache_wb_err_irq_pending_q <= dcache_wb_err_irq_pending_d;
+        dcache_wb_err_addr_q        <= dcache_wb_err_addr_d;
+      end
+    end
+
+    assign irq_nm_int       = dcache_wb_err_irq_pending_q;
+    assign irq_nm_int_cause = NMI_INT_CAUSE_DCACHE_WB;
+    assign irq_nm_int_mtval = dcache_wb_err_addr_q;
   end else begin : g_no_intg_irq_int
-    logic unused_mem_resp_intg_err_i;
+    logic        unused_mem_resp_intg_err_i;
+    logic        unused_dcache_wb_err;
+    logic [31:0] unused_dcache_wb_err_addr;
 
     assign unused_mem_resp_intg_err_i = mem_resp_intg_err_i;
+    assign unused_dcache_wb_err       = dcache_wb_err_i;
+    assign unused_dcache_wb_err_addr  = dcache_wb_err_addr_i;
 
-    // No integrity checking on incoming load data so no internal interrupts
+    // No integrity checking on incoming load data and no data cache so no internal interrupts
     assign irq_nm_int       = 1'b0;
     assign irq_nm_int_cause = nmi_int_cause_e'(0);
     assign irq_nm_int_mtval = '0;
@@ -592,8 +645,10 @@ module ibex_controller #(
         end
 
         if (branch_set_i || jump_set_i) begin
-          // Only set the PC if the branch predictor hasn't already done the branch for us
-          pc_set_o       = BranchPredictor ? ~instr_bp_taken_i : 1'b1;
+          // Only set the PC if the branch predictor hasn't already done the branch for us. A
+          // dynamic predictor may have predicted an indirect jump to the wrong target.
+          pc_set_o       = BranchPredictor ?
+                           ~instr_bp_taken_i | (jump_set_i & bp_target_mismatch_i) : 1'b1;
 
           perf_tbranch_o = branch_set_i;
           perf_jump_o    = jump_set_i;
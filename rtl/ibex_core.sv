@@ -24,15 +24,33 @@ module ibex_core import ibex_pkg::*; #(
   parameter int unsigned            MHPMCounterWidth = 40,
   parameter bit                     RV32E            = 1'b0,
   parameter rv32m_e                 RV32M            = RV32MFast,
+  parameter bit                     RV32MFastDiv     = 1'b0,
   parameter rv32b_e                 RV32B            = RV32BNone,
+  parameter rv32f_e                 RV32F            = RV32FNone,
+  parameter bit                     SoftFloatAssist  = 1'b0,
   parameter bit                     BranchTargetALU  = 1'b0,
   parameter bit                     WritebackStage   = 1'b0,
+  parameter bit                     LoadPipelining   = 1'b0,
+  parameter logic [31:0]            LoadPipeliningRegionBase = LP_REGION_BASE,
+  parameter logic [31:0]            LoadPipeliningRegionMask = LP_REGION_MASK,
+  parameter bit                     MacroOpFusion    = 1'b0,
   parameter bit                     ICache           = 1'b0,
   parameter bit                     ICacheECC        = 1'b0,
+  parameter int unsigned            ICacheNumWays    = IC_NUM_WAYS,
+  parameter int unsigned            ICacheIndexW     = IC_INDEX_W,
+  parameter int unsigned            ICacheLineSize   = IC_LINE_SIZE,
+  parameter bit                     ICachePrefetch   = 1'b0,
+  parameter bit                     DCache           = 1'b0,
+  parameter int unsigned            DCacheSizeBytes  = DC_SIZE_BYTES,
+  parameter int unsigned            DCacheNumWays    = DC_NUM_WAYS,
+  parameter logic [31:0]            DCacheRegionBase = DC_REGION_BASE,
+  parameter logic [31:0]            DCacheRegionMask = DC_REGION_MASK,
   parameter int unsigned            BusSizeECC       = BUS_SIZE,
   parameter int unsigned            TagSizeECC       = IC_TAG_SIZE,
   parameter int unsigned            LineSizeECC      = IC_LINE_SIZE,
   parameter bit                     BranchPredictor  = 1'b0,
+  parameter bit                     BranchPredictorDynamic = 1'b0,
+  parameter bit                     ReturnAddrStack  = 1'b0,
   parameter bit                     DbgTriggerEn     = 1'b0,
   parameter int unsigned            DbgHwBreakNum    = 1,
   parameter bit                     ResetAll         = 1'b0,
@@ -91,16 +109,16 @@ module ibex_core import ibex_pkg::*; #(
   input  logic [RegFileDataWidth-1:0]  rf_rdata_b_ecc_i,
 
   // RAMs interface
-  output logic [IC_NUM_WAYS-1:0]       ic_tag_req_o,
+  output logic [ICacheNumWays-1:0]     ic_tag_req_o,
   output logic                         ic_tag_write_o,
-  output logic [IC_INDEX_W-1:0]        ic_tag_addr_o,
+  output logic [ICacheIndexW-1:0]      ic_tag_addr_o,
   output logic [TagSizeECC-1:0]        ic_tag_wdata_o,
-  input  logic [TagSizeECC-1:0]        ic_tag_rdata_i [IC_NUM_WAYS],
-  output logic [IC_NUM_WAYS-1:0]       ic_data_req_o,
+  input  logic [TagSizeECC-1:0]        ic_tag_rdata_i [ICacheNumWays],
+  output logic [ICacheNumWays-1:0]     ic_data_req_o,
   output logic                         ic_data_write_o,
-  output logic [IC_INDEX_W-1:0]        ic_data_addr_o,
+  output logic [ICacheIndexW-1:0]      ic_data_addr_o,
   output logic [LineSizeECC-1:0]       ic_data_wdata_o,
-  input  logic [LineSizeECC-1:0]       ic_data_rdata_i [IC_NUM_WAYS],
+  input  logic [LineSizeECC-1:0]       ic_data_rdata_i [ICacheNumWays],
   input  logic                         ic_scr_key_valid_i,
   output logic                         ic_scr_key_req_o,
 
@@ -154,10 +172,13 @@ module ibex_core import ibex_pkg::*; #(
   output logic                         rvfi_ext_debug_mode,
   output logic                         rvfi_ext_rf_wr_suppress,
   output logic [63:0]                  rvfi_ext_mcycle,
-  output logic [31:0]                  rvfi_ext_mhpmcounters [10],
-  output logic [31:0]                  rvfi_ext_mhpmcountersh [10],
+  output logic [31:0]                  rvfi_ext_mhpmcounters [29],
+  output logic [31:0]                  rvfi_ext_mhpmcountersh [29],
   output logic                         rvfi_ext_ic_scr_key_valid,
   output logic                         rvfi_ext_irq_valid,
+  output logic                         rvfi_ext_fused,
+  output logic [31:0]                  rvfi_ext_fused_insn,
+  output logic [31:0]                  rvfi_ext_fused_rd_wdata,
   `endif
 
   // CPU Control Signals
@@ -184,8 +205,16 @@ module ibex_core import ibex_pkg::*; #(
                                                // ease fan-out)
   logic [15:0] instr_rdata_c_id;               // Compressed instruction sampled inside IF stage
   logic        instr_is_compressed_id;
+  logic        instr_fused_id;                 // Instruction is the first of a fused pair
+  logic [31:0] instr_rdata_fused_id;           // Second instruction of a fused pair
   logic        instr_perf_count_id;
   logic        instr_bp_taken_id;
+  logic        bp_target_mismatch;             // Predicted jump in ID has a different target
+  logic        bp_branch_resolve;              // Branch in ID resolved, trains the predictor
+  logic        bp_branch_taken;
+  logic        bp_jump_resolve;                // Indirect jump in ID resolved
+  logic        bp_ras_push;                    // Call in ID resolved
+  logic        bp_ras_pop;                     // Return in ID resolved
   logic        instr_fetch_err;                // Bus error on instr fetch
   logic        instr_fetch_err_plus2;          // Instruction error is misaligned
   logic        illegal_c_insn_id;              // Illegal compressed instruction sent to ID stage
@@ -265,6 +294,7 @@ module ibex_core import ibex_pkg::*; #(
   alu_op_e     alu_operator_ex;
   logic [31:0] alu_operand_a_ex;
   logic [31:0] alu_operand_b_ex;
+  logic [31:0] alu_result_mask_ex;
 
   logic [31:0] bt_a_operand;
   logic [31:0] bt_b_operand;
@@ -283,6 +313,15 @@ module ibex_core import ibex_pkg::*; #(
   logic [31:0] multdiv_operand_b_ex;
   logic        multdiv_ready_id;
 
+  // FPU Control
+  logic        fp_en_ex;
+  logic        fp_sel_ex;
+  fp_op_e      fp_operator_ex;
+  fp_rm_e      fp_rm_ex;
+  logic [4:0]  fp_fflags_ex;
+  logic        fp_fflags_we;
+  logic [2:0]  fp_frm;
+
   // CSR control
   logic        csr_access;
   csr_op_e     csr_op;
@@ -299,6 +338,8 @@ module ibex_core import ibex_pkg::*; #(
   logic [1:0]  lsu_type;
   logic        lsu_sign_ext;
   logic        lsu_req;
+  logic        lsu_spec_req;
+  logic        lsu_spec_kill;
   logic        lsu_rdata_valid;
   logic [31:0] lsu_wdata;
   logic        lsu_req_done;
@@ -337,6 +378,23 @@ module ibex_core import ibex_pkg::*; #(
   logic         pmp_req_err  [PMPNumChan];
   logic         data_req_out;
 
+  // LSU <-> data cache, connected straight to the data bus without one
+  logic                    lsu_data_req;
+  logic                    lsu_data_gnt;
+  logic                    lsu_data_rvalid;
+  logic                    lsu_data_we;
+  logic [3:0]              lsu_data_be;
+  logic [31:0]             lsu_data_addr;
+  logic [MemDataWidth-1:0] lsu_data_wdata;
+  logic [MemDataWidth-1:0] lsu_data_rdata;
+  logic                    lsu_data_err;
+  logic                    dcache_flush;
+  logic                    dcache_flush_csr;
+  logic                    dcache_flush_fencei;
+  logic                    dcache_busy;
+  logic                    dcache_wb_err;
+  logic [31:0]             dcache_wb_err_addr;
+
   logic        csr_save_if;
   logic        csr_save_id;
   logic        csr_save_wb;
@@ -369,10 +427,21 @@ module ibex_core import ibex_pkg::*; #(
   logic        perf_instr_ret_compressed_wb;
   logic        perf_instr_ret_wb_spec;
   logic        perf_instr_ret_compressed_wb_spec;
+  logic        perf_instr_ret_fused_wb;
+  logic        perf_instr_ret_fused_wb_spec;
   logic        perf_iside_wait;
   logic        perf_dside_wait;
   logic        perf_mul_wait;
   logic        perf_div_wait;
+  logic        perf_fp_wait;
+  logic        perf_bp_mispredict;
+  logic        perf_ras_hit;
+  logic        perf_icache_hit;
+  logic        perf_icache_miss;
+  logic        perf_icache_prefetch;
+  logic        perf_dcache_hit;
+  logic        perf_dcache_miss;
+  logic        perf_dcache_writeback;
   logic        perf_jump;
   logic        perf_branch;
   logic        perf_tbranch;
@@ -409,9 +478,14 @@ module ibex_core import ibex_pkg::*; #(
         assign core_busy_o[i] = ~|busy_bits_buf[i*NumBusySignals +: NumBusySignals];
       end
     end
+
+    // The data cache isn't available with SecureIbex
+    logic unused_dcache_busy;
+    assign unused_dcache_busy = dcache_busy;
   end else begin : g_core_busy_non_secure
     // For non secure Ibex, synthesis is allowed to optimize core_busy_o.
-    assign core_busy_o = (ctrl_busy || if_busy || lsu_busy) ? IbexMuBiOn : IbexMuBiOff;
+    assign core_busy_o = (ctrl_busy || if_busy || lsu_busy || dcache_busy) ?
+                         IbexMuBiOn : IbexMuBiOff;
   end
 
   //////////////
@@ -424,6 +498,10 @@ module ibex_core import ibex_pkg::*; #(
     .DummyInstructions(DummyInstructions),
     .ICache           (ICache),
     .ICacheECC        (ICacheECC),
+    .ICacheNumWays    (ICacheNumWays),
+    .ICacheIndexW     (ICacheIndexW),
+    .ICacheLineSize   (ICacheLineSize),
+    .ICachePrefetch   (ICachePrefetch),
     .BusSizeECC       (BusSizeECC),
     .TagSizeECC       (TagSizeECC),
     .LineSizeECC      (LineSizeECC),
@@ -432,6 +510,9 @@ module ibex_core import ibex_pkg::*; #(
     .RndCnstLfsrSeed  (RndCnstLfsrSeed),
     .RndCnstLfsrPerm  (RndCnstLfsrPerm),
     .BranchPredictor  (BranchPredictor),
+    .BranchPredictorDynamic(BranchPredictorDynamic),
+    .ReturnAddrStack  (ReturnAddrStack),
+    .MacroOpFusion    (MacroOpFusion),
     .MemECC           (MemECC),
     .MemDataWidth     (MemDataWidth)
   ) if_stage_i (
@@ -475,6 +556,8 @@ module ibex_core import ibex_pkg::*; #(
     .instr_fetch_err_plus2_o (instr_fetch_err_plus2),
     .illegal_c_insn_id_o     (illegal_c_insn_id),
     .dummy_instr_id_o        (dummy_instr_id),
+    .instr_fused_id_o        (instr_fused_id),
+    .instr_rdata_fused_id_o  (instr_rdata_fused_id),
     .pc_if_o                 (pc_if),
     .pc_id_o                 (pc_id),
     .pmp_err_if_i            (pmp_req_err[PMP_I]),
@@ -487,6 +570,7 @@ module ibex_core import ibex_pkg::*; #(
     .nt_branch_mispredict_i(nt_branch_mispredict),
     .exc_pc_mux_i          (exc_pc_mux_id),
     .exc_cause             (exc_cause),
+    .fusion_en_i           (~debug_mode & ~debug_single_step),
     .dummy_instr_en_i      (dummy_instr_en),
     .dummy_instr_mask_i    (dummy_instr_mask),
     .dummy_instr_seed_en_i (dummy_instr_seed_en),
@@ -494,11 +578,23 @@ module ibex_core import ibex_pkg::*; #(
     .icache_enable_i       (icache_enable),
     .icache_inval_i        (icache_inval),
     .icache_ecc_error_o    (icache_ecc_error),
+    .perf_icache_hit_o     (perf_icache_hit),
+    .perf_icache_miss_o    (perf_icache_miss),
+    .perf_icache_prefetch_o(perf_icache_prefetch),
 
     // branch targets
     .branch_target_ex_i(branch_target_ex),
     .nt_branch_addr_i  (nt_branch_addr),
 
+    // dynamic branch predictor training
+    .bp_target_mismatch_o(bp_target_mismatch),
+    .bp_branch_resolve_i (bp_branch_resolve),
+    .bp_branch_taken_i   (bp_branch_taken),
+    .bp_jump_resolve_i   (bp_jump_resolve),
+    .bp_ras_push_i       (bp_ras_push),
+    .bp_ras_pop_i        (bp_ras_pop),
+    .perf_ras_hit_o      (perf_ras_hit),
+
     // CSRs
     .csr_mepc_i      (csr_mepc),  // exception return address
     .csr_depc_i      (csr_depc),  // debug return address
@@ -546,10 +642,15 @@ module ibex_core import ibex_pkg::*; #(
     .RV32E          (RV32E),
     .RV32M          (RV32M),
     .RV32B          (RV32B),
+    .RV32F          (RV32F),
+    .SoftFloatAssist(SoftFloatAssist),
     .BranchTargetALU(BranchTargetALU),
     .DataIndTiming  (DataIndTiming),
     .WritebackStage (WritebackStage),
+    .LoadPipelining (LoadPipelining),
+    .DCache         (DCache),
     .BranchPredictor(BranchPredictor),
+    .MacroOpFusion  (MacroOpFusion),
     .MemECC         (MemECC)
   ) id_stage_i (
     .clk_i (clk_i),
@@ -565,7 +666,15 @@ module ibex_core import ibex_pkg::*; #(
     .instr_rdata_alu_i    (instr_rdata_alu_id),
     .instr_rdata_c_i      (instr_rdata_c_id),
     .instr_is_compressed_i(instr_is_compressed_id),
+    .instr_fused_i        (instr_fused_id),
+    .instr_rdata_fused_i  (instr_rdata_fused_id),
     .instr_bp_taken_i     (instr_bp_taken_id),
+    .bp_target_mismatch_i (bp_target_mismatch),
+    .bp_branch_resolve_o  (bp_branch_resolve),
+    .bp_branch_taken_o    (bp_branch_taken),
+    .bp_jump_resolve_o    (bp_jump_resolve),
+    .bp_ras_push_o        (bp_ras_push),
+    .bp_ras_pop_o         (bp_ras_pop),
 
     // Jumps and branches
     .branch_decision_i(branch_decision),
@@ -583,6 +692,8 @@ module ibex_core import ibex_pkg::*; #(
     .exc_pc_mux_o          (exc_pc_mux_id),
     .exc_cause_o           (exc_cause),
     .icache_inval_o        (icache_inval),
+    .dcache_flush_o        (dcache_flush_fencei),
+    .dcache_busy_i         (dcache_busy),
 
     .instr_fetch_err_i      (instr_fetch_err),
     .instr_fetch_err_plus2_i(instr_fetch_err_plus2),
@@ -594,9 +705,10 @@ module ibex_core import ibex_pkg::*; #(
     .ex_valid_i      (ex_valid),
     .lsu_resp_valid_i(lsu_resp_valid),
 
-    .alu_operator_ex_o (alu_operator_ex),
-    .alu_operand_a_ex_o(alu_operand_a_ex),
-    .alu_operand_b_ex_o(alu_operand_b_ex),
+    .alu_operator_ex_o   (alu_operator_ex),
+    .alu_operand_a_ex_o  (alu_operand_a_ex),
+    .alu_operand_b_ex_o  (alu_operand_b_ex),
+    .alu_result_mask_ex_o(alu_result_mask_ex),
 
     .imd_val_q_ex_o (imd_val_q_ex),
     .imd_val_d_ex_i (imd_val_d_ex),
@@ -615,6 +727,13 @@ module ibex_core import ibex_pkg::*; #(
     .multdiv_operand_b_ex_o  (multdiv_operand_b_ex),
     .multdiv_ready_id_o      (multdiv_ready_id),
 
+    .fp_en_ex_o      (fp_en_ex),
+    .fp_sel_ex_o     (fp_sel_ex),
+    .fp_operator_ex_o(fp_operator_ex),
+    .fp_rm_ex_o      (fp_rm_ex),
+    .fp_frm_i        (fp_frm),
+    .fp_fflags_we_o  (fp_fflags_we),
+
     // CSR ID/EX
     .csr_access_o         (csr_access),
     .csr_op_o             (csr_op),
@@ -634,6 +753,8 @@ module ibex_core import ibex_pkg::*; #(
 
     // LSU
     .lsu_req_o     (lsu_req),  // to load store unit
+    .lsu_spec_req_o(lsu_spec_req),  // to load store unit
+    .lsu_spec_kill_o(lsu_spec_kill),  // to load store unit
     .lsu_we_o      (lsu_we),  // to load store unit
     .lsu_type_o    (lsu_type),  // to load store unit
     .lsu_sign_ext_o(lsu_sign_ext),  // to load store unit
@@ -647,6 +768,8 @@ module ibex_core import ibex_pkg::*; #(
     .lsu_load_resp_intg_err_i (lsu_load_resp_intg_err),
     .lsu_store_err_i          (lsu_store_err),
     .lsu_store_resp_intg_err_i(lsu_store_resp_intg_err),
+    .dcache_wb_err_i          (dcache_wb_err),
+    .dcache_wb_err_addr_i     (dcache_wb_err_addr),
 
     .expecting_load_resp_o (expecting_load_resp_id),
     .expecting_store_resp_o(expecting_store_resp_id),
@@ -703,6 +826,8 @@ module ibex_core import ibex_pkg::*; #(
     .perf_dside_wait_o(perf_dside_wait),
     .perf_mul_wait_o  (perf_mul_wait),
     .perf_div_wait_o  (perf_div_wait),
+    .perf_fp_wait_o   (perf_fp_wait),
+    .perf_bp_mispredict_o(perf_bp_mispredict),
     .instr_id_done_o  (instr_id_done)
   );
 
@@ -711,7 +836,10 @@ module ibex_core import ibex_pkg::*; #(
 
   ibex_ex_block #(
     .RV32M          (RV32M),
+    .RV32MFastDiv   (RV32MFastDiv),
     .RV32B          (RV32B),
+    .RV32F          (RV32F),
+    .SoftFloatAssist(SoftFloatAssist),
     .BranchTargetALU(BranchTargetALU)
   ) ex_block_i (
     .clk_i (clk_i),
@@ -721,6 +849,7 @@ module ibex_core import ibex_pkg::*; #(
     .alu_operator_i         (alu_operator_ex),
     .alu_operand_a_i        (alu_operand_a_ex),
     .alu_operand_b_i        (alu_operand_b_ex),
+    .alu_result_mask_i      (alu_result_mask_ex),
     .alu_instr_first_cycle_i(instr_first_cycle_id),
 
     // Branch target ALU signal from ID stage
@@ -739,6 +868,13 @@ module ibex_core import ibex_pkg::*; #(
     .multdiv_ready_id_i   (multdiv_ready_id),
     .data_ind_timing_i    (data_ind_timing),
 
+    // FPU signals from ID stage
+    .fp_operator_i(fp_operator_ex),
+    .fp_rm_i      (fp_rm_ex),
+    .fp_en_i      (fp_en_ex),
+    .fp_sel_i     (fp_sel_ex),
+    .fp_fflags_o  (fp_fflags_ex),
+
     // Intermediate value register
     .imd_val_we_o(imd_val_we_ex),
     .imd_val_d_o (imd_val_d_ex),
@@ -758,28 +894,31 @@ module ibex_core import ibex_pkg::*; #(
   // Load/store unit //
   /////////////////////
 
-  assign data_req_o   = data_req_out & ~pmp_req_err[PMP_D];
+  assign lsu_data_req = data_req_out & ~pmp_req_err[PMP_D];
   assign lsu_resp_err = lsu_load_err | lsu_store_err;
 
   ibex_load_store_unit #(
     .MemECC(MemECC),
-    .MemDataWidth(MemDataWidth)
+    .MemDataWidth(MemDataWidth),
+    .LoadPipelining(LoadPipelining),
+    .LoadPipeliningRegionBase(LoadPipeliningRegionBase),
+    .LoadPipeliningRegionMask(LoadPipeliningRegionMask)
   ) load_store_unit_i (
     .clk_i (clk_i),
     .rst_ni(rst_ni),
 
     // data interface
     .data_req_o    (data_req_out),
-    .data_gnt_i    (data_gnt_i),
-    .data_rvalid_i (data_rvalid_i),
-    .data_bus_err_i(data_err_i),
+    .data_gnt_i    (lsu_data_gnt),
+    .data_rvalid_i (lsu_data_rvalid),
+    .data_bus_err_i(lsu_data_err),
     .data_pmp_err_i(pmp_req_err[PMP_D]),
 
-    .data_addr_o      (data_addr_o),
-    .data_we_o        (data_we_o),
-    .data_be_o        (data_be_o),
-    .data_wdata_o     (data_wdata_o),
-    .data_rdata_i     (data_rdata_i),
+    .data_addr_o      (lsu_data_addr),
+    .data_we_o        (lsu_data_we),
+    .data_be_o        (lsu_data_be),
+    .data_wdata_o     (lsu_data_wdata),
+    .data_rdata_i     (lsu_data_rdata),
 
     // signals to/from ID/EX stage
     .lsu_we_i      (lsu_we),
@@ -790,6 +929,8 @@ module ibex_core import ibex_pkg::*; #(
     .lsu_rdata_o      (rf_wdata_lsu),
     .lsu_rdata_valid_o(lsu_rdata_valid),
     .lsu_req_i        (lsu_req),
+    .lsu_spec_req_i   (lsu_spec_req),
+    .lsu_spec_kill_i  (lsu_spec_kill),
     .lsu_req_done_o   (lsu_req_done),
 
     .adder_result_ex_i(alu_adder_result_ex),
@@ -812,6 +953,75 @@ module ibex_core import ibex_pkg::*; #(
     .perf_store_o(perf_store)
   );
 
+  ////////////////
+  // Data cache //
+  ////////////////
+
+  // The cache is flushed by a write to the dcacheflush CSR and by FENCE.I
+  assign dcache_flush = dcache_flush_csr | dcache_flush_fencei;
+
+  if (DCache) begin : gen_dcache
+    ibex_dcache #(
+      .DCacheSizeBytes (DCacheSizeBytes),
+      .DCacheNumWays   (DCacheNumWays),
+      .DCacheRegionBase(DCacheRegionBase),
+      .DCacheRegionMask(DCacheRegionMask)
+    ) dcache_i (
+      .clk_i (clk_i),
+      .rst_ni(rst_ni),
+
+      .lsu_req_i   (lsu_data_req),
+      .lsu_gnt_o   (lsu_data_gnt),
+      .lsu_rvalid_o(lsu_data_rvalid),
+      .lsu_we_i    (lsu_data_we),
+      .lsu_be_i    (lsu_data_be),
+      .lsu_addr_i  (lsu_data_addr),
+      .lsu_wdata_i (lsu_data_wdata[31:0]),
+      .lsu_rdata_o (lsu_data_rdata[31:0]),
+      .lsu_err_o   (lsu_data_err),
+
+      .data_req_o   (data_req_o),
+      .data_gnt_i   (data_gnt_i),
+      .data_rvalid_i(data_rvalid_i),
+      .data_we_o    (data_we_o),
+      .data_be_o    (data_be_o),
+      .data_addr_o  (data_addr_o),
+      .data_wdata_o (data_wdata_o[31:0]),
+      .data_rdata_i (data_rdata_i[31:0]),
+      .data_err_i   (data_err_i),
+
+      .flush_i(dcache_flush),
+      .busy_o (dcache_busy),
+
+      .wb_err_o     (dcache_wb_err),
+      .wb_err_addr_o(dcache_wb_err_addr),
+
+      .perf_hit_o      (perf_dcache_hit),
+      .perf_miss_o     (perf_dcache_miss),
+      .perf_writeback_o(perf_dcache_writeback)
+    );
+  end else begin : gen_no_dcache
+    assign data_req_o      = lsu_data_req;
+    assign lsu_data_gnt    = data_gnt_i;
+    assign lsu_data_rvalid = data_rvalid_i;
+    assign data_we_o       = lsu_data_we;
+    assign data_be_o       = lsu_data_be;
+    assign data_addr_o     = lsu_data_addr;
+    assign data_wdata_o    = lsu_data_wdata;
+    assign lsu_data_rdata  = data_rdata_i;
+    assign lsu_data_err    = data_err_i;
+
+    logic unused_dcache_flush;
+    assign unused_dcache_flush = dcache_flush;
+
+    assign dcache_busy           = 1'b0;
+    assign dcache_wb_err         = 1'b0;
+    assign dcache_wb_err_addr    = '0;
+    assign perf_dcache_hit       = 1'b0;
+    assign perf_dcache_miss      = 1'b0;
+    assign perf_dcache_writeback = 1'b0;
+  end
+
   ibex_wb_stage #(
     .ResetAll         (ResetAll),
     .WritebackStage   (WritebackStage),
@@ -823,6 +1033,7 @@ module ibex_core import ibex_pkg::*; #(
     .instr_type_wb_i         (instr_type_wb),
     .pc_id_i                 (pc_id),
     .instr_is_compressed_id_i(instr_is_compressed_id),
+    .instr_is_fused_id_i     (instr_fused_id),
     .instr_perf_count_id_i   (instr_perf_count_id),
 
     .ready_wb_o                         (ready_wb),
@@ -834,6 +1045,8 @@ module ibex_core import ibex_pkg::*; #(
     .perf_instr_ret_compressed_wb_o     (perf_instr_ret_compressed_wb),
     .perf_instr_ret_wb_spec_o           (perf_instr_ret_wb_spec),
     .perf_instr_ret_compressed_wb_spec_o(perf_instr_ret_compressed_wb_spec),
+    .perf_instr_ret_fused_wb_o          (perf_instr_ret_fused_wb),
+    .perf_instr_ret_fused_wb_spec_o     (perf_instr_ret_fused_wb_spec),
 
     .rf_waddr_id_i(rf_waddr_id),
     .rf_wdata_id_i(rf_wdata_id),
@@ -1000,8 +1213,10 @@ module ibex_core import ibex_pkg::*; #(
     `ASSERT(NoMemRFWriteWithoutPendingLoad, rf_we_lsu |-> outstanding_load_id, clk_i, !rst_ni)
   end
 
+  // With LoadPipelining the LSU drops the response to a speculative load that didn't execute
   `ASSERT(NoMemResponseWithoutPendingAccess,
-    data_rvalid_i |-> outstanding_load_resp | outstanding_store_resp, clk_i, !rst_ni)
+    lsu_data_rvalid |-> outstanding_load_resp | outstanding_store_resp |
+                        load_store_unit_i.resp_dropped, clk_i, !rst_ni)
 
 
   // Keep track of the PC last seen in the ID stage when fetch is disabled
@@ -1055,6 +1270,7 @@ module ibex_core import ibex_pkg::*; #(
     .DummyInstructions(DummyInstructions),
     .ShadowCSR        (ShadowCSR),
     .ICache           (ICache),
+    .DCache           (DCache),
     .MHPMCounterNum   (MHPMCounterNum),
     .MHPMCounterWidth (MHPMCounterWidth),
     .PMPEnable        (PMPEnable),
@@ -1066,6 +1282,7 @@ module ibex_core import ibex_pkg::*; #(
     .RV32E            (RV32E),
     .RV32M            (RV32M),
     .RV32B            (RV32B),
+    .RV32F            (RV32F),
     .CsrMvendorId     (CsrMvendorId),
     .CsrMimpId        (CsrMimpId)
   ) cs_registers_i (
@@ -1090,6 +1307,11 @@ module ibex_core import ibex_pkg::*; #(
     .csr_op_en_i (csr_op_en),
     .csr_rdata_o (csr_rdata),
 
+    // Floating point
+    .fp_fflags_we_i(fp_fflags_we),
+    .fp_fflags_i   (fp_fflags_ex),
+    .fp_frm_o      (fp_frm),
+
     // Interrupt related control signals
     .irq_software_i   (irq_software_i),
     .irq_timer_i      (irq_timer_i),
@@ -1129,6 +1351,7 @@ module ibex_core import ibex_pkg::*; #(
     .dummy_instr_seed_en_o(dummy_instr_seed_en),
     .dummy_instr_seed_o   (dummy_instr_seed),
     .icache_enable_o      (icache_enable),
+    .dcache_flush_o       (dcache_flush_csr),
     .csr_shadow_err_o     (csr_shadow_err),
     .ic_scr_key_valid_i   (ic_scr_key_valid_i),
 
@@ -1149,6 +1372,8 @@ module ibex_core import ibex_pkg::*; #(
     .instr_ret_compressed_i     (perf_instr_ret_compressed_wb),
     .instr_ret_spec_i           (perf_instr_ret_wb_spec),
     .instr_ret_compressed_spec_i(perf_instr_ret_compressed_wb_spec),
+    .instr_ret_fused_i          (perf_instr_ret_fused_wb),
+    .instr_ret_fused_spec_i     (perf_instr_ret_fused_wb_spec),
     .iside_wait_i               (perf_iside_wait),
     .jump_i                     (perf_jump),
     .branch_i                   (perf_branch),
@@ -1157,7 +1382,16 @@ module ibex_core import ibex_pkg::*; #(
     .mem_store_i                (perf_store),
     .dside_wait_i               (perf_dside_wait),
     .mul_wait_i                 (perf_mul_wait),
-    .div_wait_i                 (perf_div_wait)
+    .div_wait_i                 (perf_div_wait),
+    .fp_wait_i                  (perf_fp_wait),
+    .branch_mispredict_i        (perf_bp_mispredict),
+    .ras_hit_i                  (perf_ras_hit),
+    .icache_hit_i               (perf_icache_hit),
+    .icache_miss_i              (perf_icache_miss),
+    .icache_prefetch_i          (perf_icache_prefetch),
+    .dcache_hit_i               (perf_dcache_hit),
+    .dcache_miss_i              (perf_dcache_miss),
+    .dcache_writeback_i         (perf_dcache_writeback)
   );
 
   // These assertions are in top-level as instr_valid_id required as the enable term
@@ -1175,15 +1409,17 @@ module ibex_core import ibex_pkg::*; #(
     pmp_req_e    pmp_req_type [PMPNumChan];
     priv_lvl_e   pmp_priv_lvl [PMPNumChan];
 
-    assign pc_if_inc            = pc_if + 32'd2;
+    // With macro-op fusion the second channel checks the next word, which holds the upper half of
+    // a misaligned instruction or the second instruction of a fused pair
+    assign pc_if_inc            = MacroOpFusion ? {pc_if[31:2] + 30'd1, 2'b00} : pc_if + 32'd2;
     assign pmp_req_addr[PMP_I]  = {2'b00, pc_if};
     assign pmp_req_type[PMP_I]  = PMP_ACC_EXEC;
     assign pmp_priv_lvl[PMP_I]  = priv_mode_id;
     assign pmp_req_addr[PMP_I2] = {2'b00, pc_if_inc};
     assign pmp_req_type[PMP_I2] = PMP_ACC_EXEC;
     assign pmp_priv_lvl[PMP_I2] = priv_mode_id;
-    assign pmp_req_addr[PMP_D]  = {2'b00, data_addr_o[31:0]};
-    assign pmp_req_type[PMP_D]  = data_we_o ? PMP_ACC_WRITE : PMP_ACC_READ;
+    assign pmp_req_addr[PMP_D]  = {2'b00, lsu_data_addr[31:0]};
+    assign pmp_req_type[PMP_D]  = lsu_data_we ? PMP_ACC_WRITE : PMP_ACC_READ;
     assign pmp_priv_lvl[PMP_D]  = priv_mode_lsu;
 
     ibex_pmp #(
@@ -1288,6 +1524,8 @@ module ibex_core import ibex_pkg::*; #(
   logic        rvfi_trap_wb;
   logic        rvfi_irq_valid;
   logic [63:0] rvfi_stage_order_d;
+  logic        rvfi_fused_id;
+  logic [31:0] rvfi_fused_rd_wdata_d;
   logic        rvfi_id_done;
   logic        rvfi_wb_done;
 
@@ -1310,10 +1548,13 @@ module ibex_core import ibex_pkg::*; #(
   logic            rvfi_ext_stage_debug_req        [RVFI_STAGES+1];
   logic            rvfi_ext_stage_debug_mode       [RVFI_STAGES];
   logic [63:0]     rvfi_ext_stage_mcycle           [RVFI_STAGES];
-  logic [31:0]     rvfi_ext_stage_mhpmcounters     [RVFI_STAGES][10];
-  logic [31:0]     rvfi_ext_stage_mhpmcountersh    [RVFI_STAGES][10];
+  logic [31:0]     rvfi_ext_stage_mhpmcounters     [RVFI_STAGES][29];
+  logic [31:0]     rvfi_ext_stage_mhpmcountersh    [RVFI_STAGES][29];
   logic            rvfi_ext_stage_ic_scr_key_valid [RVFI_STAGES];
   logic            rvfi_ext_stage_irq_valid        [RVFI_STAGES+1];
+  logic            rvfi_ext_stage_fused            [RVFI_STAGES];
+  logic [31:0]     rvfi_ext_stage_fused_insn       [RVFI_STAGES];
+  logic [31:0]     rvfi_ext_stage_fused_rd_wdata   [RVFI_STAGES];
 
 
   logic        rvfi_stage_valid_d   [RVFI_STAGES];
@@ -1375,6 +1616,9 @@ module ibex_core import ibex_pkg::*; #(
   assign rvfi_ext_mhpmcountersh    = rvfi_ext_stage_mhpmcountersh    [RVFI_STAGES-1];
   assign rvfi_ext_ic_scr_key_valid = rvfi_ext_stage_ic_scr_key_valid [RVFI_STAGES-1];
   assign rvfi_ext_irq_valid        = rvfi_ext_stage_irq_valid        [RVFI_STAGES];
+  assign rvfi_ext_fused            = rvfi_ext_stage_fused            [RVFI_STAGES-1];
+  assign rvfi_ext_fused_insn       = rvfi_ext_stage_fused_insn       [RVFI_STAGES-1];
+  assign rvfi_ext_fused_rd_wdata   = rvfi_ext_stage_fused_rd_wdata   [RVFI_STAGES-1];
 
   // When an instruction takes a trap the `rvfi_trap` signal will be set. Instructions that take
   // traps flush the pipeline so ordinarily wouldn't be seen to be retire. The RVFI tracking
@@ -1436,7 +1680,12 @@ module ibex_core import ibex_pkg::*; #(
     assign rvfi_wb_done = instr_done_wb;
   end
 
-  assign rvfi_stage_order_d = dummy_instr_id ? rvfi_stage_order[0] : rvfi_stage_order[0] + 64'd1;
+  // A fused instruction pair retires both of its instructions at once. Should the first trap (an
+  // illegal rd with RV32E) neither retires and the pair is reported as the first instruction alone.
+  assign rvfi_fused_id      = instr_fused_id & ~rvfi_trap_id;
+  assign rvfi_stage_order_d = dummy_instr_id ? rvfi_stage_order[0]          :
+                              rvfi_fused_id  ? rvfi_stage_order[0] + 64'd2 :
+                                               rvfi_stage_order[0] + 64'd1;
 
   // For interrupts and debug Ibex will take the relevant trap as soon as whatever instruction in ID
   // finishes or immediately if the ID stage is empty. The rvfi_ext interface provides the DV
@@ -1591,9 +1840,12 @@ module ibex_core import ibex_pkg::*; #(
         rvfi_ext_stage_debug_req[i+1]      <= '0;
         rvfi_ext_stage_debug_mode[i]       <= '0;
         rvfi_ext_stage_mcycle[i]           <= '0;
-        rvfi_ext_stage_mhpmcounters[i]     <= '{10{'0}};
-        rvfi_ext_stage_mhpmcountersh[i]    <= '{10{'0}};
+        rvfi_ext_stage_mhpmcounters[i]     <= '{29{'0}};
+        rvfi_ext_stage_mhpmcountersh[i]    <= '{29{'0}};
         rvfi_ext_stage_ic_scr_key_valid[i] <= '0;
+        rvfi_ext_stage_fused[i]            <= '0;
+        rvfi_ext_stage_fused_insn[i]       <= '0;
+        rvfi_ext_stage_fused_rd_wdata[i]   <= '0;
       end else begin
         rvfi_stage_valid[i] <= rvfi_stage_valid_d[i];
 
@@ -1612,7 +1864,7 @@ module ibex_core import ibex_pkg::*; #(
             rvfi_stage_pc_rdata[i]             <= pc_id;
             rvfi_stage_pc_wdata[i]             <= pc_set ? branch_target_ex : pc_if;
             rvfi_stage_mem_rmask[i]            <= rvfi_mem_mask_int;
-            rvfi_stage_mem_wmask[i]            <= data_we_o ? rvfi_mem_mask_int : 4'b0000;
+            rvfi_stage_mem_wmask[i]            <= lsu_data_we ? rvfi_mem_mask_int : 4'b0000;
             rvfi_stage_rs1_rdata[i]            <= rvfi_rs1_data_d;
             rvfi_stage_rs2_rdata[i]            <= rvfi_rs2_data_d;
             rvfi_stage_rs3_rdata[i]            <= rvfi_rs3_data_d;
@@ -1624,9 +1876,12 @@ module ibex_core import ibex_pkg::*; #(
             rvfi_ext_stage_debug_mode[i]       <= debug_mode;
             rvfi_ext_stage_mcycle[i]           <= cs_registers_i.mcycle_counter_i.counter_val_o;
             rvfi_ext_stage_ic_scr_key_valid[i] <= cs_registers_i.cpuctrlsts_ic_scr_key_valid_q;
+            rvfi_ext_stage_fused[i]            <= rvfi_fused_id;
+            rvfi_ext_stage_fused_insn[i]       <= instr_rdata_fused_id;
+            rvfi_ext_stage_fused_rd_wdata[i]   <= rvfi_fused_rd_wdata_d;
             // This is done this way because SystemVerilog does not support looping through
-            // gen_cntrs[k] within a for loop.
-            for (int k=0; k < 10; k++) begin
+            // gen_cntrs[k] within a for loop. Counters beyond MHPMCounterNum read as zero.
+            for (int k=0; k < 29; k++) begin
               rvfi_ext_stage_mhpmcounters[i][k]  <= cs_registers_i.mhpmcounter[k+3][31:0];
               rvfi_ext_stage_mhpmcountersh[i][k] <= cs_registers_i.mhpmcounter[k+3][63:32];
             end
@@ -1678,6 +1933,9 @@ module ibex_core import ibex_pkg::*; #(
             rvfi_ext_stage_ic_scr_key_valid[i] <= rvfi_ext_stage_ic_scr_key_valid[i-1];
             rvfi_ext_stage_mhpmcounters[i]     <= rvfi_ext_stage_mhpmcounters[i-1];
             rvfi_ext_stage_mhpmcountersh[i]    <= rvfi_ext_stage_mhpmcountersh[i-1];
+            rvfi_ext_stage_fused[i]            <= rvfi_ext_stage_fused[i-1];
+            rvfi_ext_stage_fused_insn[i]       <= rvfi_ext_stage_fused_insn[i-1];
+            rvfi_ext_stage_fused_rd_wdata[i]   <= rvfi_ext_stage_fused_rd_wdata[i-1];
           end
 
           // Some of the rvfi_ext_* signals are used to provide an interrupt notification (signalled
@@ -1746,6 +2004,17 @@ module ibex_core import ibex_pkg::*; #(
     end
   end
 
+  // A fused instruction pair is reported as its first instruction, with the second instruction and
+  // the value the first writes to rd (which the second then reads) given on the rvfi_ext_fused*
+  // signals
+  always_comb begin
+    unique case (instr_rdata_id[6:0])
+      OPCODE_LUI:   rvfi_fused_rd_wdata_d = {instr_rdata_id[31:12], 12'b0};
+      OPCODE_AUIPC: rvfi_fused_rd_wdata_d = pc_id + {instr_rdata_id[31:12], 12'b0};
+      default:      rvfi_fused_rd_wdata_d = rvfi_rs1_data_d << instr_rdata_id[24:20];
+    endcase
+  end
+
   // Source registers 1 and 2 are read in the first instruction cycle
   // Source register 3 is read in the second instruction cycle.
   always_comb begin
@@ -1872,9 +2141,21 @@ module ibex_core import ibex_pkg::*; #(
 
   // Certain parameter combinations are not supported
   `ASSERT_INIT(IllegalParamSecure, !(SecureIbex && (RV32M == RV32MNone)))
-
-  // If the ID stage signals its ready the mult/div FSMs must be idle in the following cycle
+  `ASSERT_INIT(IllegalParamFastDiv,
+              !(RV32MFastDiv && !(RV32M inside {RV32MFast, RV32MSingleCycle})))
+  `ASSERT_INIT(IllegalParamBranchPredictorDynamic, !(BranchPredictorDynamic && !BranchPredictor))
+  `ASSERT_INIT(IllegalParamReturnAddrStack, !(ReturnAddrStack && !BranchPredictor))
+  // The data cache doesn't store or check memory integrity bits
+  `ASSERT_INIT(IllegalParamDCacheMemECC, !(DCache && MemECC))
+  // Loads are only requested early while an earlier load is in the writeback stage
+  `ASSERT_INIT(IllegalParamLoadPipelining, !(LoadPipelining && !WritebackStage))
+  // Fusion takes the second instruction from the prefetch buffer and can't match triggers on it
+  `ASSERT_INIT(IllegalParamMacroOpFusion, !(MacroOpFusion && (ICache || DbgTriggerEn)))
+
+  // If the ID stage signals its ready the mult/div and FPU FSMs must be idle in the following
+  // cycle
   `ASSERT(MultDivFSMIdleOnIdReady, id_in_ready |=> ex_block_i.sva_multdiv_fsm_idle)
+  `ASSERT(FpuFSMIdleOnIdReady, id_in_ready |=> ex_block_i.sva_fpu_fsm_idle)
 
   //////////
   // FCOV //
@@ -13,6 +13,7 @@ module ibex_counter #(
   input  logic        rst_ni,
 
   input  logic        counter_inc_i,
+  input  logic        counter_inc_two_i,  // increment by two rather than one
   input  logic        counterh_we_i,
   input  logic        counter_we_i,
   input  logic [31:0] counter_val_i,
@@ -27,7 +28,8 @@ module ibex_counter #(
   logic [CounterWidth-1:0] counter_d;
 
   // Increment
-  assign counter_upd = counter[CounterWidth-1:0] + {{CounterWidth - 1{1'b0}}, 1'b1};
+  assign counter_upd = counter[CounterWidth-1:0] +
+                       CounterWidth'({counter_inc_two_i, ~counter_inc_two_i});
 
   // Update
   always_comb begin
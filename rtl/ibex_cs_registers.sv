@@ -16,6 +16,7 @@ module ibex_cs_registers #(
   parameter bit                     DummyInstructions = 1'b0,
   parameter bit                     ShadowCSR         = 1'b0,
   parameter bit                     ICache            = 1'b0,
+  parameter bit                     DCache            = 1'b0,
   parameter int unsigned            MHPMCounterNum    = 10,
   parameter int unsigned            MHPMCounterWidth  = 40,
   parameter bit                     PMPEnable         = 0,
@@ -27,6 +28,7 @@ module ibex_cs_registers #(
   parameter bit                     RV32E             = 0,
   parameter ibex_pkg::rv32m_e RV32M                   = ibex_pkg::RV32MFast,
   parameter ibex_pkg::rv32b_e RV32B                   = ibex_pkg::RV32BNone,
+  parameter ibex_pkg::rv32f_e RV32F                   = ibex_pkg::RV32FNone,
   // mvendorid: encoding of manufacturer/provider
   parameter logic [31:0]            CsrMvendorId      = 32'b0,
   // mimpid: encoding of processor implementation version
@@ -57,6 +59,11 @@ module ibex_cs_registers #(
   input                        csr_op_en_i,
   output logic [31:0]          csr_rdata_o,
 
+  // Floating point exception flags (accumulated into fflags) and dynamic rounding mode
+  input  logic                 fp_fflags_we_i,
+  input  logic [4:0]           fp_fflags_i,
+  output logic [2:0]           fp_frm_o,
+
   // interrupts
   input  logic                 irq_software_i,
   input  logic                 irq_timer_i,
@@ -96,6 +103,7 @@ module ibex_cs_registers #(
   output logic                 dummy_instr_seed_en_o,
   output logic [31:0]          dummy_instr_seed_o,
   output logic                 icache_enable_o,
+  output logic                 dcache_flush_o,
   output logic                 csr_shadow_err_o,
   input  logic                 ic_scr_key_valid_i,
 
@@ -117,6 +125,8 @@ module ibex_cs_registers #(
   input  logic                 instr_ret_compressed_i,      // compressed instr retired
   input  logic                 instr_ret_spec_i,            // speculative instr_ret_i
   input  logic                 instr_ret_compressed_spec_i, // speculative instr_ret_compressed_i
+  input  logic                 instr_ret_fused_i,           // fused instr pair retired
+  input  logic                 instr_ret_fused_spec_i,      // speculative instr_ret_fused_i
   input  logic                 iside_wait_i,                // core waiting for the iside
   input  logic                 jump_i,                      // jump instr seen (j, jr, jal, jalr)
   input  logic                 branch_i,                    // branch instr seen (bf, bnf)
@@ -125,7 +135,16 @@ module ibex_cs_registers #(
   input  logic                 mem_store_i,                 // store to memory in this cycle
   input  logic                 dside_wait_i,                // core waiting for the dside
   input  logic                 mul_wait_i,                  // core waiting for multiply
-  input  logic                 div_wait_i                   // core waiting for divide
+  input  logic                 div_wait_i,                  // core waiting for divide
+  input  logic                 fp_wait_i,                   // core waiting for the FPU
+  input  logic                 branch_mispredict_i,         // branch or jump mispredicted
+  input  logic                 ras_hit_i,                   // return predicted by the RAS
+  input  logic                 icache_hit_i,                // icache lookup hit
+  input  logic                 icache_miss_i,               // icache lookup missed
+  input  logic                 icache_prefetch_i,           // prefetched icache line used
+  input  logic                 dcache_hit_i,                // dcache access hit
+  input  logic                 dcache_miss_i,               // dcache access missed
+  input  logic                 dcache_writeback_i           // dirty dcache line written back
 );
 
   import ibex_pkg::*;
@@ -240,6 +259,10 @@ module ibex_cs_registers #(
   logic [31:0] dscratch0_q;
   logic [31:0] dscratch1_q;
   logic        dscratch0_en, dscratch1_en;
+  logic [4:0]  fflags_q, fflags_d;
+  logic        fflags_en;
+  logic [2:0]  frm_q, frm_d;
+  logic        frm_en;
 
   // CSRs for recoverable NMIs
   // NOTE: these CSRS are nonstandard, see https://github.com/riscv/riscv-isa-manual/issues/261
@@ -335,6 +358,20 @@ module ibex_cs_registers #(
     dbg_csr       = 1'b0;
 
     unique case (csr_addr_i)
+      // fflags, frm, fcsr: floating point exception flags and rounding mode
+      CSR_FFLAGS: begin
+        csr_rdata_int = {27'b0, fflags_q};
+        illegal_csr   = (RV32F == RV32FNone);
+      end
+      CSR_FRM: begin
+        csr_rdata_int = {29'b0, frm_q};
+        illegal_csr   = (RV32F == RV32FNone);
+      end
+      CSR_FCSR: begin
+        csr_rdata_int = {24'b0, frm_q, fflags_q};
+        illegal_csr   = (RV32F == RV32FNone);
+      end
+
       // mvendorid: encoding of manufacturer/provider
       CSR_MVENDORID: csr_rdata_int = CsrMvendorId;
       // marchid: encoding of base microarchitecture
@@ -548,6 +585,12 @@ module ibex_cs_registers #(
         csr_rdata_int = '0;
       end
 
+      // Custom CSR for flushing the data cache (cannot be read), only present with the cache
+      CSR_DCACHEFLUSH: begin
+        csr_rdata_int = '0;
+        illegal_csr   = ~DCache;
+      end
+
       default: begin
         illegal_csr = 1'b1;
       end
@@ -593,6 +636,12 @@ module ibex_cs_registers #(
     dscratch0_en = 1'b0;
     dscratch1_en = 1'b0;
 
+    // Flags raised by the FPU accumulate
+    fflags_en    = fp_fflags_we_i;
+    fflags_d     = fflags_q | fp_fflags_i;
+    frm_en       = 1'b0;
+    frm_d        = csr_wdata_int[2:0];
+
     mstack_en      = 1'b0;
     mstack_d.mpie  = mstatus_q.mpie;
     mstack_d.mpp   = mstatus_q.mpp;
@@ -610,6 +659,20 @@ module ibex_cs_registers #(
 
     if (csr_we_int) begin
       unique case (csr_addr_i)
+        CSR_FFLAGS: begin
+          fflags_en = 1'b1;
+          fflags_d  = csr_wdata_int[4:0];
+        end
+
+        CSR_FRM: frm_en = 1'b1;
+
+        CSR_FCSR: begin
+          fflags_en = 1'b1;
+          fflags_d  = csr_wdata_int[4:0];
+          frm_en    = 1'b1;
+          frm_d     = csr_wdata_int[7:5];
+        end
+
         // mstatus: IE bit
         CSR_MSTATUS: begin
           mstatus_en = 1'b1;
@@ -1075,6 +1138,50 @@ module ibex_cs_registers #(
     .rd_error_o()
   );
 
+  // FFLAGS, FRM (only present with the FPU)
+  if (RV32F != RV32FNone) begin : g_fp_csrs
+    ibex_csr #(
+      .Width     (5),
+      .ShadowCopy(1'b0),
+      .ResetValue('0)
+    ) u_fflags_csr (
+      .clk_i     (clk_i),
+      .rst_ni    (rst_ni),
+      .wr_data_i (fflags_d),
+      .wr_en_i   (fflags_en),
+      .rd_data_o (fflags_q),
+      .rd_error_o()
+    );
+
+    ibex_csr #(
+      .Width     (3),
+      .ShadowCopy(1'b0),
+      .ResetValue('0)
+    ) u_frm_csr (
+      .clk_i     (clk_i),
+      .rst_ni    (rst_ni),
+      .wr_data_i (frm_d),
+      .wr_en_i   (frm_en),
+      .rd_data_o (frm_q),
+      .rd_error_o()
+    );
+  end else begin : g_no_fp_csrs
+    // Tieoff for the unused FP CSR signals
+    logic [4:0] unused_fflags_d;
+    logic       unused_fflags_en;
+    logic [2:0] unused_frm_d;
+    logic       unused_frm_en;
+
+    assign fflags_q         = '0;
+    assign frm_q            = '0;
+    assign unused_fflags_d  = fflags_d;
+    assign unused_fflags_en = fflags_en;
+    assign unused_frm_d     = frm_d;
+    assign unused_frm_en    = frm_en;
+  end
+
+  assign fp_frm_o = frm_q;
+
   // -----------------
   // PMP registers
   // -----------------
@@ -1305,6 +1412,16 @@ module ibex_cs_registers #(
     mhpmcounter_incr[10] = instr_ret_compressed_i; // num of compressed instr
     mhpmcounter_incr[11] = mul_wait_i;             // cycles waiting for multiply
     mhpmcounter_incr[12] = div_wait_i;             // cycles waiting for divide
+    mhpmcounter_incr[13] = fp_wait_i;              // cycles waiting for the FPU
+    mhpmcounter_incr[14] = branch_mispredict_i;    // num of branch predictor mispredictions
+    mhpmcounter_incr[15] = ras_hit_i;              // num of returns predicted by the RAS
+    mhpmcounter_incr[16] = icache_hit_i;           // num of icache hits
+    mhpmcounter_incr[17] = icache_miss_i;          // num of icache misses
+    mhpmcounter_incr[18] = icache_prefetch_i;      // num of useful icache prefetches
+    mhpmcounter_incr[19] = dcache_hit_i;           // num of dcache hits
+    mhpmcounter_incr[20] = dcache_miss_i;          // num of dcache misses
+    mhpmcounter_incr[21] = dcache_writeback_i;     // num of dcache lines written back
+    mhpmcounter_incr[22] = instr_ret_fused_i;      // num of fused instr pairs
   end
 
   // event selector (hardwired, 0 means no event)
@@ -1333,6 +1450,7 @@ module ibex_cs_registers #(
     .clk_i(clk_i),
     .rst_ni(rst_ni),
     .counter_inc_i(mhpmcounter_incr[0] & ~mcountinhibit[0]),
+    .counter_inc_two_i(1'b0),
     .counterh_we_i(mhpmcounterh_we[0]),
     .counter_we_i(mhpmcounter_we[0]),
     .counter_val_i(csr_wdata_int),
@@ -1349,6 +1467,9 @@ module ibex_cs_registers #(
     .clk_i(clk_i),
     .rst_ni(rst_ni),
     .counter_inc_i(mhpmcounter_incr[2] & ~mcountinhibit[2]),
+    // A fused instruction pair retires two instructions at once, the speculative signal gives the
+    // right minstret_next below
+    .counter_inc_two_i(instr_ret_fused_i | instr_ret_fused_spec_i),
     .counterh_we_i(mhpmcounterh_we[2]),
     .counter_we_i(mhpmcounter_we[2]),
     .counter_val_i(csr_wdata_int),
@@ -1385,6 +1506,7 @@ module ibex_cs_registers #(
         .clk_i(clk_i),
         .rst_ni(rst_ni),
         .counter_inc_i(mhpmcounter_incr[Cnt] & ~mcountinhibit[Cnt]),
+        .counter_inc_two_i(1'b0),
         .counterh_we_i(mhpmcounterh_we[Cnt]),
         .counter_we_i(mhpmcounter_we[Cnt]),
         .counter_val_i(csr_wdata_int),
@@ -1656,6 +1778,9 @@ module ibex_cs_registers #(
   assign cpuctrlsts_part_wdata.double_fault_seen = cpuctrlsts_part_wdata_raw.double_fault_seen;
   assign cpuctrlsts_part_wdata.sync_exc_seen     = cpuctrlsts_part_wdata_raw.sync_exc_seen;
 
+  // Any write to the flush CSR writes back and invalidates the data cache
+  assign dcache_flush_o = DCache && csr_we_int && (csr_addr == CSR_DCACHEFLUSH);
+
   assign icache_enable_o =
     cpuctrlsts_part_q.icache_enable & ~(debug_mode_i | debug_mode_entering_i);
 
@@ -0,0 +1,456 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Data cache
+ *
+ * Small write-back, write-allocate data cache between the load-store unit and the data bus.
+ * Lines are held in flops and are filled and written back over the data bus one word at a time.
+ * Accesses outside the cacheable region are passed straight through to the bus. A failed write back
+ * has no access left to report it to and is signalled separately so the core can raise an
+ * imprecise error.
+ */
+
+`include "prim_assert.sv"
+
+module ibex_dcache import ibex_pkg::*; #(
+  parameter int unsigned DCacheSizeBytes  = DC_SIZE_BYTES,
+  // 1 (direct-mapped) or 2 ways
+  parameter int unsigned DCacheNumWays    = DC_NUM_WAYS,
+  parameter int unsigned DCacheLineSize   = DC_LINE_SIZE,
+  // Addresses with (addr & DCacheRegionMask) == DCacheRegionBase are cached
+  parameter logic [31:0] DCacheRegionBase = DC_REGION_BASE,
+  parameter logic [31:0] DCacheRegionMask = DC_REGION_MASK
+) (
+  // Clock and reset
+  input  logic        clk_i,
+  input  logic        rst_ni,
+
+  // Accesses from the load-store unit
+  input  logic        lsu_req_i,
+  output logic        lsu_gnt_o,
+  output logic        lsu_rvalid_o,
+  input  logic        lsu_we_i,
+  input  logic [3:0]  lsu_be_i,
+  input  logic [31:0] lsu_addr_i,
+  input  logic [31:0] lsu_wdata_i,
+  output logic [31:0] lsu_rdata_o,
+  output logic        lsu_err_o,
+
+  // Data bus
+  output logic        data_req_o,
+  input  logic        data_gnt_i,
+  input  logic        data_rvalid_i,
+  output logic        data_we_o,
+  output logic [3:0]  data_be_o,
+  output logic [31:0] data_addr_o,
+  output logic [31:0] data_wdata_o,
+  input  logic [31:0] data_rdata_i,
+  input  logic        data_err_i,
+
+  // Write back all dirty lines and invalidate the cache
+  input  logic        flush_i,
+
+  // Cache status
+  output logic        busy_o,
+
+  // A dirty line write back saw a bus error, with the address of the failed word
+  output logic        wb_err_o,
+  output logic [31:0] wb_err_addr_o,
+
+  // Performance counter events
+  output logic        perf_hit_o,
+  output logic        perf_miss_o,
+  output logic        perf_writeback_o
+);
+
+  // Cache geometry
+  localparam int unsigned LINE_BYTES = DCacheLineSize / 8;
+  localparam int unsigned LINE_WORDS = DCacheLineSize / 32;
+  localparam int unsigned LINE_W     = $clog2(LINE_BYTES);
+  localparam int unsigned WORD_W     = $clog2(LINE_WORDS);
+  localparam int unsigned NUM_LINES  = DCacheSizeBytes / DCacheNumWays / LINE_BYTES;
+  localparam int unsigned INDEX_W    = $clog2(NUM_LINES);
+  localparam int unsigned TAG_SIZE   = 32 - INDEX_W - LINE_W;
+  localparam int unsigned WAY_W      = (DCacheNumWays > 1) ? $clog2(DCacheNumWays) : 1;
+
+  typedef enum logic [2:0] {
+    DcIdle,
+    DcBypass,
+    DcWriteback,
+    DcRefill,
+    DcError,
+    DcFlush
+  } dc_state_e;
+
+  dc_state_e                   dc_state_q, dc_state_d;
+
+  // Cache storage
+  logic [TAG_SIZE-1:0]         tag_q   [DCacheNumWays][NUM_LINES];
+  logic [31:0]                 data_q  [DCacheNumWays][NUM_LINES][LINE_WORDS];
+  logic [DCacheNumWays-1:0]    valid_q [NUM_LINES];
+  logic [DCacheNumWays-1:0]    dirty_q [NUM_LINES];
+  // Way to replace next in each set (least recently used)
+  logic [NUM_LINES-1:0]        lru_q;
+
+  // Lookup of the LSU request
+  logic [INDEX_W-1:0]          req_index;
+  logic [TAG_SIZE-1:0]         req_tag;
+  logic [WORD_W-1:0]           req_word;
+  logic                        req_cacheable;
+  logic [DCacheNumWays-1:0]    hit_ways;
+  logic                        req_hit;
+  logic [WAY_W-1:0]            hit_way;
+  logic [WAY_W-1:0]            victim_way;
+  logic [31:0]                 hit_rdata;
+  logic                        lookup_req;
+  logic                        lookup_hit;
+  logic                        lookup_miss;
+  logic                        bypass_req;
+
+  // Line being written back or refilled
+  logic [INDEX_W-1:0]          line_index_q, line_index_d;
+  logic [WAY_W-1:0]            line_way_q, line_way_d;
+  logic [TAG_SIZE-1:0]         wb_tag_q, wb_tag_d;
+  logic [TAG_SIZE-1:0]         fill_tag_q, fill_tag_d;
+  logic [WORD_W:0]             ext_cnt_q, ext_cnt_d;
+  logic [WORD_W:0]             rvd_cnt_q, rvd_cnt_d;
+  logic                        line_err_q, line_err_d;
+  logic                        wb_flush_q, wb_flush_d;
+  logic                        line_req;
+  logic                        line_last_rvalid;
+  logic                        fill_done;
+  logic                        wb_done;
+  // The access that caused a refill retries (and hits) once it completes
+  logic                        fill_retry_q;
+
+  // Flush
+  logic                        flush_pending_q, flush_pending_d;
+  logic                        flush_req;
+  logic [INDEX_W-1:0]          flush_index_q, flush_index_d;
+  logic [WAY_W-1:0]            flush_way_q, flush_way_d;
+  logic                        flush_dirty;
+  logic                        flush_inval;
+  logic                        flush_last;
+
+  // Response to the LSU for hits and errors
+  logic                        resp_valid_q, resp_valid_d;
+  logic [31:0]                 resp_rdata_q, resp_rdata_d;
+  logic                        resp_err_q, resp_err_d;
+
+  ////////////
+  // Lookup //
+  ////////////
+
+  assign req_index     = lsu_addr_i[LINE_W+:INDEX_W];
+  assign req_tag       = lsu_addr_i[31-:TAG_SIZE];
+  assign req_word      = lsu_addr_i[2+:WORD_W];
+  assign req_cacheable = (lsu_addr_i & DCacheRegionMask) == DCacheRegionBase;
+
+  for (genvar way = 0; way < DCacheNumWays; way++) begin : gen_hit_ways
+    assign hit_ways[way] = valid_q[req_index][way] & (tag_q[way][req_index] == req_tag);
+  end
+
+  assign req_hit = |hit_ways;
+
+  if (DCacheNumWays > 1) begin : gen_two_ways
+    assign hit_way    = hit_ways[1];
+    // Fill an invalid way before replacing the least recently used one
+    assign victim_way = ~valid_q[req_index][0] ? 1'b0 :
+                        ~valid_q[req_index][1] ? 1'b1 : lru_q[req_index];
+  end else begin : gen_one_way
+    assign hit_way    = 1'b0;
+    assign victim_way = 1'b0;
+
+    logic unused_lru;
+    assign unused_lru = ^lru_q;
+  end
+
+  assign hit_rdata = data_q[hit_way][req_index][req_word];
+
+  // A pending flush is started before any further access is granted
+  assign flush_req   = flush_i | flush_pending_q;
+
+  assign lookup_req  = (dc_state_q == DcIdle) & lsu_req_i & req_cacheable & ~flush_req;
+  assign lookup_hit  = lookup_req & req_hit;
+  assign lookup_miss = lookup_req & ~req_hit;
+  assign bypass_req  = (dc_state_q == DcIdle) & lsu_req_i & ~req_cacheable & ~flush_req;
+
+  /////////////////////////
+  // Line fill and evict //
+  /////////////////////////
+
+  // Write backs and refills make LINE_WORDS word accesses, counting grants and responses
+  // separately so requests can be pipelined on the bus.
+  assign line_req         = ((dc_state_q == DcWriteback) | (dc_state_q == DcRefill)) &
+                            (ext_cnt_q != LINE_WORDS[WORD_W:0]);
+  assign line_last_rvalid = data_rvalid_i &
+                            (rvd_cnt_q == LINE_WORDS[WORD_W:0] - {{WORD_W{1'b0}}, 1'b1});
+  assign wb_done          = (dc_state_q == DcWriteback) & line_last_rvalid;
+  assign fill_done        = (dc_state_q == DcRefill) & line_last_rvalid;
+
+  // Walk every line of every way during a flush
+  assign flush_dirty = (dc_state_q == DcFlush) &
+                       valid_q[flush_index_q][flush_way_q] & dirty_q[flush_index_q][flush_way_q];
+  assign flush_inval = (dc_state_q == DcFlush) & ~flush_dirty;
+  assign flush_last  = (flush_index_q == INDEX_W'(NUM_LINES - 1)) &
+                       (flush_way_q == WAY_W'(DCacheNumWays - 1));
+
+  always_comb begin
+    dc_state_d      = dc_state_q;
+    line_index_d    = line_index_q;
+    line_way_d      = line_way_q;
+    wb_tag_d        = wb_tag_q;
+    fill_tag_d      = fill_tag_q;
+    ext_cnt_d       = ext_cnt_q;
+    rvd_cnt_d       = rvd_cnt_q;
+    line_err_d      = line_err_q;
+    wb_flush_d      = wb_flush_q;
+    flush_pending_d = flush_pending_q | flush_i;
+    flush_index_d   = flush_index_q;
+    flush_way_d     = flush_way_q;
+    resp_valid_d    = 1'b0;
+    resp_rdata_d    = resp_rdata_q;
+    resp_err_d      = 1'b0;
+
+    if (line_req && data_gnt_i) begin
+      ext_cnt_d = ext_cnt_q + {{WORD_W{1'b0}}, 1'b1};
+    end
+    if ((dc_state_q == DcWriteback || dc_state_q == DcRefill) && data_rvalid_i) begin
+      rvd_cnt_d  = rvd_cnt_q + {{WORD_W{1'b0}}, 1'b1};
+    end
+    // Write back errors are reported through wb_err_o instead
+    if ((dc_state_q == DcRefill) && data_rvalid_i) begin
+      line_err_d = line_err_q | data_err_i;
+    end
+
+    unique case (dc_state_q)
+      DcIdle: begin
+        if (flush_req) begin
+          dc_state_d    = DcFlush;
+          flush_index_d = '0;
+          flush_way_d   = '0;
+        end else if (bypass_req && data_gnt_i) begin
+          dc_state_d = DcBypass;
+        end else if (lookup_hit) begin
+          resp_valid_d = 1'b1;
+          resp_rdata_d = hit_rdata;
+        end else if (lookup_miss) begin
+          // The request is granted once the line has been refilled and it hits
+          line_index_d = req_index;
+          line_way_d   = victim_way;
+          wb_tag_d     = tag_q[victim_way][req_index];
+          fill_tag_d   = req_tag;
+          ext_cnt_d    = '0;
+          rvd_cnt_d    = '0;
+          line_err_d   = 1'b0;
+          wb_flush_d   = 1'b0;
+          dc_state_d   = valid_q[req_index][victim_way] & dirty_q[req_index][victim_way] ?
+                         DcWriteback : DcRefill;
+        end
+      end
+
+      DcBypass: begin
+        if (data_rvalid_i) begin
+          dc_state_d = DcIdle;
+        end
+      end
+
+      DcWriteback: begin
+        if (wb_done) begin
+          ext_cnt_d  = '0;
+          rvd_cnt_d  = '0;
+          dc_state_d = wb_flush_q ? DcFlush : DcRefill;
+        end
+      end
+
+      DcRefill: begin
+        if (fill_done) begin
+          dc_state_d = (line_err_q | data_err_i) ? DcError : DcIdle;
+        end
+      end
+
+      DcError: begin
+        // Grant the access that missed with an error response
+        if (lsu_req_i) begin
+          resp_valid_d = 1'b1;
+          resp_err_d   = 1'b1;
+          dc_state_d   = DcIdle;
+        end
+      end
+
+      DcFlush: begin
+        if (flush_dirty) begin
+          line_index_d = flush_index_q;
+          line_way_d   = flush_way_q;
+          wb_tag_d     = tag_q[flush_way_q][flush_index_q];
+          ext_cnt_d    = '0;
+          rvd_cnt_d    = '0;
+          line_err_d   = 1'b0;
+          wb_flush_d   = 1'b1;
+          dc_state_d   = DcWriteback;
+        end else if (flush_last) begin
+          flush_pending_d = flush_i;
+          dc_state_d      = DcIdle;
+        end else if (flush_way_q == WAY_W'(DCacheNumWays - 1)) begin
+          flush_way_d   = '0;
+          flush_index_d = flush_index_q + {{INDEX_W-1{1'b0}}, 1'b1};
+        end else begin
+          flush_way_d   = flush_way_q + {{WAY_W-1{1'b0}}, 1'b1};
+        end
+      end
+
+      default: dc_state_d = DcIdle;
+    endcase
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      dc_state_q      <= DcIdle;
+      line_index_q    <= '0;
+      line_way_q      <= '0;
+      wb_tag_q        <= '0;
+      fill_tag_q      <= '0;
+      ext_cnt_q       <= '0;
+      rvd_cnt_q       <= '0;
+      line_err_q      <= 1'b0;
+      wb_flush_q      <= 1'b0;
+      flush_pending_q <= 1'b0;
+      flush_index_q   <= '0;
+      flush_way_q     <= '0;
+      resp_valid_q    <= 1'b0;
+      resp_rdata_q    <= '0;
+      resp_err_q      <= 1'b0;
+    end else begin
+      dc_state_q      <= dc_state_d;
+      line_index_q    <= line_index_d;
+      line_way_q      <= line_way_d;
+      wb_tag_q        <= wb_tag_d;
+      fill_tag_q      <= fill_tag_d;
+      ext_cnt_q       <= ext_cnt_d;
+      rvd_cnt_q       <= rvd_cnt_d;
+      line_err_q      <= line_err_d;
+      wb_flush_q      <= wb_flush_d;
+      flush_pending_q <= flush_pending_d;
+      flush_index_q   <= flush_index_d;
+      flush_way_q     <= flush_way_d;
+      resp_valid_q    <= resp_valid_d;
+      resp_rdata_q    <= resp_rdata_d;
+      resp_err_q      <= resp_err_d;
+    end
+  end
+
+  /////////////
+  // Storage //
+  /////////////
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      for (int unsigned line = 0; line < NUM_LINES; line++) begin
+        valid_q[line] <= '0;
+        dirty_q[line] <= '0;
+      end
+      lru_q        <= '0;
+      fill_retry_q <= 1'b0;
+    end else begin
+      if (fill_done) begin
+        fill_retry_q <= 1'b1;
+      end else if (lookup_req) begin
+        fill_retry_q <= 1'b0;
+      end
+
+      if (lookup_hit) begin
+        dirty_q[req_index][hit_way] <= dirty_q[req_index][hit_way] | lsu_we_i;
+        lru_q[req_index]            <= ~hit_way[0];
+      end
+      if (wb_done) begin
+        dirty_q[line_index_q][line_way_q] <= 1'b0;
+      end
+      if (fill_done) begin
+        valid_q[line_index_q][line_way_q] <= ~(line_err_q | data_err_i);
+      end
+      if (flush_inval) begin
+        valid_q[flush_index_q][flush_way_q] <= 1'b0;
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i) begin
+    if (lookup_hit && lsu_we_i) begin
+      for (int unsigned b = 0; b < 4; b++) begin
+        if (lsu_be_i[b]) begin
+          data_q[hit_way][req_index][req_word][b*8+:8] <= lsu_wdata_i[b*8+:8];
+        end
+      end
+    end
+    if ((dc_state_q == DcRefill) && data_rvalid_i) begin
+      data_q[line_way_q][line_index_q][rvd_cnt_q[WORD_W-1:0]] <= data_rdata_i;
+    end
+    if (fill_done) begin
+      tag_q[line_way_q][line_index_q] <= fill_tag_q;
+    end
+  end
+
+  ////////////////
+  // Interfaces //
+  ////////////////
+
+  assign lsu_gnt_o    = lookup_hit | (bypass_req & data_gnt_i) |
+                        ((dc_state_q == DcError) & lsu_req_i);
+  assign lsu_rvalid_o = resp_valid_q | ((dc_state_q == DcBypass) & data_rvalid_i);
+  assign lsu_rdata_o  = resp_valid_q ? resp_rdata_q : data_rdata_i;
+  assign lsu_err_o    = resp_valid_q ? resp_err_q   : data_err_i;
+
+  always_comb begin
+    if (dc_state_q == DcWriteback) begin
+      data_req_o   = line_req;
+      data_we_o    = 1'b1;
+      data_be_o    = 4'b1111;
+      data_addr_o  = {wb_tag_q, line_index_q, ext_cnt_q[WORD_W-1:0], 2'b00};
+      data_wdata_o = data_q[line_way_q][line_index_q][ext_cnt_q[WORD_W-1:0]];
+    end else if (dc_state_q == DcRefill) begin
+      data_req_o   = line_req;
+      data_we_o    = 1'b0;
+      data_be_o    = 4'b1111;
+      data_addr_o  = {fill_tag_q, line_index_q, ext_cnt_q[WORD_W-1:0], 2'b00};
+      data_wdata_o = '0;
+    end else begin
+      data_req_o   = bypass_req;
+      data_we_o    = lsu_we_i;
+      data_be_o    = lsu_be_i;
+      data_addr_o  = lsu_addr_i;
+      data_wdata_o = lsu_wdata_i;
+    end
+  end
+
+  assign busy_o = (dc_state_q != DcIdle) | flush_pending_q | resp_valid_q;
+
+  assign wb_err_o      = (dc_state_q == DcWriteback) & data_rvalid_i & data_err_i;
+  assign wb_err_addr_o = {wb_tag_q, line_index_q, rvd_cnt_q[WORD_W-1:0], 2'b00};
+
+  ////////////////////////////////
+  // Performance counter events //
+  ////////////////////////////////
+
+  assign perf_hit_o       = lookup_hit & ~fill_retry_q;
+  assign perf_miss_o      = lookup_miss;
+  assign perf_writeback_o = wb_done;
+
+  ////////////////
+  // Assertions //
+  ////////////////
+
+  `ASSERT_INIT(size_param_legal, (DCacheLineSize >= 64) &&
+                                 (DCacheLineSize == 2**$clog2(DCacheLineSize)))
+  `ASSERT_INIT(ways_param_legal, (DCacheNumWays == 1) || (DCacheNumWays == 2))
+  `ASSERT_INIT(lines_param_legal, (NUM_LINES >= 2) && (NUM_LINES == 2**INDEX_W))
+
+  // A line fill never returns more responses than it made requests
+  `ASSERT(LineResponseOrder, (dc_state_q inside {DcWriteback, DcRefill}) & data_rvalid_i |->
+          (rvd_cnt_q < ext_cnt_q), clk_i, !rst_ni)
+  // Only one of the hit response and the bypass response is returned at once
+  `ASSERT(SingleResponse, resp_valid_q |-> ~((dc_state_q == DcBypass) & data_rvalid_i),
+          clk_i, !rst_ni)
+
+endmodule
@@ -17,7 +17,10 @@ module ibex_decoder #(
   parameter bit RV32E               = 0,
   parameter ibex_pkg::rv32m_e RV32M = ibex_pkg::RV32MFast,
   parameter ibex_pkg::rv32b_e RV32B = ibex_pkg::RV32BNone,
-  parameter bit BranchTargetALU     = 0
+  parameter ibex_pkg::rv32f_e RV32F = ibex_pkg::RV32FNone,
+  parameter bit SoftFloatAssist     = 0,
+  parameter bit BranchTargetALU     = 0,
+  parameter bit MacroOpFusion       = 0
 ) (
   input  logic                 clk_i,
   input  logic                 rst_ni,
@@ -33,6 +36,7 @@ module ibex_decoder #(
   output logic                 jump_set_o,            // jump taken set signal
   input  logic                 branch_taken_i,        // registered branch decision
   output logic                 icache_inval_o,
+  output logic                 fencei_insn_o,         // fence.i instr encountered
 
   // from IF-ID pipeline register
   input  logic                 instr_first_cycle_i,   // instruction read is in its first cycle
@@ -41,6 +45,8 @@ module ibex_decoder #(
                                                       // replicated to ease fan-out)
 
   input  logic                 illegal_c_insn_i,      // compressed instruction decode failed
+  input  logic                 instr_fused_i,         // instruction is the first of a fused pair
+  input  logic [31:0]          instr_rdata_fused_i,   // second instruction of a fused pair
 
   // immediates
   output ibex_pkg::imm_a_sel_e  imm_a_mux_sel_o,       // immediate selection for operand a
@@ -70,6 +76,7 @@ module ibex_decoder #(
   output ibex_pkg::op_b_sel_e  alu_op_b_mux_sel_o,    // operand b selection: reg value or
                                                       // immediate
   output logic                 alu_multicycle_o,      // ternary bitmanip instruction
+  output logic [31:0]          alu_result_mask_o,     // bits of the ALU result to keep
 
   // MULT & DIV
   output logic                 mult_en_o,             // perform integer multiplication
@@ -80,6 +87,14 @@ module ibex_decoder #(
   output ibex_pkg::md_op_e     multdiv_operator_o,
   output logic [1:0]           multdiv_signed_mode_o,
 
+  // FPU
+  output logic                 fp_en_o,               // perform floating point operation
+  output logic                 fp_sel_o,              // as above but static, for data muxes
+  output ibex_pkg::fp_op_e     fp_operator_o,
+  output ibex_pkg::fp_rm_e     fp_rm_o,               // rounding mode, resolved from frm if
+                                                      // dynamic
+  input  logic [2:0]           fp_frm_i,              // dynamic rounding mode from frm CSR
+
   // CSRs
   output logic                 csr_access_o,          // access to CSR
   output ibex_pkg::csr_op_e    csr_op_o,              // operation to perform on CSR
@@ -103,6 +118,7 @@ module ibex_decoder #(
   logic        illegal_insn;
   logic        illegal_reg_rv32e;
   logic        csr_illegal;
+  logic        fp_rm_illegal;
   logic        rf_we;
 
   logic [31:0] instr;
@@ -122,6 +138,10 @@ module ibex_decoder #(
   opcode_e     opcode;
   opcode_e     opcode_alu;
 
+  logic [31:0] imm_i_type;
+  logic [31:0] imm_u_type;
+  logic        fused_shift_right;
+
   // To help timing the flops containing the current instruction are replicated to reduce fan-out.
   // instr_alu is used to determine the ALU control logic and associated operand/imm select signals
   // as the ALU is often on the more critical timing paths. instr is used for everything else.
@@ -133,10 +153,10 @@ module ibex_decoder #(
   //////////////////////////////////////
 
   // immediate extraction and sign extension
-  assign imm_i_type_o = { {20{instr[31]}}, instr[31:20] };
+  assign imm_i_type   = { {20{instr[31]}}, instr[31:20] };
   assign imm_s_type_o = { {20{instr[31]}}, instr[31:25], instr[11:7] };
   assign imm_b_type_o = { {19{instr[31]}}, instr[31], instr[7], instr[30:25], instr[11:8], 1'b0 };
-  assign imm_u_type_o = { instr[31:12], 12'b0 };
+  assign imm_u_type   = { instr[31:12], 12'b0 };
   assign imm_j_type_o = { {12{instr[31]}}, instr[19:12], instr[20], instr[30:21], 1'b0 };
 
   assign csr_addr_o = csr_num_e'(instr[31:20]);
@@ -144,7 +164,47 @@ module ibex_decoder #(
   // immediate for CSR manipulation (zero extended)
   assign zimm_rs1_type_o = { 27'b0, instr_rs1 }; // rs1
 
-  if (RV32B != RV32BNone) begin : gen_rs3_flop
+  /////////////////////
+  // Macro-op fusion //
+  /////////////////////
+
+  // The IF stage only fuses lui/auipc followed by addi and slli followed by srli, with the second
+  // instruction reading and writing the destination of the first. The pair executes as the first
+  // instruction with a different immediate (and for the shifts a different ALU operation).
+  if (MacroOpFusion) begin : g_macro_op_fusion
+    logic       fused_shift;
+    logic [4:0] fused_shamt_first, fused_shamt_second, fused_shamt;
+
+    // lui/auipc + addi adds the addi immediate to the upper immediate
+    assign imm_u_type_o = instr_fused_i ?
+        imm_u_type + { {20{instr_rdata_fused_i[31]}}, instr_rdata_fused_i[31:20] } : imm_u_type;
+
+    // slli + srli, (rs1 << s1) >> s2, is a single shift by the difference of the shift amounts
+    // with the bits both shifts clear masked off the result
+    assign fused_shift        = instr_fused_i & (opcode == OPCODE_OP_IMM);
+    assign fused_shamt_first  = instr[24:20];
+    assign fused_shamt_second = instr_rdata_fused_i[24:20];
+    assign fused_shift_right  = fused_shift & (fused_shamt_second > fused_shamt_first);
+    assign fused_shamt        = fused_shift_right ? fused_shamt_second - fused_shamt_first :
+                                                    fused_shamt_first - fused_shamt_second;
+
+    assign imm_i_type_o      = fused_shift ? {27'b0, fused_shamt} : imm_i_type;
+    assign alu_result_mask_o = fused_shift ? (32'hFFFF_FFFF << fused_shamt_first) >>
+                                             fused_shamt_second : 32'hFFFF_FFFF;
+  end else begin : g_no_macro_op_fusion
+    logic        unused_instr_fused;
+    logic [31:0] unused_instr_rdata_fused;
+
+    assign unused_instr_fused       = instr_fused_i;
+    assign unused_instr_rdata_fused = instr_rdata_fused_i;
+
+    assign imm_i_type_o      = imm_i_type;
+    assign imm_u_type_o      = imm_u_type;
+    assign fused_shift_right = 1'b0;
+    assign alu_result_mask_o = 32'hFFFF_FFFF;
+  end
+
+  if (RV32B != RV32BNone || RV32F != RV32FNone) begin : gen_rs3_flop
     // the use of rs3 is known one cycle ahead.
     always_ff  @(posedge clk_i or negedge rst_ni) begin
       if (!rst_ni) begin
@@ -182,6 +242,7 @@ module ibex_decoder #(
   if (RV32E) begin : gen_rv32e_reg_check_active
     assign illegal_reg_rv32e = ((rf_raddr_a_o[4] & (alu_op_a_mux_sel_o == OP_A_REG_A)) |
                                 (rf_raddr_b_o[4] & (alu_op_b_mux_sel_o == OP_B_REG_B)) |
+                                (instr_rs3[4]    & use_rs3_d)                          |
                                 (rf_waddr_o[4]   & rf_we));
   end else begin : gen_rv32e_reg_check_inactive
     assign illegal_reg_rv32e = 1'b0;
@@ -201,6 +262,16 @@ module ibex_decoder #(
     end
   end
 
+  ///////////////////
+  // Rounding mode //
+  ///////////////////
+
+  // The dynamic rounding mode is resolved here so the FPU only ever sees a static one. Reserved
+  // rounding modes (also when held in frm) make instructions that round illegal.
+  assign fp_rm_o       = (instr[14:12] == FP_RM_DYN) ? fp_rm_e'(fp_frm_i) :
+                                                       fp_rm_e'(instr[14:12]);
+  assign fp_rm_illegal = (fp_rm_o == 3'b101) || (fp_rm_o == 3'b110) || (fp_rm_o == 3'b111);
+
   /////////////
   // Decoder //
   /////////////
@@ -210,10 +281,13 @@ module ibex_decoder #(
     jump_set_o            = 1'b0;
     branch_in_dec_o       = 1'b0;
     icache_inval_o        = 1'b0;
+    fencei_insn_o         = 1'b0;
 
     multdiv_operator_o    = MD_OP_MULL;
     multdiv_signed_mode_o = 2'b00;
 
+    fp_operator_o         = FP_OP_ADD;
+
     rf_wdata_sel_o        = RF_WD_EX;
     rf_we                 = 1'b0;
     rf_ren_a_o            = 1'b0;
@@ -560,6 +634,145 @@ module ibex_decoder #(
         end
       end
 
+      ////////////////////
+      // Floating point //
+      ////////////////////
+
+      OPCODE_MADD, OPCODE_MSUB, OPCODE_NMSUB, OPCODE_NMADD: begin
+        // rs3 is read through port A once the first cycle is done
+        rf_ren_a_o      = 1'b1;
+        rf_ren_b_o      = 1'b1;
+        rf_we           = 1'b1;
+
+        unique case (opcode)
+          OPCODE_MADD:  fp_operator_o = FP_OP_MADD;
+          OPCODE_MSUB:  fp_operator_o = FP_OP_MSUB;
+          OPCODE_NMSUB: fp_operator_o = FP_OP_NMSUB;
+          default:      fp_operator_o = FP_OP_NMADD;
+        endcase
+
+        // Only single precision (fmt == S) is supported
+        if (RV32F == RV32FNone || instr[26:25] != 2'b00 || fp_rm_illegal) begin
+          illegal_insn = 1'b1;
+        end
+      end
+
+      OPCODE_OP_FP: begin
+        rf_ren_a_o      = 1'b1;
+        rf_we           = 1'b1;
+
+        unique case (instr[31:27])
+          5'b00000: begin // fadd.s
+            fp_operator_o = FP_OP_ADD;
+            rf_ren_b_o    = 1'b1;
+            illegal_insn  = fp_rm_illegal;
+          end
+          5'b00001: begin // fsub.s
+            fp_operator_o = FP_OP_SUB;
+            rf_ren_b_o    = 1'b1;
+            illegal_insn  = fp_rm_illegal;
+          end
+          5'b00010: begin // fmul.s
+            fp_operator_o = FP_OP_MUL;
+            rf_ren_b_o    = 1'b1;
+            illegal_insn  = fp_rm_illegal;
+          end
+          5'b00011: begin // fdiv.s
+            fp_operator_o = FP_OP_DIV;
+            rf_ren_b_o    = 1'b1;
+            illegal_insn  = fp_rm_illegal;
+          end
+          5'b01011: begin // fsqrt.s
+            fp_operator_o = FP_OP_SQRT;
+            illegal_insn  = fp_rm_illegal | (instr_rs2 != 5'd0);
+          end
+          5'b00100: begin
+            rf_ren_b_o = 1'b1;
+            unique case (instr[14:12])
+              3'b000:  fp_operator_o = FP_OP_SGNJ;  // fsgnj.s
+              3'b001:  fp_operator_o = FP_OP_SGNJN; // fsgnjn.s
+              3'b010:  fp_operator_o = FP_OP_SGNJX; // fsgnjx.s
+              default: illegal_insn  = 1'b1;
+            endcase
+          end
+          5'b00101: begin
+            rf_ren_b_o = 1'b1;
+            unique case (instr[14:12])
+              3'b000:  fp_operator_o = FP_OP_MIN;   // fmin.s
+              3'b001:  fp_operator_o = FP_OP_MAX;   // fmax.s
+              default: illegal_insn  = 1'b1;
+            endcase
+          end
+          5'b10100: begin
+            rf_ren_b_o = 1'b1;
+            unique case (instr[14:12])
+              3'b010:  fp_operator_o = FP_OP_EQ;    // feq.s
+              3'b001:  fp_operator_o = FP_OP_LT;    // flt.s
+              3'b000:  fp_operator_o = FP_OP_LE;    // fle.s
+              default: illegal_insn  = 1'b1;
+            endcase
+          end
+          5'b11000: begin
+            unique case (instr_rs2)
+              5'd0:    fp_operator_o = FP_OP_CVT_W_S;  // fcvt.w.s
+              5'd1:    fp_operator_o = FP_OP_CVT_WU_S; // fcvt.wu.s
+              default: illegal_insn  = 1'b1;
+            endcase
+            illegal_insn = illegal_insn | fp_rm_illegal;
+          end
+          5'b11010: begin
+            unique case (instr_rs2)
+              5'd0:    fp_operator_o = FP_OP_CVT_S_W;  // fcvt.s.w
+              5'd1:    fp_operator_o = FP_OP_CVT_S_WU; // fcvt.s.wu
+              default: illegal_insn  = 1'b1;
+            endcase
+            illegal_insn = illegal_insn | fp_rm_illegal;
+          end
+          5'b11100: begin // fclass.s, fmv.x.w does not exist with Zfinx
+            fp_operator_o = FP_OP_CLASS;
+            illegal_insn  = (instr[14:12] != 3'b001) || (instr_rs2 != 5'd0);
+          end
+          default: begin
+            illegal_insn = 1'b1;
+          end
+        endcase
+
+        // Only single precision (fmt == S) is supported
+        if (RV32F == RV32FNone || instr[26:25] != 2'b00) begin
+          illegal_insn = 1'b1;
+        end
+      end
+
+      ///////////////////////
+      // Soft-float assist //
+      ///////////////////////
+
+      OPCODE_CUSTOM_0: begin
+        rf_ren_a_o      = 1'b1;
+        rf_we           = 1'b1;
+
+        unique case (instr[14:12])
+          3'b000,                   // sfp.srs
+          3'b010,                   // sfp.nexp
+          3'b011,                   // sfp.rpack
+          3'b100: begin             // sfp.rpflags
+            rf_ren_b_o = 1'b1;
+          end
+          3'b001,                   // sfp.norm
+          3'b101,                   // sfp.umant
+          3'b110: begin             // sfp.uexp
+            illegal_insn = (instr_rs2 != 5'd0);
+          end
+          default: begin
+            illegal_insn = 1'b1;
+          end
+        endcase
+
+        if (!SoftFloatAssist || instr[31:25] != 7'b0) begin
+          illegal_insn = 1'b1;
+        end
+      end
+
       /////////////
       // Special //
       /////////////
@@ -576,6 +789,7 @@ module ibex_decoder #(
             // requests will be ignored).
             // If present, the ICache will also be flushed.
             jump_in_dec_o   = 1'b1;
+            fencei_insn_o   = 1'b1;
 
             rf_we           = 1'b0;
 
@@ -688,6 +902,7 @@ module ibex_decoder #(
     alu_multicycle_o   = 1'b0;
     mult_sel_o         = 1'b0;
     div_sel_o          = 1'b0;
+    fp_sel_o           = 1'b0;
 
     unique case (opcode_alu)
 
@@ -1135,6 +1350,46 @@ module ibex_decoder #(
         end
       end
 
+      ////////////////////
+      // Floating point //
+      ////////////////////
+
+      OPCODE_OP_FP: begin
+        alu_op_a_mux_sel_o = OP_A_REG_A;
+        alu_op_b_mux_sel_o = OP_B_REG_B;
+        fp_sel_o           = (RV32F == RV32FNone) ? 1'b0 : 1'b1;
+      end
+
+      OPCODE_MADD, OPCODE_MSUB, OPCODE_NMSUB, OPCODE_NMADD: begin
+        alu_op_a_mux_sel_o = OP_A_REG_A;
+        alu_op_b_mux_sel_o = OP_B_REG_B;
+        fp_sel_o           = (RV32F == RV32FNone) ? 1'b0 : 1'b1;
+        // The FPU reads rs3 after the first cycle, keep it selected until the instruction is done
+        use_rs3_d          = (RV32F == RV32FNone) ? 1'b0 : 1'b1;
+      end
+
+      ///////////////////////
+      // Soft-float assist //
+      ///////////////////////
+
+      OPCODE_CUSTOM_0: begin
+        alu_op_a_mux_sel_o = OP_A_REG_A;
+        alu_op_b_mux_sel_o = OP_B_REG_B;
+
+        if (SoftFloatAssist) begin
+          unique case (instr_alu[14:12])
+            3'b000:  alu_operator_o = ALU_SFP_SRS;     // sfp.srs
+            3'b001:  alu_operator_o = ALU_SFP_NORM;    // sfp.norm
+            3'b010:  alu_operator_o = ALU_SFP_NEXP;    // sfp.nexp
+            3'b011:  alu_operator_o = ALU_SFP_RPACK;   // sfp.rpack
+            3'b100:  alu_operator_o = ALU_SFP_RPFLAGS; // sfp.rpflags
+            3'b101:  alu_operator_o = ALU_SFP_UMANT;   // sfp.umant
+            3'b110:  alu_operator_o = ALU_SFP_UEXP;    // sfp.uexp
+            default: ;
+          endcase
+        end
+      end
+
       /////////////
       // Special //
       /////////////
@@ -1186,12 +1441,20 @@ module ibex_decoder #(
       end
       default: ;
     endcase
+
+    // A fused slli/srli pair shifts right when the srli shifts further
+    if (fused_shift_right) begin
+      alu_operator_o = ALU_SRL;
+    end
   end
 
   // do not enable multdiv in case of illegal instruction exceptions
   assign mult_en_o = illegal_insn ? 1'b0 : mult_sel_o;
   assign div_en_o  = illegal_insn ? 1'b0 : div_sel_o;
 
+  // do not enable the FPU in case of illegal instruction exceptions
+  assign fp_en_o   = illegal_insn ? 1'b0 : fp_sel_o;
+
   // make sure instructions accessing non-available registers in RV32E cause illegal
   // instruction exceptions
   assign illegal_insn_o = illegal_insn | illegal_reg_rv32e;
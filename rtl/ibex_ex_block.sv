@@ -6,11 +6,14 @@
 /**
  * Execution stage
  *
- * Execution block: Hosts ALU and MUL/DIV unit
+ * Execution block: Hosts ALU, MUL/DIV unit and optional FPU
  */
 module ibex_ex_block #(
   parameter ibex_pkg::rv32m_e RV32M           = ibex_pkg::RV32MFast,
+  parameter bit               RV32MFastDiv    = 0,
   parameter ibex_pkg::rv32b_e RV32B           = ibex_pkg::RV32BNone,
+  parameter ibex_pkg::rv32f_e RV32F           = ibex_pkg::RV32FNone,
+  parameter bit               SoftFloatAssist = 0,
   parameter bit               BranchTargetALU = 0
 ) (
   input  logic                  clk_i,
@@ -21,6 +24,8 @@ module ibex_ex_block #(
   input  logic [31:0]           alu_operand_a_i,
   input  logic [31:0]           alu_operand_b_i,
   input  logic                  alu_instr_first_cycle_i,
+  input  logic [31:0]           alu_result_mask_i,     // all ones other than for a fused
+                                                       // slli/srli pair
 
   // Branch Target ALU
   // All of these signals are unusued when BranchTargetALU == 0
@@ -39,6 +44,15 @@ module ibex_ex_block #(
   input  logic                  multdiv_ready_id_i,
   input  logic                  data_ind_timing_i,
 
+  // Floating Point Unit
+  // Operands are the multiplier/divider operands, all of these signals are unused when
+  // RV32F == RV32FNone
+  input  ibex_pkg::fp_op_e      fp_operator_i,
+  input  ibex_pkg::fp_rm_e      fp_rm_i,
+  input  logic                  fp_en_i,               // dynamic enable signal, for FSM control
+  input  logic                  fp_sel_i,              // static decoder output, for data muxes
+  output logic [4:0]            fp_fflags_o,
+
   // intermediate val reg
   output logic [1:0]            imd_val_we_o,
   output logic [33:0]           imd_val_d_o[2],
@@ -55,13 +69,15 @@ module ibex_ex_block #(
 
   import ibex_pkg::*;
 
-  logic [31:0] alu_result, multdiv_result;
+  logic [31:0] alu_result, multdiv_result, fpu_result;
 
   logic [32:0] multdiv_alu_operand_b, multdiv_alu_operand_a;
   logic [33:0] alu_adder_result_ext;
   logic        alu_cmp_result, alu_is_equal_result;
   logic        multdiv_valid;
   logic        multdiv_sel;
+  logic        fpu_valid;
+  logic        fpu_sel;
   logic [31:0] alu_imd_val_q[2];
   logic [31:0] alu_imd_val_d[2];
   logic [ 1:0] alu_imd_val_we;
@@ -79,6 +95,12 @@ module ibex_ex_block #(
     assign multdiv_sel = 1'b0;
   end
 
+  if (RV32F != RV32FNone) begin : gen_fpu_sel
+    assign fpu_sel = fp_sel_i;
+  end else begin : gen_no_fpu_sel
+    assign fpu_sel = 1'b0;
+  end
+
   // Intermediate Value Register Mux
   assign imd_val_d_o[0] = multdiv_sel ? multdiv_imd_val_d[0] : {2'b0, alu_imd_val_d[0]};
   assign imd_val_d_o[1] = multdiv_sel ? multdiv_imd_val_d[1] : {2'b0, alu_imd_val_d[1]};
@@ -86,7 +108,8 @@ module ibex_ex_block #(
 
   assign alu_imd_val_q = '{imd_val_q_i[0][31:0], imd_val_q_i[1][31:0]};
 
-  assign result_ex_o  = multdiv_sel ? multdiv_result : alu_result;
+  assign result_ex_o  = fpu_sel     ? fpu_result     :
+                        multdiv_sel ? multdiv_result : alu_result & alu_result_mask_i;
 
   // branch handling
   assign branch_decision_o  = alu_cmp_result;
@@ -114,7 +137,8 @@ module ibex_ex_block #(
   /////////
 
   ibex_alu #(
-    .RV32B(RV32B)
+    .RV32B          (RV32B),
+    .SoftFloatAssist(SoftFloatAssist)
   ) alu_i (
     .operator_i         (alu_operator_i),
     .operand_a_i        (alu_operand_a_i),
@@ -164,7 +188,8 @@ module ibex_ex_block #(
     );
   end else if (RV32M == RV32MFast || RV32M == RV32MSingleCycle) begin : gen_multdiv_fast
     ibex_multdiv_fast #(
-      .RV32M(RV32M)
+      .RV32M       (RV32M),
+      .RV32MFastDiv(RV32MFastDiv)
     ) multdiv_i (
       .clk_i             (clk_i),
       .rst_ni            (rst_ni),
@@ -191,10 +216,46 @@ module ibex_ex_block #(
     );
   end
 
-  // Multiplier/divider may require multiple cycles. The ALU output is valid in the same cycle
-  // unless the intermediate result register is being written (which indicates this isn't the
+  /////////
+  // FPU //
+  /////////
+
+  if (RV32F != RV32FNone) begin : gen_fpu
+    ibex_fpu fpu_i (
+      .clk_i         (clk_i),
+      .rst_ni        (rst_ni),
+      .fp_en_i       (fp_en_i),
+      .operator_i    (fp_operator_i),
+      .rm_i          (fp_rm_i),
+      .op_a_i        (multdiv_operand_a_i),
+      .op_b_i        (multdiv_operand_b_i),
+      .fpu_ready_id_i(multdiv_ready_id_i),
+      .fpu_result_o  (fpu_result),
+      .fflags_o      (fp_fflags_o),
+      .valid_o       (fpu_valid)
+    );
+  end else begin : gen_no_fpu
+    // Unused FPU signals cause lint errors, this avoids them
+    logic unused_fp_en;
+    logic unused_fp_sel;
+    fp_op_e unused_fp_operator;
+    fp_rm_e unused_fp_rm;
+
+    assign unused_fp_en       = fp_en_i;
+    assign unused_fp_sel      = fp_sel_i;
+    assign unused_fp_operator = fp_operator_i;
+    assign unused_fp_rm       = fp_rm_i;
+
+    assign fpu_result  = '0;
+    assign fpu_valid   = 1'b0;
+    assign fp_fflags_o = '0;
+  end
+
+  // Multiplier/divider and FPU may require multiple cycles. The ALU output is valid in the same
+  // cycle unless the intermediate result register is being written (which indicates this isn't the
   // final cycle of ALU operation).
-  assign ex_valid_o = multdiv_sel ? multdiv_valid : ~(|alu_imd_val_we);
+  assign ex_valid_o = fpu_sel     ? fpu_valid     :
+                      multdiv_sel ? multdiv_valid : ~(|alu_imd_val_we);
 
 `ifdef INC_ASSERT
   // This is intended to be accessed via hierarchal references so isn't output from this module nor
@@ -212,6 +273,14 @@ module ibex_ex_block #(
   // Mark the sva_multdiv_fsm_idle as unused to avoid lint issues
   logic unused_sva_multdiv_fsm_idle;
   assign unused_sva_multdiv_fsm_idle = sva_multdiv_fsm_idle;
+
+  logic sva_fpu_fsm_idle;
+
+  if (RV32F != RV32FNone) begin : gen_fpu_sva_idle
+    assign sva_fpu_fsm_idle = gen_fpu.fpu_i.sva_fsm_idle;
+  end else begin : gen_fpu_sva_idle_none
+    assign sva_fpu_fsm_idle = 1'b1;
+  end
 `endif
 
 endmodule
@@ -8,6 +8,10 @@
  *
  * input port: send address and data to the FIFO
  * clear_i clears the FIFO for the following cycle, including any new request
+ *
+ * The word following an aligned, uncompressed output instruction is made available on the next
+ * port, so macro-op fusion can look at the following instruction. Setting out_next_ready_i pops
+ * both instructions at once.
  */
 
 `include "prim_assert.sv"
@@ -35,7 +39,12 @@ module ibex_fetch_fifo #(
   output logic [31:0]         out_addr_o,
   output logic [31:0]         out_rdata_o,
   output logic                out_err_o,
-  output logic                out_err_plus2_o
+  output logic                out_err_plus2_o,
+
+  // next instruction port
+  output logic                out_next_valid_o,
+  input  logic                out_next_ready_i,
+  output logic [31:0]         out_next_rdata_o
 );
 
   localparam int unsigned DEPTH = NUM_REQS+1;
@@ -48,7 +57,7 @@ module ibex_fetch_fifo #(
   logic [DEPTH-1:0]         valid_pushed, valid_popped;
   logic [DEPTH-1:0]         entry_en;
 
-  logic                     pop_fifo;
+  logic                     pop_fifo, pop_two;
   logic             [31:0]  rdata, rdata_unaligned;
   logic                     err,   err_unaligned, err_plus2;
   logic                     valid, valid_unaligned;
@@ -106,6 +115,18 @@ module ibex_fetch_fifo #(
   assign unaligned_is_compressed = (rdata[17:16] != 2'b11) & ~err;
   assign aligned_is_compressed   = (rdata[ 1: 0] != 2'b11) & ~err;
 
+  ///////////////////////////
+  // Next instruction port //
+  ///////////////////////////
+
+  // The next instruction is only offered when the output instruction is a whole, aligned and
+  // uncompressed entry without an error, so the next instruction starts at the following entry.
+  // That entry may come from the bypass. Instructions with an error are never offered here, they
+  // must go through the output port alone.
+  assign out_next_valid_o = valid_q[0] & ~err_q[0] & ~out_addr_o[1] & ~aligned_is_compressed &
+                            (valid_q[1] ? ~err_q[1] : (in_valid_i & ~in_err_i));
+  assign out_next_rdata_o = valid_q[1] ? rdata_q[1] : in_rdata_i;
+
   ////////////////////////////////////////
   // Instruction aligner (if unaligned) //
   ////////////////////////////////////////
@@ -143,8 +164,8 @@ module ibex_fetch_fifo #(
                                            aligned_is_compressed;
 
   assign instr_addr_next = (instr_addr_q[31:1] +
-                            // Increment address by 4 or 2
-                            {29'd0,~addr_incr_two,addr_incr_two});
+                            // Increment address by 8 (two instructions popped), 4 or 2
+                            {28'd0,pop_two,~addr_incr_two & ~pop_two,addr_incr_two});
 
   assign instr_addr_d = clear_i ? in_addr_i[31:1] :
                                   instr_addr_next;
@@ -186,6 +207,8 @@ module ibex_fetch_fifo #(
 
   // Since an entry can contain unaligned instructions, popping an entry can leave the entry valid
   assign pop_fifo = out_ready_i & out_valid_o & (~aligned_is_compressed | out_addr_o[1]);
+  // Popping the next instruction as well removes two entries
+  assign pop_two  = pop_fifo & out_next_ready_i & out_next_valid_o;
 
   for (genvar i = 0; i < (DEPTH - 1); i++) begin : g_fifo_next
     // Calculate lowest free entry (write pointer)
@@ -198,19 +221,36 @@ module ibex_fetch_fifo #(
     // An entry is set when an incoming request chooses the lowest available entry
     assign valid_pushed[i] = (in_valid_i & lowest_free_entry[i]) |
                              valid_q[i];
-    // Popping the FIFO shifts all entries down
-    assign valid_popped[i] = pop_fifo ? valid_pushed[i+1] : valid_pushed[i];
     // All entries are wiped out on a clear
     assign valid_d[i] = valid_popped[i] & ~clear_i;
 
-    // data flops are enabled if there is new data to shift into it, or
-    assign entry_en[i] = (valid_pushed[i+1] & pop_fifo) |
-                         // a new request is incoming and this is the lowest free entry
-                         (in_valid_i & lowest_free_entry[i] & ~pop_fifo);
-
-    // take the next entry or the incoming data
-    assign rdata_d[i]  = valid_q[i+1] ? rdata_q[i+1] : in_rdata_i;
-    assign err_d  [i]  = valid_q[i+1] ? err_q  [i+1] : in_err_i;
+    if (i < DEPTH - 2) begin : g_pop_two
+      // Popping the FIFO shifts all entries down, by two when two instructions are popped
+      assign valid_popped[i] = pop_two  ? valid_pushed[i+2] :
+                               pop_fifo ? valid_pushed[i+1] : valid_pushed[i];
+
+      // data flops are enabled if there is new data to shift into it, or
+      assign entry_en[i] = (valid_pushed[i+2] & pop_two) |
+                           (valid_pushed[i+1] & pop_fifo & ~pop_two) |
+                           // a new request is incoming and this is the lowest free entry
+                           (in_valid_i & lowest_free_entry[i] & ~pop_fifo);
+
+      // take the entry shifting down or the incoming data
+      assign rdata_d[i]  = pop_two ? (valid_q[i+2] ? rdata_q[i+2] : in_rdata_i) :
+                                     (valid_q[i+1] ? rdata_q[i+1] : in_rdata_i);
+      assign err_d  [i]  = pop_two ? (valid_q[i+2] ? err_q  [i+2] : in_err_i) :
+                                     (valid_q[i+1] ? err_q  [i+1] : in_err_i);
+    end else begin : g_pop_one
+      // Nothing is left to shift into this entry when two instructions are popped
+      assign valid_popped[i] = pop_two  ? 1'b0 :
+                               pop_fifo ? valid_pushed[i+1] : valid_pushed[i];
+
+      assign entry_en[i] = (valid_pushed[i+1] & pop_fifo & ~pop_two) |
+                           (in_valid_i & lowest_free_entry[i] & ~pop_fifo);
+
+      assign rdata_d[i]  = valid_q[i+1] ? rdata_q[i+1] : in_rdata_i;
+      assign err_d  [i]  = valid_q[i+1] ? err_q  [i+1] : in_err_i;
+    end
   end
   // The top entry is similar but with simpler muxing
   assign lowest_free_entry[DEPTH-1] = ~valid_q[DEPTH-1] & valid_q[DEPTH-2];
@@ -262,6 +302,9 @@ module ibex_fetch_fifo #(
   `ASSERT(IbexFetchFifoPushPopFull,
       (in_valid_i && pop_fifo) |-> (!valid_q[DEPTH-1] || clear_i))
 
+  // Two instructions are only popped together when both are offered
+  `ASSERT(IbexFetchFifoPopTwoValid, pop_two |-> out_next_valid_o && !out_addr_o[1])
+
   // Must not push to FIFO when full.
   `ASSERT(IbexFetchFifoPushFull,
       (in_valid_i) |-> (!valid_q[DEPTH-1] || clear_i))
@@ -0,0 +1,820 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Floating Point Unit
+ *
+ * Multi-cycle single precision floating point unit for the Zfinx extension, where floating point
+ * values live in the integer register file. Results and exception flags are bit-exact with the
+ * SoftFP library (see dv/verilator/fpu_check), other than where SoftFP differs from the RISC-V
+ * specification.
+ *
+ * Sign injection, min/max, compare and classify complete in the first cycle. All other operations
+ * latch their operands in the first cycle, compute an unrounded result, normalise it and round it
+ * in the final cycle:
+ *
+ *   fadd, fsub, fmul, fcvt.s.w(u)        4 cycles
+ *   fmadd, fmsub, fnmsub, fnmadd         5 cycles
+ *   fdiv, fsqrt                          20 cycles (two quotient/root bits per cycle)
+ *   fcvt.w(u).s                          3 cycles
+ *
+ * Operations with a NaN, infinite or zero operand finish early. The fused multiply-add reads rs3
+ * through operand A from its second cycle onwards.
+ */
+
+`include "prim_assert.sv"
+
+module ibex_fpu (
+  input  logic             clk_i,
+  input  logic             rst_ni,
+  input  logic             fp_en_i,     // dynamic enable signal, for FSM control
+  input  ibex_pkg::fp_op_e operator_i,
+  input  ibex_pkg::fp_rm_e rm_i,        // rounding mode, never FP_RM_DYN
+  input  logic [31:0]      op_a_i,      // rs1, rs3 after the first cycle
+  input  logic [31:0]      op_b_i,      // rs2
+  input  logic             fpu_ready_id_i,
+
+  output logic [31:0]      fpu_result_o,
+  output logic [4:0]       fflags_o,    // exception flags of the result, in fflags order
+  output logic             valid_o
+);
+
+  import ibex_pkg::*;
+
+  // fflags bits
+  localparam int unsigned FlagNX = 0; // Inexact
+  localparam int unsigned FlagUF = 1; // Underflow
+  localparam int unsigned FlagOF = 2; // Overflow
+  localparam int unsigned FlagDZ = 3; // Divide by zero
+  localparam int unsigned FlagNV = 4; // Invalid operation
+
+  localparam logic [31:0] CanonicalNaN = 32'h7fc0_0000;
+
+  // Exponents of unpacked and intermediate values. Subnormal operands are normalised on unpacking
+  // and products/quotients extend the range further, 10 bits covers all cases.
+  typedef logic signed [9:0] fp_exp_t;
+
+  typedef struct packed {
+    logic        sign;
+    fp_exp_t     exp;
+    logic [23:0] mant;      // hidden bit at bit 23, zero for a zero operand
+    logic        zero;
+    logic        subnormal;
+    logic        inf;
+    logic        nan;
+    logic        snan;
+  } fp_unpacked_t;
+
+  function automatic fp_unpacked_t fp_unpack(logic [31:0] a);
+    fp_unpacked_t u;
+    logic [4:0]   shift;
+
+    u.sign      = a[31];
+    u.zero      = (a[30:23] == 8'h00) & (a[22:0] == '0);
+    u.subnormal = (a[30:23] == 8'h00) & (a[22:0] != '0);
+    u.inf       = (a[30:23] == 8'hff) & (a[22:0] == '0);
+    u.nan       = (a[30:23] == 8'hff) & (a[22:0] != '0);
+    u.snan      = u.nan & ~a[22];
+
+    if (a[30:23] == 8'h00) begin
+      // Shift the leading one of a subnormal up to the hidden bit
+      shift = 5'd0;
+      for (int i = 0; i < 23; i++) begin
+        if (a[i]) begin
+          shift = 5'(23 - i);
+        end
+      end
+      u.mant = {1'b0, a[22:0]} << shift;
+      u.exp  = fp_exp_t'(10'd1 - {5'd0, shift});
+    end else begin
+      u.mant = {1'b1, a[22:0]};
+      u.exp  = fp_exp_t'({2'b00, a[30:23]});
+    end
+
+    return u;
+  endfunction
+
+  // Right shifts that OR any bits shifted out into the LSB
+  function automatic logic [31:0] shift_right_sticky32(logic [31:0] a, logic [9:0] shift);
+    logic [31:0] result;
+
+    if (shift >= 10'd32) begin
+      result = {31'b0, |a};
+    end else begin
+      result = (a >> shift[4:0]) | {31'b0, |(a & ~(32'hffff_ffff << shift[4:0]))};
+    end
+
+    return result;
+  endfunction
+
+  function automatic logic [63:0] shift_right_sticky64(logic [63:0] a, logic [9:0] shift);
+    logic [63:0] result;
+
+    if (shift >= 10'd64) begin
+      result = {63'b0, |a};
+    end else begin
+      result = (a >> shift[5:0]) | {63'b0, |(a & ~({64{1'b1}} << shift[5:0]))};
+    end
+
+    return result;
+  endfunction
+
+  // Value added to a mantissa with 7 bits below the LSB to round it
+  function automatic logic [6:0] round_addend(fp_rm_e rm, logic sign);
+    logic [6:0] addend;
+
+    unique case (rm)
+      FP_RM_RNE, FP_RM_RMM: addend = 7'h40;
+      FP_RM_RTZ:            addend = 7'h00;
+      // Round up for negative values with RDN and positive values with RUP
+      default:              addend = (sign ^ rm[0]) ? 7'h7f : 7'h00;
+    endcase
+
+    return addend;
+  endfunction
+
+  typedef enum logic [2:0] {
+    FPU_IDLE, FPU_EXEC, FPU_FMA_ADD, FPU_ITER, FPU_NORM, FPU_ROUND, FPU_DONE
+  } fpu_fsm_e;
+  fpu_fsm_e fpu_state_q, fpu_state_d;
+
+  // Operands, with the sign of the negated operands of fsub and the fused multiply-adds flipped
+  logic [31:0]  a_q, a_d;
+  logic [31:0]  b_q, b_d;
+  logic [31:0]  c_q, c_d;
+  fp_unpacked_t a_unp, b_unp, c_unp;
+
+  // Unrounded intermediate result
+  logic         work_sign_q, work_sign_d;
+  fp_exp_t      work_exp_q, work_exp_d;
+  logic [63:0]  work_mant_q, work_mant_d;
+
+  // Division and square root
+  logic [35:0]  iter_rem_q, iter_rem_d;
+  logic [31:0]  iter_res_q, iter_res_d;
+  logic [3:0]   iter_cnt_q, iter_cnt_d;
+
+  // Results that don't need rounding
+  logic [31:0]  result_q, result_d;
+  logic [4:0]   fflags_q, fflags_d;
+
+  logic         is_fma, single_cycle_op;
+  logic         prod_sign;
+
+  assign is_fma          = operator_i inside {FP_OP_MADD, FP_OP_MSUB, FP_OP_NMSUB, FP_OP_NMADD};
+  assign single_cycle_op = operator_i inside {FP_OP_SGNJ, FP_OP_SGNJN, FP_OP_SGNJX, FP_OP_MIN,
+                                              FP_OP_MAX, FP_OP_EQ, FP_OP_LT, FP_OP_LE,
+                                              FP_OP_CLASS};
+
+  assign a_unp     = fp_unpack(a_q);
+  assign b_unp     = fp_unpack(b_q);
+  assign c_unp     = fp_unpack(c_q);
+  assign prod_sign = a_unp.sign ^ b_unp.sign;
+
+  //////////////////////////
+  // Single cycle results //
+  //////////////////////////
+
+  fp_unpacked_t in_a_unp, in_b_unp;
+  logic         cmp_any_nan, cmp_both_zero, cmp_a_lt_b, cmp_a_eq_b;
+  logic [31:0]  single_result;
+  logic [4:0]   single_fflags;
+
+  assign in_a_unp = fp_unpack(op_a_i);
+  assign in_b_unp = fp_unpack(op_b_i);
+
+  assign cmp_any_nan   = in_a_unp.nan | in_b_unp.nan;
+  assign cmp_both_zero = (op_a_i[30:0] == '0) & (op_b_i[30:0] == '0);
+  assign cmp_a_eq_b    = (op_a_i == op_b_i) | cmp_both_zero;
+  // -0 is less than +0 here, which min/max need. The comparisons treat them as equal.
+  assign cmp_a_lt_b    = (op_a_i[31] != op_b_i[31]) ? op_a_i[31]                      :
+                         op_a_i[31]                 ? (op_a_i[30:0] > op_b_i[30:0]) :
+                                                      (op_a_i[30:0] < op_b_i[30:0]);
+
+  always_comb begin
+    single_result = '0;
+    single_fflags = '0;
+
+    unique case (operator_i)
+      FP_OP_SGNJ:  single_result = {op_b_i[31], op_a_i[30:0]};
+      FP_OP_SGNJN: single_result = {~op_b_i[31], op_a_i[30:0]};
+      FP_OP_SGNJX: single_result = {op_a_i[31] ^ op_b_i[31], op_a_i[30:0]};
+
+      FP_OP_MIN, FP_OP_MAX: begin
+        single_fflags[FlagNV] = in_a_unp.snan | in_b_unp.snan;
+        if (in_a_unp.nan & in_b_unp.nan) begin
+          single_result = CanonicalNaN;
+        end else if (in_a_unp.nan) begin
+          single_result = op_b_i;
+        end else if (in_b_unp.nan) begin
+          single_result = op_a_i;
+        end else begin
+          single_result = (cmp_a_lt_b ^ (operator_i == FP_OP_MAX)) ? op_a_i : op_b_i;
+        end
+      end
+
+      FP_OP_EQ, FP_OP_LT, FP_OP_LE: begin
+        // feq only signals invalid for signalling NaNs, flt and fle for any NaN
+        single_fflags[FlagNV] = (operator_i == FP_OP_EQ) ? in_a_unp.snan | in_b_unp.snan :
+                                                           cmp_any_nan;
+        if (!cmp_any_nan) begin
+          unique case (operator_i)
+            FP_OP_EQ: single_result[0] = cmp_a_eq_b;
+            FP_OP_LT: single_result[0] = cmp_a_lt_b & ~cmp_both_zero;
+            default:  single_result[0] = (cmp_a_lt_b & ~cmp_both_zero) | cmp_a_eq_b;
+          endcase
+        end
+      end
+
+      FP_OP_CLASS: begin
+        single_result[0] = in_a_unp.sign & in_a_unp.inf;
+        single_result[1] = in_a_unp.sign & ~in_a_unp.zero & ~in_a_unp.subnormal &
+                           ~in_a_unp.inf & ~in_a_unp.nan;
+        single_result[2] = in_a_unp.sign & in_a_unp.subnormal;
+        single_result[3] = in_a_unp.sign & in_a_unp.zero;
+        single_result[4] = ~in_a_unp.sign & in_a_unp.zero;
+        single_result[5] = ~in_a_unp.sign & in_a_unp.subnormal;
+        single_result[6] = ~in_a_unp.sign & ~in_a_unp.zero & ~in_a_unp.subnormal &
+                           ~in_a_unp.inf & ~in_a_unp.nan;
+        single_result[7] = ~in_a_unp.sign & in_a_unp.inf;
+        single_result[8] = in_a_unp.snan;
+        single_result[9] = in_a_unp.nan & ~in_a_unp.snan;
+      end
+
+      default: ;
+    endcase
+  end
+
+  ////////////////////////////////////
+  // Float to integer conversion    //
+  ////////////////////////////////////
+
+  // NaNs convert like +infinity. Values of 2^23 and above have no fractional bits to round.
+  // cvt_max is both the saturated result and the largest magnitude that converts without
+  // overflow: 2^31 - 1 for positive and 2^31 for negative signed results.
+  logic        cvt_sign, cvt_overflow, cvt_inexact;
+  logic [31:0] cvt_max, cvt_int, cvt_frac, cvt_rnd;
+  logic [6:0]  cvt_addend;
+  fp_exp_t     cvt_shift;
+
+  assign cvt_sign   = a_unp.sign & ~a_unp.nan;
+  assign cvt_max    = (operator_i == FP_OP_CVT_WU_S) ? {32{~cvt_sign}} :
+                                                       {cvt_sign, {31{~cvt_sign}}};
+  assign cvt_shift  = a_unp.exp - fp_exp_t'(150);
+  assign cvt_addend = round_addend(rm_i, cvt_sign);
+  assign cvt_int    = {8'b0, a_unp.mant} << cvt_shift[3:0];
+  assign cvt_frac   = shift_right_sticky32({1'b0, a_unp.mant, 7'b0}, 10'(-cvt_shift));
+
+  always_comb begin
+    cvt_rnd = (cvt_frac + 32'(cvt_addend)) >> 7;
+    if ((rm_i == FP_RM_RNE) && (cvt_frac[6:0] == 7'h40)) begin
+      // Halfway, round to even
+      cvt_rnd[0] = 1'b0;
+    end
+  end
+
+  always_comb begin
+    cvt_inexact = 1'b0;
+
+    if (a_unp.inf | a_unp.nan) begin
+      cvt_overflow = 1'b1;
+    end else if (cvt_shift >= 0) begin
+      cvt_overflow = (cvt_shift > fp_exp_t'(8)) | (cvt_int > cvt_max);
+    end else begin
+      cvt_overflow = cvt_rnd > cvt_max;
+      cvt_inexact  = ~cvt_overflow & (cvt_frac[6:0] != '0);
+    end
+  end
+
+  ///////////////////
+  // Special cases //
+  ///////////////////
+
+  // Results of operations with NaN, infinite or zero operands and of float to integer
+  // conversions, which are complete after the first calculation cycle. For the fused multiply-adds
+  // these are only valid once the addend has been latched.
+  logic        prod_inf, prod_zero, prod_invalid, zero_sum_sign;
+  logic        special;
+  logic [31:0] special_result;
+  logic [4:0]  special_fflags;
+
+  assign prod_inf      = a_unp.inf | b_unp.inf;
+  assign prod_zero     = a_unp.zero | b_unp.zero;
+  assign prod_invalid  = (a_unp.inf & b_unp.zero) | (b_unp.inf & a_unp.zero);
+  // Sign of an exactly zero sum of two zero terms
+  assign zero_sum_sign = (prod_sign == c_unp.sign) ? prod_sign : (rm_i == FP_RM_RDN);
+
+  always_comb begin
+    special        = 1'b0;
+    special_result = CanonicalNaN;
+    special_fflags = '0;
+
+    unique case (operator_i)
+      FP_OP_ADD, FP_OP_SUB: begin
+        if (a_unp.nan | b_unp.nan) begin
+          special                = 1'b1;
+          special_fflags[FlagNV] = a_unp.snan | b_unp.snan;
+        end else if (a_unp.inf & b_unp.inf & (a_unp.sign != b_unp.sign)) begin
+          special                = 1'b1;
+          special_fflags[FlagNV] = 1'b1;
+        end else if (a_unp.inf) begin
+          special        = 1'b1;
+          special_result = a_q;
+        end else if (b_unp.inf) begin
+          special        = 1'b1;
+          special_result = b_q;
+        end
+      end
+
+      FP_OP_MUL, FP_OP_MADD, FP_OP_MSUB, FP_OP_NMSUB, FP_OP_NMADD: begin
+        if (a_unp.nan | b_unp.nan | (is_fma & c_unp.nan) | prod_invalid) begin
+          // inf * 0 is invalid even if the addend is a quiet NaN
+          special                = 1'b1;
+          special_fflags[FlagNV] = a_unp.snan | b_unp.snan | (is_fma & c_unp.snan) | prod_invalid;
+        end else if (is_fma & prod_inf & c_unp.inf & (prod_sign != c_unp.sign)) begin
+          special                = 1'b1;
+          special_fflags[FlagNV] = 1'b1;
+        end else if (prod_inf) begin
+          special        = 1'b1;
+          special_result = {prod_sign, 8'hff, 23'b0};
+        end else if (is_fma & c_unp.inf) begin
+          special        = 1'b1;
+          special_result = c_q;
+        end else if (prod_zero) begin
+          special        = 1'b1;
+          special_result = !is_fma     ? {prod_sign, 31'b0}     :
+                           !c_unp.zero ? c_q                    :
+                                         {zero_sum_sign, 31'b0};
+        end
+      end
+
+      FP_OP_DIV: begin
+        if (a_unp.nan | b_unp.nan) begin
+          special                = 1'b1;
+          special_fflags[FlagNV] = a_unp.snan | b_unp.snan;
+        end else if ((a_unp.inf & b_unp.inf) | (a_unp.zero & b_unp.zero)) begin
+          special                = 1'b1;
+          special_fflags[FlagNV] = 1'b1;
+        end else if (a_unp.inf | b_unp.zero) begin
+          special                = 1'b1;
+          special_result         = {prod_sign, 8'hff, 23'b0};
+          special_fflags[FlagDZ] = ~a_unp.inf;
+        end else if (b_unp.inf | a_unp.zero) begin
+          special        = 1'b1;
+          special_result = {prod_sign, 31'b0};
+        end
+      end
+
+      FP_OP_SQRT: begin
+        if (a_unp.nan) begin
+          special                = 1'b1;
+          special_fflags[FlagNV] = a_unp.snan;
+        end else if (a_unp.zero | (a_unp.inf & ~a_unp.sign)) begin
+          // sqrt(-0) is -0
+          special        = 1'b1;
+          special_result = a_q;
+        end else if (a_unp.sign) begin
+          special                = 1'b1;
+          special_fflags[FlagNV] = 1'b1;
+        end
+      end
+
+      FP_OP_CVT_W_S, FP_OP_CVT_WU_S: begin
+        special                = 1'b1;
+        special_result         = cvt_overflow   ? cvt_max      :
+                                 cvt_shift >= 0 ? (cvt_sign ? 32'(-cvt_int) : cvt_int) :
+                                                  (cvt_sign ? 32'(-cvt_rnd) : cvt_rnd);
+        special_fflags[FlagNV] = cvt_overflow;
+        special_fflags[FlagNX] = cvt_inexact;
+      end
+
+      default: ;
+    endcase
+  end
+
+  //////////////////////
+  // Addition (fadd)  //
+  //////////////////////
+
+  // Align the smaller magnitude operand to the larger one, with 3 bits below the LSB
+  fp_unpacked_t add_big, add_small;
+  logic [31:0]  add_big_mant, add_small_mant, add_sum;
+  logic         add_sign;
+
+  assign add_big        = (a_q[30:0] < b_q[30:0]) ? b_unp : a_unp;
+  assign add_small      = (a_q[30:0] < b_q[30:0]) ? a_unp : b_unp;
+  assign add_big_mant   = {5'b0, add_big.mant, 3'b0};
+  assign add_small_mant = shift_right_sticky32({5'b0, add_small.mant, 3'b0},
+                                               10'(add_big.exp - add_small.exp));
+  assign add_sum        = (add_big.sign == add_small.sign) ? add_big_mant + add_small_mant :
+                                                             add_big_mant - add_small_mant;
+  // An exact zero difference is -0 only when rounding down
+  assign add_sign       = (add_sum == '0) && (add_big.sign != add_small.sign) ?
+                          (rm_i == FP_RM_RDN) : add_big.sign;
+
+  ////////////////////////////////////////
+  // Multiplication and fused multiply  //
+  ////////////////////////////////////////
+
+  logic [47:0]  mul_prod;
+
+  assign mul_prod = a_unp.mant * b_unp.mant;
+
+  // The product of the fused multiply-adds is kept in full with its MSB at bit 61 and added to
+  // the addend, aligned to whichever has the smaller magnitude
+  logic [63:0]  fma_c_mant, fma_big_mant, fma_small_mant, fma_sum;
+  fp_exp_t      fma_c_exp, fma_big_exp, fma_small_exp;
+  logic         fma_swap, fma_big_sign, fma_small_sign, fma_sign;
+
+  assign fma_c_mant     = {2'b0, c_unp.mant, 38'b0};
+  assign fma_c_exp      = c_unp.exp + fp_exp_t'(1);
+  assign fma_swap       = ~((work_exp_q > fma_c_exp) ||
+                            ((work_exp_q == fma_c_exp) &&
+                             (work_mant_q[63:32] >= fma_c_mant[63:32])));
+
+  assign fma_big_sign   = fma_swap ? c_unp.sign  : work_sign_q;
+  assign fma_small_sign = fma_swap ? work_sign_q : c_unp.sign;
+  assign fma_big_exp    = fma_swap ? fma_c_exp   : work_exp_q;
+  assign fma_small_exp  = fma_swap ? work_exp_q  : fma_c_exp;
+  assign fma_big_mant   = fma_swap ? fma_c_mant  : work_mant_q;
+  assign fma_small_mant = shift_right_sticky64(fma_swap ? work_mant_q : fma_c_mant,
+                                               10'(fma_big_exp - fma_small_exp));
+
+  assign fma_sum        = (fma_big_sign == fma_small_sign) ? fma_big_mant + fma_small_mant :
+                                                             fma_big_mant - fma_small_mant;
+  assign fma_sign       = (fma_sum == '0) && (fma_big_sign != fma_small_sign) ?
+                          (rm_i == FP_RM_RDN) : fma_big_sign;
+
+  ////////////////////////////////
+  // Division and square root   //
+  ////////////////////////////////
+
+  // Both use a restoring algorithm producing one result bit per step, two steps per cycle. The
+  // square root radicand is shifted out of work_mant_q two bits per step.
+  typedef struct packed {
+    logic [35:0] rem;
+    logic [31:0] res;
+    logic [63:0] rad;
+  } iter_state_t;
+
+  function automatic iter_state_t iter_step(iter_state_t s, logic div, logic [23:0] divisor);
+    iter_state_t next;
+
+    next = s;
+    if (div) begin
+      if (s.rem >= {12'b0, divisor}) begin
+        next.rem = {s.rem[34:0] - {11'b0, divisor}, 1'b0};
+        next.res = {s.res[30:0], 1'b1};
+      end else begin
+        next.rem = {s.rem[34:0], 1'b0};
+        next.res = {s.res[30:0], 1'b0};
+      end
+    end else begin
+      next.rad = {s.rad[61:0], 2'b00};
+      next.rem = {s.rem[33:0], s.rad[63:62]};
+      if (next.rem >= {2'b0, s.res, 2'b01}) begin
+        next.rem = next.rem - {2'b0, s.res, 2'b01};
+        next.res = {s.res[30:0], 1'b1};
+      end else begin
+        next.res = {s.res[30:0], 1'b0};
+      end
+    end
+
+    return next;
+  endfunction
+
+  iter_state_t iter_q, iter_first, iter_second;
+  logic [31:0] iter_mant;
+  fp_exp_t     sqrt_exp;
+
+  assign iter_q      = {iter_rem_q, iter_res_q, work_mant_q};
+  assign iter_first  = iter_step(iter_q, operator_i == FP_OP_DIV, b_unp.mant);
+  assign iter_second = iter_step(iter_first, operator_i == FP_OP_DIV, b_unp.mant);
+  // 32 result bits, one more than rounding needs, with the remainder as a sticky bit
+  assign iter_mant   = {1'b0, iter_second.res[31:2],
+                        |{iter_second.res[1:0], iter_second.rem != '0}};
+
+  // Unbiased exponent of a square root radicand, made even by doubling the mantissa if needed
+  assign sqrt_exp    = a_unp.exp - fp_exp_t'(127);
+
+  ////////////////////////////////////
+  // Integer to float conversion    //
+  ////////////////////////////////////
+
+  logic        cvt_s_sign;
+  logic [31:0] cvt_s_mag;
+
+  assign cvt_s_sign = (operator_i == FP_OP_CVT_S_W) & a_q[31];
+  assign cvt_s_mag  = cvt_s_sign ? 32'(-a_q) : a_q;
+
+  ///////////////////
+  // Normalisation //
+  ///////////////////
+
+  // Shift the leading one of the intermediate result up to bit 62
+  logic [5:0]  norm_shift;
+  logic [63:0] norm_mant;
+
+  always_comb begin
+    norm_shift = '0;
+    for (int i = 0; i < 63; i++) begin
+      if (work_mant_q[i]) begin
+        norm_shift = 6'(62 - i);
+      end
+    end
+  end
+
+  assign norm_mant = work_mant_q << norm_shift;
+
+  //////////////
+  // Rounding //
+  //////////////
+
+  // Round the normalised intermediate result. The upper word of work_mant_q holds it with its MSB
+  // at bit 30 and 7 bits below the LSB of the result, anything further below is folded into its
+  // LSB.
+  logic [6:0]  rnd_addend;
+  logic        rnd_tiny;
+  logic [31:0] rnd_mant;
+  logic [24:0] rnd_mant_inc;
+  fp_exp_t     rnd_exp, rnd_exp_inc;
+  logic [31:0] round_result;
+  logic [4:0]  round_fflags;
+
+  assign rnd_addend = round_addend(rm_i, work_sign_q);
+
+  always_comb begin
+    if (work_exp_q <= 0) begin
+      // Denormalise. The result underflows if it's inexact and tiny after rounding.
+      rnd_tiny = (work_exp_q < 0) | ((work_mant_q[63:32] + 32'(rnd_addend)) < 32'h8000_0000);
+      rnd_mant = shift_right_sticky32(work_mant_q[63:32], 10'(fp_exp_t'(1) - work_exp_q));
+      rnd_exp  = fp_exp_t'(1);
+    end else begin
+      rnd_tiny = 1'b0;
+      rnd_mant = work_mant_q[63:32];
+      rnd_exp  = work_exp_q;
+    end
+
+    rnd_mant_inc = 25'((rnd_mant + 32'(rnd_addend)) >> 7);
+    if ((rm_i == FP_RM_RNE) && (rnd_mant[6:0] == 7'h40)) begin
+      // Halfway, round to even
+      rnd_mant_inc[0] = 1'b0;
+    end
+    rnd_exp_inc = rnd_exp + fp_exp_t'({9'b0, rnd_mant_inc[24]});
+  end
+
+  always_comb begin
+    round_fflags         = '0;
+    round_fflags[FlagNX] = rnd_mant[6:0] != '0;
+    round_fflags[FlagUF] = rnd_tiny & round_fflags[FlagNX];
+
+    if (rnd_mant_inc[24:23] == 2'b00) begin
+      // Subnormal or zero
+      round_result = {work_sign_q, 8'h00, rnd_mant_inc[22:0]};
+    end else if (rnd_exp_inc >= fp_exp_t'(255)) begin
+      // Overflow to infinity, or the largest finite value when rounding towards zero
+      round_result         = (rnd_addend == '0) ? {work_sign_q, 8'hfe, 23'h7f_ffff} :
+                                                  {work_sign_q, 8'hff, 23'h0};
+      round_fflags[FlagOF] = 1'b1;
+      round_fflags[FlagNX] = 1'b1;
+    end else begin
+      round_result = {work_sign_q, rnd_exp_inc[7:0], rnd_mant_inc[22:0]};
+    end
+  end
+
+  /////////
+  // FSM //
+  /////////
+
+  always_comb begin
+    fpu_state_d = fpu_state_q;
+    a_d         = a_q;
+    b_d         = b_q;
+    c_d         = c_q;
+    work_sign_d = work_sign_q;
+    work_exp_d  = work_exp_q;
+    work_mant_d = work_mant_q;
+    iter_rem_d  = iter_rem_q;
+    iter_res_d  = iter_res_q;
+    iter_cnt_d  = iter_cnt_q;
+    result_d    = result_q;
+    fflags_d    = fflags_q;
+
+    unique case (fpu_state_q)
+      FPU_IDLE: begin
+        if (!single_cycle_op) begin
+          a_d         = op_a_i ^ {(operator_i inside {FP_OP_NMSUB, FP_OP_NMADD}), 31'b0};
+          b_d         = op_b_i ^ {(operator_i == FP_OP_SUB), 31'b0};
+          fpu_state_d = FPU_EXEC;
+        end
+      end
+
+      FPU_EXEC: begin
+        // Operand A holds rs3 from now on for the fused multiply-adds
+        c_d = op_a_i ^ {(operator_i inside {FP_OP_MSUB, FP_OP_NMADD}), 31'b0};
+
+        if (special && !is_fma) begin
+          result_d    = special_result;
+          fflags_d    = special_fflags;
+          fpu_state_d = FPU_DONE;
+        end else begin
+          unique case (operator_i)
+            FP_OP_ADD, FP_OP_SUB: begin
+              work_sign_d = add_sign;
+              work_exp_d  = add_big.exp + fp_exp_t'(4);
+              work_mant_d = {add_sum, 32'b0};
+              fpu_state_d = FPU_NORM;
+            end
+
+            FP_OP_MUL: begin
+              work_sign_d = prod_sign;
+              work_exp_d  = a_unp.exp + b_unp.exp - fp_exp_t'(126);
+              work_mant_d = {1'b0, mul_prod, 15'b0};
+              fpu_state_d = FPU_NORM;
+            end
+
+            FP_OP_MADD, FP_OP_MSUB, FP_OP_NMSUB, FP_OP_NMADD: begin
+              work_sign_d = prod_sign;
+              if (mul_prod[47]) begin
+                work_exp_d  = a_unp.exp + b_unp.exp - fp_exp_t'(125);
+                work_mant_d = {2'b0, mul_prod, 14'b0};
+              end else begin
+                work_exp_d  = a_unp.exp + b_unp.exp - fp_exp_t'(126);
+                work_mant_d = {1'b0, mul_prod, 15'b0};
+              end
+              fpu_state_d = FPU_FMA_ADD;
+            end
+
+            FP_OP_DIV: begin
+              iter_rem_d  = {12'b0, a_unp.mant};
+              iter_res_d  = '0;
+              iter_cnt_d  = '0;
+              work_sign_d = prod_sign;
+              work_exp_d  = a_unp.exp - b_unp.exp + fp_exp_t'(127);
+              fpu_state_d = FPU_ITER;
+            end
+
+            FP_OP_SQRT: begin
+              iter_rem_d  = '0;
+              iter_res_d  = '0;
+              iter_cnt_d  = '0;
+              work_sign_d = 1'b0;
+              if (sqrt_exp[0]) begin
+                work_exp_d  = ((sqrt_exp - fp_exp_t'(1)) >>> 1) + fp_exp_t'(127);
+                work_mant_d = {a_unp.mant, 40'b0};
+              end else begin
+                work_exp_d  = (sqrt_exp >>> 1) + fp_exp_t'(127);
+                work_mant_d = {1'b0, a_unp.mant, 39'b0};
+              end
+              fpu_state_d = FPU_ITER;
+            end
+
+            FP_OP_CVT_S_W, FP_OP_CVT_S_WU: begin
+              work_sign_d = cvt_s_sign;
+              if (cvt_s_mag[31]) begin
+                work_exp_d  = fp_exp_t'(158);
+                work_mant_d = {1'b0, cvt_s_mag[31:2], |cvt_s_mag[1:0], 32'b0};
+              end else begin
+                work_exp_d  = fp_exp_t'(157);
+                work_mant_d = {cvt_s_mag, 32'b0};
+              end
+              fpu_state_d = FPU_NORM;
+            end
+
+            default: fpu_state_d = FPU_IDLE;
+          endcase
+        end
+      end
+
+      FPU_FMA_ADD: begin
+        if (special) begin
+          result_d    = special_result;
+          fflags_d    = special_fflags;
+          fpu_state_d = FPU_DONE;
+        end else begin
+          // Nothing to add to the product for a zero addend
+          if (!c_unp.zero) begin
+            work_sign_d = fma_sign;
+            work_exp_d  = fma_big_exp;
+            work_mant_d = fma_sum;
+          end
+          fpu_state_d = FPU_NORM;
+        end
+      end
+
+      FPU_ITER: begin
+        iter_rem_d  = iter_second.rem;
+        iter_res_d  = iter_second.res;
+        iter_cnt_d  = iter_cnt_q + 4'd1;
+        work_mant_d = iter_second.rad;
+
+        if (iter_cnt_q == 4'd15) begin
+          work_mant_d = {iter_mant, 32'b0};
+          fpu_state_d = FPU_NORM;
+        end
+      end
+
+      FPU_NORM: begin
+        work_exp_d  = work_exp_q - fp_exp_t'({4'b0, norm_shift});
+        work_mant_d = {norm_mant[63:33], |norm_mant[32:0], 32'b0};
+        fpu_state_d = FPU_ROUND;
+      end
+
+      FPU_ROUND, FPU_DONE: begin
+        if (fpu_ready_id_i) begin
+          fpu_state_d = FPU_IDLE;
+        end
+      end
+
+      default: fpu_state_d = FPU_IDLE;
+    endcase
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      fpu_state_q <= FPU_IDLE;
+      a_q         <= '0;
+      b_q         <= '0;
+      c_q         <= '0;
+      work_sign_q <= 1'b0;
+      work_exp_q  <= '0;
+      work_mant_q <= '0;
+      iter_rem_q  <= '0;
+      iter_res_q  <= '0;
+      iter_cnt_q  <= '0;
+      result_q    <= '0;
+      fflags_q    <= '0;
+    end else if (fp_en_i) begin
+      fpu_state_q <= fpu_state_d;
+      a_q         <= a_d;
+      b_q         <= b_d;
+      c_q         <= c_d;
+      work_sign_q <= work_sign_d;
+      work_exp_q  <= work_exp_d;
+      work_mant_q <= work_mant_d;
+      iter_rem_q  <= iter_rem_d;
+      iter_res_q  <= iter_res_d;
+      iter_cnt_q  <= iter_cnt_d;
+      result_q    <= result_d;
+      fflags_q    <= fflags_d;
+    end
+  end
+
+  /////////////
+  // Outputs //
+  /////////////
+
+  always_comb begin
+    unique case (fpu_state_q)
+      FPU_IDLE: begin
+        fpu_result_o = single_result;
+        fflags_o     = single_fflags;
+        valid_o      = single_cycle_op;
+      end
+      FPU_ROUND: begin
+        fpu_result_o = round_result;
+        fflags_o     = round_fflags;
+        valid_o      = 1'b1;
+      end
+      FPU_DONE: begin
+        fpu_result_o = result_q;
+        fflags_o     = fflags_q;
+        valid_o      = 1'b1;
+      end
+      default: begin
+        fpu_result_o = '0;
+        fflags_o     = '0;
+        valid_o      = 1'b0;
+      end
+    endcase
+  end
+
+  // Only unpacked fields some operations need are used
+  logic unused_unp;
+  assign unused_unp = ^{c_unp.subnormal, a_unp.subnormal, b_unp.subnormal, in_a_unp.exp,
+                        in_a_unp.mant, in_b_unp.exp, in_b_unp.mant, in_b_unp.sign,
+                        in_b_unp.subnormal, in_b_unp.inf, in_b_unp.zero};
+
+  ////////////////
+  // Assertions //
+  ////////////////
+
+  // States must be known/valid.
+  `ASSERT(IbexFpuStateValid, fpu_state_q inside {
+      FPU_IDLE, FPU_EXEC, FPU_FMA_ADD, FPU_ITER, FPU_NORM, FPU_ROUND, FPU_DONE})
+  // The decoder resolves the dynamic rounding mode from frm
+  `ASSERT(IbexFpuRmResolved, fp_en_i |-> rm_i != FP_RM_DYN)
+
+`ifdef INC_ASSERT
+  logic sva_fsm_idle;
+  logic unused_sva_fsm_idle;
+
+  // This is intended to be accessed via hierarchal references so isn't output from this module nor
+  // used in any logic in this module
+  assign sva_fsm_idle = (fpu_state_q == FPU_IDLE);
+  // Mark the sva_fsm_idle as unused to avoid lint issues
+  assign unused_sva_fsm_idle = sva_fsm_idle;
+`endif
+
+endmodule
@@ -13,11 +13,17 @@
 module ibex_icache import ibex_pkg::*; #(
   parameter bit          ICacheECC       = 1'b0,
   parameter bit          ResetAll        = 1'b0,
+  // Cache geometry, ICacheNumWays ways of 2^ICacheIndexW lines of ICacheLineSize bits
+  parameter int unsigned ICacheNumWays   = IC_NUM_WAYS,
+  parameter int unsigned ICacheIndexW    = IC_INDEX_W,
+  parameter int unsigned ICacheLineSize  = IC_LINE_SIZE,
   parameter int unsigned BusSizeECC      = BUS_SIZE,
   parameter int unsigned TagSizeECC      = IC_TAG_SIZE,
   parameter int unsigned LineSizeECC     = IC_LINE_SIZE,
   // Only cache branch targets
-  parameter bit          BranchCache     = 1'b0
+  parameter bit          BranchCache     = 1'b0,
+  // Look up (and on a miss fetch) one more line ahead of the line being output
+  parameter bit          ICachePrefetch  = 1'b0
 ) (
   // Clock and reset
   input  logic                           clk_i,
@@ -47,16 +53,16 @@ module ibex_icache import ibex_pkg::*; #(
   input  logic                           instr_rvalid_i,
 
   // RAM IO
-  output logic [IC_NUM_WAYS-1:0]         ic_tag_req_o,
+  output logic [ICacheNumWays-1:0]       ic_tag_req_o,
   output logic                           ic_tag_write_o,
-  output logic [IC_INDEX_W-1:0]          ic_tag_addr_o,
+  output logic [ICacheIndexW-1:0]        ic_tag_addr_o,
   output logic [TagSizeECC-1:0]          ic_tag_wdata_o,
-  input  logic [TagSizeECC-1:0]          ic_tag_rdata_i [IC_NUM_WAYS],
-  output logic [IC_NUM_WAYS-1:0]         ic_data_req_o,
+  input  logic [TagSizeECC-1:0]          ic_tag_rdata_i [ICacheNumWays],
+  output logic [ICacheNumWays-1:0]       ic_data_req_o,
   output logic                           ic_data_write_o,
-  output logic [IC_INDEX_W-1:0]          ic_data_addr_o,
+  output logic [ICacheIndexW-1:0]        ic_data_addr_o,
   output logic [LineSizeECC-1:0]         ic_data_wdata_o,
-  input  logic [LineSizeECC-1:0]         ic_data_rdata_i [IC_NUM_WAYS],
+  input  logic [LineSizeECC-1:0]         ic_data_rdata_i [ICacheNumWays],
   input  logic                           ic_scr_key_valid_i,
   output logic                           ic_scr_key_req_o,
 
@@ -64,14 +70,27 @@ module ibex_icache import ibex_pkg::*; #(
   input  logic                           icache_enable_i,
   input  logic                           icache_inval_i,
   output logic                           busy_o,
-  output logic                           ecc_error_o
+  output logic                           ecc_error_o,
+
+  // Performance counter events
+  output logic                           perf_hit_o,
+  output logic                           perf_miss_o,
+  output logic                           perf_prefetch_o
 );
 
-  // Number of fill buffers (must be >= 2)
-  localparam int unsigned NUM_FB        = 4;
+  // Number of fill buffers (must be >= 2), prefetching uses one more
+  localparam int unsigned NUM_FB        = ICachePrefetch ? 5 : 4;
   // Request throttling threshold
   localparam int unsigned FB_THRESHOLD  = NUM_FB - 2;
 
+  // Cache geometry
+  localparam int unsigned LINE_BYTES    = ICacheLineSize / 8;
+  localparam int unsigned LINE_W        = $clog2(LINE_BYTES);
+  localparam int unsigned LINE_BEATS    = LINE_BYTES / BUS_BYTES;
+  localparam int unsigned LINE_BEATS_W  = $clog2(LINE_BEATS);
+  localparam int unsigned INDEX_HI      = ICacheIndexW + LINE_W - 1;
+  localparam int unsigned TAG_SIZE      = ADDR_W - ICacheIndexW - LINE_W + 1; // 1 valid bit
+
   // Prefetch signals
   logic [ADDR_W-1:0]                      lookup_addr_aligned;
   logic [ADDR_W-1:0]                      prefetch_addr_d, prefetch_addr_q;
@@ -80,41 +99,41 @@ module ibex_icache import ibex_pkg::*; #(
   logic                                   lookup_throttle;
   logic                                   lookup_req_ic0;
   logic [ADDR_W-1:0]                      lookup_addr_ic0;
-  logic [IC_INDEX_W-1:0]                  lookup_index_ic0;
+  logic [ICacheIndexW-1:0]                lookup_index_ic0;
   logic                                   fill_req_ic0;
-  logic [IC_INDEX_W-1:0]                  fill_index_ic0;
-  logic [IC_TAG_SIZE-1:0]                 fill_tag_ic0;
-  logic [IC_LINE_SIZE-1:0]                fill_wdata_ic0;
+  logic [ICacheIndexW-1:0]                fill_index_ic0;
+  logic [TAG_SIZE-1:0]                    fill_tag_ic0;
+  logic [ICacheLineSize-1:0]              fill_wdata_ic0;
   logic                                   lookup_grant_ic0;
   logic                                   lookup_actual_ic0;
   logic                                   fill_grant_ic0;
   logic                                   tag_req_ic0;
-  logic [IC_INDEX_W-1:0]                  tag_index_ic0;
-  logic [IC_NUM_WAYS-1:0]                 tag_banks_ic0;
+  logic [ICacheIndexW-1:0]                tag_index_ic0;
+  logic [ICacheNumWays-1:0]               tag_banks_ic0;
   logic                                   tag_write_ic0;
   logic [TagSizeECC-1:0]                  tag_wdata_ic0;
   logic                                   data_req_ic0;
-  logic [IC_INDEX_W-1:0]                  data_index_ic0;
-  logic [IC_NUM_WAYS-1:0]                 data_banks_ic0;
+  logic [ICacheIndexW-1:0]                data_index_ic0;
+  logic [ICacheNumWays-1:0]               data_banks_ic0;
   logic                                   data_write_ic0;
   logic [LineSizeECC-1:0]                 data_wdata_ic0;
   // Cache pipelipe IC1 signals
-  logic [TagSizeECC-1:0]                  tag_rdata_ic1  [IC_NUM_WAYS];
-  logic [LineSizeECC-1:0]                 data_rdata_ic1 [IC_NUM_WAYS];
+  logic [TagSizeECC-1:0]                  tag_rdata_ic1  [ICacheNumWays];
+  logic [LineSizeECC-1:0]                 data_rdata_ic1 [ICacheNumWays];
   logic [LineSizeECC-1:0]                 hit_data_ecc_ic1;
-  logic [IC_LINE_SIZE-1:0]                hit_data_ic1;
+  logic [ICacheLineSize-1:0]              hit_data_ic1;
   logic                                   lookup_valid_ic1;
-  logic [ADDR_W-1:IC_INDEX_HI+1]          lookup_addr_ic1;
-  logic [IC_NUM_WAYS-1:0]                 tag_match_ic1;
+  logic [ADDR_W-1:INDEX_HI+1]             lookup_addr_ic1;
+  logic [ICacheNumWays-1:0]               tag_match_ic1;
   logic                                   tag_hit_ic1;
-  logic [IC_NUM_WAYS-1:0]                 tag_invalid_ic1;
-  logic [IC_NUM_WAYS-1:0]                 lowest_invalid_way_ic1;
-  logic [IC_NUM_WAYS-1:0]                 round_robin_way_ic1, round_robin_way_q;
-  logic [IC_NUM_WAYS-1:0]                 sel_way_ic1;
+  logic [ICacheNumWays-1:0]               tag_invalid_ic1;
+  logic [ICacheNumWays-1:0]               lowest_invalid_way_ic1;
+  logic [ICacheNumWays-1:0]               round_robin_way_ic1, round_robin_way_q;
+  logic [ICacheNumWays-1:0]               sel_way_ic1;
   logic                                   ecc_err_ic1;
   logic                                   ecc_write_req;
-  logic [IC_NUM_WAYS-1:0]                 ecc_write_ways;
-  logic [IC_INDEX_W-1:0]                  ecc_write_index;
+  logic [ICacheNumWays-1:0]               ecc_write_ways;
+  logic [ICacheIndexW-1:0]                ecc_write_index;
   // Fill buffer signals
   logic [$clog2(NUM_FB)-1:0]              fb_fill_level;
   logic                                   fill_cache_new;
@@ -128,37 +147,40 @@ module ibex_icache import ibex_pkg::*; #(
   logic [NUM_FB-1:0]                      fill_stale_d, fill_stale_q;
   logic [NUM_FB-1:0]                      fill_cache_d, fill_cache_q;
   logic [NUM_FB-1:0]                      fill_hit_ic1, fill_hit_d, fill_hit_q;
-  logic [NUM_FB-1:0][IC_LINE_BEATS_W:0]   fill_ext_cnt_d, fill_ext_cnt_q;
+  logic                                   fill_prefetch_new;
+  logic [NUM_FB-1:0]                      fill_prefetch_d, fill_prefetch_q;
+  logic [NUM_FB-1:0]                      fill_prefetch_used;
+  logic [NUM_FB-1:0][LINE_BEATS_W:0]      fill_ext_cnt_d, fill_ext_cnt_q;
   logic [NUM_FB-1:0]                      fill_ext_hold_d, fill_ext_hold_q;
   logic [NUM_FB-1:0]                      fill_ext_done_d, fill_ext_done_q;
-  logic [NUM_FB-1:0][IC_LINE_BEATS_W:0]   fill_rvd_cnt_d, fill_rvd_cnt_q;
+  logic [NUM_FB-1:0][LINE_BEATS_W:0]      fill_rvd_cnt_d, fill_rvd_cnt_q;
   logic [NUM_FB-1:0]                      fill_rvd_done;
   logic [NUM_FB-1:0]                      fill_ram_done_d, fill_ram_done_q;
   logic [NUM_FB-1:0]                      fill_out_grant;
-  logic [NUM_FB-1:0][IC_LINE_BEATS_W:0]   fill_out_cnt_d, fill_out_cnt_q;
+  logic [NUM_FB-1:0][LINE_BEATS_W:0]      fill_out_cnt_d, fill_out_cnt_q;
   logic [NUM_FB-1:0]                      fill_out_done;
   logic [NUM_FB-1:0]                      fill_ext_req, fill_rvd_exp, fill_ram_req, fill_out_req;
   logic [NUM_FB-1:0]                      fill_data_sel, fill_data_reg;
   logic [NUM_FB-1:0]                      fill_data_hit, fill_data_rvd;
-  logic [NUM_FB-1:0][IC_LINE_BEATS_W-1:0] fill_ext_off, fill_rvd_off;
-  logic [NUM_FB-1:0][IC_LINE_BEATS_W:0]   fill_ext_beat, fill_rvd_beat;
+  logic [NUM_FB-1:0][LINE_BEATS_W-1:0]    fill_ext_off, fill_rvd_off;
+  logic [NUM_FB-1:0][LINE_BEATS_W:0]      fill_ext_beat, fill_rvd_beat;
   logic [NUM_FB-1:0]                      fill_ext_arb, fill_ram_arb, fill_out_arb;
   logic [NUM_FB-1:0]                      fill_rvd_arb;
   logic [NUM_FB-1:0]                      fill_entry_en;
   logic [NUM_FB-1:0]                      fill_addr_en;
   logic [NUM_FB-1:0]                      fill_way_en;
-  logic [NUM_FB-1:0][IC_LINE_BEATS-1:0]   fill_data_en;
-  logic [NUM_FB-1:0][IC_LINE_BEATS-1:0]   fill_err_d, fill_err_q;
+  logic [NUM_FB-1:0][LINE_BEATS-1:0]      fill_data_en;
+  logic [NUM_FB-1:0][LINE_BEATS-1:0]      fill_err_d, fill_err_q;
   logic [ADDR_W-1:0]                      fill_addr_q [NUM_FB];
-  logic [IC_NUM_WAYS-1:0]                 fill_way_q  [NUM_FB];
-  logic [IC_LINE_SIZE-1:0]                fill_data_d [NUM_FB];
-  logic [IC_LINE_SIZE-1:0]                fill_data_q [NUM_FB];
+  logic [ICacheNumWays-1:0]               fill_way_q  [NUM_FB];
+  logic [ICacheLineSize-1:0]              fill_data_d [NUM_FB];
+  logic [ICacheLineSize-1:0]              fill_data_q [NUM_FB];
   logic [ADDR_W-1:BUS_W]                  fill_ext_req_addr;
   logic [ADDR_W-1:0]                      fill_ram_req_addr;
-  logic [IC_NUM_WAYS-1:0]                 fill_ram_req_way;
-  logic [IC_LINE_SIZE-1:0]                fill_ram_req_data;
-  logic [IC_LINE_SIZE-1:0]                fill_out_data;
-  logic [IC_LINE_BEATS-1:0]               fill_out_err;
+  logic [ICacheNumWays-1:0]               fill_ram_req_way;
+  logic [ICacheLineSize-1:0]              fill_ram_req_data;
+  logic [ICacheLineSize-1:0]              fill_out_data;
+  logic [LINE_BEATS-1:0]                  fill_out_err;
   // External req signals
   logic                                   instr_req;
   logic [ADDR_W-1:BUS_W]                  instr_addr;
@@ -176,8 +198,8 @@ module ibex_icache import ibex_pkg::*; #(
   logic [ADDR_W-1:1]                      output_addr_d, output_addr_q;
   logic [15:0]                            output_data_lo, output_data_hi;
   logic                                   data_valid, output_ready;
-  logic [IC_LINE_SIZE-1:0]                line_data;
-  logic [IC_LINE_BEATS-1:0]               line_err;
+  logic [ICacheLineSize-1:0]              line_data;
+  logic [LINE_BEATS-1:0]                  line_err;
   logic [31:0]                            line_data_muxed;
   logic                                   line_err_muxed;
   logic [31:0]                            output_data;
@@ -193,7 +215,7 @@ module ibex_icache import ibex_pkg::*; #(
   inval_state_e          inval_state_q, inval_state_d;
   logic                  inval_write_req;
   logic                  inval_block_cache;
-  logic [IC_INDEX_W-1:0] inval_index_d, inval_index_q;
+  logic [ICacheIndexW-1:0] inval_index_d, inval_index_q;
   logic                  inval_index_en;
   logic                  inval_active;
 
@@ -201,7 +223,7 @@ module ibex_icache import ibex_pkg::*; #(
   // Instruction prefetch //
   //////////////////////////
 
-  assign lookup_addr_aligned = {lookup_addr_ic0[ADDR_W-1:IC_LINE_W], {IC_LINE_W{1'b0}}};
+  assign lookup_addr_aligned = {lookup_addr_ic0[ADDR_W-1:LINE_W], {LINE_W{1'b0}}};
 
   // The prefetch address increments by one cache line for each granted request.
   // This address is also updated if there is a branch that is not granted, since the target
@@ -211,7 +233,7 @@ module ibex_icache import ibex_pkg::*; #(
   // line must also be recorded for later use by the fill buffers.
   assign prefetch_addr_d     =
       lookup_grant_ic0 ? (lookup_addr_aligned +
-                          {{ADDR_W-IC_LINE_W-1{1'b0}}, 1'b1, {IC_LINE_W{1'b0}}}) :
+                          {{ADDR_W-LINE_W-1{1'b0}}, 1'b1, {LINE_W{1'b0}}}) :
                          addr_i;
 
   assign prefetch_addr_en    = branch_i | lookup_grant_ic0;
@@ -242,13 +264,13 @@ module ibex_icache import ibex_pkg::*; #(
   assign lookup_req_ic0   = req_i & ~&fill_busy_q & (branch_i | ~lookup_throttle) &
                             ~ecc_write_req;
   assign lookup_addr_ic0  = branch_i ? addr_i : prefetch_addr_q;
-  assign lookup_index_ic0 = lookup_addr_ic0[IC_INDEX_HI:IC_LINE_W];
+  assign lookup_index_ic0 = lookup_addr_ic0[INDEX_HI:LINE_W];
 
   // Cache write
   assign fill_req_ic0   = (|fill_ram_req);
-  assign fill_index_ic0 = fill_ram_req_addr[IC_INDEX_HI:IC_LINE_W];
+  assign fill_index_ic0 = fill_ram_req_addr[INDEX_HI:LINE_W];
   assign fill_tag_ic0   = {(~inval_write_req & ~ecc_write_req),
-                           fill_ram_req_addr[ADDR_W-1:IC_INDEX_HI+1]};
+                           fill_ram_req_addr[ADDR_W-1:INDEX_HI+1]};
   assign fill_wdata_ic0 = fill_ram_req_data;
 
   // Arbitrated signals - lookups have highest priority
@@ -266,7 +288,7 @@ module ibex_icache import ibex_pkg::*; #(
                                            lookup_index_ic0;
   assign tag_banks_ic0 = ecc_write_req  ? ecc_write_ways :
                          fill_grant_ic0 ? fill_ram_req_way :
-                                          {IC_NUM_WAYS{1'b1}};
+                                          {ICacheNumWays{1'b1}};
   assign tag_write_ic0 = fill_grant_ic0 | inval_write_req | ecc_write_req;
 
   // Dataram
@@ -282,20 +304,20 @@ module ibex_icache import ibex_pkg::*; #(
     // Reuse the same ecc encoding module for larger cache sizes by padding with zeros
     logic [21:0]             tag_ecc_input_padded;
     logic [27:0]             tag_ecc_output_padded;
-    logic [22-IC_TAG_SIZE:0] unused_tag_ecc_output;
+    logic [22-TAG_SIZE:0]    unused_tag_ecc_output;
 
-    assign tag_ecc_input_padded  = {{22-IC_TAG_SIZE{1'b0}},fill_tag_ic0};
-    assign unused_tag_ecc_output = tag_ecc_output_padded[21:IC_TAG_SIZE-1];
+    assign tag_ecc_input_padded  = {{22-TAG_SIZE{1'b0}},fill_tag_ic0};
+    assign unused_tag_ecc_output = tag_ecc_output_padded[21:TAG_SIZE-1];
 
     prim_secded_inv_28_22_enc tag_ecc_enc (
       .data_i (tag_ecc_input_padded),
       .data_o (tag_ecc_output_padded)
     );
 
-    assign tag_wdata_ic0 = {tag_ecc_output_padded[27:22],tag_ecc_output_padded[IC_TAG_SIZE-1:0]};
+    assign tag_wdata_ic0 = {tag_ecc_output_padded[27:22],tag_ecc_output_padded[TAG_SIZE-1:0]};
 
     // Dataram ECC
-    for (genvar bank = 0; bank < IC_LINE_BEATS; bank++) begin : gen_ecc_banks
+    for (genvar bank = 0; bank < LINE_BEATS; bank++) begin : gen_ecc_banks
       prim_secded_inv_39_32_enc data_ecc_enc (
         .data_i (fill_wdata_ic0[bank*BUS_SIZE+:BUS_SIZE]),
         .data_o (data_wdata_ic0[bank*BusSizeECC+:BusSizeECC])
@@ -312,7 +334,7 @@ module ibex_icache import ibex_pkg::*; #(
   ////////////////
 
   // Tag RAMs outputs
-  assign ic_tag_req_o    = {IC_NUM_WAYS{tag_req_ic0}} & tag_banks_ic0;
+  assign ic_tag_req_o    = {ICacheNumWays{tag_req_ic0}} & tag_banks_ic0;
   assign ic_tag_write_o  = tag_write_ic0;
   assign ic_tag_addr_o   = tag_index_ic0;
   assign ic_tag_wdata_o  = tag_wdata_ic0;
@@ -321,7 +343,7 @@ module ibex_icache import ibex_pkg::*; #(
   assign tag_rdata_ic1   = ic_tag_rdata_i;
 
   // Data RAMs outputs
-  assign ic_data_req_o   = {IC_NUM_WAYS{data_req_ic0}} & data_banks_ic0;
+  assign ic_data_req_o   = {ICacheNumWays{data_req_ic0}} & data_banks_ic0;
   assign ic_data_write_o = data_write_ic0;
   assign ic_data_addr_o  = data_index_ic0;
   assign ic_data_wdata_o = data_wdata_ic0;
@@ -343,14 +365,14 @@ module ibex_icache import ibex_pkg::*; #(
         lookup_addr_ic1 <= '0;
         fill_in_ic1     <= '0;
       end else if (lookup_grant_ic0) begin
-        lookup_addr_ic1 <= lookup_addr_ic0[ADDR_W-1:IC_INDEX_HI+1];
+        lookup_addr_ic1 <= lookup_addr_ic0[ADDR_W-1:INDEX_HI+1];
         fill_in_ic1     <= fill_alloc_sel;
       end
     end
   end else begin : g_lookup_addr_nr
     always_ff @(posedge clk_i) begin
       if (lookup_grant_ic0) begin
-        lookup_addr_ic1 <= lookup_addr_ic0[ADDR_W-1:IC_INDEX_HI+1];
+        lookup_addr_ic1 <= lookup_addr_ic0[ADDR_W-1:INDEX_HI+1];
         fill_in_ic1     <= fill_alloc_sel;
       end
     end
@@ -361,10 +383,10 @@ module ibex_icache import ibex_pkg::*; #(
   ////////////////////////
 
   // Tag matching
-  for (genvar way = 0; way < IC_NUM_WAYS; way++) begin : gen_tag_match
-    assign tag_match_ic1[way]   = (tag_rdata_ic1[way][IC_TAG_SIZE-1:0] ==
-                                   {1'b1,lookup_addr_ic1[ADDR_W-1:IC_INDEX_HI+1]});
-    assign tag_invalid_ic1[way] = ~tag_rdata_ic1[way][IC_TAG_SIZE-1];
+  for (genvar way = 0; way < ICacheNumWays; way++) begin : gen_tag_match
+    assign tag_match_ic1[way]   = (tag_rdata_ic1[way][TAG_SIZE-1:0] ==
+                                   {1'b1,lookup_addr_ic1[ADDR_W-1:INDEX_HI+1]});
+    assign tag_invalid_ic1[way] = ~tag_rdata_ic1[way][TAG_SIZE-1];
   end
 
   assign tag_hit_ic1 = |tag_match_ic1;
@@ -372,7 +394,7 @@ module ibex_icache import ibex_pkg::*; #(
   // Hit data mux
   always_comb begin
     hit_data_ecc_ic1 = 'b0;
-    for (int way = 0; way < IC_NUM_WAYS; way++) begin
+    for (int way = 0; way < ICacheNumWays; way++) begin
       if (tag_match_ic1[way]) begin
         hit_data_ecc_ic1 |= data_rdata_ic1[way];
       end
@@ -383,15 +405,15 @@ module ibex_icache import ibex_pkg::*; #(
   // 1 first invalid way
   // 2 global round-robin (pseudorandom) way
   assign lowest_invalid_way_ic1[0] = tag_invalid_ic1[0];
-  assign round_robin_way_ic1[0]    = round_robin_way_q[IC_NUM_WAYS-1];
-  for (genvar way = 1; way < IC_NUM_WAYS; way++) begin : gen_lowest_way
+  assign round_robin_way_ic1[0]    = round_robin_way_q[ICacheNumWays-1];
+  for (genvar way = 1; way < ICacheNumWays; way++) begin : gen_lowest_way
     assign lowest_invalid_way_ic1[way] = tag_invalid_ic1[way] & ~|tag_invalid_ic1[way-1:0];
     assign round_robin_way_ic1[way]    = round_robin_way_q[way-1];
   end
 
   always_ff @(posedge clk_i or negedge rst_ni) begin
     if (!rst_ni) begin
-      round_robin_way_q <= {{IC_NUM_WAYS-1{1'b0}}, 1'b1};
+      round_robin_way_q <= {{ICacheNumWays-1{1'b0}}, 1'b1};
     end else if (lookup_valid_ic1) begin
       round_robin_way_q <= round_robin_way_ic1;
     end
@@ -403,21 +425,21 @@ module ibex_icache import ibex_pkg::*; #(
   // ECC checking logic
   if (ICacheECC) begin : gen_data_ecc_checking
     // SEC_CM: ICACHE.MEM.INTEGRITY
-    logic [IC_NUM_WAYS-1:0]     tag_err_ic1;
-    logic [IC_LINE_BEATS*2-1:0] data_err_ic1;
+    logic [ICacheNumWays-1:0]   tag_err_ic1;
+    logic [LINE_BEATS*2-1:0]    data_err_ic1;
     logic                       ecc_correction_write_d, ecc_correction_write_q;
-    logic [IC_NUM_WAYS-1:0]     ecc_correction_ways_d, ecc_correction_ways_q;
-    logic [IC_INDEX_W-1:0]      lookup_index_ic1, ecc_correction_index_q;
+    logic [ICacheNumWays-1:0]   ecc_correction_ways_d, ecc_correction_ways_q;
+    logic [ICacheIndexW-1:0]    lookup_index_ic1, ecc_correction_index_q;
 
     // Tag ECC checking
-    for (genvar way = 0; way < IC_NUM_WAYS; way++) begin : gen_tag_ecc
+    for (genvar way = 0; way < ICacheNumWays; way++) begin : gen_tag_ecc
       logic [1:0]  tag_err_bank_ic1;
       logic [27:0] tag_rdata_padded_ic1;
 
       // Expand the tag rdata with extra padding if the tag size is less than the maximum
       assign tag_rdata_padded_ic1 = {tag_rdata_ic1[way][TagSizeECC-1-:6],
-                                     {22-IC_TAG_SIZE{1'b0}},
-                                     tag_rdata_ic1[way][IC_TAG_SIZE-1:0]};
+                                     {22-TAG_SIZE{1'b0}},
+                                     tag_rdata_ic1[way][TAG_SIZE-1:0]};
 
       prim_secded_inv_28_22_dec data_ecc_dec (
         .data_i     (tag_rdata_padded_ic1),
@@ -430,7 +452,7 @@ module ibex_icache import ibex_pkg::*; #(
 
     // Data ECC checking
     // Note - could generate for all ways and mux after
-    for (genvar bank = 0; bank < IC_LINE_BEATS; bank++) begin : gen_ecc_banks
+    for (genvar bank = 0; bank < LINE_BEATS; bank++) begin : gen_ecc_banks
       prim_secded_inv_39_32_dec data_ecc_dec (
         .data_i     (hit_data_ecc_ic1[bank*BusSizeECC+:BusSizeECC]),
         .data_o     (),
@@ -454,8 +476,8 @@ module ibex_icache import ibex_pkg::*; #(
     // All ways will be invalidated on a tag error to prevent X-propagation from data_err_ic1 on
     // spurious hits. Also prevents the same line being allocated twice when there was a true
     // hit and a spurious hit.
-    assign ecc_correction_ways_d  = {IC_NUM_WAYS{|tag_err_ic1}} |
-                                    (tag_match_ic1 & {IC_NUM_WAYS{|data_err_ic1}});
+    assign ecc_correction_ways_d  = {ICacheNumWays{|tag_err_ic1}} |
+                                    (tag_match_ic1 & {ICacheNumWays{|data_err_ic1}});
     assign ecc_correction_write_d = ecc_err_ic1;
 
     always_ff @(posedge clk_i or negedge rst_ni) begin
@@ -472,13 +494,13 @@ module ibex_icache import ibex_pkg::*; #(
         if (!rst_ni) begin
           lookup_index_ic1 <= '0;
         end else if (lookup_grant_ic0) begin
-          lookup_index_ic1 <= lookup_addr_ic0[IC_INDEX_HI-:IC_INDEX_W];
+          lookup_index_ic1 <= lookup_addr_ic0[INDEX_HI-:ICacheIndexW];
         end
       end
     end else begin : g_lookup_ind_nr
       always_ff @(posedge clk_i) begin
         if (lookup_grant_ic0) begin
-          lookup_index_ic1 <= lookup_addr_ic0[IC_INDEX_HI-:IC_INDEX_W];
+          lookup_index_ic1 <= lookup_addr_ic0[INDEX_HI-:ICacheIndexW];
         end
       end
     end
@@ -564,6 +586,11 @@ module ibex_icache import ibex_pkg::*; #(
 
   // Allocate a new buffer for every granted lookup
   assign fill_new_alloc = lookup_grant_ic0;
+  // With prefetching, lookups made past the usual throttling level (which would otherwise have
+  // waited for the oldest line to be output) are prefetches. They are counted as useful when the
+  // line missed and its data is then output.
+  assign fill_prefetch_new = ICachePrefetch & ~branch_i &
+                             (fb_fill_level >= FB_THRESHOLD[$clog2(NUM_FB)-1:0]);
   // Track whether a speculative external request was made from IC0, and whether it was granted
   // Speculative requests are only made for branches, or if the cache is disabled
   assign fill_spec_req  = (~icache_enable_i | branch_i) & ~|fill_ext_req;
@@ -613,6 +640,10 @@ module ibex_icache import ibex_pkg::*; #(
     // Record whether the request hit in the cache
     assign fill_hit_ic1[fb]    = lookup_valid_ic1 & fill_in_ic1[fb] & tag_hit_ic1 & ~ecc_err_ic1;
     assign fill_hit_d[fb]      = fill_hit_ic1[fb] | (fill_hit_q[fb] & fill_busy_q[fb]);
+    // Record whether the request was a prefetch
+    assign fill_prefetch_d[fb] = fill_alloc[fb] ? fill_prefetch_new : fill_prefetch_q[fb];
+    assign fill_prefetch_used[fb] = fill_done[fb] & fill_prefetch_q[fb] & ~fill_hit_q[fb] &
+                                    fill_out_done[fb] & ~fill_stale_q[fb];
 
     ///////////////////////////////////////////
     // Fill buffer external request tracking //
@@ -621,22 +652,22 @@ module ibex_icache import ibex_pkg::*; #(
     // Make an external request
     assign fill_ext_req[fb]    = fill_busy_q[fb] & ~fill_ext_done_d[fb];
 
-    // Count the number of completed external requests (each line requires IC_LINE_BEATS requests)
+    // Count the number of completed external requests (each line requires LINE_BEATS requests)
     assign fill_ext_cnt_d[fb]  = fill_alloc[fb] ?
-                                   {{IC_LINE_BEATS_W{1'b0}},fill_spec_done} :
-                                   (fill_ext_cnt_q[fb] + {{IC_LINE_BEATS_W{1'b0}},
+                                   {{LINE_BEATS_W{1'b0}},fill_spec_done} :
+                                   (fill_ext_cnt_q[fb] + {{LINE_BEATS_W{1'b0}},
                                                           fill_ext_arb[fb] & instr_gnt_i});
     // External request must be held until granted
     assign fill_ext_hold_d[fb] = (fill_alloc[fb] & fill_spec_hold) |
                                  (fill_ext_arb[fb] & ~instr_gnt_i);
     // External requests are completed when the counter is filled or when the request is cancelled
-    assign fill_ext_done_d[fb] = (fill_ext_cnt_q[fb][IC_LINE_BEATS_W] |
+    assign fill_ext_done_d[fb] = (fill_ext_cnt_q[fb][LINE_BEATS_W] |
                                   // external requests are considered complete if the request hit
                                   fill_hit_ic1[fb] | fill_hit_q[fb] |
                                   // cancel if the line won't be cached and, it is stale
                                   (~fill_cache_q[fb] & (branch_i | fill_stale_q[fb] |
                                    // or we're already at the end of the line
-                                                        fill_ext_beat[fb][IC_LINE_BEATS_W]))) &
+                                                        fill_ext_beat[fb][LINE_BEATS_W]))) &
                                  // can't cancel while we are waiting for a grant on the bus
                                  ~fill_ext_hold_q[fb] & fill_busy_q[fb];
     // Track whether this fill buffer expects to receive beats of data
@@ -644,7 +675,7 @@ module ibex_icache import ibex_pkg::*; #(
     // Count the number of rvalid beats received
     assign fill_rvd_cnt_d[fb]  = fill_alloc[fb] ? '0 :
                                                   (fill_rvd_cnt_q[fb] +
-                                                   {{IC_LINE_BEATS_W{1'b0}},fill_rvd_arb[fb]});
+                                                   {{LINE_BEATS_W{1'b0}},fill_rvd_arb[fb]});
     // External data is complete when all issued external requests have received their data
     assign fill_rvd_done[fb]   = (fill_ext_done_q[fb] & ~fill_ext_hold_q[fb]) &
                                  (fill_rvd_cnt_q[fb] == fill_ext_cnt_q[fb]);
@@ -667,18 +698,18 @@ module ibex_icache import ibex_pkg::*; #(
     assign fill_out_grant[fb]  = fill_out_arb[fb] & output_ready;
 
     // Count the beats of data output to the IF stage
-    assign fill_out_cnt_d[fb]  = fill_alloc[fb] ? {1'b0,lookup_addr_ic0[IC_LINE_W-1:BUS_W]} :
+    assign fill_out_cnt_d[fb]  = fill_alloc[fb] ? {1'b0,lookup_addr_ic0[LINE_W-1:BUS_W]} :
                                                   (fill_out_cnt_q[fb] +
-                                                   {{IC_LINE_BEATS_W{1'b0}},fill_out_grant[fb]});
+                                                   {{LINE_BEATS_W{1'b0}},fill_out_grant[fb]});
     // Data output complete when the counter fills
-    assign fill_out_done[fb]   = fill_out_cnt_q[fb][IC_LINE_BEATS_W];
+    assign fill_out_done[fb]   = fill_out_cnt_q[fb][LINE_BEATS_W];
 
     //////////////////////////////////////
     // Fill buffer ram request tracking //
     //////////////////////////////////////
 
                                  // make a fill request once all data beats received
-    assign fill_ram_req[fb]    = fill_busy_q[fb] & fill_rvd_cnt_q[fb][IC_LINE_BEATS_W] &
+    assign fill_ram_req[fb]    = fill_busy_q[fb] & fill_rvd_cnt_q[fb][LINE_BEATS_W] &
                                  // unless the request hit, was non-allocating or got an error
                                  ~fill_hit_q[fb] & fill_cache_q[fb] & ~|fill_err_q[fb] &
                                  // or the request was already completed
@@ -693,12 +724,12 @@ module ibex_icache import ibex_pkg::*; #(
 
     // When we branch into the middle of a line, the output count will not start from zero. This
     // beat count is used to know which incoming rdata beats are relevant.
-    assign fill_ext_beat[fb]   = {1'b0,fill_addr_q[fb][IC_LINE_W-1:BUS_W]} +
-                                 fill_ext_cnt_q[fb][IC_LINE_BEATS_W:0];
-    assign fill_ext_off[fb]    = fill_ext_beat[fb][IC_LINE_BEATS_W-1:0];
-    assign fill_rvd_beat[fb]   = {1'b0,fill_addr_q[fb][IC_LINE_W-1:BUS_W]} +
-                                 fill_rvd_cnt_q[fb][IC_LINE_BEATS_W:0];
-    assign fill_rvd_off[fb]    = fill_rvd_beat[fb][IC_LINE_BEATS_W-1:0];
+    assign fill_ext_beat[fb]   = {1'b0,fill_addr_q[fb][LINE_W-1:BUS_W]} +
+                                 fill_ext_cnt_q[fb][LINE_BEATS_W:0];
+    assign fill_ext_off[fb]    = fill_ext_beat[fb][LINE_BEATS_W-1:0];
+    assign fill_rvd_beat[fb]   = {1'b0,fill_addr_q[fb][LINE_W-1:BUS_W]} +
+                                 fill_rvd_cnt_q[fb][LINE_BEATS_W:0];
+    assign fill_rvd_off[fb]    = fill_rvd_beat[fb][LINE_BEATS_W-1:0];
 
     /////////////////////////////
     // Fill buffer arbitration //
@@ -751,6 +782,7 @@ module ibex_icache import ibex_pkg::*; #(
         fill_stale_q[fb]    <= 1'b0;
         fill_cache_q[fb]    <= 1'b0;
         fill_hit_q[fb]      <= 1'b0;
+        fill_prefetch_q[fb] <= 1'b0;
         fill_ext_cnt_q[fb]  <= '0;
         fill_ext_hold_q[fb] <= 1'b0;
         fill_ext_done_q[fb] <= 1'b0;
@@ -763,6 +795,7 @@ module ibex_icache import ibex_pkg::*; #(
         fill_stale_q[fb]    <= fill_stale_d[fb];
         fill_cache_q[fb]    <= fill_cache_d[fb];
         fill_hit_q[fb]      <= fill_hit_d[fb];
+        fill_prefetch_q[fb] <= fill_prefetch_d[fb];
         fill_ext_cnt_q[fb]  <= fill_ext_cnt_d[fb];
         fill_ext_hold_q[fb] <= fill_ext_hold_d[fb];
         fill_ext_done_q[fb] <= fill_ext_done_d[fb];
@@ -806,12 +839,12 @@ module ibex_icache import ibex_pkg::*; #(
     // Data either comes from the cache or the bus. If there was an ECC error, we must take
     // the incoming bus data since the cache hit data is corrupted.
     assign fill_data_d[fb] = fill_hit_ic1[fb] ? hit_data_ic1 :
-                                                {IC_LINE_BEATS{instr_rdata_i}};
+                                                {LINE_BEATS{instr_rdata_i}};
 
-    for (genvar b = 0; b < IC_LINE_BEATS; b++) begin : gen_data_buf
+    for (genvar b = 0; b < LINE_BEATS; b++) begin : gen_data_buf
       // Error tracking (per beat)
       assign fill_err_d[fb][b]   = (fill_rvd_arb[fb] & instr_err_i &
-                                    (fill_rvd_off[fb] == b[IC_LINE_BEATS_W-1:0])) |
+                                    (fill_rvd_off[fb] == b[LINE_BEATS_W-1:0])) |
       //                           Hold the error once recorded
                                    (fill_busy_q[fb] & fill_err_q[fb][b]);
 
@@ -827,7 +860,7 @@ module ibex_icache import ibex_pkg::*; #(
       // Ignore incoming rvalid data when we already have cache hit data
       assign fill_data_en[fb][b] = fill_hit_ic1[fb] |
                                    (fill_rvd_arb[fb] & ~fill_hit_q[fb] &
-                                    (fill_rvd_off[fb] == b[IC_LINE_BEATS_W-1:0]));
+                                    (fill_rvd_off[fb] == b[LINE_BEATS_W-1:0]));
 
       if (ResetAll) begin : g_fill_data_ra
         always_ff @(posedge clk_i or negedge rst_ni) begin
@@ -857,7 +890,7 @@ module ibex_icache import ibex_pkg::*; #(
     fill_ext_req_addr = '0;
     for (int i = 0; i < NUM_FB; i++) begin
       if (fill_ext_arb[i]) begin
-        fill_ext_req_addr |= {fill_addr_q[i][ADDR_W-1:IC_LINE_W], fill_ext_off[i]};
+        fill_ext_req_addr |= {fill_addr_q[i][ADDR_W-1:LINE_W], fill_ext_off[i]};
       end
     end
   end
@@ -884,7 +917,7 @@ module ibex_icache import ibex_pkg::*; #(
       if (fill_data_reg[i]) begin
         fill_out_data |= fill_data_q[i];
         // Ignore any speculative errors accumulated on cache hits
-        fill_out_err  |= (fill_err_q[i] & ~{IC_LINE_BEATS{fill_hit_q[i]}});
+        fill_out_err  |= (fill_err_q[i] & ~{LINE_BEATS{fill_hit_q[i]}});
       end
     end
   end
@@ -908,16 +941,16 @@ module ibex_icache import ibex_pkg::*; #(
 
   // Mux between line-width data sources
   assign line_data = |fill_data_hit ? hit_data_ic1 : fill_out_data;
-  assign line_err  = |fill_data_hit ? {IC_LINE_BEATS{1'b0}} : fill_out_err;
+  assign line_err  = |fill_data_hit ? {LINE_BEATS{1'b0}} : fill_out_err;
 
   // Mux the relevant beat of line data, based on the output address
   always_comb begin
     line_data_muxed = '0;
     line_err_muxed  = 1'b0;
-    for (int unsigned i = 0; i < IC_LINE_BEATS; i++) begin
+    for (int unsigned i = 0; i < LINE_BEATS; i++) begin
       // When data has been skidded, the output address is behind by one
-      if ((output_addr_q[IC_LINE_W-1:BUS_W] + {{IC_LINE_BEATS_W-1{1'b0}},skid_valid_q}) ==
-          i[IC_LINE_BEATS_W-1:0]) begin
+      if ((output_addr_q[LINE_W-1:BUS_W] + {{LINE_BEATS_W-1{1'b0}},skid_valid_q}) ==
+          i[LINE_BEATS_W-1:0]) begin
         line_data_muxed |= line_data[i*32+:32];
         line_err_muxed  |= line_err[i];
       end
@@ -1108,7 +1141,7 @@ module ibex_icache import ibex_pkg::*; #(
         // Actually invalidate the cache. Write every entry in the tag RAM with an invalid tag. Once
         // all are written we're done.
         inval_write_req = 1'b1;
-        inval_index_d   = (inval_index_q + {{IC_INDEX_W-1{1'b0}},1'b1});
+        inval_index_d   = (inval_index_q + {{ICacheIndexW-1{1'b0}},1'b1});
         inval_index_en  = 1'b1;
 
         if (icache_inval_i) begin
@@ -1169,14 +1202,25 @@ module ibex_icache import ibex_pkg::*; #(
   // outstanding.
   assign busy_o = inval_active | (|(fill_busy_q & ~fill_rvd_done));
 
+  ////////////////////////////////
+  // Performance counter events //
+  ////////////////////////////////
+
+  // Every lookup made is a hit or a miss, including lookups ahead of the line being output
+  assign perf_hit_o      = lookup_valid_ic1 & tag_hit_ic1 & ~ecc_err_ic1;
+  assign perf_miss_o     = lookup_valid_ic1 & ~(tag_hit_ic1 & ~ecc_err_ic1);
+  assign perf_prefetch_o = |fill_prefetch_used;
+
   ////////////////
   // Assertions //
   ////////////////
 
-  `ASSERT_INIT(size_param_legal, (IC_LINE_SIZE > 32))
+  `ASSERT_INIT(size_param_legal, (ICacheLineSize > 32))
+  `ASSERT_INIT(line_size_param_legal, ICacheLineSize == 2**$clog2(ICacheLineSize))
+  `ASSERT_INIT(ways_param_legal, ICacheNumWays > 0)
 
-  // ECC primitives will need to be changed for different sizes
-  `ASSERT_INIT(ecc_tag_param_legal, (IC_TAG_SIZE <= 27))
+  // The tag is padded up to the 22 data bits of the 28_22 SECDED primitives, so it can't be wider
+  `ASSERT_INIT(ecc_tag_param_legal, !ICacheECC || (TAG_SIZE <= 22))
   `ASSERT_INIT(ecc_data_param_legal, !ICacheECC || (BUS_SIZE == 32))
 
   // Lookups in the tag ram should always give a known result
@@ -21,10 +21,15 @@ module ibex_id_stage #(
   parameter bit               RV32E           = 0,
   parameter ibex_pkg::rv32m_e RV32M           = ibex_pkg::RV32MFast,
   parameter ibex_pkg::rv32b_e RV32B           = ibex_pkg::RV32BNone,
+  parameter ibex_pkg::rv32f_e RV32F           = ibex_pkg::RV32FNone,
+  parameter bit               SoftFloatAssist = 1'b0,
   parameter bit               DataIndTiming   = 1'b0,
   parameter bit               BranchTargetALU = 0,
   parameter bit               WritebackStage  = 0,
+  parameter bit               LoadPipelining  = 0,
+  parameter bit               DCache          = 0,
   parameter bit               BranchPredictor = 0,
+  parameter bit               MacroOpFusion   = 0,
   parameter bit               MemECC          = 1'b0
 ) (
   input  logic                      clk_i,
@@ -39,13 +44,23 @@ module ibex_id_stage #(
   input  logic [31:0]               instr_rdata_alu_i,     // from IF-ID pipeline registers
   input  logic [15:0]               instr_rdata_c_i,       // from IF-ID pipeline registers
   input  logic                      instr_is_compressed_i,
+  input  logic                      instr_fused_i,         // first instr of a fused pair
+  input  logic [31:0]               instr_rdata_fused_i,   // second instr of a fused pair
   input  logic                      instr_bp_taken_i,
+  input  logic                      bp_target_mismatch_i,
+  output logic                      bp_branch_resolve_o,
+  output logic                      bp_branch_taken_o,
+  output logic                      bp_jump_resolve_o,
+  output logic                      bp_ras_push_o,
+  output logic                      bp_ras_pop_o,
   output logic                      instr_req_o,
   output logic                      instr_first_cycle_id_o,
   output logic                      instr_valid_clear_o,   // kill instr in IF-ID reg
   output logic                      id_in_ready_o,         // ID stage is ready for next instr
   input  logic                      instr_exec_i,
   output logic                      icache_inval_o,
+  output logic                      dcache_flush_o,
+  input  logic                      dcache_busy_i,
 
   // Jumps and branches
   input  logic                      branch_decision_i,
@@ -71,6 +86,7 @@ module ibex_id_stage #(
   output ibex_pkg::alu_op_e         alu_operator_ex_o,
   output logic [31:0]               alu_operand_a_ex_o,
   output logic [31:0]               alu_operand_b_ex_o,
+  output logic [31:0]               alu_result_mask_ex_o,
 
   // Multicycle Operation Stage Register
   input  logic [1:0]                imd_val_we_ex_i,
@@ -92,6 +108,14 @@ module ibex_id_stage #(
   output logic [31:0]               multdiv_operand_b_ex_o,
   output logic                      multdiv_ready_id_o,
 
+  // FPU, shares the MUL/DIV operands
+  output logic                      fp_en_ex_o,
+  output logic                      fp_sel_ex_o,
+  output ibex_pkg::fp_op_e          fp_operator_ex_o,
+  output ibex_pkg::fp_rm_e          fp_rm_ex_o,
+  input  logic [2:0]                fp_frm_i,
+  output logic                      fp_fflags_we_o,
+
   // CSR
   output logic                      csr_access_o,
   output ibex_pkg::csr_op_e         csr_op_o,
@@ -111,6 +135,8 @@ module ibex_id_stage #(
 
   // Interface to load store unit
   output logic                      lsu_req_o,
+  output logic                      lsu_spec_req_o, // aligned load may request early
+  output logic                      lsu_spec_kill_o, // load leaving without executing
   output logic                      lsu_we_o,
   output logic [1:0]                lsu_type_o,
   output logic                      lsu_sign_ext_o,
@@ -135,6 +161,8 @@ module ibex_id_stage #(
   input  logic                      lsu_load_resp_intg_err_i,
   input  logic                      lsu_store_err_i,
   input  logic                      lsu_store_resp_intg_err_i,
+  input  logic                      dcache_wb_err_i,
+  input  logic [31:0]               dcache_wb_err_addr_i,
 
   output logic                      expecting_load_resp_o,
   output logic                      expecting_store_resp_o,
@@ -189,6 +217,8 @@ module ibex_id_stage #(
                                                         // access to finish before proceeding
   output logic                      perf_mul_wait_o,
   output logic                      perf_div_wait_o,
+  output logic                      perf_fp_wait_o,
+  output logic                      perf_bp_mispredict_o,
   output logic                      instr_id_done_o
 );
 
@@ -203,6 +233,8 @@ module ibex_id_stage #(
   logic        dret_insn_dec;
   logic        ecall_insn_dec;
   logic        wfi_insn_dec;
+  logic        fencei_insn_dec;
+  logic        icache_inval_dec;
 
   logic        wb_exception;
   logic        id_exception;
@@ -210,6 +242,8 @@ module ibex_id_stage #(
   logic        branch_in_dec;
   logic        branch_set, branch_set_raw, branch_set_raw_d;
   logic        branch_jump_set_done_q, branch_jump_set_done_d;
+  logic        bp_branch_executing;
+  logic        bp_branch_resolved_q, bp_branch_resolved_d;
   logic        branch_not_set;
   logic        branch_taken;
   logic        jump_in_dec;
@@ -224,6 +258,7 @@ module ibex_id_stage #(
   logic        stall_ld_hz;
   logic        stall_mem;
   logic        stall_multdiv;
+  logic        stall_fp;
   logic        stall_branch;
   logic        stall_jump;
   logic        stall_id;
@@ -283,6 +318,9 @@ module ibex_id_stage #(
   md_op_e      multdiv_operator;
   logic [1:0]  multdiv_signed_mode;
 
+  // FPU Control
+  logic        fp_en_id, fp_en_dec;
+
   // Data Memory Control
   logic        lsu_we;
   logic [1:0]  lsu_type;
@@ -437,7 +475,10 @@ module ibex_id_stage #(
     .RV32E          (RV32E),
     .RV32M          (RV32M),
     .RV32B          (RV32B),
-    .BranchTargetALU(BranchTargetALU)
+    .RV32F          (RV32F),
+    .SoftFloatAssist(SoftFloatAssist),
+    .BranchTargetALU(BranchTargetALU),
+    .MacroOpFusion  (MacroOpFusion)
   ) decoder_i (
     .clk_i (clk_i),
     .rst_ni(rst_ni),
@@ -451,13 +492,16 @@ module ibex_id_stage #(
     .wfi_insn_o    (wfi_insn_dec),
     .jump_set_o    (jump_set_dec),
     .branch_taken_i(branch_taken),
-    .icache_inval_o(icache_inval_o),
+    .icache_inval_o(icache_inval_dec),
+    .fencei_insn_o (fencei_insn_dec),
 
     // from IF-ID pipeline register
     .instr_first_cycle_i(instr_first_cycle),
     .instr_rdata_i      (instr_rdata_i),
     .instr_rdata_alu_i  (instr_rdata_alu_i),
     .illegal_c_insn_i   (illegal_c_insn_i),
+    .instr_fused_i      (instr_fused_i),
+    .instr_rdata_fused_i(instr_rdata_fused_i),
 
     // immediates
     .imm_a_mux_sel_o(imm_a_mux_sel),
@@ -487,6 +531,7 @@ module ibex_id_stage #(
     .alu_op_a_mux_sel_o(alu_op_a_mux_sel_dec),
     .alu_op_b_mux_sel_o(alu_op_b_mux_sel_dec),
     .alu_multicycle_o  (alu_multicycle_dec),
+    .alu_result_mask_o (alu_result_mask_ex_o),
 
     // MULT & DIV
     .mult_en_o            (mult_en_dec),
@@ -496,6 +541,13 @@ module ibex_id_stage #(
     .multdiv_operator_o   (multdiv_operator),
     .multdiv_signed_mode_o(multdiv_signed_mode),
 
+    // FPU
+    .fp_en_o      (fp_en_dec),
+    .fp_sel_o     (fp_sel_ex_o),
+    .fp_operator_o(fp_operator_ex_o),
+    .fp_rm_o      (fp_rm_ex_o),
+    .fp_frm_i     (fp_frm_i),
+
     // CSRs
     .csr_access_o(csr_access_o),
     .csr_op_o    (csr_op_o),
@@ -546,7 +598,8 @@ module ibex_id_stage #(
   ibex_controller #(
     .WritebackStage (WritebackStage),
     .BranchPredictor(BranchPredictor),
-    .MemECC(MemECC)
+    .MemECC(MemECC),
+    .DCache(DCache)
   ) controller_i (
     .clk_i (clk_i),
     .rst_ni(rst_ni),
@@ -568,6 +621,7 @@ module ibex_id_stage #(
     .instr_compressed_i     (instr_rdata_c_i),
     .instr_is_compressed_i  (instr_is_compressed_i),
     .instr_bp_taken_i       (instr_bp_taken_i),
+    .bp_target_mismatch_i   (bp_target_mismatch_i),
     .instr_fetch_err_i      (instr_fetch_err_i),
     .instr_fetch_err_plus2_i(instr_fetch_err_plus2_i),
     .pc_id_i                (pc_id_i),
@@ -587,12 +641,14 @@ module ibex_id_stage #(
     .exc_cause_o           (exc_cause_o),
 
     // LSU
-    .lsu_addr_last_i    (lsu_addr_last_i),
-    .load_err_i         (lsu_load_err_i),
-    .mem_resp_intg_err_i(mem_resp_intg_err),
-    .store_err_i        (lsu_store_err_i),
-    .wb_exception_o     (wb_exception),
-    .id_exception_o     (id_exception),
+    .lsu_addr_last_i     (lsu_addr_last_i),
+    .load_err_i          (lsu_load_err_i),
+    .mem_resp_intg_err_i (mem_resp_intg_err),
+    .dcache_wb_err_i     (dcache_wb_err_i),
+    .dcache_wb_err_addr_i(dcache_wb_err_addr_i),
+    .store_err_i         (lsu_store_err_i),
+    .wb_exception_o      (wb_exception),
+    .id_exception_o      (id_exception),
 
     // jump/branch control
     .branch_set_i     (branch_set),
@@ -642,6 +698,7 @@ module ibex_id_stage #(
   assign lsu_req         = instr_executing ? data_req_allowed & lsu_req_dec  : 1'b0;
   assign mult_en_id      = instr_executing ? mult_en_dec                     : 1'b0;
   assign div_en_id       = instr_executing ? div_en_dec                      : 1'b0;
+  assign fp_en_id        = instr_executing ? fp_en_dec                       : 1'b0;
 
   assign lsu_req_o               = lsu_req;
   assign lsu_we_o                = lsu_we;
@@ -653,6 +710,8 @@ module ibex_id_stage #(
   // access is illegal. A combinational loop would be created if csr_op_en_o was used along (as
   // asserting it for an illegal csr access would result in a flush that would need to deassert it).
   assign csr_op_en_o             = csr_access_o & instr_executing & instr_id_done_o;
+  // The FPU exception flags are accumulated into fflags as the instruction completes
+  assign fp_fflags_we_o          = fp_en_dec & instr_executing & instr_id_done_o;
 
   assign alu_operator_ex_o           = alu_operator;
   assign alu_operand_a_ex_o          = alu_operand_a;
@@ -666,6 +725,8 @@ module ibex_id_stage #(
   assign multdiv_operand_a_ex_o      = rf_rdata_a_fwd;
   assign multdiv_operand_b_ex_o      = rf_rdata_b_fwd;
 
+  assign fp_en_ex_o                  = fp_en_id;
+
   ////////////////////////
   // Branch set control //
   ////////////////////////
@@ -782,6 +843,7 @@ module ibex_id_stage #(
     id_fsm_d                = id_fsm_q;
     rf_we_raw               = rf_we_dec;
     stall_multdiv           = 1'b0;
+    stall_fp                = 1'b0;
     stall_jump              = 1'b0;
     stall_branch            = 1'b0;
     stall_alu               = 1'b0;
@@ -814,6 +876,15 @@ module ibex_id_stage #(
                 stall_multdiv = 1'b1;
               end
             end
+            fp_en_dec: begin
+              // FP operation, sign injection, min/max, compare and classify finish in the first
+              // cycle
+              if (~ex_valid_i) begin
+                id_fsm_d      = MULTI_CYCLE;
+                rf_we_raw     = 1'b0;
+                stall_fp      = 1'b1;
+              end
+            end
             branch_in_dec: begin
               // cond branch operation
               // All branches take two cycles in fixed time execution mode, regardless of branch
@@ -831,11 +902,19 @@ module ibex_id_stage #(
               perf_branch_o = 1'b1;
             end
             jump_in_dec: begin
-              // uncond branch operation
-              // BTALU means jumps only need one cycle
-              id_fsm_d      = BranchTargetALU ? FIRST_CYCLE : MULTI_CYCLE;
-              stall_jump    = ~BranchTargetALU;
-              jump_set_raw  = jump_set_dec;
+              if (DCache && fencei_insn_dec) begin
+                // FENCE.I starts a data cache flush and waits for it before jumping, see below.
+                // The flush only starts once no earlier memory access is outstanding
+                // (instr_executing), so stay in FIRST_CYCLE until then.
+                id_fsm_d      = instr_executing ? MULTI_CYCLE : FIRST_CYCLE;
+                stall_jump    = 1'b1;
+              end else begin
+                // uncond branch operation
+                // BTALU means jumps only need one cycle
+                id_fsm_d      = BranchTargetALU ? FIRST_CYCLE : MULTI_CYCLE;
+                stall_jump    = ~BranchTargetALU;
+                jump_set_raw  = jump_set_dec;
+              end
             end
             alu_multicycle_dec: begin
               stall_alu     = 1'b1;
@@ -849,14 +928,23 @@ module ibex_id_stage #(
         end
 
         MULTI_CYCLE: begin
-          if(multdiv_en_dec) begin
+          if(multdiv_en_dec | fp_en_dec) begin
             rf_we_raw       = rf_we_dec & ex_valid_i;
           end
 
-          if (multicycle_done & ready_wb_i) begin
+          if (DCache && fencei_insn_dec) begin
+            // The next instruction is fetched once the data cache flush has finished
+            if (dcache_busy_i) begin
+              stall_jump    = 1'b1;
+            end else begin
+              jump_set_raw  = 1'b1;
+              id_fsm_d      = FIRST_CYCLE;
+            end
+          end else if (multicycle_done & ready_wb_i) begin
             id_fsm_d        = FIRST_CYCLE;
           end else begin
             stall_multdiv   = multdiv_en_dec;
+            stall_fp        = fp_en_dec;
             stall_branch    = branch_in_dec;
             stall_jump      = jump_in_dec;
           end
@@ -877,14 +965,14 @@ module ibex_id_stage #(
 
   // Stall ID/EX stage for reason that relates to instruction in ID/EX, update assertion below if
   // modifying this.
-  assign stall_id = stall_ld_hz | stall_mem | stall_multdiv | stall_jump | stall_branch |
-                      stall_alu;
+  assign stall_id = stall_ld_hz | stall_mem | stall_multdiv | stall_fp | stall_jump |
+                      stall_branch | stall_alu;
 
   // Generally illegal instructions have no reason to stall, however they must still stall waiting
   // for outstanding memory requests so exceptions related to them take priority over the illegal
   // instruction exception.
   `ASSERT(IllegalInsnStallMustBeMemStall, illegal_insn_o & stall_id |-> stall_mem &
-    ~(stall_ld_hz | stall_multdiv | stall_jump | stall_branch | stall_alu))
+    ~(stall_ld_hz | stall_multdiv | stall_fp | stall_jump | stall_branch | stall_alu))
 
   assign instr_done = ~stall_id & ~flush_id & instr_executing;
 
@@ -895,6 +983,29 @@ module ibex_id_stage #(
   // Used by ALU to access RS3 if ternary instruction.
   assign instr_first_cycle_id_o = instr_first_cycle;
 
+  if (DCache) begin : g_fencei_dcache_flush
+    // Instructions written through the data cache must reach memory before FENCE.I fetches them.
+    // FENCE.I stays in FIRST_CYCLE until no earlier load or store is outstanding
+    // (instr_executing), starts the flush as it moves to MULTI_CYCLE, then stays in ID/EX until
+    // the flush has finished. Only then does it invalidate the ICache and jump to the next
+    // instruction, so neither can fetch stale code.
+    assign dcache_flush_o = fencei_insn_dec & instr_executing & instr_first_cycle;
+    assign icache_inval_o = fencei_insn_dec & jump_set;
+
+    // FENCE.I only waits in MULTI_CYCLE for a flush it has started
+    `ASSERT(IbexFenceIFlushOnMultiCycle,
+      fencei_insn_dec & (id_fsm_q == FIRST_CYCLE) & (id_fsm_d == MULTI_CYCLE) |-> dcache_flush_o)
+
+    logic unused_icache_inval_dec;
+    assign unused_icache_inval_dec = icache_inval_dec;
+  end else begin : g_no_fencei_dcache_flush
+    assign dcache_flush_o = 1'b0;
+    assign icache_inval_o = icache_inval_dec;
+
+    logic unused_dcache_busy;
+    assign unused_dcache_busy = dcache_busy_i;
+  end
+
   if (WritebackStage) begin : gen_stall_mem
     // Register read address matches write address in WB
     logic rf_rd_a_wb_match;
@@ -976,6 +1087,20 @@ module ibex_id_stage #(
     `ASSERT(IbexStallMemNoRequest,
       instr_valid_i & lsu_req_dec & ~instr_done |-> ~lsu_req_done_i)
 
+    if (LoadPipelining) begin : g_load_pipelining
+      // A load that is only waiting for the response to the load in writeback may request early.
+      // Whether it executes depends on that response, so the request is speculative and the LSU
+      // drops it if the load leaves ID/EX without executing (e.g. because the load in writeback
+      // saw an error). The LSU only makes the request for aligned loads inside the
+      // LoadPipeliningRegion, as a killed load is read again when it is reissued.
+      assign lsu_spec_req_o  = instr_executing_spec & ~instr_kill & lsu_req_dec & ~lsu_we &
+                               outstanding_load_wb_i & ~lsu_resp_valid_i;
+      assign lsu_spec_kill_o = instr_valid_i & instr_valid_clear_o & ~instr_done;
+    end else begin : g_no_load_pipelining
+      assign lsu_spec_req_o  = 1'b0;
+      assign lsu_spec_kill_o = 1'b0;
+    end
+
     assign rf_rd_a_wb_match = (rf_waddr_wb_i == rf_raddr_a_o) & |rf_raddr_a_o;
     assign rf_rd_b_wb_match = (rf_waddr_wb_i == rf_raddr_b_o) & |rf_raddr_b_o;
 
@@ -1007,6 +1132,10 @@ module ibex_id_stage #(
     assign perf_dside_wait_o = instr_valid_i & ~instr_kill &
                                (outstanding_memory_access | stall_ld_hz);
 
+    // A branch is decided (and may leave FIRST_CYCLE) on instr_executing_spec, so it trains the
+    // branch predictor then too, unless it is about to be killed
+    assign bp_branch_executing = instr_executing_spec & ~instr_kill;
+
     // With writeback stage load/store responses are processed in the writeback stage so the ID/EX
     // stage is never expecting a load or store response.
     assign expecting_load_resp_o  = 1'b0;
@@ -1028,6 +1157,8 @@ module ibex_id_stage #(
     assign instr_executing_spec = instr_valid_i & ~instr_fetch_err_i & controller_run;
     assign instr_executing = instr_executing_spec;
 
+    assign bp_branch_executing = instr_executing;
+
     `ASSERT(IbexStallIfValidInstrNotExecuting,
       instr_valid_i & ~instr_fetch_err_i & ~instr_executing & controller_run |-> stall_id)
 
@@ -1070,6 +1201,10 @@ module ibex_id_stage #(
     assign instr_type_wb_o = WB_INSTR_OTHER;
     assign stall_wb        = 1'b0;
 
+    // Loads are only requested early with the writeback stage
+    assign lsu_spec_req_o  = 1'b0;
+    assign lsu_spec_kill_o = 1'b0;
+
     assign perf_dside_wait_o = instr_executing & lsu_req_dec & ~lsu_resp_valid_i;
 
     assign instr_id_done_o = instr_done;
@@ -1086,6 +1221,38 @@ module ibex_id_stage #(
 
   assign perf_mul_wait_o = stall_multdiv & mult_en_dec;
   assign perf_div_wait_o = stall_multdiv & div_en_dec;
+  assign perf_fp_wait_o  = stall_fp;
+
+  // Resolved branches and indirect jumps train the dynamic branch predictor in the IF stage. A
+  // branch resolves in the first cycle it executes in FIRST_CYCLE, a jump's target is available
+  // when jump_set is raised. A not-taken branch may stay in FIRST_CYCLE while an outstanding
+  // memory access completes, so only its first resolution is sent on.
+  assign bp_branch_resolve_o = bp_branch_executing & (id_fsm_q == FIRST_CYCLE) & branch_in_dec &
+                               ~bp_branch_resolved_q;
+  assign bp_branch_taken_o   = branch_decision_i;
+
+  assign bp_branch_resolved_d = (bp_branch_resolve_o | bp_branch_resolved_q) & ~instr_valid_clear_o;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      bp_branch_resolved_q <= 1'b0;
+    end else begin
+      bp_branch_resolved_q <= bp_branch_resolved_d;
+    end
+  end
+  assign bp_jump_resolve_o   = jump_set & (opcode_e'(instr_rdata_i[6:0]) == OPCODE_JALR);
+
+  // Calls (jumps writing ra) and returns (jalr x0, 0(ra)) maintain the return address stack. The
+  // instruction has been decompressed by this point.
+  assign bp_ras_push_o = jump_set & (instr_rdata_i[11:7] == 5'd1);
+  assign bp_ras_pop_o  = jump_set & (opcode_e'(instr_rdata_i[6:0]) == OPCODE_JALR) &
+                         (instr_rdata_i[31:7] == {12'b0, 5'd1, 3'b0, 5'd0});
+
+  // A branch whose direction didn't match the prediction or a predicted jump that went somewhere
+  // else
+  assign perf_bp_mispredict_o = BranchPredictor &
+      ((bp_branch_resolve_o & (branch_decision_i ^ instr_bp_taken_i)) |
+       (jump_set & instr_bp_taken_i & bp_target_mismatch_i));
 
   //////////
   // FCOV //
@@ -1138,7 +1305,7 @@ module ibex_id_stage #(
 
   // Multicycle enable signals must be unique.
   `ASSERT(IbexMulticycleEnableUnique,
-      $onehot0({lsu_req_dec, multdiv_en_dec, branch_in_dec, jump_in_dec}))
+      $onehot0({lsu_req_dec, multdiv_en_dec, fp_en_dec, branch_in_dec, jump_in_dec}))
 
   // Duplicated instruction flops must match
   // === as DV environment can produce instructions with Xs in, so must use precise match that
@@ -14,21 +14,28 @@
 `include "dv_fcov_macros.svh"
 
 module ibex_if_stage import ibex_pkg::*; #(
-  parameter int unsigned DmHaltAddr        = 32'h1A110800,
-  parameter int unsigned DmExceptionAddr   = 32'h1A110808,
-  parameter bit          DummyInstructions = 1'b0,
-  parameter bit          ICache            = 1'b0,
-  parameter bit          ICacheECC         = 1'b0,
-  parameter int unsigned BusSizeECC        = BUS_SIZE,
-  parameter int unsigned TagSizeECC        = IC_TAG_SIZE,
-  parameter int unsigned LineSizeECC       = IC_LINE_SIZE,
-  parameter bit          PCIncrCheck       = 1'b0,
-  parameter bit          ResetAll          = 1'b0,
-  parameter lfsr_seed_t  RndCnstLfsrSeed   = RndCnstLfsrSeedDefault,
-  parameter lfsr_perm_t  RndCnstLfsrPerm   = RndCnstLfsrPermDefault,
-  parameter bit          BranchPredictor   = 1'b0,
-  parameter bit          MemECC            = 1'b0,
-  parameter int unsigned MemDataWidth      = MemECC ? 32 + 7 : 32
+  parameter int unsigned DmHaltAddr             = 32'h1A110800,
+  parameter int unsigned DmExceptionAddr        = 32'h1A110808,
+  parameter bit          DummyInstructions      = 1'b0,
+  parameter bit          ICache                 = 1'b0,
+  parameter bit          ICacheECC              = 1'b0,
+  parameter int unsigned ICacheNumWays          = IC_NUM_WAYS,
+  parameter int unsigned ICacheIndexW           = IC_INDEX_W,
+  parameter int unsigned ICacheLineSize         = IC_LINE_SIZE,
+  parameter bit          ICachePrefetch         = 1'b0,
+  parameter int unsigned BusSizeECC             = BUS_SIZE,
+  parameter int unsigned TagSizeECC             = IC_TAG_SIZE,
+  parameter int unsigned LineSizeECC            = IC_LINE_SIZE,
+  parameter bit          PCIncrCheck            = 1'b0,
+  parameter bit          ResetAll               = 1'b0,
+  parameter lfsr_seed_t  RndCnstLfsrSeed        = RndCnstLfsrSeedDefault,
+  parameter lfsr_perm_t  RndCnstLfsrPerm        = RndCnstLfsrPermDefault,
+  parameter bit          BranchPredictor        = 1'b0,
+  parameter bit          BranchPredictorDynamic = 1'b0,
+  parameter bit          ReturnAddrStack        = 1'b0,
+  parameter bit          MacroOpFusion          = 1'b0,
+  parameter bit          MemECC                 = 1'b0,
+  parameter int unsigned MemDataWidth           = MemECC ? 32 + 7 : 32
 ) (
   input  logic                         clk_i,
   input  logic                         rst_ni,
@@ -46,16 +53,16 @@ module ibex_if_stage import ibex_pkg::*; #(
   output logic                        instr_intg_err_o,
 
   // ICache RAM IO
-  output logic [IC_NUM_WAYS-1:0]      ic_tag_req_o,
+  output logic [ICacheNumWays-1:0]    ic_tag_req_o,
   output logic                        ic_tag_write_o,
-  output logic [IC_INDEX_W-1:0]       ic_tag_addr_o,
+  output logic [ICacheIndexW-1:0]     ic_tag_addr_o,
   output logic [TagSizeECC-1:0]       ic_tag_wdata_o,
-  input  logic [TagSizeECC-1:0]       ic_tag_rdata_i [IC_NUM_WAYS],
-  output logic [IC_NUM_WAYS-1:0]      ic_data_req_o,
+  input  logic [TagSizeECC-1:0]       ic_tag_rdata_i [ICacheNumWays],
+  output logic [ICacheNumWays-1:0]    ic_data_req_o,
   output logic                        ic_data_write_o,
-  output logic [IC_INDEX_W-1:0]       ic_data_addr_o,
+  output logic [ICacheIndexW-1:0]     ic_data_addr_o,
   output logic [LineSizeECC-1:0]      ic_data_wdata_o,
-  input  logic [LineSizeECC-1:0]      ic_data_rdata_i [IC_NUM_WAYS],
+  input  logic [LineSizeECC-1:0]      ic_data_rdata_i [ICacheNumWays],
   input  logic                        ic_scr_key_valid_i,
   output logic                        ic_scr_key_req_o,
 
@@ -77,10 +84,15 @@ module ibex_if_stage import ibex_pkg::*; #(
   output logic                        illegal_c_insn_id_o,      // compressed decoder thinks this
                                                                 // is an invalid instr
   output logic                        dummy_instr_id_o,         // Instruction is a dummy
+  output logic                        instr_fused_id_o,         // instr is the first of a fused
+                                                                // pair
+  output logic [31:0]                 instr_rdata_fused_id_o,   // second instr of a fused pair
   output logic [31:0]                 pc_if_o,
   output logic [31:0]                 pc_id_o,
   input  logic                        pmp_err_if_i,
-  input  logic                        pmp_err_if_plus2_i,
+  input  logic                        pmp_err_if_plus2_i,       // with MacroOpFusion an error
+                                                                // on the next word for aligned
+                                                                // instrs
 
   // control signals
   input  logic                        instr_valid_clear_i,      // clear instr valid bit in IF-ID
@@ -89,9 +101,20 @@ module ibex_if_stage import ibex_pkg::*; #(
   input  logic                        nt_branch_mispredict_i,   // Not-taken branch in ID/EX was
                                                                 // mispredicted (predicted taken)
   input  logic [31:0]                 nt_branch_addr_i,         // Not-taken branch address in ID/EX
+  output logic                        bp_target_mismatch_o,     // Jump in ID/EX was predicted
+                                                                // with a different target
+  input  logic                        bp_branch_resolve_i,      // Branch in ID/EX resolved, trains
+  input  logic                        bp_branch_taken_i,        // the dynamic branch predictor
+  input  logic                        bp_jump_resolve_i,        // Indirect jump in ID/EX resolved
+                                                                // to branch_target_ex_i
+  input  logic                        bp_ras_push_i,            // Call in ID/EX resolved
+  input  logic                        bp_ras_pop_i,             // Return in ID/EX resolved
+  output logic                        perf_ras_hit_o,           // Return correctly predicted by
+                                                                // the return address stack
   input  exc_pc_sel_e                 exc_pc_mux_i,             // selects ISR address
   input  exc_cause_t                  exc_cause,                // selects ISR address for
                                                                 // vectorized interrupt lines
+  input  logic                        fusion_en_i,              // instrs may be fused
   input  logic                        dummy_instr_en_i,
   input  logic [2:0]                  dummy_instr_mask_i,
   input  logic                        dummy_instr_seed_en_i,
@@ -99,6 +122,9 @@ module ibex_if_stage import ibex_pkg::*; #(
   input  logic                        icache_enable_i,
   input  logic                        icache_inval_i,
   output logic                        icache_ecc_error_o,
+  output logic                        perf_icache_hit_o,        // ICache lookup hit
+  output logic                        perf_icache_miss_o,       // ICache lookup missed
+  output logic                        perf_icache_prefetch_o,   // Prefetched line was used
 
   // jump and branch target
   input  logic [31:0]                 branch_target_ex_i,       // branch/jump target address
@@ -140,6 +166,9 @@ module ibex_if_stage import ibex_pkg::*; #(
   logic       [31:0] fetch_addr;
   logic              fetch_err;
   logic              fetch_err_plus2;
+  logic              fetch_next_valid;
+  logic              fetch_next_ready;
+  logic       [31:0] fetch_next_rdata;
 
   logic [31:0]       instr_decompressed;
   logic              illegal_c_insn;
@@ -152,6 +181,7 @@ module ibex_if_stage import ibex_pkg::*; #(
   logic              if_instr_pmp_err;
   logic              if_instr_err;
   logic              if_instr_err_plus2;
+  logic              if_instr_from_skid;
 
   logic       [31:0] exc_pc;
 
@@ -266,9 +296,13 @@ module ibex_if_stage import ibex_pkg::*; #(
     ibex_icache #(
       .ICacheECC       (ICacheECC),
       .ResetAll        (ResetAll),
+      .ICacheNumWays   (ICacheNumWays),
+      .ICacheIndexW    (ICacheIndexW),
+      .ICacheLineSize  (ICacheLineSize),
       .BusSizeECC      (BusSizeECC),
       .TagSizeECC      (TagSizeECC),
-      .LineSizeECC     (LineSizeECC)
+      .LineSizeECC     (LineSizeECC),
+      .ICachePrefetch  (ICachePrefetch)
     ) icache_i (
         .clk_i               ( clk_i                      ),
         .rst_ni              ( rst_ni                     ),
@@ -308,8 +342,18 @@ module ibex_if_stage import ibex_pkg::*; #(
         .icache_enable_i     ( icache_enable_i            ),
         .icache_inval_i      ( icache_inval_i             ),
         .busy_o              ( prefetch_busy              ),
-        .ecc_error_o         ( icache_ecc_error_o         )
+        .ecc_error_o         ( icache_ecc_error_o         ),
+
+        .perf_hit_o          ( perf_icache_hit_o          ),
+        .perf_miss_o         ( perf_icache_miss_o         ),
+        .perf_prefetch_o     ( perf_icache_prefetch_o     )
     );
+
+    // The ICache only provides one instruction at a time, so nothing can be fused
+    logic unused_fetch_next_ready;
+    assign unused_fetch_next_ready = fetch_next_ready;
+    assign fetch_next_valid        = 1'b0;
+    assign fetch_next_rdata        = '0;
   end else begin : gen_prefetch_buffer
     // prefetch buffer, caches a fixed number of instructions
     ibex_prefetch_buffer #(
@@ -330,6 +374,10 @@ module ibex_if_stage import ibex_pkg::*; #(
         .err_o               ( fetch_err                  ),
         .err_plus2_o         ( fetch_err_plus2            ),
 
+        .next_valid_o        ( fetch_next_valid           ),
+        .next_ready_i        ( fetch_next_ready           ),
+        .next_rdata_o        ( fetch_next_rdata           ),
+
         .instr_req_o         ( instr_req_o                ),
         .instr_addr_o        ( instr_addr_o               ),
         .instr_gnt_i         ( instr_gnt_i                ),
@@ -341,8 +389,8 @@ module ibex_if_stage import ibex_pkg::*; #(
     );
     // ICache tieoffs
     logic                   unused_icen, unused_icinv, unused_scr_key_valid;
-    logic [TagSizeECC-1:0]  unused_tag_ram_input [IC_NUM_WAYS];
-    logic [LineSizeECC-1:0] unused_data_ram_input [IC_NUM_WAYS];
+    logic [TagSizeECC-1:0]  unused_tag_ram_input [ICacheNumWays];
+    logic [LineSizeECC-1:0] unused_data_ram_input [ICacheNumWays];
     assign unused_icen           = icache_enable_i;
     assign unused_icinv          = icache_inval_i;
     assign unused_tag_ram_input  = ic_tag_rdata_i;
@@ -358,6 +406,9 @@ module ibex_if_stage import ibex_pkg::*; #(
     assign ic_data_wdata_o       = 'b0;
     assign ic_scr_key_req_o      = 'b0;
     assign icache_ecc_error_o    = 'b0;
+    assign perf_icache_hit_o      = 1'b0;
+    assign perf_icache_miss_o     = 1'b0;
+    assign perf_icache_prefetch_o = 1'b0;
 
 `ifndef SYNTHESIS
     // If we don't instantiate an icache and this is a simulation then we have a problem because the
@@ -471,6 +522,80 @@ module ibex_if_stage import ibex_pkg::*; #(
     assign dummy_instr_id_o        = 1'b0;
   end
 
+  // Macro-op fusion
+  if (MacroOpFusion) begin : g_macro_op_fusion
+    logic       instr_fused;
+    logic       fuse_first_u, fuse_first_slli, fuse_next_addi, fuse_next_srli;
+    logic [4:0] fuse_rd;
+
+    // Pairs of uncompressed instructions where the second only reads and writes the destination of
+    // the first are fused into one operation in ID/EX:
+    // - lui rd, imm   or auipc rd, imm  followed by  addi rd, rd, imm
+    // - slli rd, rs1, shamt             followed by  srli rd, rd, shamt
+    assign fuse_rd         = if_instr_rdata[11:7];
+    assign fuse_first_u    = (if_instr_rdata[6:0] == OPCODE_LUI) |
+                             (if_instr_rdata[6:0] == OPCODE_AUIPC);
+    assign fuse_first_slli = (if_instr_rdata[6:0] == OPCODE_OP_IMM) &
+                             (if_instr_rdata[14:12] == 3'b001) & (if_instr_rdata[31:25] == 7'h00);
+    assign fuse_next_addi  = (fetch_next_rdata[6:0] == OPCODE_OP_IMM) &
+                             (fetch_next_rdata[14:12] == 3'b000);
+    assign fuse_next_srli  = (fetch_next_rdata[6:0] == OPCODE_OP_IMM) &
+                             (fetch_next_rdata[14:12] == 3'b101) &
+                             (fetch_next_rdata[31:25] == 7'h00);
+
+    // The prefetch buffer only offers the next instruction when the current one is aligned,
+    // uncompressed and has no fetch error. A PMP error on either instruction or a dummy instruction
+    // going in first stops the pair being fused, both instructions then go through ID/EX alone.
+    assign instr_fused = fusion_en_i & fetch_valid & fetch_next_valid & ~if_instr_from_skid &
+                         ~if_instr_pmp_err & ~pmp_err_if_plus2_i & ~stall_dummy_instr &
+                         (fuse_rd != 5'd0) & (fetch_next_rdata[11:7] == fuse_rd) &
+                         (fetch_next_rdata[19:15] == fuse_rd) &
+                         ((fuse_first_u & fuse_next_addi) | (fuse_first_slli & fuse_next_srli));
+
+    // Both instructions leave the prefetch buffer together
+    assign fetch_next_ready = instr_fused;
+
+    if (ResetAll) begin : g_instr_fused_ra
+      always_ff @(posedge clk_i or negedge rst_ni) begin
+        if (!rst_ni) begin
+          instr_fused_id_o       <= 1'b0;
+          instr_rdata_fused_id_o <= '0;
+        end else if (if_id_pipe_reg_we) begin
+          instr_fused_id_o       <= instr_fused;
+          instr_rdata_fused_id_o <= fetch_next_rdata;
+        end
+      end
+    end else begin : g_instr_fused_nr
+      always_ff @(posedge clk_i or negedge rst_ni) begin
+        if (!rst_ni) begin
+          instr_fused_id_o <= 1'b0;
+        end else if (if_id_pipe_reg_we) begin
+          instr_fused_id_o <= instr_fused;
+        end
+      end
+
+      always_ff @(posedge clk_i) begin
+        if (if_id_pipe_reg_we) begin
+          instr_rdata_fused_id_o <= fetch_next_rdata;
+        end
+      end
+    end
+  end else begin : g_no_macro_op_fusion
+    logic        unused_fusion_en;
+    logic        unused_fetch_next_valid;
+    logic [31:0] unused_fetch_next_rdata;
+    logic        unused_if_instr_from_skid;
+
+    assign unused_fusion_en          = fusion_en_i;
+    assign unused_fetch_next_valid   = fetch_next_valid;
+    assign unused_fetch_next_rdata   = fetch_next_rdata;
+    assign unused_if_instr_from_skid = if_instr_from_skid;
+
+    assign fetch_next_ready       = 1'b0;
+    assign instr_fused_id_o       = 1'b0;
+    assign instr_rdata_fused_id_o = '0;
+  end
+
   // The ID stage becomes valid as soon as any instruction is registered in the ID stage flops.
   // Note that the current instruction is squashed by the incoming pc_set_i signal.
   // Valid is held until it is explicitly cleared (due to an instruction completing or an exception)
@@ -553,7 +678,8 @@ module ibex_if_stage import ibex_pkg::*; #(
       end
     end
 
-    assign prev_instr_addr_incr = pc_id_o + (instr_is_compressed_id_o ? 32'd2 : 32'd4);
+    assign prev_instr_addr_incr = pc_id_o + (instr_fused_id_o         ? 32'd8 :
+                                             instr_is_compressed_id_o ? 32'd2 : 32'd4);
 
     // Buffer anticipated next PC address to ensure optimiser cannot remove the check.
     prim_buf #(.Width(32)) u_prev_instr_addr_incr_buf (
@@ -572,6 +698,7 @@ module ibex_if_stage import ibex_pkg::*; #(
     logic [31:0] instr_skid_data_q;
     logic [31:0] instr_skid_addr_q;
     logic        instr_skid_bp_taken_q;
+    logic [31:0] instr_skid_bp_target_q;
     logic        instr_skid_valid_q, instr_skid_valid_d;
     logic        instr_skid_en;
     logic        instr_bp_taken_q, instr_bp_taken_d;
@@ -619,31 +746,55 @@ module ibex_if_stage import ibex_pkg::*; #(
     if (ResetAll) begin : g_instr_skid_ra
       always_ff @(posedge clk_i or negedge rst_ni) begin
         if (!rst_ni) begin
-          instr_skid_bp_taken_q <= '0;
-          instr_skid_data_q     <= '0;
-          instr_skid_addr_q     <= '0;
+          instr_skid_bp_taken_q  <= '0;
+          instr_skid_bp_target_q <= '0;
+          instr_skid_data_q      <= '0;
+          instr_skid_addr_q      <= '0;
         end else if (instr_skid_en) begin
-          instr_skid_bp_taken_q <= predict_branch_taken;
-          instr_skid_data_q     <= fetch_rdata;
-          instr_skid_addr_q     <= fetch_addr;
+          instr_skid_bp_taken_q  <= predict_branch_taken;
+          instr_skid_bp_target_q <= predict_branch_pc;
+          instr_skid_data_q      <= fetch_rdata;
+          instr_skid_addr_q      <= fetch_addr;
         end
       end
     end else begin : g_instr_skid_nr
       always_ff @(posedge clk_i) begin
         if (instr_skid_en) begin
-          instr_skid_bp_taken_q <= predict_branch_taken;
-          instr_skid_data_q     <= fetch_rdata;
-          instr_skid_addr_q     <= fetch_addr;
+          instr_skid_bp_taken_q  <= predict_branch_taken;
+          instr_skid_bp_target_q <= predict_branch_pc;
+          instr_skid_data_q      <= fetch_rdata;
+          instr_skid_addr_q      <= fetch_addr;
         end
       end
     end
 
-    ibex_branch_predict branch_predict_i (
-      .clk_i        (clk_i),
-      .rst_ni       (rst_ni),
-      .fetch_rdata_i(fetch_rdata),
-      .fetch_pc_i   (fetch_addr),
-      .fetch_valid_i(fetch_valid),
+    logic        fetch_accept;
+    logic [31:0] ras_push_addr;
+
+    // An instruction leaves fetch when it moves to ID/EX or into the skid buffer
+    assign fetch_accept  = (fetch_valid & fetch_ready & ~fetch_err) | instr_skid_en;
+    assign ras_push_addr = pc_id_o + (instr_is_compressed_id_o ? 32'd2 : 32'd4);
+
+    ibex_branch_predict #(
+      .DynamicPredictor(BranchPredictorDynamic),
+      .ReturnAddrStack (ReturnAddrStack)
+    ) branch_predict_i (
+      .clk_i         (clk_i),
+      .rst_ni        (rst_ni),
+      .fetch_rdata_i (fetch_rdata),
+      .fetch_pc_i    (fetch_addr),
+      .fetch_valid_i (fetch_valid),
+      .fetch_accept_i(fetch_accept),
+
+      .update_pc_i      (pc_id_o),
+      .update_branch_i  (bp_branch_resolve_i),
+      .update_taken_i   (bp_branch_taken_i),
+      .update_jump_i    (bp_jump_resolve_i),
+      .update_target_i  (branch_target_ex_i),
+      .update_ras_push_i(bp_ras_push_i),
+      .update_ras_addr_i(ras_push_addr),
+      .update_ras_pop_i (bp_ras_pop_i),
+      .flush_i          (pc_set_i | nt_branch_mispredict_i),
 
       .predict_branch_taken_o(predict_branch_taken_raw),
       .predict_branch_pc_o   (predict_branch_pc)
@@ -658,6 +809,7 @@ module ibex_if_stage import ibex_pkg::*; #(
     assign if_instr_valid   = fetch_valid | (instr_skid_valid_q & ~nt_branch_mispredict_i);
     assign if_instr_rdata   = instr_skid_valid_q ? instr_skid_data_q : fetch_rdata;
     assign if_instr_addr    = instr_skid_valid_q ? instr_skid_addr_q : fetch_addr;
+    assign if_instr_from_skid = instr_skid_valid_q;
 
     // Don't branch predict on instruction error so only instructions without errors end up in the
     // skid buffer.
@@ -668,10 +820,47 @@ module ibex_if_stage import ibex_pkg::*; #(
 
     assign instr_bp_taken_o = instr_bp_taken_q;
 
+    if (BranchPredictorDynamic || ReturnAddrStack) begin : g_bp_target
+      logic [31:0] instr_bp_target_q, instr_bp_target_d;
+
+      // The dynamic predictor and RAS can predict indirect jumps, ID/EX must check the jump goes to
+      // the predicted target. Other predictions take their target from the instruction itself.
+      assign instr_bp_target_d = instr_skid_valid_q ? instr_skid_bp_target_q : predict_branch_pc;
+
+      always_ff @(posedge clk_i) begin
+        if (if_id_pipe_reg_we) begin
+          instr_bp_target_q <= instr_bp_target_d;
+        end
+      end
+
+      assign bp_target_mismatch_o = instr_bp_taken_q &
+                                    (branch_target_ex_i[31:1] != instr_bp_target_q[31:1]);
+    end else begin : g_no_bp_target
+      logic [31:0] unused_instr_skid_bp_target;
+
+      assign unused_instr_skid_bp_target = instr_skid_bp_target_q;
+      assign bp_target_mismatch_o        = 1'b0;
+    end
+
+    // Only the RAS predicts returns when it is present
+    assign perf_ras_hit_o = ReturnAddrStack & bp_ras_pop_i & instr_bp_taken_q &
+                            ~bp_target_mismatch_o;
+
     `ASSERT(NoPredictSkid, instr_skid_valid_q |-> ~predict_branch_taken)
     `ASSERT(NoPredictIllegal, predict_branch_taken |-> ~illegal_c_insn)
   end else begin : g_no_branch_predictor
+    logic unused_bp_branch_resolve, unused_bp_branch_taken, unused_bp_jump_resolve;
+    logic unused_bp_ras_push, unused_bp_ras_pop;
+
+    assign unused_bp_branch_resolve = bp_branch_resolve_i;
+    assign unused_bp_branch_taken   = bp_branch_taken_i;
+    assign unused_bp_jump_resolve   = bp_jump_resolve_i;
+    assign unused_bp_ras_push       = bp_ras_push_i;
+    assign unused_bp_ras_pop        = bp_ras_pop_i;
+
     assign instr_bp_taken_o     = 1'b0;
+    assign bp_target_mismatch_o = 1'b0;
+    assign perf_ras_hit_o       = 1'b0;
     assign predict_branch_taken = 1'b0;
     assign predict_branch_pc    = 32'b0;
 
@@ -679,6 +868,7 @@ module ibex_if_stage import ibex_pkg::*; #(
     assign if_instr_rdata = fetch_rdata;
     assign if_instr_addr  = fetch_addr;
     assign if_instr_bus_err = fetch_err;
+    assign if_instr_from_skid = 1'b0;
     assign fetch_ready = id_in_ready_i & ~stall_dummy_instr;
   end
 
@@ -9,14 +9,25 @@
  *
  * Load Store Unit, used to eliminate multiple access during processor stalls,
  * and to align bytes and halfwords.
+ *
+ * With LoadPipelining an aligned load may send its request while the load ahead of it in writeback
+ * still awaits its response, so two loads can be outstanding on the bus. The early request is
+ * speculative: it only completes once the load is confirmed by its lsu_req_i and its response is
+ * dropped if the load leaves ID/EX without executing. A killed load may be read again when its
+ * instruction is reissued, so early requests are only made for addresses with
+ * (addr & LoadPipeliningRegionMask) == LoadPipeliningRegionBase, where reads have no side effects.
  */
 
 `include "prim_assert.sv"
 `include "dv_fcov_macros.svh"
 
 module ibex_load_store_unit #(
-  parameter bit          MemECC       = 1'b0,
-  parameter int unsigned MemDataWidth = MemECC ? 32 + 7 : 32
+  parameter bit          MemECC                   = 1'b0,
+  parameter int unsigned MemDataWidth             = MemECC ? 32 + 7 : 32,
+  parameter bit          LoadPipelining           = 1'b0,
+  // Idempotent region speculative loads may be requested in
+  parameter logic [31:0] LoadPipeliningRegionBase = ibex_pkg::LP_REGION_BASE,
+  parameter logic [31:0] LoadPipeliningRegionMask = ibex_pkg::LP_REGION_MASK
 ) (
   input  logic         clk_i,
   input  logic         rst_ni,
@@ -43,6 +54,8 @@ module ibex_load_store_unit #(
   output logic [31:0]  lsu_rdata_o,          // requested data                   -> to ID/EX
   output logic         lsu_rdata_valid_o,
   input  logic         lsu_req_i,            // data request                     -> from ID/EX
+  input  logic         lsu_spec_req_i,       // speculative load request         -> from ID/EX
+  input  logic         lsu_spec_kill_i,      // load left ID/EX without executing -> from ID/EX
 
   input  logic [31:0]  adder_result_ex_i,    // address computed in ALU          -> from ID/EX
 
@@ -101,9 +114,32 @@ module ibex_load_store_unit #(
   logic         lsu_err_q, lsu_err_d;
   logic         data_intg_err, data_or_pmp_err;
 
+  // Speculative load (LoadPipelining)
+  logic         spec_req_ok;     // a speculative load request can be made
+  logic         spec_addr_ok;    // load address is in the idempotent region
+  logic         spec_issue;      // speculative load request made from IDLE
+  logic         spec_gnt;        // speculative load request granted
+  logic         spec_abandon;    // speculative load request withdrawn after a PMP error
+  logic         spec_behind;     // granted speculative load is behind the current response
+  logic         spec_promote;    // speculative load becomes the current response
+  logic         spec_kill;       // speculative load will not execute
+  logic         spec_in_resp;    // unconfirmed speculative load is the current response
+  logic         spec_unconf_q, spec_unconf_d; // speculative load not yet confirmed by lsu_req_i
+  logic         spec_pend_q, spec_pend_d;     // granted, waiting behind the current response
+  logic         spec_drop_q, spec_drop_d;     // killed before becoming the current response
+  logic         resp_prev_q, resp_prev_d;     // current response due while awaiting the grant
+  logic         resp_drop_q, resp_drop_d;     // current response is for a killed load
+  logic [31:0]  spec_addr_q;
+  logic [1:0]   spec_type_q;
+  logic         spec_sign_ext_q;
+  logic [3:0]   spec_be_q;
+  logic         resp_current;    // response to the current access
+  logic         resp_dropped;    // response dropped as its load will not execute
+  logic         req_blocked;     // new requests wait for a dropped response
+
   typedef enum logic [2:0]  {
     IDLE, WAIT_GNT_MIS, WAIT_RVALID_MIS, WAIT_GNT,
-    WAIT_RVALID_MIS_GNTS_DONE
+    WAIT_RVALID_MIS_GNTS_DONE, WAIT_GNT_SPEC
   } ls_fsm_e;
 
   ls_fsm_e ls_fsm_cs, ls_fsm_ns;
@@ -207,13 +243,20 @@ module ibex_load_store_unit #(
       data_type_q     <= lsu_type_i;
       data_sign_ext_q <= lsu_sign_ext_i;
       data_we_q       <= lsu_we_i;
+    end else if (spec_promote) begin
+      rdata_offset_q  <= spec_addr_q[1:0];
+      data_type_q     <= spec_type_q;
+      data_sign_ext_q <= spec_sign_ext_q;
+      data_we_q       <= 1'b0;
     end
   end
 
   // Store last address for mtval + AGU for misaligned transactions.  Do not update in case of
   // errors, mtval needs the (first) failing address.  Where an aligned access or the first half of
   // a misaligned access sees an error provide the calculated access address. For the second half of
-  // a misaligned access provide the word aligned address of the second half.
+  // a misaligned access provide the word aligned address of the second half. A speculative load
+  // only provides its address once it becomes the current access and won't be dropped, so an error
+  // on the load ahead of it keeps its address.
   assign addr_last_d = addr_incr_req_o ? data_addr_w_aligned : data_addr;
 
   always_ff @(posedge clk_i or negedge rst_ni) begin
@@ -221,6 +264,8 @@ module ibex_load_store_unit #(
       addr_last_q <= '0;
     end else if (addr_update) begin
       addr_last_q <= addr_last_d;
+    end else if (spec_promote && !(spec_drop_q || spec_kill)) begin
+      addr_last_q <= spec_addr_q;
     end
   end
 
@@ -380,11 +425,16 @@ module ibex_load_store_unit #(
     perf_load_o         = 1'b0;
     perf_store_o        = 1'b0;
 
+    spec_issue          = 1'b0;
+
     unique case (ls_fsm_cs)
 
       IDLE: begin
         pmp_err_d = 1'b0;
-        if (lsu_req_i) begin
+        if (lsu_req_i && spec_unconf_q) begin
+          // The load was already requested speculatively, confirming it is all that's left to do
+          perf_load_o = 1'b1;
+        end else if (lsu_req_i && !req_blocked) begin
           data_req_o   = 1'b1;
           pmp_err_d    = data_pmp_err_i;
           lsu_err_d    = 1'b0;
@@ -399,6 +449,12 @@ module ibex_load_store_unit #(
           end else begin
             ls_fsm_ns           = split_misaligned_access ? WAIT_GNT_MIS    : WAIT_GNT;
           end
+        end else if (spec_req_ok) begin
+          // Speculative load, the transaction control is held in the spec_* registers until it
+          // becomes the current access
+          data_req_o = 1'b1;
+          spec_issue = 1'b1;
+          ls_fsm_ns  = data_gnt_i ? IDLE : WAIT_GNT_SPEC;
         end
       end
 
@@ -478,13 +534,127 @@ module ibex_load_store_unit #(
         end
       end
 
+      WAIT_GNT_SPEC: begin
+        data_req_o = 1'b1;
+        // The PMP check passed when the request was made. It can only fail now if the privilege
+        // level changed, which means the load was killed, so the request is withdrawn.
+        if (data_gnt_i || data_pmp_err_i) begin
+          ls_fsm_ns = IDLE;
+        end
+        perf_load_o = lsu_req_i & spec_unconf_q & data_gnt_i;
+      end
+
       default: begin
         ls_fsm_ns = IDLE;
       end
     endcase
   end
 
-  assign lsu_req_done_o = (lsu_req_i | (ls_fsm_cs != IDLE)) & (ls_fsm_ns == IDLE);
+  // A speculative load awaiting its grant is done once it is granted (a load that was withdrawn
+  // makes a new request from IDLE). Any other request waits while a dropped response is due.
+  assign lsu_req_done_o = (ls_fsm_cs == WAIT_GNT_SPEC) ? lsu_req_i & spec_unconf_q & data_gnt_i :
+      ((lsu_req_i & (spec_unconf_q | ~req_blocked)) | (ls_fsm_cs != IDLE)) & (ls_fsm_ns == IDLE);
+
+  //////////////////////
+  // Speculative load //
+  //////////////////////
+
+  // With LoadPipelining ID/EX signals lsu_spec_req_i for an aligned load that is only waiting for
+  // the response to the load in writeback (the current access). Its request is made straight away,
+  // so at most two loads are outstanding: the current access and the speculative one (B). B becomes
+  // the current access once the response ahead of it is seen (or on its grant, where that response
+  // was already seen). B is confirmed when its instruction makes the normal lsu_req_i. It is killed
+  // if the instruction leaves ID/EX without executing, which it always does when the current access
+  // sees an error as that causes a precise exception. The response to a killed or unconfirmed load
+  // is dropped: it is not signalled as a response and cannot cause a load error. Integrity errors
+  // are still reported on load_resp_intg_err_o as they are not precise.
+  //
+  // Only one speculative load is tracked and no speculative request is made until a dropped
+  // response has been seen, so responses are always matched in order.
+  //
+  // A killed load is read again if its instruction is reissued (e.g. after an interrupt), so early
+  // requests are only made inside the LoadPipeliningRegion. Loads outside it (e.g. to MMIO) wait
+  // for the response ahead of them as without LoadPipelining.
+  assign spec_addr_ok =
+      (adder_result_ex_i & LoadPipeliningRegionMask) == LoadPipeliningRegionBase;
+
+  assign spec_req_ok = LoadPipelining & lsu_spec_req_i & ~lsu_req_i & ~lsu_we_i & spec_addr_ok &
+                       ~split_misaligned_access & ~data_pmp_err_i & ~data_we_q &
+                       ~spec_unconf_q & ~spec_pend_q & ~req_blocked;
+
+  assign req_blocked  = resp_drop_q | spec_drop_q;
+
+  assign resp_current = data_rvalid_i & (ls_fsm_cs inside {IDLE, WAIT_GNT_SPEC});
+
+  assign spec_gnt     = data_gnt_i & (spec_issue | (ls_fsm_cs == WAIT_GNT_SPEC));
+  assign spec_abandon = (ls_fsm_cs == WAIT_GNT_SPEC) & data_pmp_err_i & ~data_gnt_i;
+  assign spec_behind  = (spec_issue | resp_prev_q) & ~data_rvalid_i;
+  assign spec_promote = (spec_pend_q & resp_current) | (spec_gnt & ~spec_behind);
+
+  assign spec_in_resp = spec_unconf_q & ~spec_pend_q & (ls_fsm_cs == IDLE);
+  assign spec_kill    = (lsu_spec_kill_i & (spec_unconf_q | spec_issue)) |
+                        (resp_current & data_or_pmp_err & spec_unconf_q & ~spec_in_resp);
+
+  always_comb begin
+    spec_unconf_d = spec_unconf_q;
+    spec_pend_d   = spec_pend_q;
+    spec_drop_d   = spec_drop_q;
+    resp_prev_d   = resp_prev_q;
+    resp_drop_d   = resp_drop_q;
+
+    if (spec_issue) begin
+      spec_unconf_d = 1'b1;
+      spec_drop_d   = 1'b0;
+      resp_prev_d   = 1'b1;
+    end
+
+    if (resp_current) begin
+      resp_prev_d = 1'b0;
+      resp_drop_d = 1'b0;
+      spec_pend_d = 1'b0;
+    end
+
+    if (spec_gnt && spec_behind) begin
+      spec_pend_d = 1'b1;
+    end
+
+    if (spec_kill) begin
+      if (spec_in_resp) begin
+        resp_drop_d = 1'b1;
+      end else begin
+        spec_drop_d = 1'b1;
+      end
+    end
+
+    if (spec_promote) begin
+      resp_drop_d = spec_drop_q | spec_kill;
+      spec_drop_d = 1'b0;
+    end
+
+    if (spec_abandon) begin
+      spec_drop_d = 1'b0;
+    end
+
+    // Confirmed by lsu_req_i, killed, withdrawn or its response was dropped before confirmation
+    if ((lsu_req_i & lsu_req_done_o) || spec_kill || spec_abandon ||
+        (resp_current && spec_in_resp)) begin
+      spec_unconf_d = 1'b0;
+    end
+  end
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      spec_addr_q     <= '0;
+      spec_type_q     <= 2'h0;
+      spec_sign_ext_q <= 1'b0;
+      spec_be_q       <= 4'h0;
+    end else if (spec_issue) begin
+      spec_addr_q     <= data_addr;
+      spec_type_q     <= lsu_type_i;
+      spec_sign_ext_q <= lsu_sign_ext_i;
+      spec_be_q       <= data_be;
+    end
+  end
 
   // registers for FSM
   always_ff @(posedge clk_i or negedge rst_ni) begin
@@ -493,11 +663,21 @@ module ibex_load_store_unit #(
       handle_misaligned_q <= '0;
       pmp_err_q           <= '0;
       lsu_err_q           <= '0;
+      spec_unconf_q       <= 1'b0;
+      spec_pend_q         <= 1'b0;
+      spec_drop_q         <= 1'b0;
+      resp_prev_q         <= 1'b0;
+      resp_drop_q         <= 1'b0;
     end else begin
       ls_fsm_cs           <= ls_fsm_ns;
       handle_misaligned_q <= handle_misaligned_d;
       pmp_err_q           <= pmp_err_d;
-      lsu_err_q           <= lsu_err_d;
+      lsu_err_q           <= spec_promote ? 1'b0 : lsu_err_d;
+      spec_unconf_q       <= spec_unconf_d;
+      spec_pend_q         <= spec_pend_d;
+      spec_drop_q         <= spec_drop_d;
+      resp_prev_q         <= resp_prev_d;
+      resp_drop_q         <= resp_drop_d;
     end
   end
 
@@ -506,9 +686,11 @@ module ibex_load_store_unit #(
   /////////////
 
   assign data_or_pmp_err    = lsu_err_q | data_bus_err_i | pmp_err_q;
-  assign lsu_resp_valid_o   = (data_rvalid_i | pmp_err_q) & (ls_fsm_cs == IDLE);
-  assign lsu_rdata_valid_o  =
-    (ls_fsm_cs == IDLE) & data_rvalid_i & ~data_or_pmp_err & ~data_we_q & ~data_intg_err;
+  assign resp_dropped       = resp_current & (resp_drop_q | spec_in_resp);
+  assign lsu_resp_valid_o   =
+    (data_rvalid_i | pmp_err_q) & (ls_fsm_cs inside {IDLE, WAIT_GNT_SPEC}) & ~resp_dropped;
+  assign lsu_rdata_valid_o  = resp_current & ~resp_dropped & ~data_or_pmp_err & ~data_we_q &
+                              ~data_intg_err;
 
   // output to register file
   assign lsu_rdata_o = data_rdata_ext;
@@ -516,10 +698,11 @@ module ibex_load_store_unit #(
   // output data address must be word aligned
   assign data_addr_w_aligned = {data_addr[31:2], 2'b00};
 
-  // output to data interface
-  assign data_addr_o   = data_addr_w_aligned;
-  assign data_we_o     = lsu_we_i;
-  assign data_be_o     = data_be;
+  // output to data interface, a speculative load awaiting its grant uses the registered request
+  assign data_addr_o   = (ls_fsm_cs == WAIT_GNT_SPEC) ? {spec_addr_q[31:2], 2'b00} :
+                                                        data_addr_w_aligned;
+  assign data_we_o     = (ls_fsm_cs == WAIT_GNT_SPEC) ? 1'b0      : lsu_we_i;
+  assign data_be_o     = (ls_fsm_cs == WAIT_GNT_SPEC) ? spec_be_q : data_be;
 
   /////////////////////////////////////
   // Write data integrity generation //
@@ -549,10 +732,14 @@ module ibex_load_store_unit #(
   // The data_intg_err signal is generated combinatorially from the incoming data_rdata_i. Were it
   // to be factored into load_err_o there would be a feedthrough path from data_rdata_i to
   // data_req_o which is undesirable.
+  //
+  // With LoadPipelining a load may be requested before the response to the load ahead of it is
+  // seen. That request is speculative and is dropped if the earlier load sees an error, so load
+  // errors remain precise. A dropped response still reports an integrity error.
   assign load_resp_intg_err_o  = data_intg_err & data_rvalid_i & ~data_we_q;
   assign store_resp_intg_err_o = data_intg_err & data_rvalid_i & data_we_q;
 
-  assign busy_o = (ls_fsm_cs != IDLE);
+  assign busy_o = (ls_fsm_cs != IDLE) | spec_pend_q | spec_unconf_q | resp_drop_q;
 
   //////////
   // FCOV //
@@ -613,7 +800,15 @@ module ibex_load_store_unit #(
   `ASSERT_KNOWN(IbexDataTypeQKnown, data_type_q)
   `ASSERT(IbexLsuStateValid, ls_fsm_cs inside {
       IDLE, WAIT_GNT_MIS, WAIT_RVALID_MIS, WAIT_GNT,
-      WAIT_RVALID_MIS_GNTS_DONE})
+      WAIT_RVALID_MIS_GNTS_DONE, WAIT_GNT_SPEC})
+
+  // Speculative loads are only made with LoadPipelining and are always aligned loads
+  `ASSERT(IbexSpecLoadOnlyIfPipelining, spec_issue |-> LoadPipelining)
+  `ASSERT(IbexSpecLoadAligned, spec_issue |-> ~split_misaligned_access & ~lsu_we_i)
+  // A response can't be dropped and delivered for the same access
+  `ASSERT(IbexSpecDropNotResp, resp_dropped |-> ~lsu_resp_valid_o)
+  // A confirmed speculative load can't be killed
+  `ASSERT(IbexSpecConfirmNotKill, (lsu_req_i & spec_unconf_q) |-> ~lsu_spec_kill_i)
 
   // Address must not contain X when request is sent.
   `ASSERT(IbexDataAddrUnknown, data_req_o |-> !$isunknown(data_addr_o))
@@ -20,15 +20,33 @@ module ibex_lockstep import ibex_pkg::*; #(
   parameter int unsigned            MHPMCounterWidth  = 40,
   parameter bit                     RV32E             = 1'b0,
   parameter rv32m_e                 RV32M             = RV32MFast,
+  parameter bit                     RV32MFastDiv      = 1'b0,
   parameter rv32b_e                 RV32B             = RV32BNone,
+  parameter rv32f_e                 RV32F             = RV32FNone,
+  parameter bit                     SoftFloatAssist   = 1'b0,
   parameter bit                     BranchTargetALU   = 1'b0,
   parameter bit                     WritebackStage    = 1'b0,
+  parameter bit                     LoadPipelining    = 1'b0,
+  parameter logic [31:0]            LoadPipeliningRegionBase = LP_REGION_BASE,
+  parameter logic [31:0]            LoadPipeliningRegionMask = LP_REGION_MASK,
+  parameter bit                     MacroOpFusion     = 1'b0,
   parameter bit                     ICache            = 1'b0,
   parameter bit                     ICacheECC         = 1'b0,
+  parameter int unsigned            ICacheNumWays     = IC_NUM_WAYS,
+  parameter int unsigned            ICacheIndexW      = IC_INDEX_W,
+  parameter int unsigned            ICacheLineSize    = IC_LINE_SIZE,
+  parameter bit                     ICachePrefetch    = 1'b0,
+  parameter bit                     DCache            = 1'b0,
+  parameter int unsigned            DCacheSizeBytes   = DC_SIZE_BYTES,
+  parameter int unsigned            DCacheNumWays     = DC_NUM_WAYS,
+  parameter logic [31:0]            DCacheRegionBase  = DC_REGION_BASE,
+  parameter logic [31:0]            DCacheRegionMask  = DC_REGION_MASK,
   parameter int unsigned            BusSizeECC        = BUS_SIZE,
   parameter int unsigned            TagSizeECC        = IC_TAG_SIZE,
   parameter int unsigned            LineSizeECC       = IC_LINE_SIZE,
   parameter bit                     BranchPredictor   = 1'b0,
+  parameter bit                     BranchPredictorDynamic = 1'b0,
+  parameter bit                     ReturnAddrStack   = 1'b0,
   parameter bit                     DbgTriggerEn      = 1'b0,
   parameter int unsigned            DbgHwBreakNum     = 1,
   parameter bit                     ResetAll          = 1'b0,
@@ -82,16 +100,16 @@ module ibex_lockstep import ibex_pkg::*; #(
   input  logic [RegFileDataWidth-1:0]  rf_rdata_a_ecc_i,
   input  logic [RegFileDataWidth-1:0]  rf_rdata_b_ecc_i,
 
-  input  logic [IC_NUM_WAYS-1:0]       ic_tag_req_i,
+  input  logic [ICacheNumWays-1:0]     ic_tag_req_i,
   input  logic                         ic_tag_write_i,
-  input  logic [IC_INDEX_W-1:0]        ic_tag_addr_i,
+  input  logic [ICacheIndexW-1:0]      ic_tag_addr_i,
   input  logic [TagSizeECC-1:0]        ic_tag_wdata_i,
-  input  logic [TagSizeECC-1:0]        ic_tag_rdata_i [IC_NUM_WAYS],
-  input  logic [IC_NUM_WAYS-1:0]       ic_data_req_i,
+  input  logic [TagSizeECC-1:0]        ic_tag_rdata_i [ICacheNumWays],
+  input  logic [ICacheNumWays-1:0]     ic_data_req_i,
   input  logic                         ic_data_write_i,
-  input  logic [IC_INDEX_W-1:0]        ic_data_addr_i,
+  input  logic [ICacheIndexW-1:0]      ic_data_addr_i,
   input  logic [LineSizeECC-1:0]       ic_data_wdata_i,
-  input  logic [LineSizeECC-1:0]       ic_data_rdata_i [IC_NUM_WAYS],
+  input  logic [LineSizeECC-1:0]       ic_data_rdata_i [ICacheNumWays],
   input  logic                         ic_scr_key_valid_i,
   input  logic                         ic_scr_key_req_i,
 
@@ -224,8 +242,8 @@ module ibex_lockstep import ibex_pkg::*; #(
   delayed_inputs_t [LockstepOffset-1:0] shadow_inputs_q;
   delayed_inputs_t                      shadow_inputs_in;
   // Packed arrays must be dealt with separately
-  logic [TagSizeECC-1:0]                shadow_tag_rdata_q [IC_NUM_WAYS][LockstepOffset];
-  logic [LineSizeECC-1:0]               shadow_data_rdata_q [IC_NUM_WAYS][LockstepOffset];
+  logic [TagSizeECC-1:0]                shadow_tag_rdata_q [ICacheNumWays][LockstepOffset];
+  logic [LineSizeECC-1:0]               shadow_data_rdata_q [ICacheNumWays][LockstepOffset];
 
   // Assign the inputs to the delay structure
   assign shadow_inputs_in.instr_gnt        = instr_gnt_i;
@@ -286,13 +304,13 @@ module ibex_lockstep import ibex_pkg::*; #(
     logic [4:0]                  rf_waddr_wb;
     logic                        rf_we_wb;
     logic [RegFileDataWidth-1:0] rf_wdata_wb_ecc;
-    logic [IC_NUM_WAYS-1:0]      ic_tag_req;
+    logic [ICacheNumWays-1:0]    ic_tag_req;
     logic                        ic_tag_write;
-    logic [IC_INDEX_W-1:0]       ic_tag_addr;
+    logic [ICacheIndexW-1:0]     ic_tag_addr;
     logic [TagSizeECC-1:0]       ic_tag_wdata;
-    logic [IC_NUM_WAYS-1:0]      ic_data_req;
+    logic [ICacheNumWays-1:0]    ic_data_req;
     logic                        ic_data_write;
-    logic [IC_INDEX_W-1:0]       ic_data_addr;
+    logic [ICacheIndexW-1:0]     ic_data_addr;
     logic [LineSizeECC-1:0]      ic_data_wdata;
     logic                        ic_scr_key_req;
     logic                        irq_pending;
@@ -359,17 +377,35 @@ module ibex_lockstep import ibex_pkg::*; #(
     .MHPMCounterWidth  ( MHPMCounterWidth  ),
     .RV32E             ( RV32E             ),
     .RV32M             ( RV32M             ),
+    .RV32MFastDiv      ( RV32MFastDiv      ),
     .RV32B             ( RV32B             ),
+    .RV32F             ( RV32F             ),
+    .SoftFloatAssist   ( SoftFloatAssist   ),
     .BranchTargetALU   ( BranchTargetALU   ),
     .ICache            ( ICache            ),
     .ICacheECC         ( ICacheECC         ),
+    .ICacheNumWays     ( ICacheNumWays     ),
+    .ICacheIndexW      ( ICacheIndexW      ),
+    .ICacheLineSize    ( ICacheLineSize    ),
+    .ICachePrefetch    ( ICachePrefetch    ),
+    .DCache            ( DCache            ),
+    .DCacheSizeBytes   ( DCacheSizeBytes   ),
+    .DCacheNumWays     ( DCacheNumWays     ),
+    .DCacheRegionBase  ( DCacheRegionBase  ),
+    .DCacheRegionMask  ( DCacheRegionMask  ),
     .BusSizeECC        ( BusSizeECC        ),
     .TagSizeECC        ( TagSizeECC        ),
     .LineSizeECC       ( LineSizeECC       ),
     .BranchPredictor   ( BranchPredictor   ),
+    .BranchPredictorDynamic ( BranchPredictorDynamic ),
+    .ReturnAddrStack   ( ReturnAddrStack   ),
     .DbgTriggerEn      ( DbgTriggerEn      ),
     .DbgHwBreakNum     ( DbgHwBreakNum     ),
     .WritebackStage    ( WritebackStage    ),
+    .LoadPipelining    ( LoadPipelining    ),
+    .LoadPipeliningRegionBase ( LoadPipeliningRegionBase ),
+    .LoadPipeliningRegionMask ( LoadPipeliningRegionMask ),
+    .MacroOpFusion     ( MacroOpFusion     ),
     .ResetAll          ( ResetAll          ),
     .RndCnstLfsrSeed   ( RndCnstLfsrSeed   ),
     .RndCnstLfsrPerm   ( RndCnstLfsrPerm   ),
@@ -479,6 +515,9 @@ module ibex_lockstep import ibex_pkg::*; #(
     .rvfi_ext_mhpmcountersh    (),
     .rvfi_ext_ic_scr_key_valid (),
     .rvfi_ext_irq_valid        (),
+    .rvfi_ext_fused            (),
+    .rvfi_ext_fused_insn       (),
+    .rvfi_ext_fused_rd_wdata   (),
 `endif
 
     .fetch_enable_i         (shadow_inputs_q[0].fetch_enable),
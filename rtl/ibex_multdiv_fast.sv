@@ -10,12 +10,16 @@
  * Fast Multiplier and Division
  *
  * 16x16 kernel multiplier and Long Division
+ *
+ * With RV32MFastDiv the long division produces two quotient bits per cycle (radix-4) and skips the
+ * quotient bits that are known to be zero from the leading zeros of the operands.
  */
 
 `include "prim_assert.sv"
 
 module ibex_multdiv_fast #(
-  parameter ibex_pkg::rv32m_e RV32M = ibex_pkg::RV32MFast
+  parameter ibex_pkg::rv32m_e RV32M        = ibex_pkg::RV32MFast,
+  parameter bit               RV32MFastDiv = 1'b0
   ) (
   input  logic             clk_i,
   input  logic             rst_ni,
@@ -81,6 +85,14 @@ module ibex_multdiv_fast #(
   logic        div_hold;
   logic        div_by_zero_d, div_by_zero_q;
 
+  // Radix-4 divider signals
+  logic [31:0] div_fast_remainder;
+  logic [31:0] div_fast_quotient;
+  logic        div_fast_skip;
+  logic [31:0] div_fast_rem_init;
+  logic [31:0] div_fast_num_init;
+  logic [ 4:0] div_fast_count_init;
+
   logic        mult_en_internal;
   logic        div_en_internal;
 
@@ -88,7 +100,7 @@ module ibex_multdiv_fast #(
   logic        sva_mul_fsm_idle;
 
   typedef enum logic [2:0] {
-    MD_IDLE, MD_ABS_A, MD_ABS_B, MD_COMP, MD_LAST, MD_CHANGE_SIGN, MD_FINISH
+    MD_IDLE, MD_ABS_A, MD_ABS_B, MD_PREP, MD_COMP, MD_LAST, MD_CHANGE_SIGN, MD_FINISH
   } md_fsm_e;
   md_fsm_e md_state_q, md_state_d;
 
@@ -403,6 +415,88 @@ module ibex_multdiv_fast #(
     end
   end
 
+  if (RV32MFastDiv) begin : gen_div_fast
+    logic [33:0] op_denominator3_q;
+    logic [33:0] rem_shift;
+    logic [34:0] rem_sub1, rem_sub2, rem_sub3;
+    logic [ 1:0] quotient_digit;
+    logic [ 5:0] lzc_numerator, lzc_denominator;
+    logic [ 4:0] first_bit;
+
+    function automatic logic [5:0] leading_zeros(logic [31:0] a);
+      logic [5:0] count;
+      count = 6'd32;
+      for (int unsigned i = 0; i < 32; i++) begin
+        if (a[i]) begin
+          count = 6'(31 - i);
+        end
+      end
+      return count;
+    endfunction
+
+    // Three times the denominator for the quotient digit selection. The denominator is stable from
+    // MD_PREP on, so this is valid from the first MD_COMP cycle.
+    always_ff @(posedge clk_i or negedge rst_ni) begin
+      if (!rst_ni) begin
+        op_denominator3_q <= '0;
+      end else if (div_en_internal) begin
+        op_denominator3_q <= {2'b0, op_denominator_q} + {1'b0, op_denominator_q, 1'b0};
+      end
+    end
+
+    // Each step shifts the next two numerator bits (kept at the top of op_numerator_q) into the
+    // remainder and subtracts the largest multiple of the denominator that fits
+    assign rem_shift = {imd_val_q_i[0][31:0], op_numerator_q[31:30]};
+    assign rem_sub1  = {1'b0, rem_shift} - {3'b0, op_denominator_q};
+    assign rem_sub2  = {1'b0, rem_shift} - {2'b0, op_denominator_q, 1'b0};
+    assign rem_sub3  = {1'b0, rem_shift} - {1'b0, op_denominator3_q};
+
+    always_comb begin
+      if (!rem_sub3[34]) begin
+        quotient_digit     = 2'd3;
+        div_fast_remainder = rem_sub3[31:0];
+      end else if (!rem_sub2[34]) begin
+        quotient_digit     = 2'd2;
+        div_fast_remainder = rem_sub2[31:0];
+      end else if (!rem_sub1[34]) begin
+        quotient_digit     = 2'd1;
+        div_fast_remainder = rem_sub1[31:0];
+      end else begin
+        quotient_digit     = 2'd0;
+        div_fast_remainder = rem_shift[31:0];
+      end
+    end
+
+    assign div_fast_quotient = {op_quotient_q[29:0], quotient_digit};
+
+    // Quotient bits above the difference of the leading zero counts are zero and a numerator with
+    // more leading zeros than the denominator gives a zero quotient. Neither shortcut is taken with
+    // data independent timing, which always processes all 32 bits.
+    assign lzc_numerator   = leading_zeros(op_numerator_q);
+    assign lzc_denominator = leading_zeros(op_denominator_q);
+
+    assign div_fast_skip = ~data_ind_timing_i & (lzc_numerator > lzc_denominator);
+
+    // Index of the first quotient bit to compute, made odd so the bits pair up down to bit 0
+    assign first_bit = data_ind_timing_i ? 5'd31 :
+                                           5'(lzc_denominator - lzc_numerator) | 5'd1;
+
+    // The numerator bits above first_bit form the initial remainder, the rest are aligned to the
+    // top of op_numerator_q
+    assign {div_fast_rem_init, div_fast_num_init} = {32'h0, op_numerator_q} << (5'd31 - first_bit);
+
+    // Remaining MD_COMP cycles, MD_LAST computes the final two bits
+    assign div_fast_count_init = {1'b0, first_bit[4:1]};
+
+  end else begin : gen_no_div_fast
+    assign div_fast_remainder  = '0;
+    assign div_fast_quotient   = '0;
+    assign div_fast_skip       = 1'b0;
+    assign div_fast_rem_init   = '0;
+    assign div_fast_num_init   = '0;
+    assign div_fast_count_init = '0;
+  end
+
   assign div_sign_a      = op_a_i[31] & signed_mode_i[0];
   assign div_sign_b      = op_b_i[31] & signed_mode_i[1];
   assign div_change_sign = (div_sign_a ^ div_sign_b) & ~div_by_zero_q;
@@ -467,16 +561,36 @@ module ibex_multdiv_fast #(
         op_remainder_d   = { 33'h0, op_numerator_q[31]};
         // B abs value
         op_denominator_d = div_sign_b ? alu_adder_i : op_b_i;
-        md_state_d       = MD_COMP;
+        md_state_d       = RV32MFastDiv ? MD_PREP : MD_COMP;
         div_counter_d    = 5'd31;
         // ABS(B) = 0 - B
         alu_operand_a_o  = {32'h0  , 1'b1};
         alu_operand_b_o  = {~op_b_i, 1'b1};
       end
 
+      MD_PREP: begin
+        // Radix-4 only: skip the leading zero bits of the quotient, or the whole division if the
+        // quotient is zero (the remainder is then the numerator)
+        op_remainder_d = {2'b0, div_fast_rem_init};
+        op_numerator_d = div_fast_num_init;
+        div_counter_d  = div_fast_count_init;
+        if (div_fast_skip) begin
+          op_remainder_d = (operator_i == MD_OP_DIV) ? '0 : {2'b0, op_numerator_q};
+          md_state_d     = MD_CHANGE_SIGN;
+        end else begin
+          md_state_d     = (div_fast_count_init == 5'd0) ? MD_LAST : MD_COMP;
+        end
+      end
+
       MD_COMP: begin
-        op_remainder_d  = {1'b0, next_remainder[31:0], op_numerator_q[div_counter_d]};
-        op_quotient_d   = next_quotient[31:0];
+        if (RV32MFastDiv) begin
+          op_remainder_d = {2'b0, div_fast_remainder};
+          op_quotient_d  = div_fast_quotient;
+          op_numerator_d = {op_numerator_q[29:0], 2'b00};
+        end else begin
+          op_remainder_d = {1'b0, next_remainder[31:0], op_numerator_q[div_counter_d]};
+          op_quotient_d  = next_quotient[31:0];
+        end
         md_state_d      = (div_counter_q == 5'd1) ? MD_LAST : MD_COMP;
         // Division
         alu_operand_a_o = {imd_val_q_i[0][31:0], 1'b1}; // it contains the remainder
@@ -487,10 +601,11 @@ module ibex_multdiv_fast #(
         if (operator_i == MD_OP_DIV) begin
           // this time we save the quotient in op_remainder_d (i.e. imd_val_q_i[0]) since
           // we do not need anymore the remainder
-          op_remainder_d = {1'b0, next_quotient};
+          op_remainder_d = RV32MFastDiv ? {2'b0, div_fast_quotient} : {1'b0, next_quotient};
         end else begin
           // this time we do not save the quotient anymore since we need only the remainder
-          op_remainder_d = {2'b0, next_remainder[31:0]};
+          op_remainder_d = RV32MFastDiv ? {2'b0, div_fast_remainder} :
+                                          {2'b0, next_remainder[31:0]};
         end
         // Division
         alu_operand_a_o  = {imd_val_q_i[0][31:0], 1'b1}; // it contains the remainder
@@ -530,7 +645,7 @@ module ibex_multdiv_fast #(
 
   // States must be knwon/valid.
   `ASSERT(IbexMultDivStateValid, md_state_q inside {
-      MD_IDLE, MD_ABS_A, MD_ABS_B, MD_COMP, MD_LAST, MD_CHANGE_SIGN, MD_FINISH})
+      MD_IDLE, MD_ABS_A, MD_ABS_B, MD_PREP, MD_COMP, MD_LAST, MD_CHANGE_SIGN, MD_FINISH})
 
 `ifdef INC_ASSERT
   logic sva_fsm_idle;
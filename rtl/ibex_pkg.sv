@@ -52,6 +52,11 @@ package ibex_pkg;
     RV32BFull       = 3
   } rv32b_e;
 
+  typedef enum integer {
+    RV32FNone  = 0,
+    RV32FZfinx = 1
+  } rv32f_e;
+
   /////////////
   // Opcodes //
   /////////////
@@ -61,9 +66,15 @@ package ibex_pkg;
     OPCODE_MISC_MEM = 7'h0f,
     OPCODE_OP_IMM   = 7'h13,
     OPCODE_AUIPC    = 7'h17,
+    OPCODE_CUSTOM_0 = 7'h0b,
     OPCODE_STORE    = 7'h23,
     OPCODE_OP       = 7'h33,
     OPCODE_LUI      = 7'h37,
+    OPCODE_MADD     = 7'h43,
+    OPCODE_MSUB     = 7'h47,
+    OPCODE_NMSUB    = 7'h4b,
+    OPCODE_NMADD    = 7'h4f,
+    OPCODE_OP_FP    = 7'h53,
     OPCODE_BRANCH   = 7'h63,
     OPCODE_JALR     = 7'h67,
     OPCODE_JAL      = 7'h6f,
@@ -181,7 +192,16 @@ package ibex_pkg;
     ALU_CRC32_H,
     ALU_CRC32C_H,
     ALU_CRC32_W,
-    ALU_CRC32C_W
+    ALU_CRC32C_W,
+
+    // Soft-Float Assist
+    ALU_SFP_SRS,
+    ALU_SFP_NORM,
+    ALU_SFP_NEXP,
+    ALU_SFP_RPACK,
+    ALU_SFP_RPFLAGS,
+    ALU_SFP_UMANT,
+    ALU_SFP_UEXP
   } alu_op_e;
 
   typedef enum logic [1:0] {
@@ -192,6 +212,42 @@ package ibex_pkg;
     MD_OP_REM
   } md_op_e;
 
+  typedef enum logic [4:0] {
+    // Floating point unit, single precision on the integer register file (Zfinx)
+    FP_OP_ADD,
+    FP_OP_SUB,
+    FP_OP_MUL,
+    FP_OP_DIV,
+    FP_OP_SQRT,
+    FP_OP_MADD,
+    FP_OP_MSUB,
+    FP_OP_NMSUB,
+    FP_OP_NMADD,
+    FP_OP_SGNJ,
+    FP_OP_SGNJN,
+    FP_OP_SGNJX,
+    FP_OP_MIN,
+    FP_OP_MAX,
+    FP_OP_EQ,
+    FP_OP_LT,
+    FP_OP_LE,
+    FP_OP_CLASS,
+    FP_OP_CVT_W_S,
+    FP_OP_CVT_WU_S,
+    FP_OP_CVT_S_W,
+    FP_OP_CVT_S_WU
+  } fp_op_e;
+
+  // Floating point rounding modes
+  typedef enum logic [2:0] {
+    FP_RM_RNE = 3'b000, // Round to nearest, ties to even
+    FP_RM_RTZ = 3'b001, // Round towards zero
+    FP_RM_RDN = 3'b010, // Round down
+    FP_RM_RUP = 3'b011, // Round up
+    FP_RM_RMM = 3'b100, // Round to nearest, ties to max magnitude
+    FP_RM_DYN = 3'b111  // Use the rounding mode in frm
+  } fp_rm_e;
+
 
   //////////////////////////////////
   // Control and status registers //
@@ -351,7 +407,8 @@ package ibex_pkg;
 
   // Internal NMI cause
   typedef enum logic [4:0] {
-    NMI_INT_CAUSE_ECC = 5'b0
+    NMI_INT_CAUSE_ECC       = 5'b0,
+    NMI_INT_CAUSE_DCACHE_WB = 5'b1
   } nmi_int_cause_e;
 
   // Debug cause
@@ -380,6 +437,19 @@ package ibex_pkg;
   parameter int unsigned IC_INDEX_HI      = IC_INDEX_W + IC_LINE_W - 1;
   parameter int unsigned IC_TAG_SIZE      = ADDR_W - IC_INDEX_W - IC_LINE_W + 1; // 1 valid bit
   parameter int unsigned IC_OUTPUT_BEATS  = (BUS_BYTES / 2); // number of halfwords
+  // DCache constants
+  parameter int unsigned DC_SIZE_BYTES    = 1024;
+  parameter int unsigned DC_NUM_WAYS      = 2;
+  parameter int unsigned DC_LINE_SIZE     = 128;
+  // Cached region, (addr & DC_REGION_MASK) == DC_REGION_BASE. The default is the 1MB RAM of the
+  // simple system, peripherals must never be cached.
+  parameter logic [31:0] DC_REGION_BASE   = 32'h0010_0000;
+  parameter logic [31:0] DC_REGION_MASK   = 32'hFFF0_0000;
+  // LoadPipelining constants
+  // Region loads may be requested early in, (addr & LP_REGION_MASK) == LP_REGION_BASE. Reads in it
+  // must have no side effects. The default is the 1MB RAM of the simple system.
+  parameter logic [31:0] LP_REGION_BASE   = 32'h0010_0000;
+  parameter logic [31:0] LP_REGION_MASK   = 32'hFFF0_0000;
   // ICache Scrambling Parameters
   parameter int unsigned SCRAMBLE_KEY_W   = 128;
   parameter int unsigned SCRAMBLE_NONCE_W = 64;
@@ -424,6 +494,11 @@ package ibex_pkg;
 
   // CSRs
   typedef enum logic[11:0] {
+    // Floating point
+    CSR_FFLAGS     = 12'h001,
+    CSR_FRM        = 12'h002,
+    CSR_FCSR       = 12'h003,
+
     // Machine information
     CSR_MVENDORID  = 12'hF11,
     CSR_MARCHID    = 12'hF12,
@@ -587,7 +662,8 @@ package ibex_pkg;
     CSR_MHPMCOUNTER30H = 12'hB9E,
     CSR_MHPMCOUNTER31H = 12'hB9F,
     CSR_CPUCTRLSTS     = 12'h7C0,
-    CSR_SECURESEED     = 12'h7C1
+    CSR_SECURESEED     = 12'h7C1,
+    CSR_DCACHEFLUSH    = 12'h7C2
   } csr_num_e;
 
   // CSR pmp-related offsets
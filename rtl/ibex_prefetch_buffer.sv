@@ -27,6 +27,11 @@ module ibex_prefetch_buffer #(
   output logic        err_o,
   output logic        err_plus2_o,
 
+  // instruction following the output one, see ibex_fetch_fifo
+  output logic        next_valid_o,
+  input  logic        next_ready_i,
+  output logic [31:0] next_rdata_o,
+
   // goes to instruction memory / instruction cache
   output logic        instr_req_o,
   input  logic        instr_gnt_i,
@@ -105,7 +110,11 @@ module ibex_prefetch_buffer #(
       .out_rdata_o           ( rdata_o           ),
       .out_addr_o            ( addr_o            ),
       .out_err_o             ( err_o             ),
-      .out_err_plus2_o       ( err_plus2_o       )
+      .out_err_plus2_o       ( err_plus2_o       ),
+
+      .out_next_valid_o      ( next_valid_o      ),
+      .out_next_ready_i      ( next_ready_i      ),
+      .out_next_rdata_o      ( next_rdata_o      )
   );
 
   //////////////
@@ -23,13 +23,31 @@ module ibex_top import ibex_pkg::*; #(
   parameter ibex_pkg::pmp_mseccfg_t PMPRstMsecCfg                = ibex_pkg::PmpMseccfgRst,
   parameter bit                     RV32E                        = 1'b0,
   parameter rv32m_e                 RV32M                        = RV32MFast,
+  parameter bit                     RV32MFastDiv                 = 1'b0,
   parameter rv32b_e                 RV32B                        = RV32BNone,
+  parameter rv32f_e                 RV32F                        = RV32FNone,
+  parameter bit                     SoftFloatAssist              = 1'b0,
   parameter regfile_e               RegFile                      = RegFileFF,
   parameter bit                     BranchTargetALU              = 1'b0,
   parameter bit                     WritebackStage               = 1'b0,
+  parameter bit                     LoadPipelining               = 1'b0,
+  parameter logic [31:0]            LoadPipeliningRegionBase = LP_REGION_BASE,
+  parameter logic [31:0]            LoadPipeliningRegionMask = LP_REGION_MASK,
+  parameter bit                     MacroOpFusion                = 1'b0,
   parameter bit                     ICache                       = 1'b0,
   parameter bit                     ICacheECC                    = 1'b0,
+  parameter int unsigned            ICacheSizeBytes              = IC_SIZE_BYTES,
+  parameter int unsigned            ICacheNumWays                = IC_NUM_WAYS,
+  parameter int unsigned            ICacheLineSize               = IC_LINE_SIZE,
+  parameter bit                     ICachePrefetch               = 1'b0,
+  parameter bit                     DCache                       = 1'b0,
+  parameter int unsigned            DCacheSizeBytes              = DC_SIZE_BYTES,
+  parameter int unsigned            DCacheNumWays                = DC_NUM_WAYS,
+  parameter logic [31:0]            DCacheRegionBase             = DC_REGION_BASE,
+  parameter logic [31:0]            DCacheRegionMask             = DC_REGION_MASK,
   parameter bit                     BranchPredictor              = 1'b0,
+  parameter bit                     BranchPredictorDynamic       = 1'b0,
+  parameter bit                     ReturnAddrStack              = 1'b0,
   parameter bit                     DbgTriggerEn                 = 1'b0,
   parameter int unsigned            DbgHwBreakNum                = 1,
   parameter bit                     SecureIbex                   = 1'b0,
@@ -139,10 +157,13 @@ module ibex_top import ibex_pkg::*; #(
   output logic                         rvfi_ext_debug_mode,
   output logic                         rvfi_ext_rf_wr_suppress,
   output logic [63:0]                  rvfi_ext_mcycle,
-  output logic [31:0]                  rvfi_ext_mhpmcounters [10],
-  output logic [31:0]                  rvfi_ext_mhpmcountersh [10],
+  output logic [31:0]                  rvfi_ext_mhpmcounters [29],
+  output logic [31:0]                  rvfi_ext_mhpmcountersh [29],
   output logic                         rvfi_ext_ic_scr_key_valid,
   output logic                         rvfi_ext_irq_valid,
+  output logic                         rvfi_ext_fused,
+  output logic [31:0]                  rvfi_ext_fused_insn,
+  output logic [31:0]                  rvfi_ext_fused_rd_wdata,
 `endif
 
   // CPU Control Signals
@@ -166,9 +187,13 @@ module ibex_top import ibex_pkg::*; #(
   localparam bit          MemECC                = SecureIbex;
   localparam int unsigned MemDataWidth          = MemECC ? 32 + 7 : 32;
   // Icache parameters
+  localparam int unsigned ICacheLineBytes   = ICacheLineSize / 8;
+  localparam int unsigned ICacheNumLines    = ICacheSizeBytes / ICacheNumWays / ICacheLineBytes;
+  localparam int unsigned ICacheIndexW      = $clog2(ICacheNumLines);
+  localparam int unsigned ICacheTagSize     = ADDR_W - ICacheIndexW - $clog2(ICacheLineBytes) + 1;
   localparam int unsigned BusSizeECC        = ICacheECC ? (BUS_SIZE + 7) : BUS_SIZE;
-  localparam int unsigned LineSizeECC       = BusSizeECC * IC_LINE_BEATS;
-  localparam int unsigned TagSizeECC        = ICacheECC ? (IC_TAG_SIZE + 6) : IC_TAG_SIZE;
+  localparam int unsigned LineSizeECC       = BusSizeECC * (ICacheLineSize / BUS_SIZE);
+  localparam int unsigned TagSizeECC        = ICacheECC ? (ICacheTagSize + 6) : ICacheTagSize;
   // Scrambling Parameter
   localparam int unsigned NumAddrScrRounds  = ICacheScramble ? 2 : 0;
 
@@ -194,16 +219,16 @@ module ibex_top import ibex_pkg::*; #(
   logic [MemDataWidth-1:0]     instr_rdata_core;
 
   // Core <-> RAMs signals
-  logic [IC_NUM_WAYS-1:0]      ic_tag_req;
+  logic [ICacheNumWays-1:0]    ic_tag_req;
   logic                        ic_tag_write;
-  logic [IC_INDEX_W-1:0]       ic_tag_addr;
+  logic [ICacheIndexW-1:0]     ic_tag_addr;
   logic [TagSizeECC-1:0]       ic_tag_wdata;
-  logic [TagSizeECC-1:0]       ic_tag_rdata [IC_NUM_WAYS];
-  logic [IC_NUM_WAYS-1:0]      ic_data_req;
+  logic [TagSizeECC-1:0]       ic_tag_rdata [ICacheNumWays];
+  logic [ICacheNumWays-1:0]    ic_data_req;
   logic                        ic_data_write;
-  logic [IC_INDEX_W-1:0]       ic_data_addr;
+  logic [ICacheIndexW-1:0]     ic_data_addr;
   logic [LineSizeECC-1:0]      ic_data_wdata;
-  logic [LineSizeECC-1:0]      ic_data_rdata [IC_NUM_WAYS];
+  logic [LineSizeECC-1:0]      ic_data_rdata [ICacheNumWays];
   logic                        ic_scr_key_req;
   // Alert signals
   logic                        core_alert_major_internal, core_alert_major_bus, core_alert_minor;
@@ -304,17 +329,35 @@ module ibex_top import ibex_pkg::*; #(
     .MHPMCounterWidth (MHPMCounterWidth),
     .RV32E            (RV32E),
     .RV32M            (RV32M),
+    .RV32MFastDiv     (RV32MFastDiv),
     .RV32B            (RV32B),
+    .RV32F            (RV32F),
+    .SoftFloatAssist  (SoftFloatAssist),
     .BranchTargetALU  (BranchTargetALU),
     .ICache           (ICache),
     .ICacheECC        (ICacheECC),
+    .ICacheNumWays    (ICacheNumWays),
+    .ICacheIndexW     (ICacheIndexW),
+    .ICacheLineSize   (ICacheLineSize),
+    .ICachePrefetch   (ICachePrefetch),
+    .DCache           (DCache),
+    .DCacheSizeBytes  (DCacheSizeBytes),
+    .DCacheNumWays    (DCacheNumWays),
+    .DCacheRegionBase (DCacheRegionBase),
+    .DCacheRegionMask (DCacheRegionMask),
     .BusSizeECC       (BusSizeECC),
     .TagSizeECC       (TagSizeECC),
     .LineSizeECC      (LineSizeECC),
     .BranchPredictor  (BranchPredictor),
+    .BranchPredictorDynamic(BranchPredictorDynamic),
+    .ReturnAddrStack  (ReturnAddrStack),
     .DbgTriggerEn     (DbgTriggerEn),
     .DbgHwBreakNum    (DbgHwBreakNum),
     .WritebackStage   (WritebackStage),
+    .LoadPipelining   (LoadPipelining),
+    .LoadPipeliningRegionBase(LoadPipeliningRegionBase),
+    .LoadPipeliningRegionMask(LoadPipeliningRegionMask),
+    .MacroOpFusion    (MacroOpFusion),
     .ResetAll         (ResetAll),
     .RndCnstLfsrSeed  (RndCnstLfsrSeed),
     .RndCnstLfsrPerm  (RndCnstLfsrPerm),
@@ -424,6 +467,9 @@ module ibex_top import ibex_pkg::*; #(
     .rvfi_ext_mhpmcountersh,
     .rvfi_ext_ic_scr_key_valid,
     .rvfi_ext_irq_valid,
+    .rvfi_ext_fused,
+    .rvfi_ext_fused_insn,
+    .rvfi_ext_fused_rd_wdata,
 `endif
 
     .fetch_enable_i        (fetch_enable_buf),
@@ -575,12 +621,12 @@ module ibex_top import ibex_pkg::*; #(
   // Rams Instantiation //
   ////////////////////////
 
-  logic [IC_NUM_WAYS-1:0] icache_tag_alert;
-  logic [IC_NUM_WAYS-1:0] icache_data_alert;
+  logic [ICacheNumWays-1:0] icache_tag_alert;
+  logic [ICacheNumWays-1:0] icache_data_alert;
 
   if (ICache) begin : gen_rams
 
-    for (genvar way = 0; way < IC_NUM_WAYS; way++) begin : gen_rams_inner
+    for (genvar way = 0; way < ICacheNumWays; way++) begin : gen_rams_inner
 
       if (ICacheScramble) begin : gen_scramble_rams
 
@@ -588,7 +634,7 @@ module ibex_top import ibex_pkg::*; #(
         // Tag RAM instantiation
         prim_ram_1p_scr #(
           .Width              (TagSizeECC),
-          .Depth              (IC_NUM_LINES),
+          .Depth              (ICacheNumLines),
           .DataBitsPerMask    (TagSizeECC),
           .EnableParity       (0),
           .NumPrinceRoundsHalf(ICacheScrNumPrinceRoundsHalf),
@@ -624,7 +670,7 @@ module ibex_top import ibex_pkg::*; #(
         // Data RAM instantiation
         prim_ram_1p_scr #(
           .Width              (LineSizeECC),
-          .Depth              (IC_NUM_LINES),
+          .Depth              (ICacheNumLines),
           .DataBitsPerMask    (LineSizeECC),
           .ReplicateKeyStream (1),
           .EnableParity       (0),
@@ -693,7 +739,7 @@ module ibex_top import ibex_pkg::*; #(
         // Tag RAM instantiation
         prim_ram_1p #(
           .Width            (TagSizeECC),
-          .Depth            (IC_NUM_LINES),
+          .Depth            (ICacheNumLines),
           .DataBitsPerMask  (TagSizeECC)
         ) tag_bank (
           .clk_i,
@@ -712,7 +758,7 @@ module ibex_top import ibex_pkg::*; #(
         // Data RAM instantiation
         prim_ram_1p #(
           .Width              (LineSizeECC),
-          .Depth              (IC_NUM_LINES),
+          .Depth              (ICacheNumLines),
           .DataBitsPerMask    (LineSizeECC)
         ) data_bank (
           .clk_i,
@@ -854,13 +900,13 @@ module ibex_top import ibex_pkg::*; #(
     logic [RegFileDataWidth-1:0]  rf_rdata_a_ecc_local;
     logic [RegFileDataWidth-1:0]  rf_rdata_b_ecc_local;
 
-    logic [IC_NUM_WAYS-1:0]       ic_tag_req_local;
+    logic [ICacheNumWays-1:0]     ic_tag_req_local;
     logic                         ic_tag_write_local;
-    logic [IC_INDEX_W-1:0]        ic_tag_addr_local;
+    logic [ICacheIndexW-1:0]      ic_tag_addr_local;
     logic [TagSizeECC-1:0]        ic_tag_wdata_local;
-    logic [IC_NUM_WAYS-1:0]       ic_data_req_local;
+    logic [ICacheNumWays-1:0]     ic_data_req_local;
     logic                         ic_data_write_local;
-    logic [IC_INDEX_W-1:0]        ic_data_addr_local;
+    logic [ICacheIndexW-1:0]      ic_data_addr_local;
     logic [LineSizeECC-1:0]       ic_data_wdata_local;
     logic                         scramble_key_valid_local;
     logic                         ic_scr_key_req_local;
@@ -985,9 +1031,9 @@ module ibex_top import ibex_pkg::*; #(
       .out_o(buf_out)
     );
 
-    logic [TagSizeECC-1:0]  ic_tag_rdata_local [IC_NUM_WAYS];
-    logic [LineSizeECC-1:0] ic_data_rdata_local [IC_NUM_WAYS];
-    for (genvar k = 0; k < IC_NUM_WAYS; k++) begin : gen_ways
+    logic [TagSizeECC-1:0]  ic_tag_rdata_local [ICacheNumWays];
+    logic [LineSizeECC-1:0] ic_data_rdata_local [ICacheNumWays];
+    for (genvar k = 0; k < ICacheNumWays; k++) begin : gen_ways
       prim_buf #(.Width(TagSizeECC)) u_tag_prim_buf (
         .in_i(ic_tag_rdata[k]),
         .out_o(ic_tag_rdata_local[k])
@@ -1012,17 +1058,35 @@ module ibex_top import ibex_pkg::*; #(
       .MHPMCounterWidth (MHPMCounterWidth),
       .RV32E            (RV32E),
       .RV32M            (RV32M),
+      .RV32MFastDiv     (RV32MFastDiv),
       .RV32B            (RV32B),
+      .RV32F            (RV32F),
+      .SoftFloatAssist  (SoftFloatAssist),
       .BranchTargetALU  (BranchTargetALU),
       .ICache           (ICache),
       .ICacheECC        (ICacheECC),
+      .ICacheNumWays    (ICacheNumWays),
+      .ICacheIndexW     (ICacheIndexW),
+      .ICacheLineSize   (ICacheLineSize),
+      .ICachePrefetch   (ICachePrefetch),
+      .DCache           (DCache),
+      .DCacheSizeBytes  (DCacheSizeBytes),
+      .DCacheNumWays    (DCacheNumWays),
+      .DCacheRegionBase (DCacheRegionBase),
+      .DCacheRegionMask (DCacheRegionMask),
       .BusSizeECC       (BusSizeECC),
       .TagSizeECC       (TagSizeECC),
       .LineSizeECC      (LineSizeECC),
       .BranchPredictor  (BranchPredictor),
+      .BranchPredictorDynamic(BranchPredictorDynamic),
+      .ReturnAddrStack  (ReturnAddrStack),
       .DbgTriggerEn     (DbgTriggerEn),
       .DbgHwBreakNum    (DbgHwBreakNum),
       .WritebackStage   (WritebackStage),
+      .LoadPipelining   (LoadPipelining),
+      .LoadPipeliningRegionBase(LoadPipeliningRegionBase),
+      .LoadPipeliningRegionMask(LoadPipeliningRegionMask),
+      .MacroOpFusion    (MacroOpFusion),
       .ResetAll         (ResetAll),
       .RndCnstLfsrSeed  (RndCnstLfsrSeed),
       .RndCnstLfsrPerm  (RndCnstLfsrPerm),
@@ -1142,6 +1206,9 @@ module ibex_top import ibex_pkg::*; #(
   // Parameter assertions
   `ASSERT_INIT(DmHaltAddrInRange_A, (DmHaltAddr & ~DmAddrMask) == DmBaseAddr)
   `ASSERT_INIT(DmExceptionAddrInRange_A, (DmExceptionAddr & ~DmAddrMask) == DmBaseAddr)
+  // ICache ECC protects at most 22 tag bits (including the valid bit), so each way must hold at
+  // least 2kB
+  `ASSERT_INIT(IllegalParamICacheECCTagSize, !(ICache && ICacheECC && (ICacheTagSize > 22)))
 
   // X checks for top-level outputs
   `ASSERT_KNOWN(IbexInstrReqX, instr_req_o)
@@ -14,13 +14,31 @@ module ibex_top_tracing import ibex_pkg::*; #(
   parameter int unsigned MHPMCounterWidth = 40,
   parameter bit          RV32E            = 1'b0,
   parameter rv32m_e      RV32M            = RV32MFast,
+  parameter bit          RV32MFastDiv     = 1'b0,
   parameter rv32b_e      RV32B            = RV32BNone,
+  parameter rv32f_e      RV32F            = RV32FNone,
+  parameter bit          SoftFloatAssist  = 1'b0,
   parameter regfile_e    RegFile          = RegFileFF,
   parameter bit          BranchTargetALU  = 1'b0,
   parameter bit          WritebackStage   = 1'b0,
+  parameter bit          LoadPipelining   = 1'b0,
+  parameter logic [31:0] LoadPipeliningRegionBase = LP_REGION_BASE,
+  parameter logic [31:0] LoadPipeliningRegionMask = LP_REGION_MASK,
+  parameter bit          MacroOpFusion    = 1'b0,
   parameter bit          ICache           = 1'b0,
   parameter bit          ICacheECC        = 1'b0,
+  parameter int unsigned ICacheSizeBytes  = IC_SIZE_BYTES,
+  parameter int unsigned ICacheNumWays    = IC_NUM_WAYS,
+  parameter int unsigned ICacheLineSize   = IC_LINE_SIZE,
+  parameter bit          ICachePrefetch   = 1'b0,
+  parameter bit          DCache           = 1'b0,
+  parameter int unsigned DCacheSizeBytes  = DC_SIZE_BYTES,
+  parameter int unsigned DCacheNumWays    = DC_NUM_WAYS,
+  parameter logic [31:0] DCacheRegionBase = DC_REGION_BASE,
+  parameter logic [31:0] DCacheRegionMask = DC_REGION_MASK,
   parameter bit          BranchPredictor  = 1'b0,
+  parameter bit          BranchPredictorDynamic = 1'b0,
+  parameter bit          ReturnAddrStack  = 1'b0,
   parameter bit          DbgTriggerEn     = 1'b0,
   parameter int unsigned DbgHwBreakNum    = 1,
   parameter bit          SecureIbex       = 1'b0,
@@ -130,13 +148,16 @@ module ibex_top_tracing import ibex_pkg::*; #(
   logic        rvfi_ext_rf_wr_suppress;
   logic [63:0] rvfi_ext_mcycle;
 
-  logic [31:0] rvfi_ext_mhpmcounters [10];
-  logic [31:0] rvfi_ext_mhpmcountersh [10];
+  logic [31:0] rvfi_ext_mhpmcounters [29];
+  logic [31:0] rvfi_ext_mhpmcountersh [29];
   logic        rvfi_ext_ic_scr_key_valid;
   logic        rvfi_ext_irq_valid;
+  logic        rvfi_ext_fused;
+  logic [31:0] rvfi_ext_fused_insn;
+  logic [31:0] rvfi_ext_fused_rd_wdata;
 
-  logic [31:0] unused_perf_regs [10];
-  logic [31:0] unused_perf_regsh [10];
+  logic [31:0] unused_perf_regs [29];
+  logic [31:0] unused_perf_regsh [29];
 
 
   logic [31:0] unused_rvfi_ext_pre_mip;
@@ -173,15 +194,33 @@ module ibex_top_tracing import ibex_pkg::*; #(
     .MHPMCounterWidth ( MHPMCounterWidth ),
     .RV32E            ( RV32E            ),
     .RV32M            ( RV32M            ),
+    .RV32MFastDiv     ( RV32MFastDiv     ),
     .RV32B            ( RV32B            ),
+    .RV32F            ( RV32F            ),
+    .SoftFloatAssist  ( SoftFloatAssist  ),
     .RegFile          ( RegFile          ),
     .BranchTargetALU  ( BranchTargetALU  ),
     .ICache           ( ICache           ),
     .ICacheECC        ( ICacheECC        ),
+    .ICacheSizeBytes  ( ICacheSizeBytes  ),
+    .ICacheNumWays    ( ICacheNumWays    ),
+    .ICacheLineSize   ( ICacheLineSize   ),
+    .ICachePrefetch   ( ICachePrefetch   ),
+    .DCache           ( DCache           ),
+    .DCacheSizeBytes  ( DCacheSizeBytes  ),
+    .DCacheNumWays    ( DCacheNumWays    ),
+    .DCacheRegionBase ( DCacheRegionBase ),
+    .DCacheRegionMask ( DCacheRegionMask ),
     .BranchPredictor  ( BranchPredictor  ),
+    .BranchPredictorDynamic ( BranchPredictorDynamic ),
+    .ReturnAddrStack  ( ReturnAddrStack  ),
     .DbgTriggerEn     ( DbgTriggerEn     ),
     .DbgHwBreakNum    ( DbgHwBreakNum    ),
     .WritebackStage   ( WritebackStage   ),
+    .LoadPipelining   ( LoadPipelining   ),
+    .LoadPipeliningRegionBase ( LoadPipeliningRegionBase ),
+    .LoadPipeliningRegionMask ( LoadPipeliningRegionMask ),
+    .MacroOpFusion    ( MacroOpFusion    ),
     .SecureIbex       ( SecureIbex       ),
     .ICacheScramble   ( ICacheScramble   ),
     .RndCnstLfsrSeed  ( RndCnstLfsrSeed  ),
@@ -271,6 +310,9 @@ module ibex_top_tracing import ibex_pkg::*; #(
     .rvfi_ext_mhpmcountersh,
     .rvfi_ext_ic_scr_key_valid,
     .rvfi_ext_irq_valid,
+    .rvfi_ext_fused,
+    .rvfi_ext_fused_insn,
+    .rvfi_ext_fused_rd_wdata,
 
     .fetch_enable_i,
     .alert_minor_o,
@@ -308,7 +350,10 @@ module ibex_top_tracing import ibex_pkg::*; #(
     .rvfi_mem_rmask,
     .rvfi_mem_wmask,
     .rvfi_mem_rdata,
-    .rvfi_mem_wdata
+    .rvfi_mem_wdata,
+    .rvfi_ext_fused,
+    .rvfi_ext_fused_insn,
+    .rvfi_ext_fused_rd_wdata
   );
 
 endmodule
@@ -65,7 +65,13 @@ module ibex_tracer (
   input logic [ 3:0] rvfi_mem_rmask,
   input logic [ 3:0] rvfi_mem_wmask,
   input logic [31:0] rvfi_mem_rdata,
-  input logic [31:0] rvfi_mem_wdata
+  input logic [31:0] rvfi_mem_wdata,
+
+  // Ibex extension, with rvfi_ext_fused set rvfi_insn is the first instruction of a fused pair and
+  // rvfi_ext_fused_insn the second. rvfi_ext_fused_rd_wdata is the value the first writes to rd.
+  input logic        rvfi_ext_fused,
+  input logic [31:0] rvfi_ext_fused_insn,
+  input logic [31:0] rvfi_ext_fused_rd_wdata
 );
 
   // These signals are part of RVFI, but not used in this module currently.
@@ -131,7 +137,8 @@ module ibex_tracer (
       $fwrite(fh, " %s:0x%08x", reg_addr_to_str(rvfi_rs3_addr), rvfi_rs3_rdata);
     end
     if ((data_accessed & RD) != 0) begin
-      $fwrite(fh, " %s=0x%08x", reg_addr_to_str(rvfi_rd_addr), rvfi_rd_wdata);
+      $fwrite(fh, " %s=0x%08x", reg_addr_to_str(rvfi_rd_addr),
+              rvfi_ext_fused ? rvfi_ext_fused_rd_wdata : rvfi_rd_wdata);
     end
     if ((data_accessed & MEM) != 0) begin
       $fwrite(fh, " PA:0x%08x", rvfi_mem_addr);
@@ -147,6 +154,25 @@ module ibex_tracer (
     $fwrite(fh, "\n");
   endfunction
 
+  // The second instruction of a fused pair is an addi or srli reading and writing the rd of the
+  // first, write it as if it had retired on its own
+  function automatic void printbuffer_dumpline_fused(int fh);
+    string fused_str;
+
+    if (rvfi_ext_fused_insn[14:12] == 3'b000) begin
+      fused_str = $sformatf("addi\tx%0d,x%0d,%0d", rvfi_rd_addr, rvfi_rd_addr,
+                            $signed(rvfi_ext_fused_insn[31:20]));
+    end else begin
+      fused_str = $sformatf("srli\tx%0d,x%0d,0x%0x", rvfi_rd_addr, rvfi_rd_addr,
+                            rvfi_ext_fused_insn[24:20]);
+    end
+
+    $fwrite(fh, "%15t\t%d\t%h\t%h\t%s\t",
+            $time, cycle, rvfi_pc_rdata + 32'd4, rvfi_ext_fused_insn, fused_str);
+    $fwrite(fh, " %s:0x%08x", reg_addr_to_str(rvfi_rd_addr), rvfi_ext_fused_rd_wdata);
+    $fwrite(fh, " %s=0x%08x\n", reg_addr_to_str(rvfi_rd_addr), rvfi_rd_wdata);
+  endfunction
+
 
   // Format register address with "x" prefix, left-aligned to a fixed width of 3 characters.
   function automatic string reg_addr_to_str(input logic [4:0] addr);
@@ -429,6 +455,12 @@ module ibex_tracer (
         rvfi_rs3_addr, rvfi_rs2_addr);
   endfunction
 
+  function automatic void decode_r4_insn(input string mnemonic);
+    data_accessed = RS1 | RS2 | RS3 | RD;
+    decoded_str = $sformatf("%s\tx%0d,x%0d,x%0d,x%0d", mnemonic, rvfi_rd_addr, rvfi_rs1_addr,
+        rvfi_rs2_addr, rvfi_rs3_addr);
+  endfunction
+
   function automatic void decode_i_insn(input string mnemonic);
     data_accessed = RS1 | RD;
     decoded_str = $sformatf("%s\tx%0d,x%0d,%0d", mnemonic, rvfi_rd_addr, rvfi_rs1_addr,
@@ -762,6 +794,9 @@ module ibex_tracer (
       end
 
       printbuffer_dumpline(fh);
+      if (rvfi_ext_fused) begin
+        printbuffer_dumpline_fused(fh);
+      end
     end
   end
 
@@ -1069,6 +1104,39 @@ module ibex_tracer (
         INSN_CRC32C_H:   decode_r1_insn("crc32c.h");
         INSN_CRC32C_W:   decode_r1_insn("crc32c.w");
 
+        // RV32F - ZFINX
+        INSN_FMADD_S:    decode_r4_insn("fmadd.s");
+        INSN_FMSUB_S:    decode_r4_insn("fmsub.s");
+        INSN_FNMSUB_S:   decode_r4_insn("fnmsub.s");
+        INSN_FNMADD_S:   decode_r4_insn("fnmadd.s");
+        INSN_FADD_S:     decode_r_insn("fadd.s");
+        INSN_FSUB_S:     decode_r_insn("fsub.s");
+        INSN_FMUL_S:     decode_r_insn("fmul.s");
+        INSN_FDIV_S:     decode_r_insn("fdiv.s");
+        INSN_FSQRT_S:    decode_r1_insn("fsqrt.s");
+        INSN_FSGNJ_S:    decode_r_insn("fsgnj.s");
+        INSN_FSGNJN_S:   decode_r_insn("fsgnjn.s");
+        INSN_FSGNJX_S:   decode_r_insn("fsgnjx.s");
+        INSN_FMIN_S:     decode_r_insn("fmin.s");
+        INSN_FMAX_S:     decode_r_insn("fmax.s");
+        INSN_FEQ_S:      decode_r_insn("feq.s");
+        INSN_FLT_S:      decode_r_insn("flt.s");
+        INSN_FLE_S:      decode_r_insn("fle.s");
+        INSN_FCLASS_S:   decode_r1_insn("fclass.s");
+        INSN_FCVT_W_S:   decode_r1_insn("fcvt.w.s");
+        INSN_FCVT_WU_S:  decode_r1_insn("fcvt.wu.s");
+        INSN_FCVT_S_W:   decode_r1_insn("fcvt.s.w");
+        INSN_FCVT_S_WU:  decode_r1_insn("fcvt.s.wu");
+
+        // Soft-float assist
+        INSN_SFP_SRS:     decode_r_insn("sfp.srs");
+        INSN_SFP_NORM:    decode_r1_insn("sfp.norm");
+        INSN_SFP_NEXP:    decode_r_insn("sfp.nexp");
+        INSN_SFP_RPACK:   decode_r_insn("sfp.rpack");
+        INSN_SFP_RPFLAGS: decode_r_insn("sfp.rpflags");
+        INSN_SFP_UMANT:   decode_r1_insn("sfp.umant");
+        INSN_SFP_UEXP:    decode_r1_insn("sfp.uexp");
+
         default:         decode_mnemonic("INVALID");
       endcase
     end
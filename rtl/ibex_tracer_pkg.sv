@@ -292,6 +292,47 @@ package ibex_tracer_pkg;
   parameter logic [31:0] INSN_CRC32C_W =
       {7'b0110000, 5'b11010, 5'h?, 3'b001, 5'h?, {OPCODE_OP_IMM} };
 
+  // ZFINX (rounding mode in instr[14:12] where the instruction rounds)
+  parameter logic [31:0] INSN_FMADD_S  = {5'h?, 2'b00, 10'h?, 3'h?, 5'h?, {OPCODE_MADD } };
+  parameter logic [31:0] INSN_FMSUB_S  = {5'h?, 2'b00, 10'h?, 3'h?, 5'h?, {OPCODE_MSUB } };
+  parameter logic [31:0] INSN_FNMSUB_S = {5'h?, 2'b00, 10'h?, 3'h?, 5'h?, {OPCODE_NMSUB} };
+  parameter logic [31:0] INSN_FNMADD_S = {5'h?, 2'b00, 10'h?, 3'h?, 5'h?, {OPCODE_NMADD} };
+  parameter logic [31:0] INSN_FADD_S   = {7'b0000000, 10'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FSUB_S   = {7'b0000100, 10'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FMUL_S   = {7'b0001000, 10'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FDIV_S   = {7'b0001100, 10'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FSQRT_S  = {7'b0101100, 5'b00000, 5'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FSGNJ_S  = {7'b0010000, 10'h?, 3'b000, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FSGNJN_S = {7'b0010000, 10'h?, 3'b001, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FSGNJX_S = {7'b0010000, 10'h?, 3'b010, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FMIN_S   = {7'b0010100, 10'h?, 3'b000, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FMAX_S   = {7'b0010100, 10'h?, 3'b001, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FEQ_S    = {7'b1010000, 10'h?, 3'b010, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FLT_S    = {7'b1010000, 10'h?, 3'b001, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FLE_S    = {7'b1010000, 10'h?, 3'b000, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FCLASS_S =
+      {7'b1110000, 5'b00000, 5'h?, 3'b001, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FCVT_W_S  =
+      {7'b1100000, 5'b00000, 5'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FCVT_WU_S =
+      {7'b1100000, 5'b00001, 5'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FCVT_S_W  =
+      {7'b1101000, 5'b00000, 5'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+  parameter logic [31:0] INSN_FCVT_S_WU =
+      {7'b1101000, 5'b00001, 5'h?, 3'h?, 5'h?, {OPCODE_OP_FP} };
+
+  // Soft-float assist (custom-0)
+  parameter logic [31:0] INSN_SFP_SRS     = {7'b0000000, 10'h?, 3'b000, 5'h?, {OPCODE_CUSTOM_0} };
+  parameter logic [31:0] INSN_SFP_NORM    =
+      {7'b0000000, 5'b00000, 5'h?, 3'b001, 5'h?, {OPCODE_CUSTOM_0} };
+  parameter logic [31:0] INSN_SFP_NEXP    = {7'b0000000, 10'h?, 3'b010, 5'h?, {OPCODE_CUSTOM_0} };
+  parameter logic [31:0] INSN_SFP_RPACK   = {7'b0000000, 10'h?, 3'b011, 5'h?, {OPCODE_CUSTOM_0} };
+  parameter logic [31:0] INSN_SFP_RPFLAGS = {7'b0000000, 10'h?, 3'b100, 5'h?, {OPCODE_CUSTOM_0} };
+  parameter logic [31:0] INSN_SFP_UMANT   =
+      {7'b0000000, 5'b00000, 5'h?, 3'b101, 5'h?, {OPCODE_CUSTOM_0} };
+  parameter logic [31:0] INSN_SFP_UEXP    =
+      {7'b0000000, 5'b00000, 5'h?, 3'b110, 5'h?, {OPCODE_CUSTOM_0} };
+
   // LOAD & STORE
   parameter logic [31:0] INSN_LOAD    = {25'h?,                            {OPCODE_LOAD } };
   parameter logic [31:0] INSN_STORE   = {25'h?,                            {OPCODE_STORE} };
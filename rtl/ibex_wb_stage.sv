@@ -26,6 +26,7 @@ module ibex_wb_stage #(
   input  ibex_pkg::wb_instr_type_e instr_type_wb_i,
   input  logic [31:0]              pc_id_i,
   input  logic                     instr_is_compressed_id_i,
+  input  logic                     instr_is_fused_id_i,
   input  logic                     instr_perf_count_id_i,
 
   output logic                     ready_wb_o,
@@ -37,6 +38,8 @@ module ibex_wb_stage #(
   output logic                     perf_instr_ret_compressed_wb_o,
   output logic                     perf_instr_ret_wb_spec_o,
   output logic                     perf_instr_ret_compressed_wb_spec_o,
+  output logic                     perf_instr_ret_fused_wb_o,
+  output logic                     perf_instr_ret_fused_wb_spec_o,
 
   input  logic [4:0]               rf_waddr_id_i,
   input  logic [31:0]              rf_wdata_id_i,
@@ -78,6 +81,7 @@ module ibex_wb_stage #(
     logic           wb_valid_q;
     logic [31:0]    wb_pc_q;
     logic           wb_compressed_q;
+    logic           wb_fused_q;
     logic           wb_count_q;
     wb_instr_type_e wb_instr_type_q;
 
@@ -109,6 +113,7 @@ module ibex_wb_stage #(
           wb_instr_type_q <= wb_instr_type_e'(0);
           wb_pc_q         <= '0;
           wb_compressed_q <= '0;
+          wb_fused_q      <= '0;
           wb_count_q      <= '0;
         end else if (en_wb_i) begin
           rf_we_wb_q      <= rf_we_id_i;
@@ -117,6 +122,7 @@ module ibex_wb_stage #(
           wb_instr_type_q <= instr_type_wb_i;
           wb_pc_q         <= pc_id_i;
           wb_compressed_q <= instr_is_compressed_id_i;
+          wb_fused_q      <= instr_is_fused_id_i;
           wb_count_q      <= instr_perf_count_id_i;
         end
       end
@@ -129,6 +135,7 @@ module ibex_wb_stage #(
           wb_instr_type_q <= instr_type_wb_i;
           wb_pc_q         <= pc_id_i;
           wb_compressed_q <= instr_is_compressed_id_i;
+          wb_fused_q      <= instr_is_fused_id_i;
           wb_count_q      <= instr_perf_count_id_i;
         end
       end
@@ -160,6 +167,8 @@ module ibex_wb_stage #(
     assign perf_instr_ret_wb_o                 = instr_done_wb_o & wb_count_q &
                                                  ~(lsu_resp_valid_i & lsu_resp_err_i);
     assign perf_instr_ret_compressed_wb_o      = perf_instr_ret_wb_o & wb_compressed_q;
+    assign perf_instr_ret_fused_wb_spec_o      = perf_instr_ret_wb_spec_o & wb_fused_q;
+    assign perf_instr_ret_fused_wb_o           = perf_instr_ret_wb_o & wb_fused_q;
 
     // Forward data that will be written to the RF back to ID to resolve data hazards. The flopped
     // rf_wdata_wb_q is used rather than rf_wdata_wb_o as the latter includes read data from memory
@@ -208,9 +217,11 @@ module ibex_wb_stage #(
     // values will be correct.
     assign perf_instr_ret_wb_spec_o            = 1'b0;
     assign perf_instr_ret_compressed_wb_spec_o = 1'b0;
+    assign perf_instr_ret_fused_wb_spec_o      = 1'b0;
     assign perf_instr_ret_wb_o                 = instr_perf_count_id_i & en_wb_i &
                                                  ~(lsu_resp_valid_i & lsu_resp_err_i);
     assign perf_instr_ret_compressed_wb_o      = perf_instr_ret_wb_o & instr_is_compressed_id_i;
+    assign perf_instr_ret_fused_wb_o           = perf_instr_ret_wb_o & instr_is_fused_id_i;
 
     // ready needs to be constant 1 without writeback stage (otherwise ID/EX stage will stall)
     assign ready_wb_o    = 1'b1;
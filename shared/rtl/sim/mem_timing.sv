@@ -0,0 +1,221 @@
+// Copyright lowRISC contributors.
+// Licensed under the Apache License, Version 2.0, see LICENSE for details.
+// SPDX-License-Identifier: Apache-2.0
+
+/**
+ * Memory timing model
+ *
+ * Sits between an Ibex memory interface (the host) and a device that responds in the cycle after
+ * each request, and makes the device look like slower memory. This module is meant for
+ * simulation, do not use it in a real-world system.
+ *
+ * - The latency of reads and writes, counted from the grant to the response, is set per address
+ *   region. Accesses outside every enabled region keep the single cycle latency of the device.
+ * - Up to cfg_jitter_i random extra cycles are added to the latency of every access.
+ * - The grant is withheld in a random cfg_stall_pct_i percent of the cycles a request is made.
+ * - At most cfg_bw_accesses_i accesses are granted in every window of cfg_bw_window_i cycles. A
+ *   window of 0 disables the limit.
+ *
+ * The device is accessed in the cycle the host is granted, the model only holds back the response.
+ * Responses are returned in order, at most one per cycle. With the default (all zero)
+ * configuration the timing of the device is unchanged.
+ */
+
+`include "prim_assert.sv"
+
+module mem_timing #(
+  parameter int unsigned NumRegions     = 4,
+  // Accesses granted but not yet responded to, the grant is withheld once there are this many
+  parameter int unsigned MaxOutstanding = 8,
+  // Seed of the random generator, combined with cfg_seed_i
+  parameter logic [31:0] RndSeed        = 32'h2545F491
+) (
+  input  logic        clk_i,
+  input  logic        rst_ni,
+
+  // Host (the address, byte enables and write data go straight to the device)
+  input  logic        host_req_i,
+  output logic        host_gnt_o,
+  input  logic        host_we_i,
+  input  logic [31:0] host_addr_i,
+  output logic        host_rvalid_o,
+  output logic [31:0] host_rdata_o,
+  output logic        host_err_o,
+
+  // Device
+  output logic        device_req_o,
+  input  logic        device_rvalid_i,
+  input  logic [31:0] device_rdata_i,
+  input  logic        device_err_i,
+
+  // Accesses are outstanding
+  output logic        busy_o,
+
+  // Configuration
+  input  logic        cfg_region_en_i         [NumRegions],
+  input  logic [31:0] cfg_region_base_i       [NumRegions],
+  input  logic [31:0] cfg_region_mask_i       [NumRegions],
+  input  logic [15:0] cfg_region_rd_latency_i [NumRegions],
+  input  logic [15:0] cfg_region_wr_latency_i [NumRegions],
+  input  logic [15:0] cfg_jitter_i,
+  input  logic [ 6:0] cfg_stall_pct_i,
+  input  logic [15:0] cfg_bw_accesses_i,
+  input  logic [15:0] cfg_bw_window_i,
+  input  logic [31:0] cfg_seed_i
+);
+
+  localparam int unsigned IdxW = MaxOutstanding > 1 ? $clog2(MaxOutstanding) : 1;
+  localparam int unsigned CntW = $clog2(MaxOutstanding + 1);
+
+  logic [31:0]     cycle_q;
+  logic [31:0]     rnd_q, rnd_d;
+
+  logic [31:0]     latency;
+  logic [31:0]     jitter;
+  logic [31:0]     due_min, due;
+  logic [31:0]     last_due_q;
+  logic            stall, bw_ok, full;
+
+  logic [15:0]     bw_cycle_q, bw_grants_q;
+
+  // Outstanding accesses, in the order they were granted
+  logic [31:0]     due_q    [MaxOutstanding];
+  logic            filled_q [MaxOutstanding];
+  logic [31:0]     rdata_q  [MaxOutstanding];
+  logic            err_q    [MaxOutstanding];
+
+  logic [IdxW-1:0] wptr_q, rptr_q, wptr_next, rptr_next;
+  logic [CntW-1:0] count_q;
+  logic [IdxW-1:0] fill_idx_q;
+  logic            head_filling;
+
+  ////////////
+  // Random //
+  ////////////
+
+  // 32 bit xorshift generator, advanced every cycle. It must not be seeded with 0.
+  always_comb begin
+    rnd_d = rnd_q ^ (rnd_q << 13);
+    rnd_d = rnd_d ^ (rnd_d >> 17);
+    rnd_d = rnd_d ^ (rnd_d << 5);
+  end
+
+  assign stall  = (32'(rnd_q[15:0]) % 32'd100) < 32'(cfg_stall_pct_i);
+  assign jitter = (32'(rnd_q[31:16]) % (32'(cfg_jitter_i) + 32'd1));
+
+  /////////////
+  // Latency //
+  /////////////
+
+  // The lowest numbered enabled region containing the address sets the latency
+  always_comb begin
+    latency = 32'd1;
+    for (int i = NumRegions - 1; i >= 0; i--) begin
+      if (cfg_region_en_i[i] &&
+          ((host_addr_i & cfg_region_mask_i[i]) == cfg_region_base_i[i])) begin
+        latency = host_we_i ? 32'(cfg_region_wr_latency_i[i]) : 32'(cfg_region_rd_latency_i[i]);
+      end
+    end
+
+    // The device can't respond any sooner
+    if (latency == '0) begin
+      latency = 32'd1;
+    end
+  end
+
+  // Responses are returned in order and one per cycle, so an access can't complete before (or
+  // with) the previous one. The cycle count wraps, so compare the difference.
+  assign due_min = cycle_q + latency + jitter;
+  assign due     = (count_q != '0) && $signed(last_due_q + 32'd1 - due_min) > 0 ?
+                   last_due_q + 32'd1 : due_min;
+
+  ///////////
+  // Grant //
+  ///////////
+
+  assign full  = count_q == CntW'(MaxOutstanding);
+  assign bw_ok = (cfg_bw_window_i == '0) || (bw_grants_q < cfg_bw_accesses_i);
+
+  assign host_gnt_o   = host_req_i & ~full & ~stall & bw_ok;
+  assign device_req_o = host_gnt_o;
+
+  //////////////
+  // Response //
+  //////////////
+
+  // The device responds in the cycle after the grant, to the most recently granted access
+  assign head_filling = device_rvalid_i && (fill_idx_q == rptr_q);
+
+  assign host_rvalid_o = (count_q != '0) && (filled_q[rptr_q] || head_filling) &&
+                         $signed(cycle_q - due_q[rptr_q]) >= 0;
+  assign host_rdata_o  = filled_q[rptr_q] ? rdata_q[rptr_q] : device_rdata_i;
+  assign host_err_o    = filled_q[rptr_q] ? err_q[rptr_q]   : device_err_i;
+
+  assign busy_o = count_q != '0;
+
+  assign wptr_next = wptr_q == IdxW'(MaxOutstanding - 1) ? '0 : wptr_q + 1'b1;
+  assign rptr_next = rptr_q == IdxW'(MaxOutstanding - 1) ? '0 : rptr_q + 1'b1;
+
+  always_ff @(posedge clk_i or negedge rst_ni) begin
+    if (!rst_ni) begin
+      cycle_q     <= '0;
+      rnd_q       <= (RndSeed ^ cfg_seed_i) | 32'h1;
+      wptr_q      <= '0;
+      rptr_q      <= '0;
+      count_q     <= '0;
+      fill_idx_q  <= '0;
+      last_due_q  <= '0;
+      bw_cycle_q  <= '0;
+      bw_grants_q <= '0;
+    end else begin
+      cycle_q <= cycle_q + 32'd1;
+      rnd_q   <= rnd_d;
+
+      if (host_gnt_o) begin
+        wptr_q     <= wptr_next;
+        fill_idx_q <= wptr_q;
+        last_due_q <= due;
+      end
+
+      if (host_rvalid_o) begin
+        rptr_q <= rptr_next;
+      end
+
+      count_q <= count_q + CntW'(host_gnt_o) - CntW'(host_rvalid_o);
+
+      if ((cfg_bw_window_i != '0) && (bw_cycle_q >= cfg_bw_window_i - 16'd1)) begin
+        bw_cycle_q  <= '0;
+        bw_grants_q <= '0;
+      end else begin
+        bw_cycle_q  <= bw_cycle_q + 16'd1;
+        bw_grants_q <= bw_grants_q + 16'(host_gnt_o);
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i) begin
+    if (host_gnt_o) begin
+      due_q[wptr_q]    <= due;
+      filled_q[wptr_q] <= 1'b0;
+    end
+
+    if (device_rvalid_i) begin
+      filled_q[fill_idx_q] <= 1'b1;
+      rdata_q[fill_idx_q]  <= device_rdata_i;
+      err_q[fill_idx_q]    <= device_err_i;
+    end
+  end
+
+  ////////////////
+  // Assertions //
+  ////////////////
+
+  `ASSERT_INIT(ParamLegal, MaxOutstanding >= 1)
+
+  // The device must respond in the cycle after each request and only then
+  `ASSERT(DeviceRespNextCycle, device_rvalid_i == $past(device_req_o))
+
+  // A window without any accesses would never grant
+  `ASSERT(BandwidthLegal, (cfg_bw_window_i != '0) |-> (cfg_bw_accesses_i != '0))
+
+endmodule
@@ -6,13 +6,17 @@
  * Module for communicating with the simulator that interfaces via the memory
  * system.
  *
- * Contains two registers
+ * Contains three registers
  *
  * * 0x0 - CHAR_OUT_ADDR - [7:0] of write data output via output_char DPI call
  * and SimOutputManager (see dv/common/cpp/sim_output_manager.cc)
  *
  * * 0x8 - SIM_CTRL_ADDR - Write 1 to bit 0 to halt sim
  *
+ * * 0x10 - MARKER_ADDR - A full word write is passed out on marker_o, with
+ * marker_valid_o high for one cycle. The simple system uses this to sample
+ * the performance counters at points chosen by software.
+ *
  * The slightly odd spacing is because we also use SIM_CTRL_ADDR when
  * simulating simple_system code with Spike, which requires the address to be
  * 64-bit aligned.
@@ -35,11 +39,15 @@ module simulator_ctrl #(
   input        [31:0] addr_i,
   input        [31:0] wdata_i,
   output logic        rvalid_o,
-  output logic [31:0] rdata_o
+  output logic [31:0] rdata_o,
+
+  output logic        marker_valid_o,
+  output logic [31:0] marker_o
 );
 
   localparam logic [7:0] CHAR_OUT_ADDR = 8'h0;
   localparam logic [7:0] SIM_CTRL_ADDR = 8'h2;
+  localparam logic [7:0] MARKER_ADDR   = 8'h4;
 
   logic [7:0] ctrl_addr;
   logic [2:0] sim_finish;
@@ -60,9 +68,12 @@ module simulator_ctrl #(
     if (~rst_ni) begin
       rvalid_o <= 0;
       sim_finish <= 'b0;
+      marker_valid_o <= 1'b0;
+      marker_o <= '0;
     end else begin
       // Immeditely respond to any request
       rvalid_o <= req_i;
+      marker_valid_o <= 1'b0;
 
       if (req_i & we_i) begin
         case (ctrl_addr)
@@ -81,6 +92,12 @@ module simulator_ctrl #(
               sim_finish <= 3'b001;
             end
           end
+          MARKER_ADDR: begin
+            if (be_i == 4'b1111) begin
+              marker_valid_o <= 1'b1;
+              marker_o <= wdata_i;
+            end
+          end
           default: ;
         endcase
       end
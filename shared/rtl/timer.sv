@@ -149,6 +149,25 @@ module timer #(
   assign timer_rvalid_o = rvalid_q;
   assign timer_err_o    = error_q;
 
+`ifndef SYNTHESIS
+  // Simulation-only functions used to fast-forward over cycles in which nothing happens but mtime
+  // counting up (see the simple system's --skip-idle-cycles).
+
+  // Return the number of cycles until mtime reaches mtimecmp, or 0 if it already has.
+  export "DPI-C" function timer_cycles_to_interrupt;
+
+  function automatic longint unsigned timer_cycles_to_interrupt();
+    return mtime_q < mtimecmp_q ? mtimecmp_q - mtime_q : '0;
+  endfunction
+
+  // Advance mtime as if |cycles| clock cycles had passed.
+  export "DPI-C" function timer_skip_cycles;
+
+  function automatic void timer_skip_cycles(input longint unsigned cycles);
+    mtime_q = mtime_q + cycles;
+  endfunction
+`endif
+
   // Assertions
   `ASSERT_INIT(param_legal, DataWidth == 32)
 endmodule
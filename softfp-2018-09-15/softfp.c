@@ -28,6 +28,9 @@
 
 #include "cutils.h"
 #include "softfp.h"
+#ifdef SOFTFP_XSFP
+#include "softfp_xsfp.h"
+#endif
 
 static inline int clz32(uint32_t a)
 {
@@ -93,6 +93,9 @@ static inline F_UINT unpack_sf(uint32_t *pa_sign, int32_t *pa_exp,
 static F_UINT rshift_rnd(F_UINT a, int d)
 {
     F_UINT mask;
+#if defined(SOFTFP_XSFP) && F_SIZE == 32
+    return xsfp_srs(a, d);
+#endif
     if (d != 0) {
         if (d >= F_SIZE) {
             a = (a != 0);
@@ -111,6 +114,12 @@ static F_UINT round_pack_sf(uint32_t a_sign, int a_exp, F_UINT a_mant,
     int diff;
     uint32_t addend, rnd_bits;
 
+#if defined(SOFTFP_XSFP) && F_SIZE == 32
+    if (rm == RM_RNE) {
+        *pfflags |= xsfp_rpflags((a_sign << 31) | a_mant, a_exp);
+        return xsfp_rpack((a_sign << 31) | a_mant, a_exp);
+    }
+#endif
     switch(rm) {
     case RM_RNE:
     case RM_RMM:
@@ -179,6 +188,11 @@ static F_UINT normalize_sf(uint32_t a_sign, int a_exp, F_UINT a_mant,
                            RoundingModeEnum rm, uint32_t *pfflags)
 {
     int shift;
+#if defined(SOFTFP_XSFP) && F_SIZE == 32
+    a_exp = xsfp_nexp(a_mant, a_exp);
+    a_mant = xsfp_norm(a_mant);
+    return round_pack_sf(a_sign, a_exp, a_mant, rm, pfflags);
+#endif
     shift = clz(a_mant) - (F_SIZE - 1 - IMANT_SIZE);
     assert(shift >= 0);
     a_exp -= shift;
@@ -298,6 +312,10 @@ F_UINT glue(sub_sf, F_SIZE)(F_UINT a, F_UINT b, RoundingModeEnum rm,
 static inline F_UINT normalize_subnormal_sf(int32_t *pa_exp, F_UINT a_mant)
 {
     int shift;
+#if defined(SOFTFP_XSFP) && F_SIZE == 32
+    *pa_exp = xsfp_uexp(a_mant);
+    return xsfp_umant(a_mant);
+#endif
     shift = MANT_SIZE - ((F_SIZE - 1 - clz(a_mant)));
     *pa_exp = 1 - shift;
     return a_mant << shift;
@@ -0,0 +1,71 @@
+/*
+ * Ibex soft-float assist instructions (SoftFloatAssist parameter, custom-0
+ * opcode), used by the binary32 routines when SOFTFP_XSFP is defined. See
+ * the "Soft-Float Assist Instructions" section of the Ibex documentation for
+ * their definition.
+ */
+#ifndef SOFTFP_XSFP_H
+#define SOFTFP_XSFP_H
+
+#include <inttypes.h>
+
+#define XSFP_R(funct3, a, b)                                        \
+    ({                                                              \
+        uint32_t xsfp_rd_;                                          \
+        __asm__(".insn r 0x0b, " #funct3 ", 0, %0, %1, %2"          \
+                : "=r"(xsfp_rd_) : "r"(a), "r"(b));                 \
+        xsfp_rd_;                                                   \
+    })
+
+/* Single operand instructions, rs2 must be x0 */
+#define XSFP_R1(funct3, a)                                          \
+    ({                                                              \
+        uint32_t xsfp_rd_;                                          \
+        __asm__(".insn r 0x0b, " #funct3 ", 0, %0, %1, zero"        \
+                : "=r"(xsfp_rd_) : "r"(a));                         \
+        xsfp_rd_;                                                   \
+    })
+
+/* Sticky right shift, see rshift_rnd() */
+static inline uint32_t xsfp_srs(uint32_t a, uint32_t d)
+{
+    return XSFP_R(0, a, d);
+}
+
+/* Mantissa and exponent normalised to the internal format, see
+   normalize_sf() */
+static inline uint32_t xsfp_norm(uint32_t a_mant)
+{
+    return XSFP_R1(1, a_mant);
+}
+
+static inline int32_t xsfp_nexp(uint32_t a_mant, int32_t a_exp)
+{
+    return XSFP_R(2, a_mant, a_exp);
+}
+
+/* Round to nearest even and pack {sign, mantissa} and exponent, and the
+   exception flags of doing so, see round_pack_sf() */
+static inline uint32_t xsfp_rpack(uint32_t a_sign_mant, int32_t a_exp)
+{
+    return XSFP_R(3, a_sign_mant, a_exp);
+}
+
+static inline uint32_t xsfp_rpflags(uint32_t a_sign_mant, int32_t a_exp)
+{
+    return XSFP_R(4, a_sign_mant, a_exp);
+}
+
+/* Mantissa (with the hidden bit) and exponent of a binary32 value, with
+   subnormals normalised, see normalize_subnormal_sf() */
+static inline uint32_t xsfp_umant(uint32_t a)
+{
+    return XSFP_R1(5, a);
+}
+
+static inline int32_t xsfp_uexp(uint32_t a)
+{
+    return XSFP_R1(6, a);
+}
+
+#endif /* SOFTFP_XSFP_H */